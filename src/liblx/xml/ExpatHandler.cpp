@@ -114,17 +114,10 @@ unknownEncodingHandler(void* /*encodingHandlerData*/,
  */
 ExpatHandler::ExpatHandler (XML_Parser parser, XMLHandler& handler) :
    mParser ( parser  )
- , mHandler( handler )
+ , mHandler( &handler )
+ , mHandlerError( NULL )
 {
-  XML_SetXmlDeclHandler      ( mParser, LIBSBML_CPP_NAMESPACE ::XMLDeclHandler    );
-  XML_SetElementHandler      ( mParser, LIBSBML_CPP_NAMESPACE ::startElement, 
-                                        LIBSBML_CPP_NAMESPACE ::endElement        );
-  XML_SetCharacterDataHandler( mParser, LIBSBML_CPP_NAMESPACE ::characters        );
-  XML_SetNamespaceDeclHandler( mParser, LIBSBML_CPP_NAMESPACE ::startNamespace, 0 );
-  XML_SetUserData            ( mParser, static_cast<void*>(this)     );
-  XML_SetReturnNSTriplet     ( mParser, 1                            );
-  mHandlerError = NULL;
-  setHasXMLDeclaration(false);
+  reset(handler);
 }
 
 
@@ -156,6 +149,30 @@ ExpatHandler& ExpatHandler::operator=(const ExpatHandler& other)
 }
 
 
+/**
+ * Installs this handler's callbacks on the Expat parser again, as needed
+ * after XML_ParserReset(), and redirects events to the given XMLHandler.
+ */
+void
+ExpatHandler::reset (XMLHandler& handler)
+{
+  mHandler = &handler;
+
+  XML_SetXmlDeclHandler      ( mParser, LIBSBML_CPP_NAMESPACE ::XMLDeclHandler    );
+  XML_SetElementHandler      ( mParser, LIBSBML_CPP_NAMESPACE ::startElement, 
+                                        LIBSBML_CPP_NAMESPACE ::endElement        );
+  XML_SetCharacterDataHandler( mParser, LIBSBML_CPP_NAMESPACE ::characters        );
+  XML_SetNamespaceDeclHandler( mParser, LIBSBML_CPP_NAMESPACE ::startNamespace, 0 );
+  XML_SetUserData            ( mParser, static_cast<void*>(this)     );
+  XML_SetReturnNSTriplet     ( mParser, 1                            );
+
+  delete mHandlerError;
+  mHandlerError = NULL;
+  mNamespaces.clear();
+  setHasXMLDeclaration(false);
+}
+
+
 /**
  * Destroys this ExpatHandler.
  */
@@ -170,7 +187,7 @@ ExpatHandler::~ExpatHandler ()
 void
 ExpatHandler::startDocument ()
 {
-  mHandler.startDocument();
+  mHandler->startDocument();
 }
 
 
@@ -186,17 +203,17 @@ ExpatHandler::XML (const XML_Char* version, const XML_Char* encoding)
   XML_SetUnknownEncodingHandler( mParser, &unknownEncodingHandler, 0 );
   if (encoding == NULL)
   {
-    mHandler.XML(version, "");
+    mHandler->XML(version, "");
     return XML_STATUS_ERROR;
   }
   else if (version == NULL)
   {
-    mHandler.XML("", encoding);
+    mHandler->XML("", encoding);
     return XML_STATUS_ERROR;
   }
   else
   {
-    mHandler.XML(version, encoding);
+    mHandler->XML(version, encoding);
   }
 
   return 0;
@@ -212,12 +229,25 @@ ExpatHandler::XML (const XML_Char* version, const XML_Char* encoding)
 void
 ExpatHandler::startElement (const XML_Char* name, const XML_Char** attrs)
 {
+  if (mHandler->skipStartElement())
+  {
+    mNamespaces.clear();
+    return;
+  }
+
   const XMLTriple       triple    ( name  );
+
+  if (mHandler->filterElement(triple.getName(), triple.getURI()))
+  {
+    mNamespaces.clear();
+    return;
+  }
+
   const ExpatAttributes attributes( attrs, name );
   const XMLToken        element   ( triple, attributes, mNamespaces,
 			            getLine(), getColumn() );
 
-  mHandler.startElement(element);
+  mHandler->startElement(element);
   mNamespaces.clear();
 }
 
@@ -258,7 +288,7 @@ ExpatHandler::startNamespace (const XML_Char* prefix, const XML_Char* uri)
 void
 ExpatHandler::endDocument ()
 {
-  mHandler.endDocument();
+  mHandler->endDocument();
 }
 
 
@@ -270,10 +300,12 @@ ExpatHandler::endDocument ()
 void
 ExpatHandler::endElement (const XML_Char* name)
 {
+  if (mHandler->skipEndElement()) return;
+
   const XMLTriple  triple ( name );
   const XMLToken   element( triple, getLine(), getColumn() );
 
-  mHandler.endElement(element);
+  mHandler->endElement(element);
 }
 
 
@@ -286,8 +318,9 @@ ExpatHandler::endElement (const XML_Char* name)
 void
 ExpatHandler::characters (const XML_Char* chars, int length)
 {
-  XMLToken data( string(chars, length) );
-  mHandler.characters(data);
+  if (mHandler->isSkipping()) return;
+
+  mHandler->characters(chars, (size_t) length);
 }
 
 
@@ -77,6 +77,14 @@ public:
   ExpatHandler& operator=(const ExpatHandler& other);
 
 
+  /**
+   * Installs this handler's callbacks on the Expat parser again, as
+   * needed after XML_ParserReset(), and redirects events to the given
+   * XMLHandler.
+   */
+  void reset (XMLHandler& handler);
+
+
   /**
    * Destroys this ExpatHandler.
    */
@@ -167,7 +175,7 @@ protected:
   bool gotXMLDecl;
 
   XML_Parser    mParser;
-  XMLHandler&   mHandler;
+  XMLHandler*   mHandler;
   XMLNamespaces mNamespaces;
 
   XMLError*     mHandlerError;
@@ -355,6 +355,8 @@ ExpatParser::parseNext ()
   int bytes = mSource->copyTo(mBuffer, BUFFER_SIZE);
   int done  = (bytes == 0);
 
+  countRead((unsigned int) bytes);
+
   // Attempt to parse the content, checking for the Expat return status.
 
   if ( XML_ParseBuffer(mParser, bytes, done) == XML_STATUS_ERROR )
@@ -398,5 +400,26 @@ ExpatParser::parseReset ()
   mSource = 0;
 }
 
+
+/**
+ * Resets this parser for a new document whose events go to the given
+ * handler.  XML_ParserReset() keeps Expat's internal buffers, but clears
+ * the callbacks, so they are installed again.
+ */
+bool
+ExpatParser::reuse (XMLHandler& handler)
+{
+  if (mParser == NULL) return false;
+
+  parseReset();
+
+  if (XML_ParserReset(mParser, NULL) != XML_TRUE) return false;
+
+  mHandler.reset(handler);
+  mBuffer = XML_GetBuffer(mParser, BUFFER_SIZE);
+
+  return (mBuffer != NULL);
+}
+
 LIBSBML_CPP_NAMESPACE_END
 /** @endcond */
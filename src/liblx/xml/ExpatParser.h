@@ -118,6 +118,15 @@ public:
   virtual void parseReset ();
 
 
+  /**
+   * Resets this parser for a new document whose events go to the given
+   * handler.
+   *
+   * @return @c true if the parser is ready for parseFirst().
+   */
+  virtual bool reuse (XMLHandler& handler);
+
+
   /**
    * Returns the current column position of the parser.
    *
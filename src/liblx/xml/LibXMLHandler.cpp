@@ -74,12 +74,15 @@ x_start_element (  void*           user_data
                  , int             num_defaulted
                  , const xmlChar** attributes )
 {
+  LibXMLHandler* handler = static_cast<LibXMLHandler*>(user_data);
+
+  if (handler->skipElement(localname, uri)) return;
+
   const LibXMLAttributes attrs(attributes, localname,
 			       (unsigned int)(num_attributes + num_defaulted));
   const LibXMLNamespaces xmlns(namespaces, (unsigned int)num_namespaces);
 
-  static_cast<LibXMLHandler*>(user_data)->
-    startElement(localname, prefix, uri, attrs, xmlns);
+  handler->startElement(localname, prefix, uri, attrs, xmlns);
 }
 
 
@@ -163,7 +166,7 @@ static xmlSAXHandler SAXHandler =
  * given XMLHandler.
  */
 LibXMLHandler::LibXMLHandler (XMLHandler& handler) :
-   mHandler( handler )
+   mHandler( &handler )
  , mContext( NULL    )
  , mLocator( NULL    )
 {
@@ -213,8 +216,8 @@ LibXMLHandler::startDocument ()
   const string version  = LibXMLTranscode( mContext->version  );
   const string encoding = LibXMLTranscode( mContext->encoding );
 
-  mHandler.startDocument();
-  mHandler.XML(version, encoding);
+  mHandler->startDocument();
+  mHandler->XML(version, encoding);
 }
 
 
@@ -242,7 +245,24 @@ LibXMLHandler::startElement (  const xmlChar*           localname
   const XMLToken   element( triple, attributes, namespaces,
                             getLine(), getColumn() );
 
-  mHandler.startElement(element);
+  mHandler->startElement(element);
+}
+
+
+/**
+ * Tells the XMLHandler a start tag has been read, before its attributes
+ * are gathered.
+ *
+ * @return true if the element is being skipped.
+ */
+bool
+LibXMLHandler::skipElement (const xmlChar* localname, const xmlChar* uri)
+{
+  if (mHandler->skipStartElement()) return true;
+  if (!mHandler->hasElementFilter()) return false;
+
+  return mHandler->filterElement( LibXMLTranscode(localname),
+                                  LibXMLTranscode(uri) );
 }
 
 
@@ -258,6 +278,8 @@ LibXMLHandler::endElement (  const xmlChar*   localname
                            , const xmlChar*   prefix
                            , const xmlChar*   uri )
 {
+  if (mHandler->skipEndElement()) return;
+
   const string nsuri    = LibXMLTranscode( uri       );
   const string name     = LibXMLTranscode( localname );
   const string nsprefix = LibXMLTranscode( prefix    );
@@ -265,7 +287,7 @@ LibXMLHandler::endElement (  const xmlChar*   localname
   const XMLTriple  triple ( name, nsuri, nsprefix );
   const XMLToken   element( triple, getLine(), getColumn() );
 
-  mHandler.endElement(element);
+  mHandler->endElement(element);
 }
 
 
@@ -275,7 +297,7 @@ LibXMLHandler::endElement (  const xmlChar*   localname
 void
 LibXMLHandler::endDocument ()
 {
-  mHandler.endDocument();
+  mHandler->endDocument();
 }
 
 
@@ -288,8 +310,9 @@ LibXMLHandler::endDocument ()
 void
 LibXMLHandler::characters (const xmlChar* chars, int length)
 {
-  XMLToken data( LibXMLTranscode(chars, length) );
-  mHandler.characters(data);
+  if (mHandler->isSkipping()) return;
+
+  mHandler->characters(reinterpret_cast<const char*>(chars), (size_t) length);
 }
 
 
@@ -307,6 +330,18 @@ LibXMLHandler::setContext (xmlParserCtxt* context)
 }
 
 
+/**
+ * Redirects LibXML events to the given XMLHandler, for a parser that is
+ * reused for another document.
+ */
+void
+LibXMLHandler::setHandler (XMLHandler& handler)
+{
+  mHandler = &handler;
+  mLocator = NULL;
+}
+
+
 /**
  * Receive a Locator object for document events.
  */
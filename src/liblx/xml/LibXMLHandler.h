@@ -84,6 +84,19 @@ public:
   void startDocument ();
 
 
+  /**
+   * Tells the XMLHandler a start tag has been read, before its attributes
+   * are gathered.
+   *
+   * @param  localname  The local part of the element name
+   * @param  uri        The URI of the namespace for this element
+   *
+   * @return true if the element is being skipped, in which case nothing
+   * else is to be reported for it.
+   */
+  bool skipElement (const xmlChar* localname, const xmlChar* uri);
+
+
   /**
    * Receive notification of the start of an element.
    *
@@ -143,6 +156,13 @@ public:
   void setContext (xmlParserCtxt* context);
 
 
+  /**
+   * Redirects LibXML events to the given XMLHandler, for a parser that is
+   * reused for another document.
+   */
+  void setHandler (XMLHandler& handler);
+
+
   /**
    * Receive a Locator object for document events.
    */
@@ -175,7 +195,7 @@ public:
 
 protected:
 
-  XMLHandler&          mHandler;
+  XMLHandler*          mHandler;
   xmlParserCtxt*       mContext;
   const xmlSAXLocator* mLocator;
 };
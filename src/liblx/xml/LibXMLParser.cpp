@@ -37,8 +37,10 @@
  * ---------------------------------------------------------------------- -->*/
 
 #include <iostream>
+#include <mutex>
 #include <sstream>
 
+#include <libxml/parser.h>
 #include <libxml/xmlerror.h>
 
 #include <liblx/xml/XMLFileBuffer.h>
@@ -56,6 +58,9 @@ LIBLX_CPP_NAMESPACE_BEGIN
 
 static const int BUFFER_SIZE = 8192;
 
+/* libxml2 must be initialized once before parsers run on several threads */
+static once_flag libxmlInitialized;
+
 /*
  * Table mapping libXML error codes to ours.  The error code numbers are not
  * contiguous, hence the table has to map pairs of numbers rather than
@@ -87,6 +92,11 @@ static struct libxmlErrors {
   { XML_ERR_CHARREF_IN_PROLOG,	       BadlyFormedXML},
   { XML_ERR_CHARREF_IN_EPILOG,	       BadlyFormedXML},
   { XML_ERR_CHARREF_IN_DTD,	       BadlyFormedXML},
+  { XML_ERR_ENTITYREF_AT_EOF,	       BadlyFormedXML},
+  { XML_ERR_ENTITYREF_IN_PROLOG,       BadlyFormedXML},
+  { XML_ERR_ENTITYREF_IN_EPILOG,       BadlyFormedXML},
+  { XML_ERR_ENTITYREF_NO_NAME,	       BadlyFormedXML},
+  { XML_ERR_ENTITYREF_SEMICOL_MISSING, BadlyFormedXML},
   { XML_ERR_UNDECLARED_ENTITY,         UndefinedXMLEntity},
   { XML_WAR_UNDECLARED_ENTITY,         UndefinedXMLEntity},
   { XML_ERR_UNKNOWN_ENCODING,	       BadXMLDecl},
@@ -243,6 +253,8 @@ LibXMLParser::LibXMLParser (XMLHandler& handler) :
  , mBuffer ( new char[BUFFER_SIZE] )
  , mSource ( NULL                  )
 {
+  call_once(libxmlInitialized, xmlInitParser);
+
   xmlSAXHandler* sax  = LibXMLHandler::getInternalHandler();
   void*          data = static_cast<void*>(&mHandler);
   mParser             = xmlCreatePushParserCtxt(sax, data, 0, 0, 0);
@@ -410,6 +422,8 @@ LibXMLParser::parseNext ()
   int bytes = (int)mSource->copyTo(mBuffer, BUFFER_SIZE);
   int done  = (bytes == 0);
 
+  countRead((unsigned int) bytes);
+
   if ( mSource->error() )
   {
     reportError(InternalXMLParserError,
@@ -455,6 +469,22 @@ LibXMLParser::parseReset ()
 }
 
 
+/**
+ * Resets this parser for a new document whose events go to the given
+ * handler.  The push context and the chunk buffer are kept.
+ */
+bool
+LibXMLParser::reuse (XMLHandler& handler)
+{
+  if (mParser == NULL || mBuffer == NULL) return false;
+
+  parseReset();
+  mHandler.setHandler(handler);
+
+  return true;
+}
+
+
 LIBLX_CPP_NAMESPACE_END
 
 /** @endcond */
@@ -0,0 +1,1884 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    NativeParser.cpp
+ * @brief   Dependency-free XMLParser for UTF-8 input
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstring>
+#include <sstream>
+
+#include <liblx/xml/XMLFileBuffer.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLHandler.h>
+#include <liblx/xml/XMLToken.h>
+
+#include <liblx/xml/NativeParser.h>
+
+#include <liblx/xml/compress/CompressCommon.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NATIVE_PARSER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+static const size_t BUFFER_SIZE = 8192;
+
+static const string XML_NAMESPACE = "http://www.w3.org/XML/1998/namespace";
+static const string NO_NAMESPACE  = "";
+
+
+/*
+ * Character classes.  Bytes of multibyte UTF-8 sequences are accepted in
+ * names without further checks; character data and attribute values are
+ * validated.
+ */
+static inline bool
+isSpace (char c)
+{
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+
+static inline bool
+isNameStart (char c)
+{
+  const unsigned char u = (unsigned char) c;
+  return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z')
+      || u == '_' || u == ':' || u >= 0x80;
+}
+
+
+static inline bool
+isNameChar (char c)
+{
+  const unsigned char u = (unsigned char) c;
+  return isNameStart(c) || (u >= '0' && u <= '9') || u == '-' || u == '.';
+}
+
+
+/*
+ * @return true if the code point is a Char in the sense of XML 1.0.
+ */
+static inline bool
+isXMLChar (unsigned long code)
+{
+  return (code >= 0x20 && code <= 0xD7FF) || code == 0x9 || code == 0xA
+      || code == 0xD || (code >= 0xE000 && code <= 0xFFFD)
+      || (code >= 0x10000 && code <= 0x10FFFF);
+}
+
+
+static inline bool
+isDigit (char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+
+static inline bool
+isLetter (char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+
+/*
+ * @return true if the attribute name is "xmlns" or "xmlns:" followed by a
+ * prefix.  Like libxml2, a bare "xmlns:" is read as an ordinary attribute.
+ */
+static inline bool
+isNamespaceDecl (const char* name, size_t length)
+{
+  return length >= 5 && strncmp(name, "xmlns", 5) == 0
+         && (length == 5 || (name[5] == ':' && length > 6));
+}
+
+
+static void
+appendUTF8 (string& out, unsigned long code)
+{
+  if (code < 0x80)
+  {
+    out += (char) code;
+  }
+  else if (code < 0x800)
+  {
+    out += (char) (0xC0 | (code >> 6));
+    out += (char) (0x80 | (code & 0x3F));
+  }
+  else if (code < 0x10000)
+  {
+    out += (char) (0xE0 | (code >> 12));
+    out += (char) (0x80 | ((code >> 6) & 0x3F));
+    out += (char) (0x80 | (code & 0x3F));
+  }
+  else
+  {
+    out += (char) (0xF0 | (code >> 18));
+    out += (char) (0x80 | ((code >> 12) & 0x3F));
+    out += (char) (0x80 | ((code >> 6) & 0x3F));
+    out += (char) (0x80 | (code & 0x3F));
+  }
+}
+
+
+static const char*
+skipSpace (const char* p, const char* end)
+{
+  while (p < end && isSpace(*p)) ++p;
+  return p;
+}
+
+
+static const char*
+scanName (const char* p, const char* end)
+{
+  if (p == end || !isNameStart(*p)) return p;
+  ++p;
+  while (p < end && isNameChar(*p)) ++p;
+  return p;
+}
+
+
+/*
+ * Skips the name and external ID of the DOCTYPE at p, as libxml2 reads
+ * them.  A missing name or malformed external ID is recorded in code, as
+ * libxml2 reads on and complains again only if the declaration does not
+ * then end.
+ *
+ * @return where the internal subset or the closing '>' should be, or end
+ * if the declaration runs past end.
+ */
+static const char*
+skipDoctypeHeader (const char* p, const char* end, XMLErrorCode_t& code)
+{
+  const char* name = skipSpace(p + 9, end);
+
+  p = scanName(name, end);
+  if (p == end) return end;
+  if (p == name) code = BadlyFormedXML;
+
+  p = skipSpace(p, end);
+  if (end - p < 6) return (p < end && (*p == '[' || *p == '>')) ? p : end;
+
+  int literals = 0;
+  if (strncmp(p, "SYSTEM", 6) == 0) literals = 1;
+  if (strncmp(p, "PUBLIC", 6) == 0) literals = 2;
+
+  if (literals > 0) p += 6;
+
+  for (; literals > 0; --literals)
+  {
+    const char* q = skipSpace(p, end);
+    if (q == end) return end;
+
+    if (q == p || (*q != '"' && *q != '\''))
+    {
+      code = BadlyFormedXML;
+      return q;
+    }
+
+    p = static_cast<const char*>(memchr(q + 1, *q, (size_t) (end - q - 1)));
+    if (p == NULL) return end;
+    ++p;
+  }
+
+  return skipSpace(p, end);
+}
+
+
+/*
+ * The pseudo-attributes of the XML declaration.
+ */
+enum DeclValue { DeclVersion, DeclEncoding, DeclStandalone };
+
+
+/*
+ * Reads the "= 'value'" of a pseudo-attribute of the XML declaration at q,
+ * as libxml2 reads it, and leaves q where reading stopped.  An error is
+ * recorded in code and at rather than reported, since libxml2 reads on
+ * and reports the last error it meets.  The declaration is known to end
+ * before end.
+ *
+ * @return true if a value was read.
+ */
+static bool
+readDeclValue (  const char*& q
+               , const char* end
+               , DeclValue kind
+               , string& value
+               , XMLErrorCode_t& code
+               , const char*& at )
+{
+  q = skipSpace(q, end);
+  if (*q != '=')
+  {
+    code = BadlyFormedXML;
+    at   = q;
+    return false;
+  }
+
+  q = skipSpace(q + 1, end);
+  if (*q != '"' && *q != '\'')
+  {
+    code = BadlyFormedXML;
+    at   = q;
+    return false;
+  }
+
+  const char  quote = *q;
+  const char* start = ++q;
+  bool        valid = true;
+
+  if (kind == DeclVersion)
+  {
+    /* a digit, a period and any number of digits */
+    if (isDigit(*q) && q[1] == '.')
+    {
+      for (q += 2; isDigit(*q); ++q) ;
+    }
+    else
+    {
+      if (isDigit(*q)) ++q;
+      valid = false;
+    }
+  }
+  else if (kind == DeclEncoding)
+  {
+    if (isLetter(*q))
+    {
+      for (++q; isLetter(*q) || isDigit(*q)
+                || *q == '.' || *q == '_' || *q == '-'; ++q) ;
+    }
+    else
+    {
+      code  = BadXMLDecl;
+      at    = q;
+      valid = false;
+    }
+  }
+  else if (strncmp(q, "no", 2) == 0 || strncmp(q, "yes", 3) == 0)
+  {
+    q += (*q == 'n') ? 2 : 3;
+  }
+  else
+  {
+    code  = BadlyFormedXML;
+    at    = q;
+    valid = false;
+  }
+
+  value.assign(start, q);
+
+  if (*q != quote)
+  {
+    /* libxml2 keeps a version whose quote is not closed */
+    code = BadlyFormedXML;
+    at   = q;
+    return valid && kind == DeclVersion;
+  }
+
+  ++q;
+  return valid;
+}
+
+
+/*
+ * Structural scanning.  Most of a document is character data and
+ * attribute values that pass through unchanged; these scanners find the
+ * next byte that needs attention sixteen bytes at a time.  Bytes from
+ * 0x80 up compare as negative in a signed comparison, so a single test
+ * against 0x20 finds both control characters and the start of multibyte
+ * sequences.
+ */
+#ifdef NATIVE_PARSER_SSE2
+static inline unsigned int
+firstBit (int mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, (unsigned long) mask);
+  return (unsigned int) index;
+#else
+  return (unsigned int) __builtin_ctz((unsigned int) mask);
+#endif
+}
+
+
+static inline unsigned int
+lastBit (int mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanReverse(&index, (unsigned long) mask);
+  return (unsigned int) index;
+#else
+  return 31 - (unsigned int) __builtin_clz((unsigned int) mask);
+#endif
+}
+
+
+static inline unsigned int
+bitCount (unsigned int mask)
+{
+  mask = mask - ((mask >> 1) & 0x5555);
+  mask = (mask & 0x3333) + ((mask >> 2) & 0x3333);
+  mask = (mask + (mask >> 4)) & 0x0F0F;
+  return (mask + (mask >> 8)) & 0x1F;
+}
+#endif
+
+
+static inline bool
+isTextSpecial (char c)
+{
+  return c == '<' || c == '&' || c == ']'
+      || ((signed char) c < 0x20 && c != '\t' && c != '\n');
+}
+
+
+/*
+ * @return the first byte in [p, end) that ends a run of plain character
+ * data: '<', '&', ']', '\\r', any other control character except tab and
+ * newline, or the start of a multibyte sequence.
+ */
+static const char*
+scanText (const char* p, const char* end)
+{
+#ifdef NATIVE_PARSER_SSE2
+  const __m128i lt    = _mm_set1_epi8('<');
+  const __m128i amp   = _mm_set1_epi8('&');
+  const __m128i rsqb  = _mm_set1_epi8(']');
+  const __m128i tab   = _mm_set1_epi8('\t');
+  const __m128i nl    = _mm_set1_epi8('\n');
+  const __m128i space = _mm_set1_epi8(0x20);
+
+  while (end - p >= 16)
+  {
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+    __m128i special = _mm_andnot_si128(
+                        _mm_or_si128(_mm_cmpeq_epi8(b, tab),
+                                     _mm_cmpeq_epi8(b, nl)),
+                        _mm_cmplt_epi8(b, space));
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(b, lt));
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(b, amp));
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(b, rsqb));
+
+    const int mask = _mm_movemask_epi8(special);
+    if (mask != 0) return p + firstBit(mask);
+
+    p += 16;
+  }
+#endif
+
+  while (p < end && !isTextSpecial(*p)) ++p;
+  return p;
+}
+
+
+static inline bool
+isValueSpecial (char c, char quote)
+{
+  return c == quote || c == '<' || c == '&' || (signed char) c < 0x20;
+}
+
+
+/*
+ * @return the first byte in [p, end) that ends a run of plain attribute
+ * value: the closing quote, '<', '&', any control character (including
+ * whitespace other than ' ', which is normalized) or the start of a
+ * multibyte sequence.
+ */
+static const char*
+scanValue (const char* p, const char* end, char quote)
+{
+#ifdef NATIVE_PARSER_SSE2
+  const __m128i q     = _mm_set1_epi8(quote);
+  const __m128i lt    = _mm_set1_epi8('<');
+  const __m128i amp   = _mm_set1_epi8('&');
+  const __m128i space = _mm_set1_epi8(0x20);
+
+  while (end - p >= 16)
+  {
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+
+    __m128i special = _mm_cmplt_epi8(b, space);
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(b, q));
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(b, lt));
+    special = _mm_or_si128(special, _mm_cmpeq_epi8(b, amp));
+
+    const int mask = _mm_movemask_epi8(special);
+    if (mask != 0) return p + firstBit(mask);
+
+    p += 16;
+  }
+#endif
+
+  while (p < end && !isValueSpecial(*p, quote)) ++p;
+  return p;
+}
+
+
+/*
+ * @return true if the encoding name is one this parser reads: UTF-8 or
+ * its subset ASCII.  Like iconv, which libxml2 uses to look names up, case
+ * and punctuation are ignored.
+ */
+static bool
+isSupportedEncoding (const string& encoding)
+{
+  string name;
+  for (size_t n = 0; n < encoding.size(); ++n)
+  {
+    char c = encoding[n];
+    if (c >= 'a' && c <= 'z') c = (char) (c - 'a' + 'A');
+    if (isLetter(c) || isDigit(c)) name += c;
+  }
+
+  return name == "UTF8" || name == "USASCII" || name == "ASCII";
+}
+
+
+/*
+ * Note that the given error code is an XMLError code; NativeParser
+ * reports the code the libxml2 adapter would give for the same document.
+ */
+void
+NativeParser::reportError (const XMLErrorCode_t code,
+                           const string         extraMsg,
+                           const unsigned int   line,
+                           const unsigned int   column)
+{
+  if (mErrorLog != NULL)
+    mErrorLog->add(XMLError( code, extraMsg, line, column) );
+}
+
+
+/*
+ * Creates a new NativeParser.  The parser will notify the given XMLHandler
+ * of parse events and errors.
+ */
+NativeParser::NativeParser (XMLHandler& handler) :
+   mHandler      ( &handler       )
+ , mSource       ( NULL           )
+ , mCur          ( NULL           )
+ , mEnd          ( NULL           )
+ , mCounted      ( NULL           )
+ , mLine         ( 1              )
+ , mColumn       ( 1              )
+ , mStarted      ( false          )
+ , mSeenRoot     ( false          )
+ , mSeenDoctype  ( false          )
+ , mFailed       ( false          )
+ , mDepth        ( 0              )
+ , mDeferredCode ( BadlyFormedXML )
+ , mDeferredAt   ( NULL           )
+{
+  mBindings.push_back(make_pair(string("xml"), XML_NAMESPACE));
+}
+
+
+/*
+ * Destroys this NativeParser.
+ */
+NativeParser::~NativeParser ()
+{
+  delete mSource;
+}
+
+
+/*
+ * @return true if the parser encountered an error, false otherwise.
+ */
+bool
+NativeParser::error () const
+{
+  return mFailed || (mSource != NULL && mSource->error());
+}
+
+
+/*
+ * @return the current column position of the parser.
+ */
+unsigned int
+NativeParser::getColumn () const
+{
+  return mColumn;
+}
+
+
+/*
+ * @return the current line position of the parser.
+ */
+unsigned int
+NativeParser::getLine () const
+{
+  return mLine;
+}
+
+
+/*
+ * Parses XML content in one fell swoop.
+ */
+bool
+NativeParser::parse (const char* content, bool isFile)
+{
+  bool result = parseFirst(content, isFile);
+
+  if (result)
+  {
+    while( parseNext() );
+    result = (error() == false);
+  }
+
+  parseReset();
+
+  return result;
+}
+
+
+/*
+ * Begins a progressive parse of XML content.
+ */
+bool
+NativeParser::parseFirst (const char* content, bool isFile)
+{
+  if ( error() ) return false;
+
+  if (content == NULL) return false;
+
+  mData.clear();
+
+  if ( isFile )
+  {
+    try
+    {
+      mSource = new XMLFileBuffer(content);
+    }
+    catch ( ZlibNotLinked& )
+    {
+      std::ostringstream oss;
+      oss << "Tried to read " << content << ". Reading a gzip/zip file is not enabled because "
+          << "underlying libLX is not linked with zlib.";
+      reportError(XMLFileUnreadable, oss.str(), 0, 0);
+      return false;
+    }
+    catch ( Bzip2NotLinked& )
+    {
+      std::ostringstream oss;
+      oss << "Tried to read " << content << ". Reading a bzip2 file is not enabled because "
+          << "underlying libLX is not linked with bzip2.";
+      reportError(XMLFileUnreadable, oss.str(), 0, 0);
+      return false;
+    }
+
+    if ( mSource->error() )
+    {
+      reportError(XMLFileUnreadable, content, 0, 0);
+      return false;
+    }
+  }
+  else
+  {
+    /* the content is copied: callers may release it before parsing ends */
+    mData.assign(content, content + strlen(content));
+    countRead((unsigned int) mData.size());
+  }
+
+  mCur     = mData.empty() ? NULL : &mData[0];
+  mEnd     = mCur + mData.size();
+  mCounted = mCur;
+
+  return true;
+}
+
+
+/*
+ * Parses the next chunk of XML content.
+ */
+bool
+NativeParser::parseNext ()
+{
+  if ( error() ) return false;
+
+  size_t consumed = 0;
+
+  while (consumed < BUFFER_SIZE)
+  {
+    const char* before   = mCur;
+    Progress    progress = Incomplete;
+
+    if (mCur != mEnd)
+    {
+      progress = mStarted ? parseItem() : parseXMLDecl();
+    }
+
+    consumed += (size_t) (mCur - before);
+
+    if (progress == Failed) return false;
+
+    if (progress == Incomplete && !fill())
+    {
+      /* deliver what this call read before ending the document */
+      if (mFailed) return false;
+      return (consumed > 0) ? true : finish();
+    }
+  }
+
+  return true;
+}
+
+
+/*
+ * Resets the progressive parser.
+ */
+void
+NativeParser::parseReset ()
+{
+  delete mSource;
+  mSource = NULL;
+
+  mData.clear();
+  mCur     = NULL;
+  mEnd     = NULL;
+  mCounted = NULL;
+  mLine    = 1;
+  mColumn  = 1;
+
+  mStarted     = false;
+  mSeenRoot    = false;
+  mSeenDoctype = false;
+  mFailed      = false;
+
+  mText.clear();
+  mDepth = 0;
+  mBindings.resize(1);
+}
+
+
+/*
+ * Resets this parser for a new document whose events go to the given
+ * handler.  The input buffer keeps its capacity.
+ */
+bool
+NativeParser::reuse (XMLHandler& handler)
+{
+  parseReset();
+  mHandler = &handler;
+
+  return true;
+}
+
+
+/*
+ * Moves the unparsed input to the front of mData and appends as much of
+ * the source as fits, growing mData when a single construct fills more
+ * than half of it.
+ *
+ * @return false if no more input could be read.
+ */
+bool
+NativeParser::fill ()
+{
+  if (mSource == NULL) return false;
+
+  advanceTo(mCur);
+
+  const size_t kept = (size_t) (mEnd - mCur);
+  if (kept > 0) memmove(&mData[0], mCur, kept);
+
+  if (mData.size() < BUFFER_SIZE)
+  {
+    mData.resize(BUFFER_SIZE);
+  }
+  else if (kept > mData.size() / 2)
+  {
+    mData.resize(mData.size() * 2);
+  }
+
+  const unsigned int bytes =
+    mSource->copyTo(&mData[kept], (unsigned int) (mData.size() - kept));
+  countRead(bytes);
+
+  mCur     = &mData[0];
+  mEnd     = mCur + kept + bytes;
+  mCounted = mCur;
+
+  if ( mSource->error() )
+  {
+    reportError(InternalXMLParserError,
+                "error: Could not read from source buffer.");
+    mFailed = true;
+    return false;
+  }
+
+  return bytes > 0;
+}
+
+
+/*
+ * Called once all input has been read.  An incomplete document is
+ * reported at its end, with the error libxml2 gives for the construct left
+ * unfinished; either way the handler sees the end of the document, as it
+ * does with the libxml2 adapter.
+ *
+ * @return false.
+ */
+bool
+NativeParser::finish ()
+{
+  if (mCur != mEnd || !mSeenRoot || mDepth > 0)
+  {
+    XMLErrorCode_t code = BadlyFormedXML;
+
+    if (!mStarted && mCur != mEnd)
+      code = BadXMLDecl;
+    else if (lookingAt(mCur, "<!--") > 0)
+      code = BadXMLComment;
+    else if (lookingAt(mCur, "<?") > 0)
+      code = BadProcessingInstruction;
+    else if (lookingAt(mCur, "</") > 0 && mDepth > 0)
+    {
+      const char*        name = mCur + 2;
+      const OpenElement& open = mOpen[mDepth - 1];
+
+      if (open.qname.compare(0, string::npos, name,
+                             (size_t) (scanName(name, mEnd) - name)) != 0)
+      {
+        code = XMLTagMismatch;
+      }
+    }
+    else if (lookingAt(mCur, "<!DOCTYPE") > 0)
+    {
+      const char* q = skipDoctypeHeader(mCur, mEnd, code);
+      code = (q != mEnd && *q == '[') ? BadlyFormedXML : BadXMLDOCTYPE;
+    }
+
+    fail(code, mEnd);
+  }
+
+  mHandler->endDocument();
+  return false;
+}
+
+
+/*
+ * Reports the error at the position of the given byte and stops the
+ * parse.
+ */
+NativeParser::Progress
+NativeParser::fail (XMLErrorCode_t code, const char* at, const string& extraMsg)
+{
+  if (at != NULL) advanceTo(at);
+
+  reportError(code, extraMsg, mLine, mColumn);
+  mFailed = true;
+
+  return Failed;
+}
+
+
+/*
+ * Advances the line and column count to the character at p.  Columns
+ * count characters, not bytes.
+ */
+void
+NativeParser::advanceTo (const char* p)
+{
+  const char* q = mCounted;
+  if (q == NULL || p <= q) return;
+
+#ifdef NATIVE_PARSER_SSE2
+  /* newlines and UTF-8 continuation bytes (0x80 to 0xBF, the signed
+   * values below -64), sixteen bytes at a time */
+  const __m128i newline = _mm_set1_epi8('\n');
+  const __m128i lead    = _mm_set1_epi8((char) 0xC0);
+
+  for (; p - q >= 16; q += 16)
+  {
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q));
+
+    const int lines = _mm_movemask_epi8(_mm_cmpeq_epi8(b, newline));
+    unsigned int chars =
+      ~(unsigned int) _mm_movemask_epi8(_mm_cmplt_epi8(b, lead)) & 0xFFFF;
+
+    if (lines != 0)
+    {
+      mLine  += bitCount((unsigned int) lines);
+      mColumn = 1;
+      chars  &= ~((2u << lastBit(lines)) - 1);
+    }
+
+    mColumn += bitCount(chars);
+  }
+#endif
+
+  const char* nl;
+  while ((nl = static_cast<const char*>(memchr(q, '\n', (size_t) (p - q))))
+         != NULL)
+  {
+    ++mLine;
+    mColumn = 1;
+    q = nl + 1;
+  }
+
+  for (; q < p; ++q)
+  {
+    if ((*q & 0xC0) != 0x80) ++mColumn;
+  }
+
+  mCounted = p;
+}
+
+
+/*
+ * @return 1 if the input at p starts with literal, 0 if it does not, and
+ * -1 if the input ends before that can be decided.
+ */
+int
+NativeParser::lookingAt (const char* p, const char* literal) const
+{
+  for (; *literal != '\0'; ++p, ++literal)
+  {
+    if (p == mEnd) return -1;
+    if (*p != *literal) return 0;
+  }
+
+  return 1;
+}
+
+
+/*
+ * Reads the byte order mark and XML declaration, if present, and
+ * notifies the handler of the start of the document.
+ */
+NativeParser::Progress
+NativeParser::parseXMLDecl ()
+{
+  const char* p = mCur;
+
+  if (mEnd - p >= 2
+      && (((unsigned char) p[0] == 0xFE && (unsigned char) p[1] == 0xFF)
+       || ((unsigned char) p[0] == 0xFF && (unsigned char) p[1] == 0xFE)))
+  {
+    return fail(BadXMLDecl, p,
+                "The native parser only reads UTF-8 documents.");
+  }
+
+  const int bom = lookingAt(p, "\xEF\xBB\xBF");
+  if (bom < 0) return Incomplete;
+  if (bom > 0)
+  {
+    p += 3;
+    mCounted = p;
+  }
+
+  string version  = "1.0";
+  string encoding = "";
+
+  const int decl = lookingAt(p, "<?xml");
+  if (decl < 0) return Incomplete;
+
+  if (decl > 0)
+  {
+    if (p + 5 == mEnd) return Incomplete;
+
+    if (isSpace(p[5]))
+    {
+      /* like libxml2, wait for the whole declaration before reading it */
+      const char* close = p + 5;
+      while (true)
+      {
+        close = static_cast<const char*>(memchr(close, '?', (size_t) (mEnd - close)));
+        if (close == NULL || close + 1 == mEnd) return Incomplete;
+        if (close[1] == '>') break;
+        ++close;
+      }
+
+      /* libxml2 reads on past most errors in the declaration, and reports
+       * the last one it meets; the declaration is read as it reads it */
+      XMLErrorCode_t code       = BadXMLDecl;
+      const char*    at         = NULL;
+      const char*    q          = skipSpace(p + 5, mEnd);
+      bool           sawVersion = false;
+      bool           done       = false;
+      string         text;
+
+      if (lookingAt(q, "version") > 0)
+      {
+        q += 7;
+        sawVersion = readDeclValue(q, mEnd, DeclVersion, text, code, at);
+      }
+
+      if (!sawVersion || text.size() < 2 || text[0] != '1' || text[1] != '.')
+      {
+        code = BadXMLDecl;
+        at   = q;
+      }
+      else
+      {
+        version = text;
+      }
+
+      if (!isSpace(*q) && lookingAt(q, "?>") > 0)
+      {
+        done = true;
+      }
+      else
+      {
+        if (!isSpace(*q))
+        {
+          code = BadlyFormedXML;
+          at   = q;
+        }
+        q = skipSpace(q, mEnd);
+
+        bool sawEncoding = false;
+
+        if (lookingAt(q, "encoding") > 0)
+        {
+          q += 8;
+          sawEncoding = readDeclValue(q, mEnd, DeclEncoding, text, code, at);
+          if (sawEncoding) encoding = text;
+        }
+
+        if (sawEncoding && !isSpace(*q))
+        {
+          if (lookingAt(q, "?>") > 0)
+          {
+            done = true;
+          }
+          else
+          {
+            code = BadlyFormedXML;
+            at   = q;
+          }
+        }
+      }
+
+      if (done)
+      {
+        q += 2;
+      }
+      else
+      {
+        q = skipSpace(q, mEnd);
+
+        if (lookingAt(q, "standalone") > 0)
+        {
+          q += 10;
+          readDeclValue(q, mEnd, DeclStandalone, text, code, at);
+          q = skipSpace(q, mEnd);
+        }
+
+        if (lookingAt(q, "?>") > 0)
+        {
+          q += 2;
+        }
+        else
+        {
+          code = BadXMLDecl;
+          at   = q;
+          q    = static_cast<const char*>(memchr(q, '>', (size_t) (mEnd - q))) + 1;
+        }
+      }
+
+      if (at != NULL) return fail(code, at);
+
+      if (!encoding.empty() && !isSupportedEncoding(encoding))
+      {
+        return fail(BadXMLDecl, q,
+                    "The native parser only reads UTF-8 documents; "
+                    "the declared encoding is " + encoding + ".");
+      }
+
+      p = q;
+    }
+  }
+
+  mCur     = p;
+  mStarted = true;
+
+  mHandler->startDocument();
+  mHandler->XML(version, encoding);
+
+  return Complete;
+}
+
+
+/*
+ * Reads one construct: a run of character data or whitespace, a tag, a
+ * comment, a CDATA section, a processing instruction or a DOCTYPE.
+ */
+NativeParser::Progress
+NativeParser::parseItem ()
+{
+  if (*mCur != '<')
+  {
+    return (mDepth > 0) ? parseText() : parseSpace();
+  }
+
+  if (mEnd - mCur < 2) return Incomplete;
+
+  switch (mCur[1])
+  {
+  case '/':
+    return parseEndTag();
+
+  case '?':
+    return parseProcessingInstruction();
+
+  case '!':
+    return parseMarkupDecl();
+
+  default:
+    return parseStartTag();
+  }
+}
+
+
+/*
+ * Skips whitespace before or after the document element, where nothing
+ * else may appear as character data.
+ */
+NativeParser::Progress
+NativeParser::parseSpace ()
+{
+  const char* p = skipSpace(mCur, mEnd);
+
+  /* libxml2 reports text before the document element as a missing one */
+  if (p < mEnd && *p != '<')
+  {
+    return fail(mSeenRoot ? BadlyFormedXML : XMLContentEmpty, p);
+  }
+
+  mCur = p;
+  return Complete;
+}
+
+
+/*
+ * Reads character data up to the next markup, decoding references and
+ * normalizing line ends.  The text is passed to the handler when the next
+ * tag is read.
+ */
+NativeParser::Progress
+NativeParser::parseText ()
+{
+  const char* p = mCur;
+
+  while (true)
+  {
+    const char* q = scanText(p, mEnd);
+    mText.append(p, q);
+    mCur = q;
+
+    if (q == mEnd || *q == '<') return Complete;
+
+    const char c = *q;
+
+    if (c == '&')
+    {
+      Progress progress = parseReference(q, mText);
+      if (progress != Complete) return progress;
+    }
+    else if (c == ']')
+    {
+      const int end = lookingAt(q, "]]>");
+      if (end < 0) return Incomplete;
+      if (end > 0) return fail(BadlyFormedXML, q);
+
+      mText += ']';
+      ++q;
+    }
+    else if (c == '\r')
+    {
+      if (q + 1 == mEnd) return Incomplete;
+
+      mText += '\n';
+      q += (q[1] == '\n') ? 2 : 1;
+    }
+    else if ((signed char) c < 0)
+    {
+      const char* start    = q;
+      Progress    progress = skipUTF8(q);
+      if (progress != Complete) return progress;
+
+      mText.append(start, q);
+    }
+    else
+    {
+      return fail(InvalidCharInXML, q);
+    }
+
+    p = q;
+  }
+}
+
+
+/*
+ * Reads the markup beginning "<!": a comment anywhere, a CDATA section
+ * inside the document element or a DOCTYPE before it.
+ */
+NativeParser::Progress
+NativeParser::parseMarkupDecl ()
+{
+  const int comment = lookingAt(mCur, "<!--");
+  if (comment < 0) return Incomplete;
+
+  if (comment > 0)
+  {
+    const char* q = mCur + 4;
+
+    while (true)
+    {
+      q = static_cast<const char*>(memchr(q, '-', (size_t) (mEnd - q)));
+      if (q == NULL || mEnd - q < 3) return Incomplete;
+
+      if (q[1] == '-')
+      {
+        if (q[2] != '>') return fail(BadXMLComment, q);
+        if (checkChars(mCur + 4, q) != Complete) return Failed;
+
+        mCur = q + 3;
+        return Complete;
+      }
+
+      ++q;
+    }
+  }
+
+  const int cdata = lookingAt(mCur, "<![CDATA[");
+  if (cdata < 0) return Incomplete;
+
+  if (cdata > 0)
+  {
+    if (mDepth == 0) return fail(BadlyFormedXML, mCur);
+
+    const char* begin = mCur + 9;
+    const char* q     = begin;
+
+    while (true)
+    {
+      q = static_cast<const char*>(memchr(q, ']', (size_t) (mEnd - q)));
+      if (q == NULL) return Incomplete;
+
+      const int end = lookingAt(q, "]]>");
+      if (end < 0) return Incomplete;
+      if (end > 0) break;
+
+      ++q;
+    }
+
+    if (checkChars(begin, q) != Complete) return Failed;
+
+    for (const char* c = begin; c < q; ++c)
+    {
+      if (*c != '\r')
+      {
+        mText += *c;
+      }
+      else if (c + 1 == q || c[1] != '\n')
+      {
+        mText += '\n';
+      }
+    }
+
+    mCur = q + 3;
+    return Complete;
+  }
+
+  const int doctype = lookingAt(mCur, "<!DOCTYPE");
+  if (doctype < 0) return Incomplete;
+
+  if (doctype == 0 || mSeenRoot || mSeenDoctype)
+  {
+    return fail(BadlyFormedXML, mCur);
+  }
+
+  /* the internal subset is skipped: only predefined entities are known */
+  XMLErrorCode_t code = BadXMLDOCTYPE;
+  const char*    q    = skipDoctypeHeader(mCur, mEnd, code);
+
+  if (q == mEnd) return Incomplete;
+
+  if (*q == '[')
+  {
+    /* like libxml2, wait for a ']' followed by the '>' before reading the
+     * subset; without one the document is reported as badly formed */
+    const char* subset = q + 1;
+    char        quote  = 0;
+
+    for (++q; q < mEnd; ++q)
+    {
+      if (quote != 0)
+      {
+        if (*q == quote) quote = 0;
+      }
+      else if (*q == '"' || *q == '\'')
+      {
+        quote = *q;
+      }
+      else if (*q == ']')
+      {
+        const char* r = skipSpace(q + 1, mEnd);
+        if (r == mEnd) return Incomplete;
+        if (*r == '>') break;
+      }
+    }
+
+    if (q == mEnd) return Incomplete;
+
+    subset = skipSpace(subset, q);
+    if (subset != q && *subset != '<' && *subset != '%')
+    {
+      return fail(BadXMLDOCTYPE, subset);
+    }
+
+    q = skipSpace(q + 1, mEnd);
+  }
+  else if (*q == '>' && code != BadXMLDOCTYPE)
+  {
+    return fail(code, q);
+  }
+
+  if (*q != '>') return fail(BadXMLDOCTYPE, q);
+
+  mSeenDoctype = true;
+  mCur = q + 1;
+  return Complete;
+}
+
+
+/*
+ * Skips a processing instruction.  An XML declaration anywhere but at the
+ * very start of the document is an error.
+ */
+NativeParser::Progress
+NativeParser::parseProcessingInstruction ()
+{
+  const char* name = mCur + 2;
+  const char* q    = scanName(name, mEnd);
+
+  if (q == mEnd) return Incomplete;
+  if (q == name) return fail(BadProcessingInstruction, q);
+
+  const char* data = q;
+
+  while (true)
+  {
+    q = static_cast<const char*>(memchr(q, '?', (size_t) (mEnd - q)));
+    if (q == NULL || q + 1 == mEnd) return Incomplete;
+    if (q[1] == '>') break;
+    ++q;
+  }
+
+  if (checkChars(data, q) != Complete) return Failed;
+
+  /* the target is followed by white space or the end of the instruction;
+   * like libxml2, look for the end before complaining */
+  if (data != q && !isSpace(*data)) return fail(BadlyFormedXML, data);
+
+  if (data - name == 3
+      && (name[0] == 'x' || name[0] == 'X')
+      && (name[1] == 'm' || name[1] == 'M')
+      && (name[2] == 'l' || name[2] == 'L'))
+  {
+    return fail(BadXMLDeclLocation, data);
+  }
+
+  mCur = q + 2;
+  return Complete;
+}
+
+
+/*
+ * Reads a start tag or empty-element tag and notifies the handler.
+ */
+NativeParser::Progress
+NativeParser::parseStartTag ()
+{
+  if (mDepth == 0 && mSeenRoot) return fail(BadlyFormedXML, mCur);
+
+  const char* name = mCur + 1;
+  const char* p    = scanName(name, mEnd);
+
+  if (p == mEnd) return Incomplete;
+  if (p == name) return fail(BadlyFormedXML, p);
+
+  const size_t nameLength = (size_t) (p - name);
+  size_t       numRaw     = 0;
+  bool         empty      = false;
+
+  mDeferredAt = NULL;
+
+  while (true)
+  {
+    const char* space = p;
+    p = skipSpace(p, mEnd);
+    if (p == mEnd) return Incomplete;
+
+    if (*p == '>')
+    {
+      ++p;
+      break;
+    }
+
+    if (*p == '/')
+    {
+      if (p + 1 == mEnd) return Incomplete;
+      if (p[1] != '>') return fail(BadlyFormedXML, p);
+
+      p += 2;
+      empty = true;
+      break;
+    }
+
+    if (p == space) return fail(BadlyFormedXML, p);
+
+    const char* attr = p;
+    p = scanName(p, mEnd);
+    if (p == mEnd) return Incomplete;
+    if (p == attr) return fail(BadlyFormedXML, p);
+
+    const size_t attrLength = (size_t) (p - attr);
+
+    p = skipSpace(p, mEnd);
+    if (p == mEnd) return Incomplete;
+    if (*p != '=')
+    {
+      /* libxml2 reports the missing value only where the tag then ends;
+       * otherwise the attribute is simply malformed */
+      if (*p == '/' && p + 1 == mEnd) return Incomplete;
+
+      const bool ends = (*p == '>') || (*p == '/' && p[1] == '>');
+      return fail(ends ? MissingXMLAttributeValue : BadlyFormedXML, p);
+    }
+
+    p = skipSpace(p + 1, mEnd);
+    if (p == mEnd) return Incomplete;
+    if (*p != '"' && *p != '\'')
+    {
+      /* libxml2's code for a value missing where the tag then ends is
+       * mapped to InternalXMLParserError */
+      if (*p == '/' && p + 1 == mEnd) return Incomplete;
+
+      const bool ends = (*p == '>') || (*p == '/' && p[1] == '>');
+      return fail(ends ? InternalXMLParserError : BadlyFormedXML, p);
+    }
+
+    if (mRaw.size() == numRaw) mRaw.push_back(RawAttribute());
+
+    RawAttribute& raw = mRaw[numRaw];
+    raw.name   = attr;
+    raw.length = attrLength;
+    raw.value.clear();
+
+    Progress progress = parseValue(p, raw.value);
+    if (progress != Complete) return progress;
+
+    raw.end = p;
+
+    ++numRaw;
+  }
+
+  /* namespace declarations first, as they apply to the element's own
+   * attributes */
+  const size_t scope = mBindings.size();
+
+  mAttributes.clear();
+  mNamespaces.clear();
+
+  for (size_t n = 0; n < numRaw; ++n)
+  {
+    const RawAttribute& raw = mRaw[n];
+
+    if (isNamespaceDecl(raw.name, raw.length))
+    {
+      for (size_t m = 0; m < n; ++m)
+      {
+        if (mRaw[m].length == raw.length
+            && memcmp(mRaw[m].name, raw.name, raw.length) == 0)
+        {
+          mBindings.resize(scope);
+          return fail(DuplicateXMLAttribute, raw.end);
+        }
+      }
+
+      const string prefix = (raw.length == 5)
+                          ? string() : string(raw.name + 6, raw.length - 6);
+
+      /* a prefix cannot be undeclared; libxml2 ignores the attempt */
+      if (!prefix.empty() && raw.value.empty()) continue;
+
+      mBindings.push_back(make_pair(prefix, raw.value));
+      mNamespaces.add(raw.value, prefix);
+    }
+  }
+
+  const char* colon = static_cast<const char*>(memchr(name, ':', nameLength));
+
+  if (colon != NULL && colon != name && colon + 1 != name + nameLength)
+  {
+    mPrefix.assign(name, colon);
+    mName.assign(colon + 1, name + nameLength);
+  }
+  else
+  {
+    mPrefix.clear();
+    mName.assign(name, nameLength);
+  }
+
+  const XMLTriple triple(mName, resolve(mPrefix), mPrefix);
+
+  /* text before the tag belongs to the content around it, which may be
+   * about to be skipped */
+  flushText();
+
+  /* nothing is reported for an element being skipped, so its attributes
+   * are only checked for repeated names */
+  const bool skipped = mHandler->skipStartElement()
+                    || mHandler->filterElement(triple.getName(), triple.getURI());
+
+  for (size_t n = 0; n < numRaw; ++n)
+  {
+    const RawAttribute& raw = mRaw[n];
+
+    if (isNamespaceDecl(raw.name, raw.length)) continue;
+
+    for (size_t m = 0; m < n; ++m)
+    {
+      if (mRaw[m].length == raw.length
+          && memcmp(mRaw[m].name, raw.name, raw.length) == 0)
+      {
+        mBindings.resize(scope);
+        return fail(DuplicateXMLAttribute, raw.end);
+      }
+    }
+
+    if (skipped) continue;
+
+    const char* colon = static_cast<const char*>(memchr(raw.name, ':', raw.length));
+
+    if (colon != NULL && colon != raw.name && colon + 1 != raw.name + raw.length)
+    {
+      mPrefix.assign(raw.name, colon);
+      mName.assign(colon + 1, raw.name + raw.length);
+    }
+    else
+    {
+      mPrefix.clear();
+      mName.assign(raw.name, raw.length);
+    }
+
+    /* two prefixes bound to the same URI may give two attributes the
+     * same expanded name; libxml2 only warns and keeps both */
+    const string& uri = mPrefix.empty() ? NO_NAMESPACE : resolve(mPrefix);
+
+    mAttributes.append(XMLTriple(mName, uri, mPrefix), raw.value);
+  }
+
+  if (mDeferredAt != NULL)
+  {
+    mBindings.resize(scope);
+    return fail(mDeferredCode, mDeferredAt);
+  }
+
+  if (mOpen.size() == mDepth) mOpen.push_back(OpenElement());
+
+  OpenElement& open = mOpen[mDepth];
+  open.qname.assign(name, nameLength);
+
+  /* like libxml2, report the start tag at its '>' (or the '/' of an
+   * empty-element tag) */
+  mCur = p;
+  advanceTo(mCur - (empty ? 2 : 1));
+
+  mSeenRoot = true;
+
+  if (!skipped)
+  {
+    mHandler->startElement(
+      XMLToken(triple, mAttributes, mNamespaces, mLine, mColumn));
+  }
+
+  if (empty)
+  {
+    if (!mHandler->skipEndElement())
+    {
+      mHandler->endElement(XMLToken(triple, mLine, mColumn));
+    }
+    mBindings.resize(scope);
+  }
+  else
+  {
+    open.triple = triple;
+    open.scope  = scope;
+    ++mDepth;
+  }
+
+  return Complete;
+}
+
+
+/*
+ * Reads an end tag, checks it closes the innermost open element and
+ * notifies the handler.
+ */
+NativeParser::Progress
+NativeParser::parseEndTag ()
+{
+  const char* name = mCur + 2;
+  const char* p    = scanName(name, mEnd);
+
+  if (p == mEnd) return Incomplete;
+  if (mDepth == 0) return fail(BadlyFormedXML, p);
+
+  const size_t       nameLength = (size_t) (p - name);
+  const OpenElement& open       = mOpen[mDepth - 1];
+
+  /* as with libxml2, a name that does not match (or is missing) is a
+   * mismatch whatever follows it */
+  const bool matches = open.qname.size() == nameLength
+                       && memcmp(open.qname.data(), name, nameLength) == 0;
+
+  p = skipSpace(p, mEnd);
+  if (p == mEnd) return Incomplete;
+
+  if (!matches) return fail(XMLTagMismatch, (*p == '>') ? p + 1 : p);
+  if (*p != '>') return fail(BadlyFormedXML, p);
+  ++p;
+
+  mCur = p;
+  flushText();
+  advanceTo(mCur);
+
+  --mDepth;
+  mBindings.resize(open.scope);
+
+  if (!mHandler->skipEndElement())
+  {
+    mHandler->endElement(XMLToken(open.triple, mLine, mColumn));
+  }
+
+  return Complete;
+}
+
+
+/*
+ * Decodes the character or entity reference at p, which points to '&',
+ * onto out and moves p past it.  Only the predefined entities are known.
+ * In an attribute value a bad reference is deferred, and p moved past as
+ * much of it as libxml2 reads.
+ */
+NativeParser::Progress
+NativeParser::parseReference (const char*& p, string& out, bool inValue)
+{
+  const char* q = p + 1;
+  if (q == mEnd) return Incomplete;
+
+  if (*q == '#')
+  {
+    if (++q == mEnd) return Incomplete;
+
+    const bool          hex    = (*q == 'x');
+    unsigned long       code   = 0;
+
+    if (hex) ++q;
+
+    const char* digits = q;
+
+    for (; q < mEnd; ++q)
+    {
+      const char    c = *q;
+      unsigned long d;
+
+      if (c >= '0' && c <= '9')
+        d = (unsigned long) (c - '0');
+      else if (hex && c >= 'a' && c <= 'f')
+        d = (unsigned long) (c - 'a' + 10);
+      else if (hex && c >= 'A' && c <= 'F')
+        d = (unsigned long) (c - 'A' + 10);
+      else
+        break;
+
+      code = code * (hex ? 16 : 10) + d;
+      if (code > 0x10FFFF) code = 0x110000;
+    }
+
+    if (q == mEnd) return Incomplete;
+
+    if (q == digits || *q != ';')
+    {
+      p = (*q == ';') ? q + 1 : q;
+      return badReference(InvalidCharInXML, q, inValue);
+    }
+
+    p = q + 1;
+    if (!isXMLChar(code)) return badReference(InvalidCharInXML, p, inValue);
+
+    appendUTF8(out, code);
+    return Complete;
+  }
+
+  const char* name = q;
+  q = scanName(q, mEnd);
+
+  if (q == mEnd) return Incomplete;
+
+  if (q == name || *q != ';')
+  {
+    const char* at = p;
+    p = (q == name) ? p + 1 : q;
+    return badReference(BadlyFormedXML, at, inValue);
+  }
+
+  const size_t length = (size_t) (q - name);
+
+  if (length == 2 && name[0] == 'l' && name[1] == 't')
+    out += '<';
+  else if (length == 2 && name[0] == 'g' && name[1] == 't')
+    out += '>';
+  else if (length == 3 && strncmp(name, "amp", 3) == 0)
+    out += '&';
+  else if (length == 4 && strncmp(name, "apos", 4) == 0)
+    out += '\'';
+  else if (length == 4 && strncmp(name, "quot", 4) == 0)
+    out += '"';
+  else
+  {
+    p = q + 1;
+    return badReference(UndefinedXMLEntity, p, inValue);
+  }
+
+  p = q + 1;
+  return Complete;
+}
+
+
+/*
+ * Reports a bad reference, or in an attribute value defers it: libxml2
+ * reads on to the end of the start tag, and reports the last error it
+ * meets there.
+ */
+NativeParser::Progress
+NativeParser::badReference (XMLErrorCode_t code, const char* at, bool inValue)
+{
+  if (!inValue) return fail(code, at);
+
+  mDeferredCode = code;
+  mDeferredAt   = at;
+
+  return Complete;
+}
+
+
+/*
+ * Reads the quoted attribute value at p onto out, decoding references and
+ * normalizing whitespace, and moves p past the closing quote.
+ */
+NativeParser::Progress
+NativeParser::parseValue (const char*& p, string& out)
+{
+  const char  quote = *p;
+  const char* q     = p + 1;
+
+  while (true)
+  {
+    const char* r = scanValue(q, mEnd, quote);
+    out.append(q, r);
+
+    if (r == mEnd) return Incomplete;
+
+    const char c = *r;
+
+    if (c == quote)
+    {
+      p = r + 1;
+      return Complete;
+    }
+    else if (c == '<')
+    {
+      return fail(BadlyFormedXML, r);
+    }
+    else if (c == '&')
+    {
+      Progress progress = parseReference(r, out, true);
+      if (progress != Complete) return progress;
+    }
+    else if (c == '\t' || c == '\n')
+    {
+      out += ' ';
+      ++r;
+    }
+    else if (c == '\r')
+    {
+      if (r + 1 == mEnd) return Incomplete;
+
+      out += ' ';
+      r += (r[1] == '\n') ? 2 : 1;
+    }
+    else if ((signed char) c < 0)
+    {
+      const char* start    = r;
+      Progress    progress = skipUTF8(r);
+      if (progress != Complete) return progress;
+
+      out.append(start, r);
+    }
+    else
+    {
+      return fail(InvalidCharInXML, r);
+    }
+
+    q = r;
+  }
+}
+
+
+/*
+ * Checks the multibyte UTF-8 sequence at p and moves p past it.  Overlong
+ * forms, surrogates, code points beyond U+10FFFF and the non-characters
+ * U+FFFE and U+FFFF are rejected.
+ */
+NativeParser::Progress
+NativeParser::skipUTF8 (const char*& p)
+{
+  const unsigned char lead = (unsigned char) *p;
+  size_t        length;
+  unsigned char low  = 0x80;
+  unsigned char high = 0xBF;
+
+  if (lead >= 0xC2 && lead <= 0xDF)
+  {
+    length = 2;
+  }
+  else if (lead >= 0xE0 && lead <= 0xEF)
+  {
+    length = 3;
+    if (lead == 0xE0) low  = 0xA0;
+    if (lead == 0xED) high = 0x9F;
+  }
+  else if (lead >= 0xF0 && lead <= 0xF4)
+  {
+    length = 4;
+    if (lead == 0xF0) low  = 0x90;
+    if (lead == 0xF4) high = 0x8F;
+  }
+  else
+  {
+    return fail(InvalidCharInXML, p);
+  }
+
+  if ((size_t) (mEnd - p) < length) return Incomplete;
+
+  for (size_t n = 1; n < length; ++n)
+  {
+    const unsigned char c = (unsigned char) p[n];
+
+    if (c < low || c > high) return fail(InvalidCharInXML, p);
+
+    low  = 0x80;
+    high = 0xBF;
+  }
+
+  if (lead == 0xEF && (unsigned char) p[1] == 0xBF
+      && (unsigned char) p[2] >= 0xBE)
+  {
+    return fail(InvalidCharInXML, p);
+  }
+
+  p += length;
+
+  return Complete;
+}
+
+
+/*
+ * Checks that [p, end), the content of a comment, CDATA section or
+ * processing instruction, holds only characters allowed in XML.
+ */
+NativeParser::Progress
+NativeParser::checkChars (const char* p, const char* end)
+{
+  while (p < end)
+  {
+    const char c = *p;
+
+    if ((signed char) c >= 0x20 || c == '\t' || c == '\n' || c == '\r')
+    {
+      ++p;
+    }
+    else if ((signed char) c < 0)
+    {
+      Progress progress = skipUTF8(p);
+      if (progress != Complete) return progress;
+    }
+    else
+    {
+      return fail(InvalidCharInXML, p);
+    }
+  }
+
+  return Complete;
+}
+
+
+/*
+ * Passes any pending character data to the handler.
+ */
+void
+NativeParser::flushText ()
+{
+  if (mText.empty()) return;
+
+  if (!mHandler->isSkipping())
+  {
+    mHandler->characters(mText.data(), mText.size());
+  }
+  mText.clear();
+}
+
+
+/*
+ * @return the URI bound to the given prefix, or the default namespace
+ * for the empty prefix.  Unbound prefixes resolve to no namespace, as
+ * with the libxml2 adapter.
+ */
+const string&
+NativeParser::resolve (const string& prefix) const
+{
+  for (size_t n = mBindings.size(); n > 0; --n)
+  {
+    if (mBindings[n - 1].first == prefix) return mBindings[n - 1].second;
+  }
+
+  return NO_NAMESPACE;
+}
+
+
+LIBLX_CPP_NAMESPACE_END
+
+/** @endcond */
@@ -0,0 +1,301 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    NativeParser.h
+ * @brief   Dependency-free XMLParser for UTF-8 input
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class NativeParser
+ * @sbmlbrief{core} XMLParser implementation that needs no XML library.
+ *
+ * NativeParser reads UTF-8 (or ASCII) documents and calls the XMLHandler
+ * directly, without the callback translation and string transcoding the
+ * Expat, libxml2 and Xerces adapters need.  Character data and attribute
+ * values are scanned sixteen bytes at a time, with SSE2 where the
+ * compiler provides it, stopping only at bytes that need attention
+ * (markup, references, line ends and non-ASCII characters).
+ *
+ * It checks well-formedness and namespace scoping but, like the other
+ * backends as configured by libLX, does not read external entities or
+ * expand entities declared in a DOCTYPE.  Apart from documents declared
+ * in an encoding other than UTF-8 or ASCII, which it rejects with
+ * BadXMLDecl, a document is rejected exactly when the libxml2 adapter
+ * rejects it.  Where libxml2 reads on past an error and reports the last
+ * one it met, NativeParser does the same, so most problems are reported
+ * with the same XMLError code.  The known differences are:
+ *
+ * @li the line and column of an error, and which elements of a broken
+ * document reach the handler first, may differ;
+ * @li where a start tag with an error also uses an undeclared prefix or
+ * binds one to a malformed URI, libxml2's namespace warning (BadXMLPrefix
+ * or BadXMLPrefixValue) is reported rather than the error;
+ * @li a version other than 1.x in the XML declaration is BadXMLDecl, where
+ * libxml2's code is unmapped (UnrecognizedXMLParserCode);
+ * @li an internal subset is only skipped, so errors inside one, or a ']'
+ * inside a CDATA section that follows an unfinished one, may be reported
+ * differently.
+ *
+ * The parser is selected with the library name "native" and is available
+ * when libLX is built with WITH_NATIVE_PARSER.
+ *
+ * @ifnot clike @internal @endif@~
+ */
+
+#ifndef NativeParser_h
+#define NativeParser_h
+
+#ifdef __cplusplus
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <liblx/xml/XMLParser.h>
+#include <liblx/xml/XMLAttributes.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLTriple.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+class XMLBuffer;
+class XMLHandler;
+
+
+class NativeParser : public XMLParser
+{
+public:
+
+  /**
+   * Creates a new NativeParser.  The parser will notify the given
+   * XMLHandler of parse events and errors.
+   */
+  NativeParser (XMLHandler& handler);
+
+
+  /**
+   * Destroys this NativeParser.
+   */
+  virtual ~NativeParser ();
+
+
+  /**
+   * @return the current column position of the parser.
+   */
+  virtual unsigned int getColumn () const;
+
+
+  /**
+   * @return the current line position of the parser.
+   */
+  virtual unsigned int getLine () const;
+
+
+  /**
+   * Parses XML content in one fell swoop.
+   *
+   * If isFile is true (default), content is treated as a filename from
+   * which to read the XML content.  Otherwise, content is treated as a
+   * null-terminated buffer containing XML data and is read directly.
+   *
+   * @return true if the parse was successful, false otherwise.
+   */
+  virtual bool parse (const char* content, bool isFile);
+
+
+  /**
+   * Begins a progressive parse of XML content.  Successive chunks of
+   * roughly 8 KB are parsed by calling parseNext().
+   *
+   * If isFile is true (default), content is treated as a filename from
+   * which to read the XML content.  Otherwise, content is treated as a
+   * null-terminated buffer containing XML data, which is copied.
+   *
+   * @return true if the first step of the progressive parse was
+   * successful, false otherwise.
+   */
+  virtual bool parseFirst (const char* content, bool isFile);
+
+
+  /**
+   * Parses the next chunk of XML content.
+   *
+   * @return true if the next step of the progressive parse was successful,
+   * false otherwise or when at EOF.
+   */
+  virtual bool parseNext ();
+
+
+  /**
+   * Resets the progressive parser.  Call between the last call to
+   * parseNext() and the next call to parseFirst().
+   */
+  virtual void parseReset ();
+
+
+  /**
+   * Resets this parser for a new document whose events go to the given
+   * handler.
+   *
+   * @return @c true if the parser is ready for parseFirst().
+   */
+  virtual bool reuse (XMLHandler& handler);
+
+
+protected:
+
+  /*
+   * The outcome of an attempt to read one construct.  Incomplete means
+   * the construct runs past the data read so far; nothing has been
+   * reported and the attempt is repeated once more data is available.
+   */
+  enum Progress { Complete, Incomplete, Failed };
+
+  /* An attribute as written in the start tag, before prefixes are
+   * resolved.  The end is just past the closing quote. */
+  struct RawAttribute
+  {
+    const char* name;
+    size_t      length;
+    const char* end;
+    std::string value;
+  };
+
+  /* The attributes of a start tag, kept in order even where two share an
+   * expanded name. */
+  class Attributes : public XMLAttributes
+  {
+  public:
+    void append (const XMLTriple& triple, const std::string& value)
+    {
+      mNames .push_back(triple);
+      mValues.push_back(value);
+    }
+  };
+
+  /* An element whose end tag has not been seen yet. */
+  struct OpenElement
+  {
+    std::string qname;
+    XMLTriple   triple;
+    size_t      scope;
+  };
+
+
+  bool error () const;
+
+  bool fill ();
+
+  bool finish ();
+
+  Progress fail (XMLErrorCode_t code, const char* at,
+                 const std::string& extraMsg = "");
+
+  void advanceTo (const char* p);
+
+  int lookingAt (const char* p, const char* literal) const;
+
+  Progress parseXMLDecl ();
+
+  Progress parseItem ();
+
+  Progress parseSpace ();
+
+  Progress parseText ();
+
+  Progress parseMarkupDecl ();
+
+  Progress parseProcessingInstruction ();
+
+  Progress parseStartTag ();
+
+  Progress parseEndTag ();
+
+  Progress parseReference (const char*& p, std::string& out,
+                           bool inValue = false);
+
+  Progress badReference (XMLErrorCode_t code, const char* at, bool inValue);
+
+  Progress parseValue (const char*& p, std::string& out);
+
+  Progress skipUTF8 (const char*& p);
+
+  Progress checkChars (const char* p, const char* end);
+
+  void flushText ();
+
+  const std::string& resolve (const std::string& prefix) const;
+
+
+  XMLHandler*       mHandler;
+  XMLBuffer*        mSource;
+
+  /* The unparsed input lies between mCur and mEnd, inside mData. */
+  std::vector<char> mData;
+  const char*       mCur;
+  const char*       mEnd;
+
+  /* Line and column of the character at mCounted. */
+  const char*       mCounted;
+  unsigned int      mLine;
+  unsigned int      mColumn;
+
+  bool              mStarted;
+  bool              mSeenRoot;
+  bool              mSeenDoctype;
+  bool              mFailed;
+
+  /* Character data not yet passed to the handler. */
+  std::string       mText;
+
+  std::vector<OpenElement>  mOpen;
+  size_t                    mDepth;
+
+  /* In-scope namespace bindings as (prefix, URI), innermost last. */
+  std::vector< std::pair<std::string, std::string> > mBindings;
+
+  /* Scratch space reused from one start tag to the next. */
+  std::vector<RawAttribute> mRaw;
+  Attributes                mAttributes;
+  XMLNamespaces             mNamespaces;
+  std::string               mPrefix;
+  std::string               mName;
+
+  /* A bad reference in an attribute value of the current start tag, to be
+   * reported unless the tag holds a later error. */
+  XMLErrorCode_t            mDeferredCode;
+  const char*               mDeferredAt;
+
+
+private:
+
+  NativeParser (const NativeParser& orig);
+  NativeParser& operator= (const NativeParser& rhs);
+
+  /**
+   * Log or otherwise report the given error.
+   */
+  void reportError (  const XMLErrorCode_t code
+                    , const std::string    extraMsg     = ""
+                    , const unsigned int   lineNumber   = 0
+                    , const unsigned int   columnNumber = 0 );
+};
+
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* NativeParser_h */
+
+/** @endcond */
@@ -1265,6 +1265,41 @@ operator<< (XMLOutputStream& stream, const XMLAttributes& attributes)
 /** @endcond */
 
 
+/*
+ * @return the bytes of memory this XMLAttributes holds.
+ */
+size_t
+XMLAttributes::getMemoryUsage () const
+{
+  XMLMemoryUsage usage;
+  return getMemoryUsage(usage);
+}
+
+
+/*
+ * Adds the memory this XMLAttributes holds to usage.
+ */
+size_t
+XMLAttributes::getMemoryUsage (XMLMemoryUsage& usage) const
+{
+  size_t bytes = sizeof(XMLAttributes)
+               + mNames.capacity()  * sizeof(XMLTriple)
+               + mValues.capacity() * sizeof(std::string)
+               + XMLMemoryUsage::getStringBytes(mElementName);
+
+  for (size_t n = 0; n < mNames.size(); ++n)
+  {
+    bytes += XMLMemoryUsage::getStringBytes(mNames[n].getName())
+           + XMLMemoryUsage::getStringBytes(mNames[n].getURI())
+           + XMLMemoryUsage::getStringBytes(mNames[n].getPrefix())
+           + XMLMemoryUsage::getStringBytes(mValues[n]);
+  }
+
+  usage.mAttributes += bytes;
+  return bytes;
+}
+
+
 #endif /* __cplusplus */
 /** @cond doxygenIgnored */
 LIBLX_EXTERN
@@ -1719,6 +1754,16 @@ XMLAttributes_readIntoStringByTriple (XMLAttributes_t *xa,
 }
 
 
+
+
+LIBLX_EXTERN
+unsigned long
+XMLAttributes_getMemoryUsage (const XMLAttributes_t *attributes)
+{
+  if (attributes == NULL) return 0;
+  return (unsigned long) attributes->getMemoryUsage();
+}
+
 LIBLX_CPP_NAMESPACE_END
 /** @endcond */
 
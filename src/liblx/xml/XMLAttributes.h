@@ -238,6 +238,7 @@ foo:myattribute="7"
 #include <vector>
 #include <stdexcept>
 
+#include <liblx/xml/XMLMemoryUsage.h>
 #include <liblx/xml/XMLTriple.h>
 
 LIBLX_CPP_NAMESPACE_BEGIN
@@ -1537,6 +1538,28 @@ public:
   /** @endcond */
 
 
+  /**
+   * Returns the bytes of memory this XMLAttributes holds, counting the object
+   * itself, the names and values of its attributes, and the spare capacity of each.
+   *
+   * @return the bytes held by this XMLAttributes.
+   *
+   * @see XMLMemoryUsage
+   */
+  size_t getMemoryUsage () const;
+
+
+  /**
+   * Adds the memory this XMLAttributes holds to @p usage, split by kind, and
+   * returns it.
+   *
+   * @param usage the XMLMemoryUsage to add to.
+   *
+   * @return the bytes held by this XMLAttributes.
+   */
+  size_t getMemoryUsage (XMLMemoryUsage& usage) const;
+
+
   /** @cond doxygenLibsbmlInternal */
   /**
    * (Optional) Sets the log used when logging attributeTypeError() and
@@ -1573,6 +1596,8 @@ public:
 
 protected:
   /** @cond doxygenLibsbmlInternal */
+  friend class XMLNode;
+
   /**
    * Used by attributeTypeError().
    */
@@ -2796,6 +2821,21 @@ XMLAttributes_readIntoStringByTriple (XMLAttributes_t *xa,
                                XMLErrorLog_t *log,
                                int required);
 
+/**
+ * Returns the bytes of memory held by the given XMLAttributes_t structure,
+ * counting the structure itself, the names and values of its attributes, and the spare capacity of each.
+ *
+ * @param attributes the XMLAttributes_t structure.
+ *
+ * @return the bytes held, or @c 0 if @p attributes is @c NULL.
+ *
+ * @memberof XMLAttributes_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLAttributes_getMemoryUsage (const XMLAttributes_t *attributes);
+
+
 END_C_DECLS
 LIBLX_CPP_NAMESPACE_END
 
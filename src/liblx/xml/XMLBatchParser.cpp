@@ -0,0 +1,419 @@
+/**
+ * @file    XMLBatchParser.cpp
+ * @brief   Reads many documents at once on a pool of threads
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include <liblx/xml/XMLBatchParser.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/operationReturnValues.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * The work of one call to parse(): a queue of document indices per
+ * worker.  The owner takes from the front of its queue and others steal
+ * from the back, so the two rarely meet on the same lock.
+ */
+struct XMLBatchParser::Pool
+{
+  struct Queue
+  {
+    mutex                 lock;
+    deque<unsigned int>   items;
+  };
+
+  Pool (vector<Document>& documents, const string& library,
+        unsigned int numWorkers)
+   : documents ( documents  )
+   , library   ( library    )
+   , queues    ( numWorkers )
+  {
+  }
+
+  bool take (unsigned int worker, unsigned int& item)
+  {
+    Queue& own = queues[worker];
+    lock_guard<mutex> guard(own.lock);
+
+    if (own.items.empty()) return false;
+
+    item = own.items.front();
+    own.items.pop_front();
+    return true;
+  }
+
+  bool steal (unsigned int worker, unsigned int& item)
+  {
+    for (size_t n = 1; n < queues.size(); ++n)
+    {
+      Queue& victim = queues[(worker + n) % queues.size()];
+      lock_guard<mutex> guard(victim.lock);
+
+      if (victim.items.empty()) continue;
+
+      item = victim.items.back();
+      victim.items.pop_back();
+      return true;
+    }
+
+    return false;
+  }
+
+  vector<Document>& documents;
+  const string&     library;
+  vector<Queue>     queues;
+};
+/** @endcond */
+
+
+/*
+ * Creates a new, empty XMLBatchParser.
+ */
+XMLBatchParser::XMLBatchParser (  unsigned int  numThreads
+                                , const string& library )
+ : mNumThreads ( numThreads )
+ , mLibrary    ( library    )
+ , mNumFailed  ( 0          )
+{
+  if (mNumThreads == 0) mNumThreads = thread::hardware_concurrency();
+  if (mNumThreads == 0) mNumThreads = 1;
+}
+
+
+/*
+ * Destroys this XMLBatchParser and the documents it holds.
+ */
+XMLBatchParser::~XMLBatchParser ()
+{
+  clearResults();
+}
+
+
+/*
+ * @return the number of threads this batch reads with.
+ */
+unsigned int
+XMLBatchParser::getNumThreads () const
+{
+  return mNumThreads;
+}
+
+
+/*
+ * Adds a file to the batch.
+ */
+int
+XMLBatchParser::addFile (const string& filename)
+{
+  Document document;
+  document.content = filename;
+  document.isFile  = true;
+  document.root    = NULL;
+  document.log     = NULL;
+
+  mDocuments.push_back(document);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * Adds a document held in memory to the batch.
+ */
+int
+XMLBatchParser::addString (const string& content)
+{
+  Document document;
+  document.content = content;
+  document.isFile  = false;
+  document.root    = NULL;
+  document.log     = NULL;
+
+  mDocuments.push_back(document);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the number of documents in the batch.
+ */
+unsigned int
+XMLBatchParser::getNumDocuments () const
+{
+  return (unsigned int) mDocuments.size();
+}
+
+
+/*
+ * Reads every document in the batch.
+ */
+int
+XMLBatchParser::parse ()
+{
+  clearResults();
+
+  const unsigned int numDocuments = getNumDocuments();
+  unsigned int       numWorkers   = mNumThreads;
+  if (numWorkers > numDocuments) numWorkers = numDocuments;
+
+  if (numWorkers > 0)
+  {
+    Pool pool(mDocuments, mLibrary, numWorkers);
+
+    /* contiguous runs keep neighbouring documents, which are often
+     * alike in size, on one worker */
+    for (unsigned int n = 0; n < numDocuments; ++n)
+    {
+      pool.queues[(unsigned long) n * numWorkers / numDocuments].items
+        .push_back(n);
+    }
+
+    vector<thread> threads;
+
+    for (unsigned int n = 1; n < numWorkers; ++n)
+    {
+      try
+      {
+        threads.push_back(thread(work, &pool, n));
+      }
+      catch ( ... )
+      {
+        /* the remaining queues are stolen by the workers that did start */
+        break;
+      }
+    }
+
+    work(&pool, 0);
+
+    for (size_t n = 0; n < threads.size(); ++n)
+    {
+      threads[n].join();
+    }
+  }
+
+  for (unsigned int n = 0; n < numDocuments; ++n)
+  {
+    if (mDocuments[n].log->getNumErrors() > 0) ++mNumFailed;
+  }
+
+  return (mNumFailed == 0) ? LIBLX_OPERATION_SUCCESS : LIBLX_OPERATION_FAILED;
+}
+
+
+/*
+ * @return the number of documents that logged an error in the last call
+ * to parse().
+ */
+unsigned int
+XMLBatchParser::getNumFailed () const
+{
+  return mNumFailed;
+}
+
+
+/*
+ * @return the document element read for the nth document.
+ */
+const XMLNode*
+XMLBatchParser::getDocument (unsigned int n) const
+{
+  return (n < mDocuments.size()) ? mDocuments[n].root : NULL;
+}
+
+
+/*
+ * Hands the document element read for the nth document to the caller.
+ */
+XMLNode*
+XMLBatchParser::releaseDocument (unsigned int n)
+{
+  if (n >= mDocuments.size()) return NULL;
+
+  XMLNode* root = mDocuments[n].root;
+  mDocuments[n].root = NULL;
+
+  return root;
+}
+
+
+/*
+ * @return the errors logged while reading the nth document.
+ */
+const XMLErrorLog*
+XMLBatchParser::getErrorLog (unsigned int n) const
+{
+  return (n < mDocuments.size()) ? mDocuments[n].log : NULL;
+}
+
+
+/*
+ * Removes every document from the batch.
+ */
+void
+XMLBatchParser::clear ()
+{
+  clearResults();
+  mDocuments.clear();
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Deletes the trees and logs of the last call to parse().
+ */
+void
+XMLBatchParser::clearResults ()
+{
+  for (size_t n = 0; n < mDocuments.size(); ++n)
+  {
+    delete mDocuments[n].root;
+    delete mDocuments[n].log;
+
+    mDocuments[n].root = NULL;
+    mDocuments[n].log  = NULL;
+  }
+
+  mNumFailed = 0;
+}
+
+
+/*
+ * Reads documents from the worker's own queue, then from the others,
+ * until none are left.
+ */
+void
+XMLBatchParser::work (Pool* pool, unsigned int worker)
+{
+  unsigned int item;
+
+  while (pool->take(worker, item) || pool->steal(worker, item))
+  {
+    parseDocument(pool->documents[item], pool->library);
+  }
+}
+
+
+/*
+ * Reads one document, and anything after its document element, so that
+ * its log holds every error in it.
+ */
+void
+XMLBatchParser::parseDocument (Document& document, const string& library)
+{
+  document.log = new XMLErrorLog;
+
+  try
+  {
+    XMLInputStream stream(document.content.c_str(), document.isFile,
+                          library, document.log);
+
+    if (stream.peek().isStart())
+    {
+      document.root = new XMLNode(stream);
+    }
+
+    while (stream.isGood()) stream.next();
+  }
+  catch (bad_alloc&)
+  {
+    document.log->add(XMLError(XMLOutOfMemory));
+  }
+  catch ( ... )
+  {
+    document.log->add(XMLError(InternalXMLParserError));
+  }
+}
+/** @endcond */
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLBatchParser_t *
+XMLBatchParser_create (unsigned int numThreads, const char *library)
+{
+  return new(nothrow) XMLBatchParser(numThreads,
+                                     library != NULL ? library : "");
+}
+
+
+LIBLX_EXTERN
+void
+XMLBatchParser_free (XMLBatchParser_t *batch)
+{
+  if (batch == NULL) return;
+  delete static_cast<XMLBatchParser*>(batch);
+}
+
+
+LIBLX_EXTERN
+int
+XMLBatchParser_addFile (XMLBatchParser_t *batch, const char *filename)
+{
+  if (batch == NULL || filename == NULL) return LIBLX_INVALID_OBJECT;
+  return batch->addFile(filename);
+}
+
+
+LIBLX_EXTERN
+int
+XMLBatchParser_addString (XMLBatchParser_t *batch, const char *content)
+{
+  if (batch == NULL || content == NULL) return LIBLX_INVALID_OBJECT;
+  return batch->addString(content);
+}
+
+
+LIBLX_EXTERN
+int
+XMLBatchParser_parse (XMLBatchParser_t *batch)
+{
+  if (batch == NULL) return LIBLX_INVALID_OBJECT;
+  return batch->parse();
+}
+
+
+LIBLX_EXTERN
+const XMLNode_t *
+XMLBatchParser_getDocument (const XMLBatchParser_t *batch, unsigned int n)
+{
+  if (batch == NULL) return NULL;
+  return batch->getDocument(n);
+}
+
+
+LIBLX_EXTERN
+const XMLErrorLog_t *
+XMLBatchParser_getErrorLog (const XMLBatchParser_t *batch, unsigned int n)
+{
+  if (batch == NULL) return NULL;
+  return batch->getErrorLog(n);
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
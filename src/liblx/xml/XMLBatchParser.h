@@ -0,0 +1,341 @@
+/**
+ * @file    XMLBatchParser.h
+ * @brief   Reads many documents at once on a pool of threads
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLBatchParser
+ * @sbmlbrief{core} Reads a list of files or strings into XMLNode trees
+ * concurrently.
+ *
+ * Jobs that read thousands of small documents spend most of their time
+ * in the parser, one document after another.  An XMLBatchParser is given
+ * the whole list up front and reads the documents on a pool of worker
+ * threads, each with its own parser, so throughput grows with the number
+ * of cores.
+ *
+ * The documents are dealt out to the workers in contiguous runs.  A
+ * worker that finishes its run early takes documents from the end of
+ * another worker's run, so a few large documents do not leave the other
+ * threads idle.
+ *
+ * Each document gets its own XMLErrorLog, and its document element is
+ * kept as an XMLNode until the batch is cleared or the node is released.
+ *
+@code{.cpp}
+XMLBatchParser batch;
+for (size_t n = 0; n < files.size(); ++n) batch.addFile(files[n]);
+
+batch.parse();
+
+for (unsigned int n = 0; n < batch.getNumDocuments(); ++n)
+{
+  if (batch.getErrorLog(n)->getNumErrors() > 0) continue;
+  process(*batch.getDocument(n));
+}
+@endcode
+ */
+
+#ifndef XMLBatchParser_h
+#define XMLBatchParser_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLErrorLog;
+class XMLNode;
+
+
+class LIBLX_EXTERN XMLBatchParser
+{
+public:
+
+  /**
+   * Creates a new, empty XMLBatchParser.
+   *
+   * @param numThreads the number of threads to read with, or @c 0 for the
+   * number of hardware threads.
+   * @param library the XML library each thread uses, as for
+   * XMLParser::create().
+   */
+  XMLBatchParser (  unsigned int       numThreads = 0
+                  , const std::string& library    = "" );
+
+
+  /**
+   * Destroys this XMLBatchParser and the documents it holds.
+   */
+  virtual ~XMLBatchParser ();
+
+
+  /**
+   * @return the number of threads this batch reads with.
+   */
+  unsigned int getNumThreads () const;
+
+
+  /**
+   * Adds a file to the batch.  The file may be compressed, as for
+   * XMLInputStream.
+   *
+   * @param filename the name of the file.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   */
+  int addFile (const std::string& filename);
+
+
+  /**
+   * Adds a document held in memory to the batch.
+   *
+   * @param content the document.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   */
+  int addString (const std::string& content);
+
+
+  /**
+   * @return the number of documents in the batch.
+   */
+  unsigned int getNumDocuments () const;
+
+
+  /**
+   * Reads every document in the batch, replacing the results of any
+   * earlier call.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * if no document logged an error.
+   * @li @sbmlconstant{LIBLX_OPERATION_FAILED, OperationReturnValues_t}
+   * if any document logged an error; see getErrorLog().
+   */
+  int parse ();
+
+
+  /**
+   * @return the number of documents that logged an error in the last
+   * call to parse().
+   */
+  unsigned int getNumFailed () const;
+
+
+  /**
+   * @param n the index of the document, in the order it was added.
+   *
+   * @return the document element read for the nth document, which the
+   * batch still owns, or @c NULL if none was read or @p n is out of range.
+   */
+  const XMLNode* getDocument (unsigned int n) const;
+
+
+  /**
+   * Hands the document element read for the nth document to the caller.
+   *
+   * @param n the index of the document, in the order it was added.
+   *
+   * @return the document element, which the caller must delete, or
+   * @c NULL if none was read, it was already released or @p n is out of
+   * range.
+   */
+  XMLNode* releaseDocument (unsigned int n);
+
+
+  /**
+   * @param n the index of the document, in the order it was added.
+   *
+   * @return the errors logged while reading the nth document, or @c NULL
+   * if the batch has not been read or @p n is out of range.
+   */
+  const XMLErrorLog* getErrorLog (unsigned int n) const;
+
+
+  /**
+   * Removes every document, and the results of reading them, from the
+   * batch.
+   */
+  void clear ();
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+protected:
+
+  struct Document
+  {
+    std::string  content;
+    bool         isFile;
+    XMLNode*     root;
+    XMLErrorLog* log;
+  };
+
+  struct Pool;
+
+  void clearResults ();
+
+  static void work (Pool* pool, unsigned int worker);
+
+  static void parseDocument (Document& document, const std::string& library);
+
+
+  unsigned int          mNumThreads;
+  std::string           mLibrary;
+  std::vector<Document> mDocuments;
+  unsigned int          mNumFailed;
+
+private:
+
+  XMLBatchParser (const XMLBatchParser& orig);
+  XMLBatchParser& operator= (const XMLBatchParser& rhs);
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Creates a new, empty XMLBatchParser_t.
+ *
+ * @param numThreads the number of threads to read with, or @c 0 for the
+ * number of hardware threads.
+ * @param library the XML library each thread uses, or @c NULL for the
+ * default.
+ *
+ * @return pointer to the XMLBatchParser_t structure created.
+ *
+ * @memberof XMLBatchParser_t
+ */
+LIBLX_EXTERN
+XMLBatchParser_t *
+XMLBatchParser_create (unsigned int numThreads, const char *library);
+
+
+/**
+ * Destroys this XMLBatchParser_t structure and the documents it holds.
+ *
+ * @param batch XMLBatchParser_t structure to be freed.
+ *
+ * @memberof XMLBatchParser_t
+ */
+LIBLX_EXTERN
+void
+XMLBatchParser_free (XMLBatchParser_t *batch);
+
+
+/**
+ * Adds a file to the batch.
+ *
+ * @param batch the XMLBatchParser_t structure.
+ * @param filename the name of the file.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLBatchParser_t
+ */
+LIBLX_EXTERN
+int
+XMLBatchParser_addFile (XMLBatchParser_t *batch, const char *filename);
+
+
+/**
+ * Adds a document held in memory to the batch.
+ *
+ * @param batch the XMLBatchParser_t structure.
+ * @param content the document.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLBatchParser_t
+ */
+LIBLX_EXTERN
+int
+XMLBatchParser_addString (XMLBatchParser_t *batch, const char *content);
+
+
+/**
+ * Reads every document in the batch.
+ *
+ * @param batch the XMLBatchParser_t structure.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_OPERATION_FAILED, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLBatchParser_t
+ */
+LIBLX_EXTERN
+int
+XMLBatchParser_parse (XMLBatchParser_t *batch);
+
+
+/**
+ * Returns the document element read for the nth document.
+ *
+ * @param batch the XMLBatchParser_t structure.
+ * @param n the index of the document.
+ *
+ * @return the document element, which the batch still owns, or @c NULL.
+ *
+ * @memberof XMLBatchParser_t
+ */
+LIBLX_EXTERN
+const XMLNode_t *
+XMLBatchParser_getDocument (const XMLBatchParser_t *batch, unsigned int n);
+
+
+/**
+ * Returns the errors logged while reading the nth document.
+ *
+ * @param batch the XMLBatchParser_t structure.
+ * @param n the index of the document.
+ *
+ * @return the XMLErrorLog_t, which the batch still owns, or @c NULL.
+ *
+ * @memberof XMLBatchParser_t
+ */
+LIBLX_EXTERN
+const XMLErrorLog_t *
+XMLBatchParser_getErrorLog (const XMLBatchParser_t *batch, unsigned int n);
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLBatchParser_h */
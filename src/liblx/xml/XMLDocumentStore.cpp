@@ -0,0 +1,810 @@
+/**
+ * @file    XMLDocumentStore.cpp
+ * @brief   Read-only XML document held in flat node arrays
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstring>
+#include <new>
+
+#include <liblx/xml/XMLDocumentStore.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNamePool.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLToken.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+const unsigned int XMLDocumentStore::npos = static_cast<unsigned int>(-1);
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return true if s contains nothing but XML whitespace.
+ */
+static bool
+isWhitespace (const string& s)
+{
+  return s.find_first_not_of(" \t\r\n") == string::npos;
+}
+
+
+static const XMLTriple&
+emptyTriple ()
+{
+  static const XMLTriple triple;
+  return triple;
+}
+/** @endcond */
+
+
+/*
+ * Creates a new, empty XMLDocumentStore.
+ */
+XMLDocumentStore::XMLDocumentStore ()
+{
+  mArena.push_back('\0');
+  mAttrBegin.push_back(0);
+  mNsBegin.push_back(0);
+}
+
+
+/*
+ * Creates a new XMLDocumentStore by reading the next element, and
+ * everything it contains, from the given stream.
+ */
+XMLDocumentStore::XMLDocumentStore (XMLInputStream& stream)
+{
+  mArena.push_back('\0');
+  mAttrBegin.push_back(0);
+  mNsBegin.push_back(0);
+
+  read(stream);
+}
+
+
+/*
+ * Creates a new XMLDocumentStore holding a copy of the given tree.
+ */
+XMLDocumentStore::XMLDocumentStore (const XMLNode& node)
+{
+  mArena.push_back('\0');
+  mAttrBegin.push_back(0);
+  mNsBegin.push_back(0);
+
+  unsigned int last = npos;
+
+  if (node.isEOF())
+  {
+    /* a dummy root; its children become the top-level nodes */
+    for (unsigned int c = 0; c < node.getNumChildren(); ++c)
+    {
+      appendTree(node.getChild(c), npos, last);
+    }
+  }
+  else
+  {
+    appendTree(node, npos, last);
+  }
+}
+
+
+/*
+ * Destroys this XMLDocumentStore.
+ */
+XMLDocumentStore::~XMLDocumentStore ()
+{
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Reads one element from the stream in the same way as
+ * XMLNode::XMLNode(XMLInputStream&), but iteratively and straight into the
+ * node arrays.
+ */
+void
+XMLDocumentStore::read (XMLInputStream& stream)
+{
+  const XMLToken token = stream.next();
+  if (!token.isStart() && !token.isText()) return;
+
+  unsigned int topLevel = npos;
+  unsigned int root     = appendNode(token, npos, topLevel);
+
+  if (!token.isStart() || token.isEnd()) return;
+
+  vector<unsigned int> open;
+  vector<unsigned int> lastChild;
+
+  open.push_back(root);
+  lastChild.push_back(npos);
+
+  while (stream.isGood() && !open.empty())
+  {
+    const XMLToken& next = stream.peek();
+
+    if (next.isStart())
+    {
+      const XMLToken element = stream.next();
+      unsigned int   n       = appendNode(element, open.back(), lastChild.back());
+
+      if (!element.isEnd())
+      {
+        open.push_back(n);
+        lastChild.push_back(npos);
+      }
+    }
+    else if (next.isText())
+    {
+      if (isWhitespace(next.getCharacters()))
+      {
+        stream.skipText();
+      }
+      else
+      {
+        appendNode(stream.next(), open.back(), lastChild.back());
+      }
+    }
+    else if (next.isEnd())
+    {
+      stream.next();
+      open.pop_back();
+      lastChild.pop_back();
+    }
+    else
+    {
+      break;
+    }
+  }
+}
+
+
+/*
+ * Appends a node for the given token as the last child of parent (or as
+ * the last top-level node if parent is npos).  lastChild is the previous
+ * last child and is updated to the new node.
+ */
+unsigned int
+XMLDocumentStore::appendNode (  const XMLToken& token
+                              , unsigned int    parent
+                              , unsigned int&   lastChild )
+{
+  const unsigned int n = static_cast<unsigned int>(mKind.size());
+
+  if (token.isText())
+  {
+    mKind.push_back(TextNode);
+    mNameId.push_back(npos);
+    mText.push_back(addString(token.getCharacters()));
+  }
+  else
+  {
+    unsigned char kind = ElementNode;
+    if (token.isEnd()) kind |= EmptyElement;
+
+    mKind.push_back(kind);
+    mNameId.push_back(token.mTriple != NULL ?
+                      internName(*token.mTriple) : internName(emptyTriple()));
+    mText.push_back(0);
+
+    if (token.mAttributes != NULL)
+    {
+      const XMLAttributes& attributes = *token.mAttributes;
+      for (int i = 0; i < attributes.getLength(); ++i)
+      {
+        XMLTriple triple(attributes.getName(i), attributes.getURI(i),
+                         attributes.getPrefix(i));
+        mAttrName.push_back(internName(triple));
+        mAttrValue.push_back(addString(attributes.getValue(i)));
+      }
+    }
+
+    if (token.mNamespaces != NULL)
+    {
+      const XMLNamespaces& namespaces = *token.mNamespaces;
+      for (int i = 0; i < namespaces.getLength(); ++i)
+      {
+        mNsPrefix.push_back(addString(namespaces.getPrefix(i)));
+        mNsURI.push_back(addString(namespaces.getURI(i)));
+      }
+    }
+  }
+
+  mAttrBegin.push_back(static_cast<unsigned int>(mAttrName.size()));
+  mNsBegin.push_back(static_cast<unsigned int>(mNsPrefix.size()));
+
+  mParent.push_back(parent);
+  mFirstChild.push_back(npos);
+  mNextSibling.push_back(npos);
+
+  if (lastChild != npos)
+  {
+    mNextSibling[lastChild] = n;
+  }
+  else if (parent != npos)
+  {
+    mFirstChild[parent] = n;
+  }
+
+  lastChild = n;
+
+  return n;
+}
+
+
+/*
+ * Appends a copy of the given tree.
+ */
+void
+XMLDocumentStore::appendTree (  const XMLNode& node
+                              , unsigned int   parent
+                              , unsigned int&  lastChild )
+{
+  const unsigned int n = appendNode(node, parent, lastChild);
+
+  unsigned int last = npos;
+  for (unsigned int c = 0; c < node.getNumChildren(); ++c)
+  {
+    appendTree(node.getChild(c), n, last);
+  }
+}
+
+
+/*
+ * @return the id of the given name, adding it to the name table if this
+ * store has not seen it before.
+ */
+unsigned int
+XMLDocumentStore::internName (const XMLTriple& triple)
+{
+  const XMLTriple* pooled = XMLNamePool::intern(triple);
+
+  if (pooled != NULL)
+  {
+    unordered_map<const XMLTriple*, unsigned int>::const_iterator it =
+      mNameIds.find(pooled);
+
+    if (it != mNameIds.end()) return it->second;
+  }
+  else
+  {
+    for (unsigned int id = 0; id < mNames.size(); ++id)
+    {
+      if (mNames[id] == triple) return id;
+    }
+  }
+
+  const unsigned int id = static_cast<unsigned int>(mNames.size());
+  mNames.push_back(triple);
+  if (pooled != NULL) mNameIds[pooled] = id;
+
+  return id;
+}
+
+
+/*
+ * Copies s, NUL-terminated, into the arena and returns its offset.
+ * Offset 0 always holds the empty string.
+ */
+unsigned int
+XMLDocumentStore::addString (const string& s)
+{
+  if (s.empty()) return 0;
+
+  const unsigned int offset = static_cast<unsigned int>(mArena.size());
+  mArena.append(s);
+  mArena.push_back('\0');
+
+  return offset;
+}
+
+
+/*
+ * Adds the children of the given node to target, which already holds the
+ * node itself.  Each child is filled before target takes it over, so that
+ * no subtree is copied.
+ */
+void
+XMLDocumentStore::fillNode (XMLNode& target, unsigned int node) const
+{
+  for (unsigned int c = mFirstChild[node]; c != npos; c = mNextSibling[c])
+  {
+    XMLNode* child = createNode(c);
+    fillNode(*child, c);
+
+    target.adoptChild(child);
+  }
+}
+
+
+/*
+ * @return a new childless XMLNode for the given node.
+ */
+XMLNode*
+XMLDocumentStore::createNode (unsigned int node) const
+{
+  if (isText(node))
+  {
+    return new XMLNode(string(getCharacters(node)));
+  }
+
+  XMLAttributes attributes;
+  for (unsigned int i = 0; i < getNumAttributes(node); ++i)
+  {
+    const XMLTriple& triple = getNameTriple(getAttrNameId(node, i));
+    attributes.add(triple, getAttrValue(node, i));
+  }
+
+  XMLNamespaces namespaces;
+  for (unsigned int i = 0; i < getNumNamespaces(node); ++i)
+  {
+    namespaces.add(getNamespaceURI(node, i), getNamespacePrefix(node, i));
+  }
+
+  XMLNode* result = new XMLNode(getNameTriple(mNameId[node]), attributes,
+                                namespaces);
+  if (mKind[node] & EmptyElement) result->setEnd();
+
+  return result;
+}
+/** @endcond */
+
+
+/*
+ * Returns a new XMLNode tree with the contents of the given subtree.
+ */
+XMLNode*
+XMLDocumentStore::toXMLNode (unsigned int node) const
+{
+  if (node == npos)
+  {
+    if (isEmpty()) return NULL;
+
+    /* several top-level nodes are returned under a dummy root */
+    if (mNextSibling[0] != npos)
+    {
+      XMLNode* root = new XMLNode();
+      for (unsigned int n = 0; n != npos; n = mNextSibling[n])
+      {
+        XMLNode* child = createNode(n);
+        fillNode(*child, n);
+
+        root->adoptChild(child);
+      }
+      return root;
+    }
+
+    node = 0;
+  }
+
+  if (node >= getNumNodes()) return NULL;
+
+  XMLNode* result = createNode(node);
+  fillNode(*result, node);
+
+  return result;
+}
+
+
+/*
+ * @return the number of nodes held by this store.
+ */
+unsigned int
+XMLDocumentStore::getNumNodes () const
+{
+  return static_cast<unsigned int>(mKind.size());
+}
+
+
+/*
+ * @return true if this store holds no nodes.
+ */
+bool
+XMLDocumentStore::isEmpty () const
+{
+  return mKind.empty();
+}
+
+
+/*
+ * @return an iterator on the first node of the subtree rooted at node.
+ */
+XMLDocumentStore::const_iterator
+XMLDocumentStore::begin (unsigned int node) const
+{
+  return const_iterator(node < getNumNodes() ? node : getNumNodes());
+}
+
+
+/*
+ * @return an iterator just past the last node of the subtree rooted at
+ * node.  Nodes are stored in document order, so that is the next sibling
+ * of the nearest ancestor-or-self that has one.
+ */
+XMLDocumentStore::const_iterator
+XMLDocumentStore::end (unsigned int node) const
+{
+  while (node < getNumNodes())
+  {
+    if (mNextSibling[node] != npos) return const_iterator(mNextSibling[node]);
+    node = mParent[node];
+  }
+
+  return const_iterator(getNumNodes());
+}
+
+
+/*
+ * @return true if the given node is an element.
+ */
+bool
+XMLDocumentStore::isElement (unsigned int node) const
+{
+  return node < getNumNodes() && (mKind[node] & ElementNode) != 0;
+}
+
+
+/*
+ * @return true if the given node is a text node.
+ */
+bool
+XMLDocumentStore::isText (unsigned int node) const
+{
+  return node < getNumNodes() && (mKind[node] & TextNode) != 0;
+}
+
+
+/*
+ * @return the index of the parent of the given node.
+ */
+unsigned int
+XMLDocumentStore::getParent (unsigned int node) const
+{
+  return node < getNumNodes() ? mParent[node] : npos;
+}
+
+
+/*
+ * @return the index of the first child of the given node.
+ */
+unsigned int
+XMLDocumentStore::getFirstChild (unsigned int node) const
+{
+  return node < getNumNodes() ? mFirstChild[node] : npos;
+}
+
+
+/*
+ * @return the index of the next sibling of the given node.
+ */
+unsigned int
+XMLDocumentStore::getNextSibling (unsigned int node) const
+{
+  return node < getNumNodes() ? mNextSibling[node] : npos;
+}
+
+
+/*
+ * @return the number of children of the given node.
+ */
+unsigned int
+XMLDocumentStore::getNumChildren (unsigned int node) const
+{
+  unsigned int count = 0;
+
+  for (unsigned int c = getFirstChild(node); c != npos; c = mNextSibling[c])
+  {
+    ++count;
+  }
+
+  return count;
+}
+
+
+/*
+ * @return the index of the nth child of the given node.
+ */
+unsigned int
+XMLDocumentStore::getChild (unsigned int node, unsigned int n) const
+{
+  unsigned int c = getFirstChild(node);
+
+  while (c != npos && n > 0)
+  {
+    c = mNextSibling[c];
+    --n;
+  }
+
+  return c;
+}
+
+
+/*
+ * @return the name id of the given element.
+ */
+unsigned int
+XMLDocumentStore::getNameId (unsigned int node) const
+{
+  return node < getNumNodes() ? mNameId[node] : npos;
+}
+
+
+/*
+ * @return the id of the given name within this store.
+ */
+unsigned int
+XMLDocumentStore::findName (const string& name, const string& uri) const
+{
+  for (unsigned int id = 0; id < mNames.size(); ++id)
+  {
+    if (mNames[id].getName() == name && mNames[id].getURI() == uri)
+    {
+      return id;
+    }
+  }
+
+  return npos;
+}
+
+
+/*
+ * @return the number of distinct names used in this store.
+ */
+unsigned int
+XMLDocumentStore::getNumNames () const
+{
+  return static_cast<unsigned int>(mNames.size());
+}
+
+
+/*
+ * @return the name, URI and prefix with the given id.
+ */
+const XMLTriple&
+XMLDocumentStore::getNameTriple (unsigned int nameId) const
+{
+  return nameId < mNames.size() ? mNames[nameId] : emptyTriple();
+}
+
+
+/*
+ * @return the local name of the given element.
+ */
+const string&
+XMLDocumentStore::getName (unsigned int node) const
+{
+  return getNameTriple(getNameId(node)).getName();
+}
+
+
+/*
+ * @return the namespace URI of the given element.
+ */
+const string&
+XMLDocumentStore::getURI (unsigned int node) const
+{
+  return getNameTriple(getNameId(node)).getURI();
+}
+
+
+/*
+ * @return the namespace prefix of the given element.
+ */
+const string&
+XMLDocumentStore::getPrefix (unsigned int node) const
+{
+  return getNameTriple(getNameId(node)).getPrefix();
+}
+
+
+/*
+ * @return the characters of the given text node.
+ */
+const char*
+XMLDocumentStore::getCharacters (unsigned int node) const
+{
+  return mArena.c_str() + (node < getNumNodes() ? mText[node] : 0);
+}
+
+
+/*
+ * @return the number of attributes of the given node.
+ */
+unsigned int
+XMLDocumentStore::getNumAttributes (unsigned int node) const
+{
+  if (node >= getNumNodes()) return 0;
+  return mAttrBegin[node + 1] - mAttrBegin[node];
+}
+
+
+/*
+ * @return the name id of the nth attribute of the given node.
+ */
+unsigned int
+XMLDocumentStore::getAttrNameId (unsigned int node, unsigned int n) const
+{
+  if (n >= getNumAttributes(node)) return npos;
+  return mAttrName[mAttrBegin[node] + n];
+}
+
+
+/*
+ * @return the value of the nth attribute of the given node.
+ */
+const char*
+XMLDocumentStore::getAttrValue (unsigned int node, unsigned int n) const
+{
+  if (n >= getNumAttributes(node)) return NULL;
+  return mArena.c_str() + mAttrValue[mAttrBegin[node] + n];
+}
+
+
+/*
+ * @return the value of the attribute with the given name id.
+ */
+const char*
+XMLDocumentStore::getAttrValueById (  unsigned int node
+                                    , unsigned int nameId ) const
+{
+  if (node >= getNumNodes()) return NULL;
+
+  for (unsigned int a = mAttrBegin[node]; a < mAttrBegin[node + 1]; ++a)
+  {
+    if (mAttrName[a] == nameId) return mArena.c_str() + mAttrValue[a];
+  }
+
+  return NULL;
+}
+
+
+/*
+ * @return the value of the attribute with the given name.
+ */
+const char*
+XMLDocumentStore::getAttrValue (  unsigned int  node
+                                , const string& name
+                                , const string& uri ) const
+{
+  if (node >= getNumNodes()) return NULL;
+
+  for (unsigned int a = mAttrBegin[node]; a < mAttrBegin[node + 1]; ++a)
+  {
+    const XMLTriple& triple = mNames[mAttrName[a]];
+    if (triple.getName() == name && triple.getURI() == uri)
+    {
+      return mArena.c_str() + mAttrValue[a];
+    }
+  }
+
+  return NULL;
+}
+
+
+/*
+ * @return the number of namespaces declared on the given node.
+ */
+unsigned int
+XMLDocumentStore::getNumNamespaces (unsigned int node) const
+{
+  if (node >= getNumNodes()) return 0;
+  return mNsBegin[node + 1] - mNsBegin[node];
+}
+
+
+/*
+ * @return the prefix of the nth namespace declared on the given node.
+ */
+const char*
+XMLDocumentStore::getNamespacePrefix (unsigned int node, unsigned int n) const
+{
+  if (n >= getNumNamespaces(node)) return NULL;
+  return mArena.c_str() + mNsPrefix[mNsBegin[node] + n];
+}
+
+
+/*
+ * @return the URI of the nth namespace declared on the given node.
+ */
+const char*
+XMLDocumentStore::getNamespaceURI (unsigned int node, unsigned int n) const
+{
+  if (n >= getNumNamespaces(node)) return NULL;
+  return mArena.c_str() + mNsURI[mNsBegin[node] + n];
+}
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLDocumentStore_t *
+XMLDocumentStore_createFromStream (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return NULL;
+  return new(nothrow) XMLDocumentStore(*stream);
+}
+
+
+LIBLX_EXTERN
+XMLDocumentStore_t *
+XMLDocumentStore_createFromNode (const XMLNode_t *node)
+{
+  if (node == NULL) return NULL;
+  return new(nothrow) XMLDocumentStore(*node);
+}
+
+
+LIBLX_EXTERN
+void
+XMLDocumentStore_free (XMLDocumentStore_t *store)
+{
+  if (store == NULL) return;
+  delete static_cast<XMLDocumentStore*>(store);
+}
+
+
+LIBLX_EXTERN
+XMLNode_t *
+XMLDocumentStore_toXMLNode (const XMLDocumentStore_t *store)
+{
+  if (store == NULL) return NULL;
+  return store->toXMLNode();
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLDocumentStore_getNumNodes (const XMLDocumentStore_t *store)
+{
+  if (store == NULL) return 0;
+  return store->getNumNodes();
+}
+
+
+LIBLX_EXTERN
+const char *
+XMLDocumentStore_getName (const XMLDocumentStore_t *store, unsigned int node)
+{
+  if (store == NULL) return NULL;
+  return store->getName(node).c_str();
+}
+
+
+LIBLX_EXTERN
+const char *
+XMLDocumentStore_getCharacters (const XMLDocumentStore_t *store,
+                                unsigned int node)
+{
+  if (store == NULL) return NULL;
+  return store->getCharacters(node);
+}
+
+
+LIBLX_EXTERN
+const char *
+XMLDocumentStore_getAttrValue (const XMLDocumentStore_t *store,
+                               unsigned int node, const char *name)
+{
+  if (store == NULL || name == NULL) return NULL;
+  return store->getAttrValue(node, name);
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,547 @@
+/**
+ * @file    XMLDocumentStore.h
+ * @brief   Read-only XML document held in flat node arrays
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLDocumentStore
+ * @sbmlbrief{core} A read-only XML document stored as flat node arrays.
+ *
+ * An XMLNode tree is convenient to edit, but every node is a separate heap
+ * object and walking the tree means following a pointer per child.  An
+ * XMLDocumentStore holds the same content in a form meant to be loaded once
+ * and traversed many times.
+ *
+ * Nodes are identified by their index.  They are stored in document order,
+ * so the subtree of a node occupies a contiguous range of indices that
+ * begins at the node itself.  For each node the store keeps, in separate
+ * arrays, its kind, the id of its name, its parent, first child and next
+ * sibling, the range of its attributes and namespace declarations and, for
+ * text nodes, the offset of the characters.  All character data is held in
+ * a single arena.  Element and attribute names are replaced by small integer
+ * ids, so two names can be compared without comparing strings; use
+ * XMLDocumentStore::findName() to obtain the id of a name once and compare
+ * it against XMLDocumentStore::getNameId().
+ *
+ * Whitespace-only text is dropped, as it is when an XMLNode is read from an
+ * XMLInputStream.  Line and column numbers are not kept.
+ *
+ * A store may hold more than one top-level node.  This is the case when it
+ * is created from the dummy root returned by
+ * XMLNode::convertStringToXMLNode() for a string with several top-level
+ * elements; XMLDocumentStore::toXMLNode() then returns a dummy root again.
+ *
+ * The following visits every element named @c species in a document:
+@code{.cpp}
+XMLInputStream stream("model.xml");
+XMLDocumentStore store(stream);
+
+unsigned int species = store.findName("species", sbmlURI);
+for (XMLDocumentStore::const_iterator it = store.begin();
+     it != store.end(); ++it)
+{
+  if (store.getNameId(*it) == species)
+  {
+    const char* id = store.getAttrValue(*it, "id");
+    ...
+  }
+}
+@endcode
+ */
+
+#ifndef XMLDocumentStore_h
+#define XMLDocumentStore_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <liblx/xml/XMLTriple.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLInputStream;
+class XMLNode;
+class XMLToken;
+
+
+class LIBLX_EXTERN XMLDocumentStore
+{
+public:
+
+  /**
+   * Value returned in place of a node index or name id when there is no
+   * such node or name.
+   */
+  static const unsigned int npos;
+
+
+  /**
+   * Iterates over the nodes of a subtree in document (depth-first) order.
+   * Dereferencing the iterator gives the index of the current node.
+   */
+  class const_iterator
+  {
+  public:
+    const_iterator (unsigned int node = 0) : mNode(node) { }
+
+    unsigned int operator* () const { return mNode; }
+
+    const_iterator& operator++ () { ++mNode; return *this; }
+
+    const_iterator operator++ (int)
+    { const_iterator old(*this); ++mNode; return old; }
+
+    bool operator== (const const_iterator& rhs) const
+    { return mNode == rhs.mNode; }
+
+    bool operator!= (const const_iterator& rhs) const
+    { return mNode != rhs.mNode; }
+
+  private:
+    unsigned int mNode;
+  };
+
+
+  /**
+   * Creates a new, empty XMLDocumentStore.
+   */
+  XMLDocumentStore ();
+
+
+  /**
+   * Creates a new XMLDocumentStore by reading the next element, and
+   * everything it contains, from the given stream.
+   *
+   * @param stream the XMLInputStream to read from.
+   */
+  XMLDocumentStore (XMLInputStream& stream);
+
+
+  /**
+   * Creates a new XMLDocumentStore holding a copy of the given tree.
+   *
+   * @param node the root of the tree to copy.
+   */
+  XMLDocumentStore (const XMLNode& node);
+
+
+  /**
+   * Destroys this XMLDocumentStore.
+   */
+  virtual ~XMLDocumentStore ();
+
+
+  /**
+   * Returns a new XMLNode tree with the contents of the given subtree.
+   *
+   * @param node the index of the root of the subtree.  When omitted the
+   * whole store is converted.
+   *
+   * @return the new XMLNode, owned by the caller, or @c NULL if @p node
+   * is not a valid index.
+   */
+  XMLNode* toXMLNode (unsigned int node = npos) const;
+
+
+  /**
+   * @return the number of nodes held by this store.
+   */
+  unsigned int getNumNodes () const;
+
+
+  /**
+   * @return @c true if this store holds no nodes, @c false otherwise.
+   */
+  bool isEmpty () const;
+
+
+  /**
+   * @return an iterator positioned on the first node of the subtree
+   * rooted at @p node.
+   */
+  const_iterator begin (unsigned int node = 0) const;
+
+
+  /**
+   * @return an iterator positioned just past the last node of the subtree
+   * rooted at @p node.  When @p node is omitted this is the end of the
+   * whole store.
+   */
+  const_iterator end (unsigned int node = npos) const;
+
+
+  /**
+   * @return @c true if the given node is an element, @c false otherwise.
+   */
+  bool isElement (unsigned int node) const;
+
+
+  /**
+   * @return @c true if the given node is a text node, @c false otherwise.
+   */
+  bool isText (unsigned int node) const;
+
+
+  /**
+   * @return the index of the parent of the given node, or
+   * XMLDocumentStore::npos for a top-level node.
+   */
+  unsigned int getParent (unsigned int node) const;
+
+
+  /**
+   * @return the index of the first child of the given node, or
+   * XMLDocumentStore::npos if it has none.
+   */
+  unsigned int getFirstChild (unsigned int node) const;
+
+
+  /**
+   * @return the index of the next sibling of the given node, or
+   * XMLDocumentStore::npos if it is the last child.
+   */
+  unsigned int getNextSibling (unsigned int node) const;
+
+
+  /**
+   * @return the number of children of the given node.
+   */
+  unsigned int getNumChildren (unsigned int node) const;
+
+
+  /**
+   * @return the index of the nth child of the given node, or
+   * XMLDocumentStore::npos if there is no such child.
+   */
+  unsigned int getChild (unsigned int node, unsigned int n) const;
+
+
+  /**
+   * @return the name id of the given element, or XMLDocumentStore::npos
+   * for a text node.
+   */
+  unsigned int getNameId (unsigned int node) const;
+
+
+  /**
+   * Returns the id of the given name within this store.
+   *
+   * @param name the local name.
+   * @param uri the namespace URI.
+   *
+   * @return the name id, or XMLDocumentStore::npos if no element or
+   * attribute in this store has that name.
+   */
+  unsigned int findName (  const std::string& name
+                         , const std::string& uri = "" ) const;
+
+
+  /**
+   * @return the number of distinct names used in this store.
+   */
+  unsigned int getNumNames () const;
+
+
+  /**
+   * @return the name, URI and prefix with the given id.
+   */
+  const XMLTriple& getNameTriple (unsigned int nameId) const;
+
+
+  /**
+   * @return the local name of the given element, or an empty string for a
+   * text node.
+   */
+  const std::string& getName (unsigned int node) const;
+
+
+  /**
+   * @return the namespace URI of the given element.
+   */
+  const std::string& getURI (unsigned int node) const;
+
+
+  /**
+   * @return the namespace prefix of the given element.
+   */
+  const std::string& getPrefix (unsigned int node) const;
+
+
+  /**
+   * @return the characters of the given text node, or an empty string for
+   * an element.  The pointer remains valid for the lifetime of the store.
+   */
+  const char* getCharacters (unsigned int node) const;
+
+
+  /**
+   * @return the number of attributes of the given node.
+   */
+  unsigned int getNumAttributes (unsigned int node) const;
+
+
+  /**
+   * @return the name id of the nth attribute of the given node.
+   */
+  unsigned int getAttrNameId (unsigned int node, unsigned int n) const;
+
+
+  /**
+   * @return the value of the nth attribute of the given node.
+   */
+  const char* getAttrValue (unsigned int node, unsigned int n) const;
+
+
+  /**
+   * Returns the value of the attribute with the given name id.
+   *
+   * @return the value, or @c NULL if the node has no such attribute.
+   */
+  const char* getAttrValueById (unsigned int node, unsigned int nameId) const;
+
+
+  /**
+   * Returns the value of the attribute with the given name.
+   *
+   * @param node the index of the node.
+   * @param name the local name of the attribute.
+   * @param uri the namespace URI of the attribute.
+   *
+   * @return the value, or @c NULL if the node has no such attribute.
+   */
+  const char* getAttrValue (  unsigned int       node
+                            , const std::string& name
+                            , const std::string& uri = "" ) const;
+
+
+  /**
+   * @return the number of namespaces declared on the given node.
+   */
+  unsigned int getNumNamespaces (unsigned int node) const;
+
+
+  /**
+   * @return the prefix of the nth namespace declared on the given node.
+   */
+  const char* getNamespacePrefix (unsigned int node, unsigned int n) const;
+
+
+  /**
+   * @return the URI of the nth namespace declared on the given node.
+   */
+  const char* getNamespaceURI (unsigned int node, unsigned int n) const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+protected:
+
+  enum NodeKind
+  {
+      ElementNode  = 0x1
+    , TextNode     = 0x2
+    , EmptyElement = 0x4   /* element token that also closed itself */
+  };
+
+
+  void read (XMLInputStream& stream);
+
+  unsigned int appendNode (  const XMLToken& token
+                           , unsigned int    parent
+                           , unsigned int&   lastChild );
+
+  void appendTree (  const XMLNode& node
+                   , unsigned int   parent
+                   , unsigned int&  lastChild );
+
+  void fillNode (XMLNode& target, unsigned int node) const;
+
+  XMLNode* createNode (unsigned int node) const;
+
+  unsigned int internName (const XMLTriple& triple);
+
+  unsigned int addString (const std::string& s);
+
+
+  /* One entry per node. */
+  std::vector<unsigned char> mKind;
+  std::vector<unsigned int>  mNameId;
+  std::vector<unsigned int>  mParent;
+  std::vector<unsigned int>  mFirstChild;
+  std::vector<unsigned int>  mNextSibling;
+  std::vector<unsigned int>  mText;
+
+  /* One entry per node plus a sentinel; node n owns the attributes
+   * [mAttrBegin[n], mAttrBegin[n+1]) and likewise for namespaces. */
+  std::vector<unsigned int>  mAttrBegin;
+  std::vector<unsigned int>  mNsBegin;
+
+  /* One entry per attribute. */
+  std::vector<unsigned int>  mAttrName;
+  std::vector<unsigned int>  mAttrValue;
+
+  /* One entry per namespace declaration. */
+  std::vector<unsigned int>  mNsPrefix;
+  std::vector<unsigned int>  mNsURI;
+
+  /* Names indexed by name id, the ids of those interned in the
+   * XMLNamePool by their pooled copy, and the character arena.  Names the
+   * full pool did not take are only found by value. */
+  std::vector<XMLTriple>                             mNames;
+  std::unordered_map<const XMLTriple*, unsigned int> mNameIds;
+  std::string                                        mArena;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Creates a new XMLDocumentStore_t by reading the next element from the
+ * given stream.
+ *
+ * @param stream the XMLInputStream_t to read from.
+ *
+ * @return pointer to the XMLDocumentStore_t structure created.
+ *
+ * @memberof XMLDocumentStore_t
+ */
+LIBLX_EXTERN
+XMLDocumentStore_t *
+XMLDocumentStore_createFromStream (XMLInputStream_t *stream);
+
+
+/**
+ * Creates a new XMLDocumentStore_t holding a copy of the given tree.
+ *
+ * @param node the XMLNode_t to copy.
+ *
+ * @return pointer to the XMLDocumentStore_t structure created.
+ *
+ * @memberof XMLDocumentStore_t
+ */
+LIBLX_EXTERN
+XMLDocumentStore_t *
+XMLDocumentStore_createFromNode (const XMLNode_t *node);
+
+
+/**
+ * Destroys this XMLDocumentStore_t structure.
+ *
+ * @param store XMLDocumentStore_t structure to be freed.
+ *
+ * @memberof XMLDocumentStore_t
+ */
+LIBLX_EXTERN
+void
+XMLDocumentStore_free (XMLDocumentStore_t *store);
+
+
+/**
+ * Returns a new XMLNode_t tree with the contents of the given store.
+ *
+ * @param store the XMLDocumentStore_t structure to convert.
+ *
+ * @return the new XMLNode_t, owned by the caller.
+ *
+ * @memberof XMLDocumentStore_t
+ */
+LIBLX_EXTERN
+XMLNode_t *
+XMLDocumentStore_toXMLNode (const XMLDocumentStore_t *store);
+
+
+/**
+ * Returns the number of nodes held by the given store.
+ *
+ * @param store the XMLDocumentStore_t structure to query.
+ *
+ * @return the number of nodes.
+ *
+ * @memberof XMLDocumentStore_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLDocumentStore_getNumNodes (const XMLDocumentStore_t *store);
+
+
+/**
+ * Returns the local name of the given element.
+ *
+ * @param store the XMLDocumentStore_t structure to query.
+ * @param node the index of the node.
+ *
+ * @return the name, or an empty string for a text node.
+ *
+ * @memberof XMLDocumentStore_t
+ */
+LIBLX_EXTERN
+const char *
+XMLDocumentStore_getName (const XMLDocumentStore_t *store, unsigned int node);
+
+
+/**
+ * Returns the characters of the given text node.
+ *
+ * @param store the XMLDocumentStore_t structure to query.
+ * @param node the index of the node.
+ *
+ * @return the characters, or an empty string for an element.
+ *
+ * @memberof XMLDocumentStore_t
+ */
+LIBLX_EXTERN
+const char *
+XMLDocumentStore_getCharacters (const XMLDocumentStore_t *store,
+                                unsigned int node);
+
+
+/**
+ * Returns the value of the named attribute of the given node.
+ *
+ * @param store the XMLDocumentStore_t structure to query.
+ * @param node the index of the node.
+ * @param name the local name of the attribute.
+ *
+ * @return the value, or @c NULL if there is no such attribute.
+ *
+ * @memberof XMLDocumentStore_t
+ */
+LIBLX_EXTERN
+const char *
+XMLDocumentStore_getAttrValue (const XMLDocumentStore_t *store,
+                               unsigned int node, const char *name);
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLDocumentStore_h */
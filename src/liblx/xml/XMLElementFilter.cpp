@@ -0,0 +1,178 @@
+/**
+ * @file    XMLElementFilter.cpp
+ * @brief   Element names and namespaces an XMLInputStream skips as it parses
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <new>
+
+#include <liblx/xml/XMLElementFilter.h>
+#include <liblx/xml/operationReturnValues.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/*
+ * Creates a new XMLElementFilter that lists no elements.
+ */
+XMLElementFilter::XMLElementFilter (bool keepListed) :
+   mKeepListed ( keepListed )
+{
+}
+
+
+/*
+ * Lists the elements with the given local name, in any namespace.
+ */
+int
+XMLElementFilter::addElement (const string& name)
+{
+  if (name.empty()) return LIBLX_INVALID_ATTRIBUTE_VALUE;
+
+  mNames.insert(name);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * Lists the elements with the given local name in the given namespace.
+ */
+int
+XMLElementFilter::addElement (const string& name, const string& uri)
+{
+  if (name.empty()) return LIBLX_INVALID_ATTRIBUTE_VALUE;
+
+  mQualifiedNames.insert(make_pair(uri, name));
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * Lists every element in the given namespace.
+ */
+int
+XMLElementFilter::addNamespace (const string& uri)
+{
+  mNamespaces.insert(uri);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+bool
+XMLElementFilter::getKeepListed () const
+{
+  return mKeepListed;
+}
+
+
+bool
+XMLElementFilter::isEmpty () const
+{
+  return mNames.empty() && mQualifiedNames.empty() && mNamespaces.empty();
+}
+
+
+/*
+ * Removes every element and namespace from the list.
+ */
+void
+XMLElementFilter::clear ()
+{
+  mNames.clear();
+  mQualifiedNames.clear();
+  mNamespaces.clear();
+}
+
+
+/*
+ * @return true if the element is listed, by name or by namespace.
+ */
+bool
+XMLElementFilter::isListed (const string& name, const string& uri) const
+{
+  if (!mNames.empty() && mNames.count(name) > 0) return true;
+  if (!mNamespaces.empty() && mNamespaces.count(uri) > 0) return true;
+
+  return !mQualifiedNames.empty()
+         && mQualifiedNames.count(make_pair(uri, name)) > 0;
+}
+
+
+/*
+ * @return true if the element is to be skipped with its content.
+ */
+bool
+XMLElementFilter::skips (const string& name, const string& uri) const
+{
+  return isListed(name, uri) != mKeepListed;
+}
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLElementFilter_t *
+XMLElementFilter_create (int keepListed)
+{
+  return new(nothrow) XMLElementFilter(keepListed != 0);
+}
+
+
+LIBLX_EXTERN
+void
+XMLElementFilter_free (XMLElementFilter_t *filter)
+{
+  if (filter == NULL) return;
+  delete static_cast<XMLElementFilter*>(filter);
+}
+
+
+LIBLX_EXTERN
+int
+XMLElementFilter_addElement (  XMLElementFilter_t *filter
+                             , const char *name
+                             , const char *uri )
+{
+  if (filter == NULL || name == NULL) return LIBLX_INVALID_OBJECT;
+
+  return (uri == NULL) ? filter->addElement(name)
+                       : filter->addElement(name, uri);
+}
+
+
+LIBLX_EXTERN
+int
+XMLElementFilter_addNamespace (XMLElementFilter_t *filter, const char *uri)
+{
+  if (filter == NULL || uri == NULL) return LIBLX_INVALID_OBJECT;
+  return filter->addNamespace(uri);
+}
+
+
+LIBLX_EXTERN
+int
+XMLElementFilter_skips (  const XMLElementFilter_t *filter
+                        , const char *name
+                        , const char *uri )
+{
+  if (filter == NULL || name == NULL || uri == NULL) return 0;
+  return static_cast<int>( filter->skips(name, uri) );
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,270 @@
+/**
+ * @file    XMLElementFilter.h
+ * @brief   Element names and namespaces an XMLInputStream skips as it parses
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLElementFilter
+ * @sbmlbrief{core} Elements to be skipped, with everything they contain,
+ * while a document is parsed.
+ *
+ * An XMLElementFilter lists elements by local name, by local name and
+ * namespace URI, or by namespace URI alone.  Given to
+ * XMLInputStream::setElementFilter(), it is applied by the XML library's
+ * event handler before any XMLToken is made: a skipped element, its
+ * attributes and everything inside it are parsed only far enough to find
+ * where it ends, and never reach the stream.
+ *
+ * A filter either skips the elements it lists, or keeps only the elements
+ * it lists and skips all others.  In either case an element that is
+ * skipped takes its content with it, so when keeping elements, every
+ * element on the way down to those wanted must be listed, the document
+ * element included:
+ *
+@code{.cpp}
+XMLElementFilter filter(true);
+filter.addElement("sbml");
+filter.addElement("model");
+filter.addElement("listOfSpecies");
+filter.addElement("species");
+
+XMLInputStream stream("huge.xml");
+stream.setElementFilter(&filter);
+XMLNode root(stream);
+@endcode
+ */
+
+#ifndef XMLElementFilter_h
+#define XMLElementFilter_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+#ifdef __cplusplus
+
+#include <set>
+#include <string>
+#include <utility>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+class LIBLX_EXTERN XMLElementFilter
+{
+public:
+
+  /**
+   * Creates a new XMLElementFilter that lists no elements.
+   *
+   * @param keepListed @c false to skip the elements listed, @c true to
+   * keep them and skip every other element.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLElementFilter (bool keepListed = false);
+
+
+  /**
+   * Lists the elements with the given local name, in any namespace.
+   *
+   * @param name the local name, without a prefix.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * if @p name is empty.
+   */
+  int addElement (const std::string& name);
+
+
+  /**
+   * Lists the elements with the given local name in the given namespace.
+   *
+   * @param name the local name, without a prefix.
+   * @param uri the namespace URI, or an empty string for elements in no
+   * namespace.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * if @p name is empty.
+   */
+  int addElement (const std::string& name, const std::string& uri);
+
+
+  /**
+   * Lists every element in the given namespace.
+   *
+   * @param uri the namespace URI, or an empty string for elements in no
+   * namespace.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   */
+  int addNamespace (const std::string& uri);
+
+
+  /**
+   * @return @c true if the elements listed are kept and all others
+   * skipped, @c false if the elements listed are skipped.
+   */
+  bool getKeepListed () const;
+
+
+  /**
+   * @return @c true if no elements are listed.
+   */
+  bool isEmpty () const;
+
+
+  /**
+   * Removes every element and namespace from the list.
+   */
+  void clear ();
+
+
+  /**
+   * Returns whether the element with the given name is listed.
+   *
+   * @param name the local name of the element.
+   * @param uri the namespace URI of the element.
+   *
+   * @return @c true if the element is listed, by name or by namespace.
+   */
+  bool isListed (const std::string& name, const std::string& uri) const;
+
+
+  /**
+   * Returns whether the element with the given name is to be skipped.
+   *
+   * @param name the local name of the element.
+   * @param uri the namespace URI of the element.
+   *
+   * @return @c true if the element is to be skipped with its content.
+   */
+  bool skips (const std::string& name, const std::string& uri) const;
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  bool                                            mKeepListed;
+  std::set<std::string>                           mNames;
+  std::set< std::pair<std::string, std::string> > mQualifiedNames;
+  std::set<std::string>                           mNamespaces;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Creates a new XMLElementFilter_t that lists no elements.
+ *
+ * @param keepListed zero to skip the elements listed, nonzero to keep
+ * them and skip every other element.
+ *
+ * @return pointer to the XMLElementFilter_t structure created.
+ *
+ * @memberof XMLElementFilter_t
+ */
+LIBLX_EXTERN
+XMLElementFilter_t *
+XMLElementFilter_create (int keepListed);
+
+
+/**
+ * Destroys this XMLElementFilter_t structure.
+ *
+ * @param filter XMLElementFilter_t structure to be freed.
+ *
+ * @memberof XMLElementFilter_t
+ */
+LIBLX_EXTERN
+void
+XMLElementFilter_free (XMLElementFilter_t *filter);
+
+
+/**
+ * Lists the elements with the given local name in the given namespace.
+ *
+ * @param filter the XMLElementFilter_t structure.
+ * @param name the local name, without a prefix.
+ * @param uri the namespace URI, or @c NULL for any namespace.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLElementFilter_t
+ */
+LIBLX_EXTERN
+int
+XMLElementFilter_addElement (  XMLElementFilter_t *filter
+                             , const char *name
+                             , const char *uri );
+
+
+/**
+ * Lists every element in the given namespace.
+ *
+ * @param filter the XMLElementFilter_t structure.
+ * @param uri the namespace URI.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLElementFilter_t
+ */
+LIBLX_EXTERN
+int
+XMLElementFilter_addNamespace (XMLElementFilter_t *filter, const char *uri);
+
+
+/**
+ * Returns whether the element with the given name is to be skipped.
+ *
+ * @param filter the XMLElementFilter_t structure.
+ * @param name the local name of the element.
+ * @param uri the namespace URI of the element.
+ *
+ * @return @c 1 if the element is to be skipped, @c 0 otherwise or if any
+ * argument is @c NULL.
+ *
+ * @memberof XMLElementFilter_t
+ */
+LIBLX_EXTERN
+int
+XMLElementFilter_skips (  const XMLElementFilter_t *filter
+                        , const char *name
+                        , const char *uri );
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLElementFilter_h */
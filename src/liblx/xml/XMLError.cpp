@@ -34,14 +34,17 @@
  * also available online as http://sbml.org/software/libsbml/license.html
  * ---------------------------------------------------------------------- -->*/
 
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <vector>
 
 #include <liblx/xml/common/common.h>
 #include <liblx/xml/XMLError.h>
 #include <liblx/xml/XMLAttributes.h>
 #include <liblx/xml/XMLConstructorException.h>
+#include <liblx/xml/XMLMemoryUsage.h>
 #include <liblx/xml/LibLXError.h>
 #include <liblx/xml/operationReturnValues.h>
 
@@ -288,6 +291,33 @@ static const xmlErrorTableEntry errorTable[] =
 };
 
 
+/*
+ * @return an array, indexed by error code, of the position in errorTable
+ * of each code below XMLErrorCodesUpperBound, or -1 for codes the table
+ * does not have.  It is built on first use and makes looking up a code a
+ * single array access.
+ */
+static const vector<short>&
+errorTableIndex ()
+{
+  struct Index : public vector<short>
+  {
+    Index () : vector<short>(XMLErrorCodesUpperBound, -1)
+    {
+      const size_t tableSize = sizeof(errorTable)/sizeof(errorTable[0]);
+
+      for (size_t i = 0; i < tableSize; ++i)
+      {
+        (*this)[errorTable[i].code] = static_cast<short>(i);
+      }
+    }
+  };
+
+  static const Index index;
+  return index;
+}
+
+
 /*
  * Table of strings corresponding to the values from XMLErrorSeverity_t.
  * Be careful that the enum is used to index into this table.
@@ -316,10 +346,27 @@ const char * xmlCategoryStringTable[] =
 /** @endcond **/
 
 
+/** @cond doxygenLibsbmlInternal **/
+/*
+ * The text of an XMLError, composed on first use.
+ */
+struct XMLError::Text
+{
+  std::string message;
+  std::string shortMessage;
+  std::string severityString;
+  std::string categoryString;
+};
+/** @endcond **/
+
+
 /*
  * XMLErrorLog will check if line & column = 0 and attempt to fill in
  * the line and column by consulting the parser.  This constructor
  * purposefully doesn't do that.
+ *
+ * Only the id, details, severity and category are kept; the messages are
+ * composed by getText() when they are first asked for.
  */
 XMLError::XMLError (  const int errorId
                     , const std::string details
@@ -328,11 +375,13 @@ XMLError::XMLError (  const int errorId
                     , const unsigned int severity
                     , const unsigned int category ) :
     mErrorId( (unsigned int)errorId )
+  , mDetails( details )
   , mLine   ( line    )
   , mColumn ( column  )
   , mValidError ( true )
   , mPackage ("")
   , mErrorIdOffset (0)
+  , mText ( NULL )
 {
   // Check if the given id is one we have in our table of error codes.  If
   // it is, fill in the fields of the error object with the appropriate
@@ -340,30 +389,13 @@ XMLError::XMLError (  const int errorId
 
   if ( errorId >= 0 && errorId < XMLErrorCodesUpperBound )
   {
-    unsigned int tableSize = sizeof(errorTable)/sizeof(errorTable[0]);    
+    const short entry = errorTableIndex()[errorId];
 
-    for ( unsigned int i = 0; i < tableSize; i++ )
+    if ( entry >= 0 )
     {
-      if ( errorTable[i].code == errorId )
-      {
-        mMessage      = errorTable[i].message;
-        mShortMessage = errorTable[i].shortMessage;
-
-        if ( !details.empty() )
-        {
-          mMessage.append(" ");
-          mMessage.append(details);
-        }
-        mMessage += "\n";
-
-        mSeverity = errorTable[i].severity;
-        mCategory = errorTable[i].category;
-        
-        mSeverityString = stringForSeverity(mSeverity);
-        mCategoryString = stringForCategory(mCategory);
-
-        return;
-      }
+      mSeverity = errorTable[entry].severity;
+      mCategory = errorTable[entry].category;
+      return;
     }
 
     // The id is in the range of error numbers that are supposed to be in
@@ -380,22 +412,8 @@ XMLError::XMLError (  const int errorId
 
     // Now we log the error as an UnKnown Error and mark it as invalid
 
-    mMessage      = errorTable[0].message;
-    mMessage += "\n";
-    mShortMessage = errorTable[0].shortMessage;
-
-    if ( !details.empty() )
-    {
-      mMessage.append(" ");
-      mMessage.append(details);
-      mMessage.append("\n");
-    }
-
     mSeverity = LIBLX_SEV_WARNING;
     mCategory = errorTable[0].category;
-    
-    mSeverityString = stringForSeverity(mSeverity);
-    mCategoryString = stringForCategory(mCategory);
 
     mValidError = false;
     return;
@@ -406,44 +424,32 @@ XMLError::XMLError (  const int errorId
   // filled in all the relevant additional data.  (If they didn't, the
   // following ends up merely assigning the defaults.)
 
-  mMessage  = details;
-
-  // The following is just a default that seems more sensible than setting
-  // an empty string for the short message.
-
-  mShortMessage = mMessage;
-
-  // Other initializations.
-
   if (severity == LIBLX_SEV_UNKNOWN) {
     mSeverity = LIBLX_SEV_ERROR;
   }
   else {
     mSeverity = severity;
   }
-  mSeverityString = stringForSeverity(severity);
 
-  mCategory       = category;
-  mCategoryString = stringForCategory(category);
+  mCategory = category;
 }
 
 
 /*
- * Copy Constructor
+ * Copy Constructor.  The text is not copied; the copy composes its own
+ * if it is asked for.
  */
 XMLError::XMLError(const XMLError& orig)
   : mErrorId        ( orig.mErrorId )
-  , mMessage        ( orig.mMessage )
-  , mShortMessage   ( orig.mShortMessage )
+  , mDetails        ( orig.mDetails )
   , mSeverity       ( orig.mSeverity )
   , mCategory       ( orig.mCategory )
   , mLine           ( orig.mLine )
   , mColumn         ( orig.mColumn )
-  , mSeverityString ( orig.mSeverityString )
-  , mCategoryString ( orig.mCategoryString )
   , mValidError     ( orig.mValidError )
   , mPackage        ( orig.mPackage )
   , mErrorIdOffset  ( orig.mErrorIdOffset )
+  , mText           ( NULL )
 {
 }
 
@@ -457,16 +463,15 @@ XMLError::operator=(const XMLError& rhs)
   if(&rhs!=this)
   {
     mErrorId        = rhs.mErrorId;
-    mMessage        = rhs.mMessage;
-    mShortMessage   = rhs.mShortMessage;
+    mDetails        = rhs.mDetails;
     mSeverity       = rhs.mSeverity;
     mCategory       = rhs.mCategory;
     mLine           = rhs.mLine;
     mColumn         = rhs.mColumn;
-    mSeverityString = rhs.mSeverityString;
-    mCategoryString = rhs.mCategoryString;
     mPackage        = rhs.mPackage;
     mErrorIdOffset  = rhs.mErrorIdOffset;
+
+    clearText();
   }
 
   return *this;
@@ -478,6 +483,7 @@ XMLError::operator=(const XMLError& rhs)
  */
 XMLError::~XMLError ()
 {
+  delete mText.load(memory_order_relaxed);
 }
 
 
@@ -493,6 +499,112 @@ XMLError::clone() const
 /** @endcond **/
 
 
+/** @cond doxygenLibsbmlInternal **/
+/*
+ * @return the text of this XMLError, composing it the first time.  Threads
+ * that race to compose it keep whichever text is published first.
+ */
+const XMLError::Text&
+XMLError::getText () const
+{
+  Text* text = mText.load(memory_order_acquire);
+  if (text != NULL) return *text;
+
+  text = new Text;
+
+  const short entry = ( mErrorId < (unsigned int)XMLErrorCodesUpperBound )
+                      ? errorTableIndex()[mErrorId] : -1;
+
+  if ( entry >= 0 )
+  {
+    const xmlErrorTableEntry& e = errorTable[entry];
+
+    // the message is sized once rather than grown by each append
+    text->message.reserve(strlen(e.message) + mDetails.size() + 2);
+    text->message      = e.message;
+    text->shortMessage = e.shortMessage;
+
+    if ( !mDetails.empty() )
+    {
+      text->message += ' ';
+      text->message += mDetails;
+    }
+    text->message += '\n';
+  }
+  else if ( mErrorId < (unsigned int)XMLErrorCodesUpperBound )
+  {
+    text->message      = errorTable[0].message;
+    text->message     += "\n";
+    text->shortMessage = errorTable[0].shortMessage;
+
+    if ( !mDetails.empty() )
+    {
+      text->message.append(" ");
+      text->message.append(mDetails);
+      text->message.append("\n");
+    }
+  }
+  else
+  {
+    // The following is just a default that seems more sensible than
+    // setting an empty string for the short message.
+
+    text->message      = mDetails;
+    text->shortMessage = mDetails;
+  }
+
+  text->severityString = stringForSeverity(mSeverity);
+  text->categoryString = stringForCategory(mCategory);
+
+  Text* expected = NULL;
+  if (!mText.compare_exchange_strong(expected, text, memory_order_acq_rel))
+  {
+    delete text;
+    return *expected;
+  }
+
+  return *text;
+}
+/** @endcond **/
+
+
+/** @cond doxygenLibsbmlInternal **/
+/*
+ * Drops the text of this XMLError, after a change to the fields it is
+ * composed from.
+ */
+void
+XMLError::clearText ()
+{
+  delete mText.exchange(NULL, memory_order_acq_rel);
+}
+/** @endcond **/
+
+
+/*
+ * @return the bytes of memory this XMLError holds.
+ */
+size_t
+XMLError::getMemoryUsage () const
+{
+  size_t bytes = sizeof(XMLError)
+               + XMLMemoryUsage::getStringBytes(mDetails)
+               + XMLMemoryUsage::getStringBytes(mPackage);
+
+  const Text* text = mText.load(memory_order_acquire);
+  if (text != NULL)
+  {
+    bytes += sizeof(Text)
+           + XMLMemoryUsage::getStringBytes(text->message)
+           + XMLMemoryUsage::getStringBytes(text->shortMessage)
+           + XMLMemoryUsage::getStringBytes(text->severityString)
+           + XMLMemoryUsage::getStringBytes(text->categoryString);
+  }
+
+  return bytes;
+}
+
+
 /*
  * @return the id of this XMLError.
  */
@@ -509,7 +621,7 @@ XMLError::getErrorId () const
 const string&
 XMLError::getMessage () const
 {
-  return mMessage;
+  return getText().message;
 }
 
 
@@ -519,7 +631,7 @@ XMLError::getMessage () const
 const string&
 XMLError::getShortMessage () const
 {
-  return mShortMessage;
+  return getText().shortMessage;
 }
 
 
@@ -563,7 +675,7 @@ XMLError::getSeverity () const
 const std::string& 
 XMLError::getSeverityAsString() const
 {
-  return mSeverityString;
+  return getText().severityString;
 }
 
 
@@ -587,7 +699,7 @@ XMLError::getCategory () const
 const std::string& 
 XMLError::getCategoryAsString() const
 {
-  return mCategoryString;
+  return getText().categoryString;
 }
 
 const std::string& 
@@ -563,6 +563,7 @@ LIBLX_CPP_NAMESPACE_END
 #ifdef __cplusplus
 
 
+#include <atomic>
 #include <iosfwd>
 #include <string>
 #include <liblx/xml/operationReturnValues.h>
@@ -721,6 +722,9 @@ public:
    * obtain additional information about the nature and severity of the
    * problem.
    *
+   * An XMLError keeps only its identifier and details until one of its
+   * messages is asked for; the text is composed then, once.
+   *
    * @return the message text.
    *
    * @see getErrorId()
@@ -1109,6 +1113,16 @@ public:
   unsigned int getErrorIdOffset() const;
 
 
+  /**
+   * Returns the bytes of memory this XMLError holds, counting the object
+   * itself, its details and package name, and its messages once they have
+   * been composed.
+   *
+   * @return the bytes held by this XMLError.
+   */
+  size_t getMemoryUsage () const;
+
+
 #ifndef SWIG
 
   /** @cond doxygenLibsbmlInternal */
@@ -1138,8 +1152,12 @@ protected:
   /** @cond doxygenLibsbmlInternal */
   unsigned int mErrorId;
 
-  std::string  mMessage;
-  std::string  mShortMessage;
+  /*
+   * The details given to the constructor.  The messages and the names of
+   * the severity and category are composed from the id and details on
+   * first use (see getText()) and dropped by clearText().
+   */
+  std::string  mDetails;
 
   unsigned int mSeverity;
   unsigned int mCategory;
@@ -1147,14 +1165,17 @@ protected:
   unsigned int mLine;
   unsigned int mColumn;
 
-  std::string mSeverityString;
-  std::string mCategoryString;
-
   bool mValidError;
 
   std::string mPackage;
   unsigned int mErrorIdOffset;
 
+  struct Text;
+  mutable std::atomic<Text*> mText;
+
+  const Text& getText () const;
+  void clearText ();
+
   virtual std::string stringForSeverity(unsigned int code) const;
   virtual std::string stringForCategory(unsigned int code) const;
 
@@ -35,6 +35,7 @@
  * ---------------------------------------------------------------------- -->*/
 
 #include <algorithm>
+#include <climits>
 #include <functional>
 #include <sstream>
 
@@ -42,6 +43,7 @@
 #include <liblx/xml/XMLParser.h>
 
 #include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLTrace.h>
 
 #include <liblx/xml/sbmlMemoryStubs.h>
 #include <liblx/xml/operationReturnValues.h>
@@ -54,6 +56,13 @@ using namespace std;
 LIBLX_CPP_NAMESPACE_BEGIN
 #ifdef __cplusplus
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * The position recorded for an id none of whose errors is stored.
+ */
+static const unsigned int NOT_STORED = UINT_MAX;
+/** @endcond */
+
 /** @cond doxygenLibsbmlInternal */
 /*
  * Creates a new empty XMLErrorLog.
@@ -61,6 +70,14 @@ LIBLX_CPP_NAMESPACE_BEGIN
 XMLErrorLog::XMLErrorLog ()
   : mParser(NULL)
   , mOverriddenSeverity(LIBSBXML_OVERRIDE_DISABLED)
+  , mMaxErrors     ( 0 )
+  , mNumDropped    ( 0 )
+  , mAggregate     ( false )
+  , mCallback      ( NULL )
+  , mCallbackData  ( NULL )
+  , mStopCount     ( 0 )
+  , mStopSeverity  ( LIBLX_SEV_FATAL )
+  , mStopRequested ( false )
 {
 }
 /** @endcond */
@@ -72,8 +89,16 @@ XMLErrorLog::XMLErrorLog ()
 XMLErrorLog::XMLErrorLog (const XMLErrorLog& other)
   : mParser(NULL)
   , mOverriddenSeverity(other.mOverriddenSeverity)
+  , mMaxErrors     ( 0 )
+  , mNumDropped    ( 0 )
+  , mAggregate     ( false )
+  , mCallback      ( NULL )
+  , mCallbackData  ( NULL )
+  , mStopCount     ( 0 )
+  , mStopSeverity  ( LIBLX_SEV_FATAL )
+  , mStopRequested ( false )
 {
-  add(other.mErrors);
+  copyLog(other);
 }
 /** @endcond */
 
@@ -88,13 +113,41 @@ XMLErrorLog& XMLErrorLog::operator=(const XMLErrorLog& other)
     mOverriddenSeverity = other.mOverriddenSeverity;
     mParser = NULL;
     
-    mErrors.clear();
-    add(other.mErrors);
+    clearLog();
+    copyLog(other);
   }
   return *this;
 }
 /** @endcond */
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Makes this empty log a copy of other.  The callback is not copied, so
+ * that copying a log never calls back into its owner.
+ */
+void
+XMLErrorLog::copyLog (const XMLErrorLog& other)
+{
+  mErrors.reserve(other.mErrors.size());
+  for (size_t n = 0; n < other.mErrors.size(); ++n)
+  {
+    mErrors.push_back(other.mErrors[n]->clone());
+  }
+
+  mErrorsById       = other.mErrorsById;
+  mErrorsBySeverity = other.mErrorsBySeverity;
+  mOccurrences      = other.mOccurrences;
+  mRepeats          = other.mRepeats;
+  mUnstored         = other.mUnstored;
+  mMaxErrors        = other.mMaxErrors;
+  mNumDropped       = other.mNumDropped;
+  mAggregate        = other.mAggregate;
+  mStopCount        = other.mStopCount;
+  mStopSeverity     = other.mStopSeverity;
+  mStopRequested    = other.mStopRequested;
+}
+/** @endcond */
+
 /** @cond doxygenLibsbmlInternal */
 /**
  * Used by the Destructor to delete each item in mErrors.
@@ -118,13 +171,77 @@ XMLErrorLog::~XMLErrorLog ()
 
 /** @cond doxygenLibsbmlInternal */
 /*
- * Logs the given XMLError.
+ * @return the severity an error of the given severity is logged with
+ * under the given override.
+ */
+static unsigned int
+overriddenSeverity (XMLErrorSeverityOverride_t override, 
+                    unsigned int severity)
+{
+  if (override == LIBSBXML_OVERRIDE_WARNING && severity > LIBLX_SEV_WARNING)
+  {
+    return LIBLX_SEV_WARNING;
+  }
+  else if (override == LIBSBXML_OVERRIDE_ERROR && 
+           severity == LIBLX_SEV_WARNING)
+  {
+    return LIBLX_SEV_ERROR;
+  }
+
+  return severity;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Logs the given XMLError.  Every error is counted; it is then passed to
+ * the callback, counted against an earlier stored error it repeats,
+ * dropped if the log is full, or else stored.  Only a stored error is
+ * copied to the heap.
  */
 void
 XMLErrorLog::add (const XMLError& error)
 {
   if (mOverriddenSeverity == LIBSBXML_OVERRIDE_DONT_LOG) return;
 
+  LIBLX_TRACE4(error__add, this, error.getErrorId(), error.getSeverity(),
+               error.getLine());
+
+  if (mCallback != NULL)
+  {
+    XMLError copy(error);
+    prepareError(copy);
+    countError(copy.getErrorId(), copy.getSeverity());
+    countUnstored(copy, copy.getSeverity());
+
+    if (mCallback(&copy, mCallbackData) != 0) mStopRequested = true;
+    return;
+  }
+
+  if (mAggregate)
+  {
+    const unsigned int repeat = findRepeat(error);
+    if (repeat < mErrors.size())
+    {
+      countError(error.getErrorId(), mErrors[repeat]->getSeverity());
+      ++mOccurrences[repeat];
+      return;
+    }
+  }
+
+  if (mMaxErrors > 0 && mErrors.size() >= mMaxErrors)
+  {
+    const unsigned int severity =
+      overriddenSeverity(mOverriddenSeverity, error.getSeverity());
+
+    countError(error.getErrorId(), severity);
+    countUnstored(error, severity);
+
+    ++mNumDropped;
+    return;
+  }
+
   XMLError* cerror;
 
   try
@@ -138,22 +255,35 @@ XMLErrorLog::add (const XMLError& error)
     return;
   }
 
+  prepareError(*cerror);
+  countError(cerror->getErrorId(), cerror->getSeverity());
+  storeError(cerror);
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Gives error the severity the override calls for and, if it has no
+ * position, the position of the parser.
+ */
+void
+XMLErrorLog::prepareError (XMLError& error) const
+{
   if (mOverriddenSeverity == LIBSBXML_OVERRIDE_WARNING &&
-    cerror->getSeverity() > LIBLX_SEV_WARNING)
+    error.getSeverity() > LIBLX_SEV_WARNING)
   {
-    cerror->mSeverity = LIBLX_SEV_WARNING;
-    cerror->mSeverityString = "Warning";
+    error.mSeverity = LIBLX_SEV_WARNING;
+    error.clearText();
   }
   else if (mOverriddenSeverity == LIBSBXML_OVERRIDE_ERROR &&
-    cerror->getSeverity() == LIBLX_SEV_WARNING)
+    error.getSeverity() == LIBLX_SEV_WARNING)
   {
-    cerror->mSeverity = LIBLX_SEV_ERROR;
-    cerror->mSeverityString = "Error";
+    error.mSeverity = LIBLX_SEV_ERROR;
+    error.clearText();
   }
 
-  mErrors.push_back(cerror);
-
-  if (cerror->getLine() == 0 && cerror->getColumn() == 0)
+  if (error.getLine() == 0 && error.getColumn() == 0)
   {
     unsigned int line, column;
     if (mParser != NULL)
@@ -175,9 +305,150 @@ XMLErrorLog::add (const XMLError& error)
       column = 1;
     }
 
-    cerror->setLine(line);
-    cerror->setColumn(column);
+    error.setLine(line);
+    error.setColumn(column);
+  }
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Counts an error of the given id and severity.
+ */
+void
+XMLErrorLog::countError (unsigned int errorId, unsigned int severity)
+{
+  IdEntry& entry = mErrorsById[errorId];
+  if (entry.count++ == 0)
+  {
+    entry.first = NOT_STORED;
   }
+
+  ++severityEntry(severity).count;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Counts an error of the given severity that is not stored, so that
+ * changeErrorSeverity() can move it with the stored ones.
+ */
+void
+XMLErrorLog::countUnstored (const XMLError& error, unsigned int severity)
+{
+  for (size_t n = 0; n < mUnstored.size(); ++n)
+  {
+    if (mUnstored[n].severity == severity
+        && mUnstored[n].package == error.getPackage())
+    {
+      ++mUnstored[n].count;
+      return;
+    }
+  }
+
+  UnstoredEntry entry;
+  entry.severity = severity;
+  entry.package  = error.getPackage();
+  entry.count    = 1;
+
+  mUnstored.push_back(entry);
+}
+
+
+/*
+ * @return the counts of errors with the given severity.
+ */
+XMLErrorLog::SeverityEntry&
+XMLErrorLog::severityEntry (unsigned int severity)
+{
+  if (severity >= mErrorsBySeverity.size())
+  {
+    mErrorsBySeverity.resize(severity + 1, SeverityEntry());
+  }
+  return mErrorsBySeverity[severity];
+}
+
+
+/*
+ * Moves count errors, stored of them stored, from one severity to another
+ * in the counts.
+ */
+void
+XMLErrorLog::moveSeverityCount (unsigned int from, unsigned int to,
+                                unsigned int count, unsigned int stored)
+{
+  SeverityEntry& target = severityEntry(to);
+  target.count  += count;
+  target.stored += stored;
+
+  SeverityEntry& source = mErrorsBySeverity[from];
+  source.count  -= count;
+  source.stored -= stored;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return a hash of the id and details of an error, by which repeats are
+ * found.  Errors with the same id and details have the same message.
+ */
+static size_t
+repeatHash (unsigned int errorId, const string& details)
+{
+  return hash<string>()(details) 
+         ^ (static_cast<size_t>(errorId) * 0x9e3779b9u);
+}
+
+
+/*
+ * Stores error, which this log then owns.
+ */
+void
+XMLErrorLog::storeError (XMLError* error)
+{
+  const unsigned int n = (unsigned int)mErrors.size();
+
+  mErrors.push_back(error);
+  mOccurrences.push_back(1);
+
+  IdEntry& entry = mErrorsById[error->getErrorId()];
+  if (entry.stored++ == 0) entry.first = n;
+
+  ++severityEntry(error->getSeverity()).stored;
+
+  if (mAggregate)
+  {
+    mRepeats.insert(make_pair(repeatHash(error->getErrorId(), 
+                                         error->mDetails), n));
+  }
+}
+
+
+/*
+ * @return the index of a stored error with the id and details of error,
+ * or getNumErrors() if there is none.
+ */
+unsigned int
+XMLErrorLog::findRepeat (const XMLError& error) const
+{
+  typedef unordered_multimap<size_t, unsigned int>::const_iterator Iterator;
+  pair<Iterator, Iterator> range = 
+    mRepeats.equal_range(repeatHash(error.getErrorId(), error.mDetails));
+
+  for (Iterator it = range.first; it != range.second; ++it)
+  {
+    const XMLError* stored = mErrors[it->second];
+    if (stored->getErrorId() == error.getErrorId() &&
+        stored->mDetails == error.mDetails)
+    {
+      return it->second;
+    }
+  }
+
+  return (unsigned int)mErrors.size();
 }
 /** @endcond */
 
@@ -283,6 +554,13 @@ XMLErrorLog::clearLog()
 {
   for_each( mErrors.begin(), mErrors.end(), Delete() );
   mErrors.clear();
+  mErrorsById.clear();
+  mErrorsBySeverity.clear();
+  mOccurrences.clear();
+  mRepeats.clear();
+  mUnstored.clear();
+  mNumDropped    = 0;
+  mStopRequested = false;
 }
 
 /** @cond doxygenLibsbmlInternal */
@@ -334,66 +612,289 @@ XMLErrorLog::printErrors(std::ostream& stream, unsigned int severity) const
 }
 
 
+/*
+ * Changes the severity of the errors logged with originalSeverity.  Each
+ * stored error moves in the counts with all its repeats, and errors not
+ * stored move with them.
+ */
 void 
 XMLErrorLog::changeErrorSeverity(XMLErrorSeverity_t originalSeverity,
                                  XMLErrorSeverity_t targetSeverity,
                                  std::string package)
 {
-  vector<XMLError*>::const_iterator iter;
+  if (originalSeverity == targetSeverity) return;
 
-  for (iter = mErrors.begin(); iter != mErrors.end(); ++iter) 
+  for (size_t n = 0; n < mErrors.size(); ++n)
   {
-    if ((*iter)->getSeverity() == (unsigned int)(originalSeverity))
+    XMLError* error = mErrors[n];
+
+    if (error->getSeverity() == (unsigned int)(originalSeverity))
     {
-      if (package == "all" || (*iter)->getPackage() == package)
+      if (package == "all" || error->getPackage() == package)
       {
-        (*iter)->mSeverity = targetSeverity;
-        (*iter)->mSeverityString = (*iter)->stringForSeverity(targetSeverity);
+        error->mSeverity = targetSeverity;
+        error->clearText();
+
+        moveSeverityCount(originalSeverity, targetSeverity, 
+                          mOccurrences[n], 1);
       }
     }
   }
+
+  for (size_t n = 0; n < mUnstored.size(); ++n)
+  {
+    UnstoredEntry& entry = mUnstored[n];
+
+    if (entry.severity == (unsigned int)(originalSeverity)
+        && (package == "all" || entry.package == package))
+    {
+      entry.severity = targetSeverity;
+      moveSeverityCount(originalSeverity, targetSeverity, entry.count, 0);
+    }
+  }
+}
+
+/*
+ * @return true if an error with the given id is stored in this log.
+ */
+bool
+XMLErrorLog::contains(const unsigned int errorId) const
+{
+  return getNumErrorsWithId(errorId) > 0;
+}
+
+
+/*
+ * @return the number of errors with the given id stored in this log.
+ */
+unsigned int
+XMLErrorLog::getNumErrorsWithId (unsigned int errorId) const
+{
+  unordered_map<unsigned int, IdEntry>::const_iterator it = 
+    mErrorsById.find(errorId);
+
+  return (it != mErrorsById.end()) ? it->second.stored : 0;
+}
+
+
+/*
+ * @return the number of times an error with the given id was logged.
+ */
+unsigned int
+XMLErrorLog::getNumLoggedWithId (unsigned int errorId) const
+{
+  unordered_map<unsigned int, IdEntry>::const_iterator it = 
+    mErrorsById.find(errorId);
+
+  return (it != mErrorsById.end()) ? it->second.count : 0;
 }
 
+
 /*
- * Helper class used by XMLErrorLog::contains.
+ * @return the first error logged with the given id, or NULL.
  */
-class MatchErrorId
+const XMLError*
+XMLErrorLog::getFirstErrorWithId (unsigned int errorId) const
 {
-public:
-  MatchErrorId(const unsigned int theId) : idToFind(theId) {};
+  unordered_map<unsigned int, IdEntry>::const_iterator it = 
+    mErrorsById.find(errorId);
 
-  bool operator() (XMLError* e) const
+  if (it == mErrorsById.end() || it->second.first == NOT_STORED)
   {
-    return e->getErrorId() == idToFind;
-  };
+    return NULL;
+  }
 
-private:
-  unsigned int idToFind;
-};
+  return mErrors[it->second.first];
+}
 
 
+/*
+ * @return the number of errors with the given severity stored in this
+ * log.
+ */
+unsigned int
+XMLErrorLog::getNumErrorsWithSeverity (unsigned int severity) const
+{
+  return (severity < mErrorsBySeverity.size()) 
+         ? mErrorsBySeverity[severity].stored : 0;
+}
 
 
-bool
-XMLErrorLog::contains(const unsigned int errorId) const
+/*
+ * @return the number of times an error with the given severity was
+ * logged.
+ */
+unsigned int
+XMLErrorLog::getNumLoggedWithSeverity (unsigned int severity) const
 {
-  vector<XMLError*>::const_iterator iter;
+  return (severity < mErrorsBySeverity.size()) 
+         ? mErrorsBySeverity[severity].count : 0;
+}
+
+
+/*
+ * Limits the number of errors this log stores.
+ */
+void
+XMLErrorLog::setMaxErrors (unsigned int max)
+{
+  mMaxErrors = max;
+}
+
+
+/*
+ * @return the most errors this log stores, or 0 if there is no limit.
+ */
+unsigned int
+XMLErrorLog::getMaxErrors () const
+{
+  return mMaxErrors;
+}
 
-  // finds an item with the given errorId (the first item will be found if
-  // there are two or more items with the same Id)
-  iter = find_if(mErrors.begin(), mErrors.end(), MatchErrorId(errorId));
 
-  if (iter != mErrors.end())
+/*
+ * @return the number of errors not stored because the log was full.
+ */
+unsigned int
+XMLErrorLog::getNumDroppedErrors () const
+{
+  return mNumDropped;
+}
+
+
+/*
+ * Turns the aggregation of repeated errors on or off.  Errors stored
+ * before it is turned on are indexed so that later repeats find them.
+ */
+void
+XMLErrorLog::setAggregateRepeats (bool aggregate)
+{
+  if (aggregate && !mAggregate)
+  {
+    for (unsigned int n = 0; n < mErrors.size(); ++n)
+    {
+      mRepeats.insert(make_pair(repeatHash(mErrors[n]->getErrorId(), 
+                                           mErrors[n]->mDetails), n));
+    }
+  }
+  else if (!aggregate)
   {
-    return true;
+    mRepeats.clear();
   }
-  else
+
+  mAggregate = aggregate;
+}
+
+
+/*
+ * @return true if repeated errors are aggregated.
+ */
+bool
+XMLErrorLog::getAggregateRepeats () const
+{
+  return mAggregate;
+}
+
+
+/*
+ * @return the number of times the nth error was logged.
+ */
+unsigned int
+XMLErrorLog::getNumOccurrences (unsigned int n) const
+{
+  return (n < mOccurrences.size()) ? mOccurrences[n] : 0;
+}
+
+
+/*
+ * Sets a function to receive each error instead of the error being
+ * stored.
+ */
+void
+XMLErrorLog::setCallback (XMLErrorCallback callback, void* userData)
+{
+  mCallback     = callback;
+  mCallbackData = userData;
+}
+
+
+/*
+ * Sets the number of errors of the given severity or worse at which
+ * streams reading into this log stop.
+ */
+void
+XMLErrorLog::setStopThreshold (unsigned int count, unsigned int severity)
+{
+  mStopCount    = count;
+  mStopSeverity = severity;
+}
+
+
+/*
+ * @return true if the stop threshold has been reached or the callback
+ * has asked to stop.
+ */
+bool
+XMLErrorLog::isStopRequested () const
+{
+  if (mStopRequested) return true;
+  if (mStopCount == 0) return false;
+
+  unsigned int count = 0;
+  for (size_t n = mStopSeverity; n < mErrorsBySeverity.size(); ++n)
   {
-    return false;
+    count += mErrorsBySeverity[n].count;
   }
+
+  return count >= mStopCount;
 }
 
 
+/*
+ * @return the bytes of memory this XMLErrorLog holds.
+ */
+size_t
+XMLErrorLog::getMemoryUsage () const
+{
+  XMLMemoryUsage usage;
+  return getMemoryUsage(usage);
+}
+
+
+/*
+ * Adds the memory this XMLErrorLog holds to usage.  The entries of the
+ * hash tables are taken to cost their value and a link each, and the
+ * tables a pointer per bucket, as in the common implementations.
+ */
+size_t
+XMLErrorLog::getMemoryUsage (XMLMemoryUsage& usage) const
+{
+  typedef unordered_map<unsigned int, IdEntry>::value_type IdValue;
+  typedef unordered_multimap<size_t, unsigned int>::value_type RepeatValue;
+
+  size_t bytes = sizeof(XMLErrorLog)
+               + mErrors.capacity()           * sizeof(XMLError*)
+               + mErrorsBySeverity.capacity() * sizeof(SeverityEntry)
+               + mOccurrences.capacity()      * sizeof(unsigned int)
+               + mErrorsById.bucket_count()   * sizeof(void*)
+               + mErrorsById.size()  * (sizeof(IdValue) + sizeof(void*))
+               + mRepeats.bucket_count()      * sizeof(void*)
+               + mRepeats.size()     * (sizeof(RepeatValue) + sizeof(void*))
+               + mUnstored.capacity()         * sizeof(UnstoredEntry);
+
+  for (size_t n = 0; n < mErrors.size(); ++n)
+  {
+    bytes += mErrors[n]->getMemoryUsage();
+  }
+
+  for (size_t n = 0; n < mUnstored.size(); ++n)
+  {
+    bytes += mUnstored[n].package.capacity();
+  }
+
+  usage.mErrors += bytes;
+  return bytes;
+}
 
 
 #endif /* __cplusplus */
@@ -450,6 +951,113 @@ XMLErrorLog_clearLog (XMLErrorLog_t *log)
 }
 
 
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumErrorsWithId (const XMLErrorLog_t *log, 
+                                unsigned int errorId)
+{
+  if (log == NULL) return 0;
+  return log->getNumErrorsWithId(errorId);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumLoggedWithId (const XMLErrorLog_t *log, 
+                                unsigned int errorId)
+{
+  if (log == NULL) return 0;
+  return log->getNumLoggedWithId(errorId);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumErrorsWithSeverity (const XMLErrorLog_t *log, 
+                                      unsigned int severity)
+{
+  if (log == NULL) return 0;
+  return log->getNumErrorsWithSeverity(severity);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumLoggedWithSeverity (const XMLErrorLog_t *log, 
+                                      unsigned int severity)
+{
+  if (log == NULL) return 0;
+  return log->getNumLoggedWithSeverity(severity);
+}
+
+
+LIBLX_EXTERN
+void
+XMLErrorLog_setMaxErrors (XMLErrorLog_t *log, unsigned int max)
+{
+  if (log == NULL) return;
+  log->setMaxErrors(max);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumDroppedErrors (const XMLErrorLog_t *log)
+{
+  if (log == NULL) return 0;
+  return log->getNumDroppedErrors();
+}
+
+
+LIBLX_EXTERN
+void
+XMLErrorLog_setAggregateRepeats (XMLErrorLog_t *log, int aggregate)
+{
+  if (log == NULL) return;
+  log->setAggregateRepeats(aggregate != 0);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumOccurrences (const XMLErrorLog_t *log, unsigned int n)
+{
+  if (log == NULL) return 0;
+  return log->getNumOccurrences(n);
+}
+
+
+LIBLX_EXTERN
+void
+XMLErrorLog_setCallback (  XMLErrorLog_t    *log
+                         , XMLErrorCallback callback
+                         , void             *userData )
+{
+  if (log == NULL) return;
+  log->setCallback(callback, userData);
+}
+
+
+LIBLX_EXTERN
+void
+XMLErrorLog_setStopThreshold (  XMLErrorLog_t *log
+                              , unsigned int  count
+                              , unsigned int  severity )
+{
+  if (log == NULL) return;
+  log->setStopThreshold(count, severity);
+}
+
+
+LIBLX_EXTERN
+int
+XMLErrorLog_isStopRequested (const XMLErrorLog_t *log)
+{
+  if (log == NULL) return 0;
+  return static_cast<int>(log->isStopRequested());
+}
+
+
 LIBLX_EXTERN
 char*
 XMLErrorLog_toString (XMLErrorLog_t *log)
@@ -490,6 +1098,15 @@ XMLErrorLog_setSeverityOverride (XMLErrorLog_t *log, XMLErrorSeverityOverride_t
   log->setSeverityOverride(overridden);
 }
 
+
+LIBLX_EXTERN
+unsigned long
+XMLErrorLog_getMemoryUsage (const XMLErrorLog_t *log)
+{
+  if (log == NULL) return 0;
+  return (unsigned long) log->getMemoryUsage();
+}
+
 LIBLX_CPP_NAMESPACE_END
 /** @endcond */
 
@@ -58,6 +58,26 @@
  * XMLErrorLog and simply wraps commands for working with SBMLError objects
  * rather than the low-level XMLError objects.  Classes such as
  * SBMLDocument use the higher-level SBMLErrorLog.
+ *
+ * A corrupt input can produce a great many errors, most of them alike.  A
+ * log can be told to store at most a given number of errors
+ * (setMaxErrors()), to store an error that repeats the id and message of
+ * one already stored only as a further occurrence of it
+ * (setAggregateRepeats()), or to pass each error to a callback instead of
+ * storing it (setCallback()).  The counts by id and severity cover every
+ * error logged, stored or not.  setStopThreshold() makes XMLInputStream
+ * objects reading into the log stop once enough serious errors have been
+ * logged:
+ *
+@code{.cpp}
+XMLErrorLog log;
+log.setMaxErrors(100);
+log.setAggregateRepeats(true);
+log.setStopThreshold(10, LIBLX_SEV_ERROR);
+
+XMLInputStream stream("feed.xml", true, "", &log);
+XMLNode root(stream);          // stops after the tenth error
+@endcode
  */
 
 /**
@@ -84,13 +104,35 @@
 
 #include <liblx/xml/common/extern.h>
 #include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLMemoryUsage.h>
 #include <liblx/xml/common/liblxfwd.h>
 
 
+LIBLX_CPP_NAMESPACE_BEGIN
+
+/**
+ * Function an XMLErrorLog calls with each error logged, instead of
+ * storing it, once set with XMLErrorLog::setCallback().
+ *
+ * @param error the error, with its severity overridden and its position
+ * filled in as the log would have stored it.  It is destroyed when the
+ * callback returns.
+ * @param userData the pointer given with the callback.
+ *
+ * @return @c 0 to continue, or any other value to ask streams reading
+ * into the log to stop.
+ */
+typedef int (*XMLErrorCallback) (  const XMLError_t* error
+                                 , void*             userData );
+
+LIBLX_CPP_NAMESPACE_END
+
+
 #ifdef __cplusplus
 
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <list>
 
@@ -364,7 +406,11 @@ public:
    * This method searches through the list of errors in the log, comparing
    * each one's severity to the value of @p originalSeverity.  For each error
    * encountered with that severity logged by the named @p package, the
-   * severity of the error is reset to @p targetSeverity.
+   * severity of the error is reset to @p targetSeverity.  The counts
+   * returned by getNumErrorsWithSeverity() and getNumLoggedWithSeverity()
+   * change with it, the latter for every repeat of an aggregated error
+   * and for the errors of that severity passed to the callback or dropped
+   * because the log was full.
    *
    * @copydetails doc_what_are_severity_overrides
    *
@@ -393,16 +439,307 @@ public:
   /**
   * Returns @c true if XMLErrorLog contains an errorId
   *
+  * The log keeps an index of the ids logged, so this takes constant time
+  * however many errors the log holds.  Only errors stored in the log, as
+  * returned by getError(), count; an error passed to the callback or
+  * dropped because the log was full does not.
+  *
   * @param errorId the error identifier of the error to be found.
+  *
+  * @see getNumLoggedWithId(unsigned int errorId)
   */
   bool contains(const unsigned int errorId) const;
 
+
+  /**
+   * Returns the number of errors with the given id in this log, in
+   * constant time.  Like getNumErrors(), this counts the errors stored, so
+   * an aggregated error counts once however often it was repeated.
+   *
+   * @param errorId the error identifier to count.
+   *
+   * @return the number of errors stored with @p errorId.
+   *
+   * @see getNumLoggedWithId(unsigned int errorId)
+   */
+  unsigned int getNumErrorsWithId (unsigned int errorId) const;
+
+
+  /**
+   * Returns the number of times an error with the given id was logged, in
+   * constant time.  This counts every repeat of an aggregated error, and
+   * errors passed to the callback or dropped because the log was full.
+   *
+   * @param errorId the error identifier to count.
+   *
+   * @return the number of errors logged with @p errorId.
+   */
+  unsigned int getNumLoggedWithId (unsigned int errorId) const;
+
+
+  /**
+   * Returns the first error logged with the given id, in constant time.
+   *
+   * @param errorId the error identifier to find.
+   *
+   * @return the first XMLError in this log with @p errorId, or @c NULL if
+   * there is none.
+   */
+  const XMLError* getFirstErrorWithId (unsigned int errorId) const;
+
+
+  /**
+   * Returns the number of errors with the given severity in this log, in
+   * constant time.  Like getNumErrorsWithId(), this counts the errors
+   * stored, so an aggregated error counts once however often it was
+   * repeated.
+   *
+   * @param severity the severity to count, such as
+   * @sbmlconstant{LIBLX_SEV_FATAL, XMLErrorSeverity_t}.
+   *
+   * @return the number of errors stored with @p severity.
+   *
+   * @see getNumLoggedWithSeverity(unsigned int severity)
+   */
+  unsigned int getNumErrorsWithSeverity (unsigned int severity) const;
+
+
+  /**
+   * Returns the number of times an error with the given severity was
+   * logged, in constant time.  Like getNumLoggedWithId(), this counts
+   * every repeat of an aggregated error, and errors passed to the callback
+   * or dropped because the log was full; this is the count
+   * setStopThreshold() is compared with.
+   *
+   * @param severity the severity to count, such as
+   * @sbmlconstant{LIBLX_SEV_FATAL, XMLErrorSeverity_t}.
+   *
+   * @return the number of errors logged with @p severity.
+   */
+  unsigned int getNumLoggedWithSeverity (unsigned int severity) const;
+
+
+  /**
+   * Limits the number of errors this log stores.  Errors logged once the
+   * limit is reached are counted, but neither stored nor passed on.
+   *
+   * @param max the most errors to store, or @c 0 for no limit, the
+   * default.
+   */
+  void setMaxErrors (unsigned int max);
+
+
+  /**
+   * @return the most errors this log stores, or @c 0 if there is no
+   * limit.
+   */
+  unsigned int getMaxErrors () const;
+
+
+  /**
+   * @return the number of errors logged but not stored because the limit
+   * set with setMaxErrors() had been reached.
+   */
+  unsigned int getNumDroppedErrors () const;
+
+
+  /**
+   * Turns the aggregation of repeated errors on or off.  With it on, an
+   * error with the same id and message as one already stored is not
+   * stored again; the stored one counts another occurrence instead, and
+   * keeps the position at which it was first logged.
+   *
+   * @param aggregate whether to aggregate repeated errors; off by
+   * default.
+   */
+  void setAggregateRepeats (bool aggregate);
+
+
+  /**
+   * @return @c true if repeated errors are aggregated.
+   */
+  bool getAggregateRepeats () const;
+
+
+  /**
+   * Returns the number of times the <i>n</i>th error was logged, which is
+   * more than one only if repeated errors are aggregated.
+   *
+   * @param n the index number of the error, from 0.
+   *
+   * @return the number of occurrences of the <i>n</i>th error, or @c 0 if
+   * @p n is out of range.
+   */
+  unsigned int getNumOccurrences (unsigned int n) const;
+
+
+  /**
+   * Sets a function to receive each error as it is logged, instead of
+   * the error being stored.  Errors passed to the callback are counted
+   * but do not appear in getError().
+   *
+   * @param callback the function to call, or @c NULL to store errors
+   * again.
+   * @param userData a pointer passed to each call.
+   */
+  void setCallback (XMLErrorCallback callback, void* userData = NULL);
+
+
+  /**
+   * Sets the point at which streams reading into this log stop: once
+   * @p count errors of severity @p severity or worse have been logged,
+   * an XMLInputStream using this log reads no further and reports
+   * isError().  Parsing also stops once the callback has asked it to.
+   *
+   * @param count the number of errors at which to stop, or @c 0 never to
+   * stop, the default.
+   * @param severity the least severity counted.
+   */
+  void setStopThreshold (unsigned int count, 
+                         unsigned int severity = LIBLX_SEV_FATAL);
+
+
+  /**
+   * @return @c true if enough errors have been logged to reach the
+   * threshold set with setStopThreshold(), or the callback has asked to
+   * stop.
+   */
+  bool isStopRequested () const;
+
+
+  /**
+   * Returns the bytes of memory this XMLErrorLog holds, counting the log
+   * itself, the errors it stores and its indexes of them.
+   *
+   * @return the bytes held by this XMLErrorLog.
+   *
+   * @see XMLMemoryUsage
+   */
+  size_t getMemoryUsage () const;
+
+
+  /**
+   * Adds the memory this XMLErrorLog holds to @p usage, as errors, and
+   * returns it.
+   *
+   * @param usage the XMLMemoryUsage to add to.
+   *
+   * @return the bytes held by this XMLErrorLog.
+   */
+  size_t getMemoryUsage (XMLMemoryUsage& usage) const;
+
 protected:
   /** @cond doxygenLibsbmlInternal */
+
+  /*
+   * Counts an error of the given id and severity.
+   */
+  void countError (unsigned int errorId, unsigned int severity);
+
+  /*
+   * Counts an error of the given severity that is not stored, so that
+   * changeErrorSeverity() can move it with the stored ones.
+   */
+  void countUnstored (const XMLError& error, unsigned int severity);
+
+  /*
+   * Moves count errors, stored of them stored, from one severity to
+   * another in the counts.
+   */
+  void moveSeverityCount (unsigned int from, unsigned int to,
+                          unsigned int count, unsigned int stored);
+
+  /*
+   * Gives error the severity the override calls for and, if it has no
+   * position, the position of the parser.
+   */
+  void prepareError (XMLError& error) const;
+
+  /*
+   * Stores error, which this log then owns.
+   */
+  void storeError (XMLError* error);
+
+  /*
+   * @return the index of a stored error with the id and message of
+   * error, or getNumErrors() if there is none.
+   */
+  unsigned int findRepeat (const XMLError& error) const;
+
+  /*
+   * Makes this log a copy of other, its errors, counts and settings, the
+   * callback apart.
+   */
+  void copyLog (const XMLErrorLog& other);
+
+  /*
+   * The number of errors logged with an id, the number of them stored,
+   * and the position of the first stored in mErrors.
+   */
+  struct IdEntry
+  {
+    unsigned int count;
+    unsigned int stored;
+    unsigned int first;
+  };
+
+  /*
+   * The number of errors logged with a severity and the number of them
+   * stored.
+   */
+  struct SeverityEntry
+  {
+    unsigned int count;
+    unsigned int stored;
+  };
+
+  /*
+   * @return the counts of errors with the given severity, growing the
+   * table to hold it.
+   */
+  SeverityEntry& severityEntry (unsigned int severity);
+
   std::vector<XMLError*> mErrors;
   const XMLParser*       mParser;
   XMLErrorSeverityOverride_t    mOverriddenSeverity;
 
+  /*
+   * Counts of the errors logged by id and by severity, kept up to date by
+   * add(), changeErrorSeverity() and clearLog().
+   */
+  std::unordered_map<unsigned int, IdEntry> mErrorsById;
+  std::vector<SeverityEntry>                mErrorsBySeverity;
+
+  /*
+   * The number of times each stored error was logged, and the stored
+   * errors by a hash of their id and message when repeats are
+   * aggregated.
+   */
+  std::vector<unsigned int>                 mOccurrences;
+  std::unordered_multimap<size_t, unsigned int> mRepeats;
+
+  /*
+   * The number of errors of a severity and package passed to the callback
+   * or dropped because the log was full.
+   */
+  struct UnstoredEntry
+  {
+    unsigned int severity;
+    std::string  package;
+    unsigned int count;
+  };
+
+  std::vector<UnstoredEntry>                mUnstored;
+
+  unsigned int      mMaxErrors;
+  unsigned int      mNumDropped;
+  bool              mAggregate;
+  XMLErrorCallback  mCallback;
+  void*             mCallbackData;
+  unsigned int      mStopCount;
+  unsigned int      mStopSeverity;
+  bool              mStopRequested;
+
   /** @endcond */
 };
 
@@ -494,6 +831,184 @@ LIBLX_EXTERN
 void
 XMLErrorLog_clearLog (XMLErrorLog_t *log);
 
+
+/**
+ * Returns the number of errors with the given id stored in this log.
+ *
+ * @param log XMLErrorLog_t, the error log to be queried.
+ * @param errorId the error identifier to count.
+ *
+ * @return the number of errors stored with @p errorId, or @c 0 if
+ * @p log is @c NULL.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumErrorsWithId (const XMLErrorLog_t *log, 
+                                unsigned int errorId);
+
+
+/**
+ * Returns the number of times an error with the given id was logged,
+ * counting repeats and errors not stored.
+ *
+ * @param log XMLErrorLog_t, the error log to be queried.
+ * @param errorId the error identifier to count.
+ *
+ * @return the number of errors logged with @p errorId, or @c 0 if
+ * @p log is @c NULL.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumLoggedWithId (const XMLErrorLog_t *log, 
+                                unsigned int errorId);
+
+
+/**
+ * Returns the number of errors with the given severity stored in this
+ * log.
+ *
+ * @param log XMLErrorLog_t, the error log to be queried.
+ * @param severity the severity to count.
+ *
+ * @return the number of errors stored with @p severity, or @c 0 if
+ * @p log is @c NULL.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumErrorsWithSeverity (const XMLErrorLog_t *log, 
+                                      unsigned int severity);
+
+
+/**
+ * Returns the number of times an error with the given severity was
+ * logged, counting repeats and errors not stored.
+ *
+ * @param log XMLErrorLog_t, the error log to be queried.
+ * @param severity the severity to count.
+ *
+ * @return the number of errors logged with @p severity, or @c 0 if
+ * @p log is @c NULL.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumLoggedWithSeverity (const XMLErrorLog_t *log, 
+                                      unsigned int severity);
+
+
+/**
+ * Limits the number of errors this log stores.
+ *
+ * @param log XMLErrorLog_t, the error log to change.
+ * @param max the most errors to store, or @c 0 for no limit.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+void
+XMLErrorLog_setMaxErrors (XMLErrorLog_t *log, unsigned int max);
+
+
+/**
+ * Returns the number of errors logged but not stored because the limit
+ * had been reached.
+ *
+ * @param log XMLErrorLog_t, the error log to be queried.
+ *
+ * @return the number of errors dropped, or @c 0 if @p log is @c NULL.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumDroppedErrors (const XMLErrorLog_t *log);
+
+
+/**
+ * Turns the aggregation of repeated errors on or off.
+ *
+ * @param log XMLErrorLog_t, the error log to change.
+ * @param aggregate nonzero to count repeated errors against the first.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+void
+XMLErrorLog_setAggregateRepeats (XMLErrorLog_t *log, int aggregate);
+
+
+/**
+ * Returns the number of times the <i>n</i>th error was logged.
+ *
+ * @param log XMLErrorLog_t, the error log to be queried.
+ * @param n the index number of the error, from 0.
+ *
+ * @return the number of occurrences, or @c 0 if @p log is @c NULL or
+ * @p n is out of range.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLErrorLog_getNumOccurrences (const XMLErrorLog_t *log, unsigned int n);
+
+
+/**
+ * Sets a function to receive each error as it is logged, instead of the
+ * error being stored.
+ *
+ * @param log XMLErrorLog_t, the error log to change.
+ * @param callback the function to call, or @c NULL to store errors again.
+ * @param userData a pointer passed to each call.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+void
+XMLErrorLog_setCallback (  XMLErrorLog_t    *log
+                         , XMLErrorCallback callback
+                         , void             *userData );
+
+
+/**
+ * Sets the number of errors of the given severity or worse at which
+ * streams reading into this log stop.
+ *
+ * @param log XMLErrorLog_t, the error log to change.
+ * @param count the number of errors at which to stop, or @c 0 never to
+ * stop.
+ * @param severity the least severity counted.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+void
+XMLErrorLog_setStopThreshold (  XMLErrorLog_t *log
+                              , unsigned int  count
+                              , unsigned int  severity );
+
+
+/**
+ * Returns whether streams reading into this log have been asked to stop.
+ *
+ * @param log XMLErrorLog_t, the error log to be queried.
+ *
+ * @return @c 1 if the threshold has been reached or the callback has
+ * asked to stop, @c 0 otherwise or if @p log is @c NULL.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+int
+XMLErrorLog_isStopRequested (const XMLErrorLog_t *log);
+
 /**
  * Writes all errors contained in this log to a string and returns it. 
  *
@@ -573,6 +1088,22 @@ void
 XMLErrorLog_setSeverityOverride (XMLErrorLog_t *log, XMLErrorSeverityOverride_t overridden);
 
 
+/**
+ * Returns the bytes of memory held by the given XMLErrorLog_t structure,
+ * counting the structure itself, the errors it stores and its indexes of
+ * them.
+ *
+ * @param log the XMLErrorLog_t structure.
+ *
+ * @return the bytes held, or @c 0 if @p log is @c NULL.
+ *
+ * @memberof XMLErrorLog_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLErrorLog_getMemoryUsage (const XMLErrorLog_t *log);
+
+
 END_C_DECLS
 LIBLX_CPP_NAMESPACE_END
 
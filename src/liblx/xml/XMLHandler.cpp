@@ -36,6 +36,7 @@
  * also available online as http://sbml.org/software/libsbml/license.html
  * ---------------------------------------------------------------------- -->*/
 
+#include <liblx/xml/XMLElementFilter.h>
 #include <liblx/xml/XMLHandler.h>
 #include <liblx/xml/XMLToken.h>
 
@@ -46,7 +47,9 @@ LIBLX_CPP_NAMESPACE_BEGIN
 /*
  * Creates a new XMLHandler.
  */
-XMLHandler::XMLHandler ()
+XMLHandler::XMLHandler () :
+   mSkipDepth ( 0    )
+ , mFilter    ( NULL )
 {
 }
 
@@ -54,7 +57,9 @@ XMLHandler::XMLHandler ()
 /**
  * Copy Constructor
  */
-XMLHandler::XMLHandler (const XMLHandler&)
+XMLHandler::XMLHandler (const XMLHandler& orig) :
+   mSkipDepth ( orig.mSkipDepth )
+ , mFilter    ( orig.mFilter    )
 {
 }
 
@@ -139,5 +144,97 @@ XMLHandler::characters (const XMLToken& )
 {
 }
 
+
+/*
+ * Receive notification of character data inside an element, as the bytes
+ * the XML library delivered.
+ */
+void
+XMLHandler::characters (const char* chars, size_t length)
+{
+  characters( XMLToken( string(chars, length) ) );
+}
+
+
+/*
+ * Sets the filter applied to every element the XML library reports.
+ */
+void
+XMLHandler::setElementFilter (const XMLElementFilter* filter)
+{
+  mFilter = filter;
+}
+
+
+/*
+ * Starts skipping events until depth elements have ended.
+ */
+void
+XMLHandler::skipElements (unsigned int depth)
+{
+  mSkipDepth = depth;
+}
+
+
+/*
+ * @return true if events are being skipped.
+ */
+bool
+XMLHandler::isSkipping () const
+{
+  return (mSkipDepth > 0);
+}
+
+
+/*
+ * Called at every start tag: inside an element being skipped, counts one
+ * more element to end.
+ */
+bool
+XMLHandler::skipStartElement ()
+{
+  if (mSkipDepth == 0) return false;
+
+  ++mSkipDepth;
+  return true;
+}
+
+
+/*
+ * Starts skipping the element if the filter says so.
+ */
+bool
+XMLHandler::filterElement (const string& name, const string& uri)
+{
+  if (mFilter == NULL || !mFilter->skips(name, uri)) return false;
+
+  mSkipDepth = 1;
+  return true;
+}
+
+
+/*
+ * @return true if an element filter is set.
+ */
+bool
+XMLHandler::hasElementFilter () const
+{
+  return (mFilter != NULL);
+}
+
+
+/*
+ * Called at every end tag: inside an element being skipped, counts one
+ * element fewer to end.
+ */
+bool
+XMLHandler::skipEndElement ()
+{
+  if (mSkipDepth == 0) return false;
+
+  --mSkipDepth;
+  return true;
+}
+
 LIBLX_CPP_NAMESPACE_END
 /** @endcond */
@@ -52,6 +52,7 @@
 
 LIBLX_CPP_NAMESPACE_BEGIN
 
+class XMLElementFilter;
 class XMLToken;
 
 class LIBLX_EXTERN XMLHandler
@@ -131,6 +132,82 @@ public:
    * to take specific actions for each chunk of character data.
    */
   virtual void characters (const XMLToken& data);
+
+
+  /**
+   * Receive notification of character data inside an element, as the
+   * bytes the XML library delivered.  Backends call this rather than
+   * building an XMLToken themselves, so that a handler which has no use
+   * for the characters need not pay for one.
+   *
+   * By default, pass a text XMLToken holding the characters to
+   * characters(const XMLToken&).
+   */
+  virtual void characters (const char* chars, size_t length);
+
+
+  /**
+   * Sets the filter applied to every element the XML library reports.  An
+   * element the filter skips is not passed to startElement(), and neither
+   * is anything inside it.
+   *
+   * @param filter the filter, which must outlive its use by this handler,
+   * or @c NULL for none.
+   */
+  void setElementFilter (const XMLElementFilter* filter);
+
+
+  /**
+   * Starts skipping the events of the XML library until @p depth elements
+   * have ended, none of those events being passed on.
+   */
+  void skipElements (unsigned int depth);
+
+
+  /**
+   * @return @c true if the events of the XML library are being skipped.
+   */
+  bool isSkipping () const;
+
+
+  /*
+   * The backends call these before making an XMLToken for an event, so
+   * that no token is made for an element that is skipped or for anything
+   * inside it.  Character data is dropped when isSkipping() is true.
+   */
+
+  /*
+   * Called at every start tag.  @return true if the element is inside one
+   * being skipped, in which case the backend reports nothing.
+   */
+  bool skipStartElement ();
+
+  /*
+   * Called at a start tag once skipStartElement() has returned false.
+   * @return true if the filter skips the element, which then starts being
+   * skipped; the backend reports nothing.
+   */
+  bool filterElement (const std::string& name, const std::string& uri);
+
+  /*
+   * @return true if an element filter is set, so that the backend knows
+   * whether it must find the name and URI for filterElement().
+   */
+  bool hasElementFilter () const;
+
+  /*
+   * Called at every end tag.  @return true if the end belongs to an
+   * element being skipped, in which case the backend reports nothing.
+   */
+  bool skipEndElement ();
+
+
+protected:
+
+  /* the number of elements still to end before events are passed on
+     again, and the filter applied to each start tag */
+  unsigned int            mSkipDepth;
+  const XMLElementFilter* mFilter;
 };
 
 LIBLX_CPP_NAMESPACE_END
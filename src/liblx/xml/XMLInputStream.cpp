@@ -36,8 +36,12 @@
  * also available online as http://sbml.org/software/libsbml/license.html
  * ---------------------------------------------------------------------- -->*/
 
+#include <liblx/xml/XMLElementFilter.h>
 #include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLParseStats.h>
 #include <liblx/xml/XMLParser.h>
+#include <liblx/xml/XMLParserPool.h>
+#include <liblx/xml/XMLTrace.h>
 
 #include <liblx/xml/XMLInputStream.h>
 
@@ -64,6 +68,10 @@ XMLInputStream::XMLInputStream (  const char*   content
    mIsError ( false )
  , mParser  ( XMLParser::create( mTokenizer, library) )
  , mXMLns  ( NULL )
+ , mPool   ( NULL )
+ , mStats  ( NULL )
+ , mResource ( NULL )
+ , mFilter   ( NULL )
 {
   // if the content points to nothing throw an exception ??
   //if (content == NULL)
@@ -71,9 +79,39 @@ XMLInputStream::XMLInputStream (  const char*   content
 
   if ( !isGood() ) return;
   if ( errorLog != NULL ) setErrorLog(errorLog);
+  mParser->resetReadCounts();
   // if this fails we should probably flag the stream as error
   if (!mParser->parseFirst(content, isFile))
     mIsError = true; 
+
+  LIBLX_TRACE3(stream__create, this, isFile, library.c_str());
+}
+
+
+/*
+ * Creates a new XMLInputStream whose parser is taken from pool.
+ */
+XMLInputStream::XMLInputStream (  const char*        content
+                                , bool               isFile
+                                , XMLParserPool&     pool
+                                , const std::string  library
+                                , XMLErrorLog*       errorLog ) :
+   mIsError ( false )
+ , mParser  ( pool.acquire( mTokenizer, library) )
+ , mXMLns   ( NULL    )
+ , mPool    ( &pool   )
+ , mLibrary ( library )
+ , mStats   ( NULL    )
+ , mResource( NULL    )
+ , mFilter  ( NULL    )
+{
+  if ( !isGood() ) return;
+  if ( errorLog != NULL ) setErrorLog(errorLog);
+  mParser->resetReadCounts();
+  if (!mParser->parseFirst(content, isFile))
+    mIsError = true;
+
+  LIBLX_TRACE3(stream__create, this, isFile, library.c_str());
 }
 
  /**
@@ -83,6 +121,10 @@ XMLInputStream::XMLInputStream (  const char*   content
    : mIsError(true)   
    , mParser(NULL)
    , mXMLns(NULL)
+   , mPool(NULL)
+   , mStats(NULL)
+   , mResource(NULL)
+   , mFilter(NULL)
  {
  }
 
@@ -103,6 +145,9 @@ XMLInputStream::XMLInputStream (  const char*   content
  */
 XMLInputStream::~XMLInputStream ()
 {
+  LIBLX_TRACE3(stream__destroy, this,
+               (mParser != NULL) ? mParser->getBytesRead() : 0, mIsError);
+
   if ( mParser != NULL )
   {
      /**
@@ -114,8 +159,13 @@ XMLInputStream::~XMLInputStream ()
     XMLErrorLog* errorLog = mParser->getErrorLog();
     if ( errorLog != NULL ) errorLog->setParser(NULL);
   }
-  delete mParser;
+  if ( mPool != NULL )
+    mPool->release(mParser, mLibrary);
+  else
+    delete mParser;
   delete mXMLns;
+  delete mStats;
+  delete mFilter;
 }
 
 
@@ -190,7 +240,10 @@ XMLToken
 XMLInputStream::next ()
 {
   queueToken();
-  return mTokenizer.hasNext() ? mTokenizer.next() : XMLToken();
+  if ( !mTokenizer.hasNext() ) return XMLToken();
+
+  if ( mStats != NULL ) countToken( mTokenizer.peek() );
+  return mTokenizer.next();
 }
 
 
@@ -210,24 +263,76 @@ XMLInputStream::peek ()
 
 /*
  * Runs mParser until mTokenizer is ready to deliver at least one XMLToken
- * or a fatal error occurs.
+ * or a fatal error occurs.  Parsing also stops, as though at an error,
+ * once the error log asks for it (XMLErrorLog::isStopRequested()).
+ *
+ * When statistics are collected they are brought up to date here, so
+ * that they stay current between calls to getStats().  When the stream
+ * is timed, the time since it last returned to its caller is counted as
+ * the caller's, and the time in parseNext() as the parser's.
  */
 void
 XMLInputStream::queueToken ()
 {
   if ( !isGood() ) return;
 
+  const bool timed = (mStats != NULL && mStats->mTimed);
+  if (timed && mStats->mLastReturn > 0)
+  {
+    mStats->mConsumerTime += XMLParseStats::now() - mStats->mLastReturn;
+  }
+
+  const XMLErrorLog* log = mParser->getErrorLog();
   bool success = true;
 
   while ( success && mTokenizer.hasNext() == false )
   {
-    success = mParser->parseNext();
+    if (log != NULL && log->isStopRequested())
+    {
+      mIsError = true;
+      return;
+    }
+
+    if (timed)
+    {
+      const double start = XMLParseStats::now();
+      success = parseChunk();
+      mStats->mParseTime += XMLParseStats::now() - start;
+    }
+    else
+    {
+      success = parseChunk();
+    }
   }
 
   if (success == false && isEOF() == false)
   {
     mIsError = true;
   }
+
+  if (mStats != NULL)
+  {
+    if (mTokenizer.mTokens.size() > mStats->mPeakQueueDepth)
+    {
+      mStats->mPeakQueueDepth = mTokenizer.mTokens.size();
+    }
+    refreshStats();
+    if (timed) mStats->mLastReturn = XMLParseStats::now();
+  }
+}
+
+
+/*
+ * Counts token, about to be delivered, in mStats.
+ */
+void
+XMLInputStream::countToken (const XMLToken& token)
+{
+  ++mStats->mNumTokens;
+
+  if (token.isStart()) ++mStats->mNumStartElements;
+  if (token.isEnd())   ++mStats->mNumEndElements;
+  if (token.isText())  ++mStats->mNumTextTokens;
 }
 
 
@@ -238,7 +343,14 @@ XMLInputStream::requeueToken ()
   if ( !isGood() ) return success;
   else if (this->mTokenizer.mEOFSeen == true) return success;
 
-  success = mParser->parseNext();
+  const XMLErrorLog* log = mParser->getErrorLog();
+  if (log != NULL && log->isStopRequested())
+  {
+    mIsError = true;
+    return success;
+  }
+
+  success = parseChunk();
 
   if (success == false && isEOF() == false)
   {
@@ -249,6 +361,24 @@ XMLInputStream::requeueToken ()
 }
 
 
+/*
+ * Runs mParser once, telling any tracer what it read and produced.
+ */
+bool
+XMLInputStream::parseChunk ()
+{
+  const unsigned long read   = mParser->getBytesRead();
+  const size_t        queued = mTokenizer.mTokens.size();
+
+  const bool success = mParser->parseNext();
+
+  LIBLX_TRACE3(parse__chunk, this, mParser->getBytesRead() - read,
+               mTokenizer.mTokens.size() - queued);
+
+  return success;
+}
+
+
 /*
  * Sets the XMLErrorLog this stream will use to log errors.
  */
@@ -268,8 +398,57 @@ XMLInputStream::skipPastEnd (const XMLToken& element)
 {
   if ( element.isEnd() ) return;
 
-  while ( isGood() && !peek().isEndFor(element) ) next();
-  next();
+  unsigned int depth = 1;
+
+  /* the element itself, if it has only been peeked at; element may be
+     the very token peek() returned, and is not used once it is gone */
+  if ( mTokenizer.hasNext() )
+  {
+    const XMLToken& token = mTokenizer.peek();
+
+    if ( &token == &element ||
+         ( token.isStart()                          &&
+           token.getLine()   == element.getLine()   &&
+           token.getColumn() == element.getColumn() &&
+           token.getName()   == element.getName()   &&
+           token.getURI()    == element.getURI() ) )
+    {
+      skipToken();
+    }
+  }
+
+  /* first the tokens already read ahead */
+  while ( depth > 0 && mTokenizer.hasNext() )
+  {
+    const XMLToken& token = mTokenizer.peek();
+
+    if ( token.isStart() && !token.isEnd() )
+    {
+      ++depth;
+    }
+    else if ( token.isEnd() && !token.isStart() )
+    {
+      --depth;
+    }
+
+    skipToken();
+  }
+
+  if ( depth == 0 || !isGood() ) return;
+
+  /*
+   * Then the rest, as it is parsed.  Whatever the tokenizer is holding
+   * back lies inside the element: a start tag is one more element to end,
+   * and text is dropped with it.
+   */
+  if ( mTokenizer.mInStart ) ++depth;
+
+  mTokenizer.mInStart = false;
+  mTokenizer.mInChars = false;
+  mTokenizer.mSpace.clear();
+  mTokenizer.skipElements(depth);
+
+  while ( mTokenizer.isSkipping() && requeueToken() ) ;
 }
 
 
@@ -284,6 +463,20 @@ XMLInputStream::skipText ()
 }
 
 
+/*
+ * Consume the next token without returning it.
+ */
+void
+XMLInputStream::skipToken ()
+{
+  queueToken();
+  if ( !mTokenizer.hasNext() ) return;
+
+  if ( mStats != NULL ) countToken( mTokenizer.peek() );
+  mTokenizer.discard();
+}
+
+
 /*
  * Prints a string representation of the underlying token stream, for
  * debugging purposes.
@@ -294,6 +487,181 @@ XMLInputStream::toString ()
   return mTokenizer.toString();
 }
 
+/*
+ * Starts collecting statistics on this stream, afresh if they were being
+ * collected already.
+ */
+void
+XMLInputStream::enableStats (bool timed)
+{
+  if (mStats == NULL)
+  {
+    mStats = new XMLParseStats(timed);
+  }
+  else
+  {
+    *mStats = XMLParseStats(timed);
+  }
+
+  mStats->mCoalescedBase  = mTokenizer.mNumCoalesced;
+  mStats->mWhitespaceBase = mTokenizer.mNumWhitespaceDropped;
+  mStats->mPeakQueueDepth = mTokenizer.mTokens.size();
+
+  const XMLErrorLog* log = (mParser != NULL) ? mParser->getErrorLog() : NULL;
+  if (log != NULL)
+  {
+    mStats->mErrorsBase = log->getNumErrors() + log->getNumDroppedErrors();
+  }
+
+  mTokenizer.mStats = timed ? mStats : NULL;
+}
+
+
+/*
+ * Stops collecting statistics on this stream.
+ */
+void
+XMLInputStream::disableStats ()
+{
+  mTokenizer.mStats = NULL;
+  delete mStats;
+  mStats = NULL;
+}
+
+
+/*
+ * @return the statistics collected on this stream, brought up to date, or
+ * NULL if none are being collected.
+ */
+const XMLParseStats*
+XMLInputStream::getStats ()
+{
+  if (mStats != NULL) refreshStats();
+  return mStats;
+}
+
+
+/*
+ * Sets the resource from which trees read from this stream are allocated.
+ */
+void
+XMLInputStream::setMemoryResource (XMLMemoryResource* resource)
+{
+  mResource = resource;
+}
+
+
+/*
+ * @return the resource from which trees read from this stream are
+ * allocated.
+ */
+XMLMemoryResource*
+XMLInputStream::getMemoryResource () const
+{
+  return (mResource != NULL) ? mResource : XMLMemoryResource::getDefault();
+}
+
+
+/*
+ * Sets the filter deciding which elements are skipped as they are parsed.
+ */
+void
+XMLInputStream::setElementFilter (const XMLElementFilter* filter)
+{
+  delete mFilter;
+  mFilter = (filter != NULL) ? new XMLElementFilter(*filter) : NULL;
+
+  mTokenizer.setElementFilter(mFilter);
+}
+
+
+/*
+ * @return the filter deciding which elements are skipped, or NULL.
+ */
+const XMLElementFilter*
+XMLInputStream::getElementFilter () const
+{
+  return mFilter;
+}
+
+
+/*
+ * Sets whether whitespace-only character data is dropped by the tokenizer.
+ */
+void
+XMLInputStream::setIgnoreWhitespace (bool ignore)
+{
+  mTokenizer.setIgnoreWhitespace(ignore);
+}
+
+
+/*
+ * @return true if whitespace-only character data is dropped.
+ */
+bool
+XMLInputStream::getIgnoreWhitespace () const
+{
+  return mTokenizer.getIgnoreWhitespace();
+}
+
+
+/*
+ * @return the bytes of memory held by the tokens this stream has queued.
+ */
+size_t
+XMLInputStream::getMemoryUsage () const
+{
+  XMLMemoryUsage usage;
+  return getMemoryUsage(usage);
+}
+
+
+/*
+ * Adds the tokens the tokenizer has queued, and the one it is still
+ * building, to usage.
+ */
+size_t
+XMLInputStream::getMemoryUsage (XMLMemoryUsage& usage) const
+{
+  size_t bytes = mTokenizer.mCurrent.getMemoryUsage(usage);
+
+  for (size_t n = 0; n < mTokenizer.mTokens.size(); ++n)
+  {
+    bytes += mTokenizer.mTokens[n].getMemoryUsage(usage);
+  }
+
+  return bytes;
+}
+
+
+/*
+ * Copies the counts kept by the parser, the tokenizer and the error log
+ * into mStats.
+ */
+void
+XMLInputStream::refreshStats ()
+{
+  if (mParser == NULL) return;
+
+  mStats->mBytesRead    = mParser->getBytesRead();
+  mStats->mNumChunks    = mParser->getNumChunks();
+  mStats->mNumCoalesced = mTokenizer.mNumCoalesced - mStats->mCoalescedBase;
+  mStats->mNumWhitespaceDropped = mTokenizer.mNumWhitespaceDropped
+                                - mStats->mWhitespaceBase;
+
+  const XMLErrorLog* log = mParser->getErrorLog();
+  if (log != NULL)
+  {
+    const unsigned long errors = log->getNumErrors()
+                               + log->getNumDroppedErrors();
+
+    /* the log may have been cleared since collection began */
+    if (errors < mStats->mErrorsBase) mStats->mErrorsBase = 0;
+    mStats->mNumErrors = errors - mStats->mErrorsBase;
+  }
+}
+
+
 XMLNamespaces *
 XMLInputStream::getXMLNamespaces()
 {
@@ -388,6 +756,16 @@ XMLInputStream_create (const char* content, int isFile, const char *library)
 }
 
 
+LIBLX_EXTERN
+XMLInputStream_t *
+XMLInputStream_createWithPool (const char* content, int isFile,
+                               XMLParserPool_t *pool, const char *library)
+{
+  if (content == NULL || pool == NULL || library == NULL) return NULL;
+  return new(nothrow) XMLInputStream(content, isFile, *pool, library);
+}
+
+
 LIBLX_EXTERN
 void
 XMLInputStream_free (XMLInputStream_t *stream)
@@ -479,6 +857,15 @@ XMLInputStream_skipText (XMLInputStream_t *stream)
 }
 
 
+LIBLX_EXTERN
+void
+XMLInputStream_skipToken (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return;
+  stream->skipToken();
+}
+
+
 LIBLX_EXTERN
 int
 XMLInputStream_setErrorLog (XMLInputStream_t *stream, XMLErrorLog_t *log)
@@ -488,5 +875,60 @@ XMLInputStream_setErrorLog (XMLInputStream_t *stream, XMLErrorLog_t *log)
 }
 
 
+LIBLX_EXTERN
+void
+XMLInputStream_enableStats (XMLInputStream_t *stream, int timed)
+{
+  if (stream == NULL) return;
+  stream->enableStats(timed != 0);
+}
+
+
+LIBLX_EXTERN
+void
+XMLInputStream_setElementFilter (  XMLInputStream_t *stream
+                                 , const XMLElementFilter_t *filter )
+{
+  if (stream == NULL) return;
+  stream->setElementFilter(filter);
+}
+
+
+LIBLX_EXTERN
+void
+XMLInputStream_setIgnoreWhitespace (XMLInputStream_t *stream, int ignore)
+{
+  if (stream == NULL) return;
+  stream->setIgnoreWhitespace(ignore != 0);
+}
+
+
+LIBLX_EXTERN
+int
+XMLInputStream_getIgnoreWhitespace (const XMLInputStream_t *stream)
+{
+  if (stream == NULL) return 0;
+  return static_cast<int>(stream->getIgnoreWhitespace());
+}
+
+
+LIBLX_EXTERN
+void
+XMLInputStream_disableStats (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return;
+  stream->disableStats();
+}
+
+
+LIBLX_EXTERN
+const XMLParseStats_t *
+XMLInputStream_getStats (XMLInputStream_t *stream)
+{
+  if (stream == NULL) return NULL;
+  return stream->getStats();
+}
+
+
 LIBLX_CPP_NAMESPACE_END
 /** @endcond */
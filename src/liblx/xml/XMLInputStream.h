@@ -118,12 +118,16 @@
 
 #include <string>
 
+#include <liblx/xml/XMLMemoryResource.h>
+#include <liblx/xml/XMLParseStats.h>
 #include <liblx/xml/XMLTokenizer.h>
 
 LIBLX_CPP_NAMESPACE_BEGIN
 
+class XMLElementFilter;
 class XMLErrorLog;
 class XMLParser;
+class XMLParserPool;
 class XMLNamespaces;
 
 
@@ -153,6 +157,33 @@ public:
                   , XMLErrorLog*       errorLog = NULL );
 
 
+  /**
+   * Creates a new XMLInputStream whose parser is taken from @p pool and
+   * returned to it when the stream is destroyed.
+   *
+   * @param content the source of the stream.
+   *
+   * @param isFile a boolean flag to indicate whether @p content is a file
+   * name.
+   *
+   * @param pool the XMLParserPool to take the parser from, which must
+   * outlive this stream.
+   *
+   * @param library the name of the parser library to use.
+   *
+   * @param errorLog the XMLErrorLog object to use.
+   *
+   * @see XMLParserPool
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLInputStream (  const char*        content
+                  , bool               isFile
+                  , XMLParserPool&     pool
+                  , const std::string  library  = ""
+                  , XMLErrorLog*       errorLog = NULL );
+
+
   /**
    * Destroys this XMLInputStream.
    */
@@ -251,7 +282,15 @@ public:
    * Consume zero or more tokens up to and including the corresponding end
    * element or EOF.
    *
-   * @param element the element whose end will be sought in the input stream.
+   * Elements nested inside @p element are counted, so that the end found
+   * is that of @p element itself even when they have the same name.  Once
+   * the tokens already read ahead are used up, the rest of the element is
+   * skipped as the XML library parses it, without tokens being made for
+   * it.
+   *
+   * @param element the start element whose end will be sought in the
+   * input stream, normally the last token returned by next().  If it is
+   * instead the token peek() would return, it is consumed first.
    */
   void skipPastEnd (const XMLToken& element);
 
@@ -263,6 +302,13 @@ public:
   void skipText ();
 
 
+  /**
+   * Consume the next token without returning it.  Unlike next(), this does
+   * not copy the token.
+   */
+  void skipToken ();
+
+
   /**
    * Sets the XMLErrorLog this stream will use to log errors.
    *
@@ -379,6 +425,147 @@ public:
   bool containsChild(const std::string& childName,
                                             const std::string& container);
 
+
+  /**
+   * Starts collecting statistics on this stream: how much of the document
+   * has been read, how many tokens of each kind were delivered, and so on.
+   * Until this is called the stream keeps no statistics and spends no time
+   * on them.
+   *
+   * Calling this again starts the counts afresh.
+   *
+   * @param timed whether to split the time spent reading between the XML
+   * library, the tokenizer and the caller as well.  Timing reads the clock
+   * on every request for a token.
+   *
+   * @see getStats()
+   * @see XMLParseStats
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  void enableStats (bool timed = false);
+
+
+  /**
+   * Stops collecting statistics on this stream and discards those
+   * collected.
+   */
+  void disableStats ();
+
+
+  /**
+   * Returns the statistics collected on this stream, brought up to date.
+   * The object is owned by the stream and stays valid until the stream is
+   * destroyed or disableStats() is called.  The stream keeps it current as
+   * tokens are read, so it may be held on to and looked at while the
+   * stream is read.
+   *
+   * @return the XMLParseStats of this stream, or @c NULL if statistics
+   * are not being collected.
+   *
+   * @see enableStats()
+   */
+  const XMLParseStats* getStats ();
+
+
+  /**
+   * Sets the resource from which XMLNode trees read from this stream take
+   * their memory.  XMLNode(XMLInputStream&) allocates the lists of
+   * children, and every node below the one constructed, from it.
+   *
+   * The resource is not owned by the stream and must outlive every node
+   * read with it.
+   *
+   * @param resource the resource to use, or @c NULL for the default.
+   *
+   * @see XMLMemoryResource
+   */
+  void setMemoryResource (XMLMemoryResource* resource);
+
+
+  /**
+   * Returns the resource from which XMLNode trees read from this stream
+   * take their memory.
+   *
+   * @return the resource set with setMemoryResource(), or the default
+   * resource if none was.
+   */
+  XMLMemoryResource* getMemoryResource () const;
+
+
+  /**
+   * Sets whether character data made only of whitespace (spaces, tabs,
+   * carriage returns and line feeds) between elements is to be dropped as
+   * it is read, before any token is made for it.  On an indented document
+   * this is most of the text the XML library delivers, and the tokens
+   * XMLNode(XMLInputStream&) would otherwise build only to throw away.
+   *
+   * Whitespace next to other characters, as in mixed content, is kept;
+   * only runs of whitespace between one tag and the next are dropped.  Set
+   * this before the first token is read.
+   *
+   * @param ignore @c true to drop whitespace-only character data.
+   *
+   * @see XMLParseStats::getNumWhitespaceDropped()
+   */
+  void setIgnoreWhitespace (bool ignore);
+
+
+  /**
+   * Returns whether whitespace-only character data is being dropped.
+   *
+   * @return @c true if setIgnoreWhitespace() was last called with
+   * @c true, @c false otherwise.
+   */
+  bool getIgnoreWhitespace () const;
+
+
+  /**
+   * Sets the filter deciding which elements are skipped, with everything
+   * inside them, as the document is parsed.  No tokens are made for the
+   * elements skipped.  Set this before the first token is read: elements
+   * already read ahead by the stream are not filtered.
+   *
+   * @param filter the filter to use, which is copied, or @c NULL to stop
+   * filtering.
+   *
+   * @see XMLElementFilter
+   */
+  void setElementFilter (const XMLElementFilter* filter);
+
+
+  /**
+   * Returns the filter deciding which elements are skipped.
+   *
+   * @return this stream's copy of the filter set with setElementFilter(),
+   * or @c NULL if there is none.
+   */
+  const XMLElementFilter* getElementFilter () const;
+
+
+  /**
+   * Returns the bytes of memory held by the tokens this stream has read
+   * from the document and not yet delivered, counting the tokens
+   * themselves, their characters, attributes and namespaces.  The buffers
+   * of the XML library are not included.
+   *
+   * @return the bytes held by the queued tokens.
+   *
+   * @see XMLMemoryUsage
+   */
+  size_t getMemoryUsage () const;
+
+
+  /**
+   * Adds the memory held by the tokens this stream has queued to
+   * @p usage, split by kind, and returns it.
+   *
+   * @param usage the XMLMemoryUsage to add to.
+   *
+   * @return the bytes held by the queued tokens.
+   */
+  size_t getMemoryUsage (XMLMemoryUsage& usage) const;
+
 private:
   /** @cond doxygenLibsbmlInternal */
   /**
@@ -414,6 +601,24 @@ protected:
   bool requeueToken ();
 
 
+  /**
+   * Runs mParser on the next chunk of the document.
+   */
+  bool parseChunk ();
+
+
+  /**
+   * Counts token, about to be delivered, in mStats.
+   */
+  void countToken (const XMLToken& token);
+
+
+  /**
+   * Brings mStats up to date with the counts kept elsewhere.
+   */
+  void refreshStats ();
+
+
   bool mIsError;
 
   XMLToken     mEOF;
@@ -422,6 +627,19 @@ protected:
 
   XMLNamespaces* mXMLns;
 
+  /* the pool mParser came from, if any, and the library it was asked for */
+  XMLParserPool* mPool;
+  std::string    mLibrary;
+
+  /* the statistics being collected, or NULL */
+  XMLParseStats* mStats;
+
+  /* where trees read from the stream are allocated, or NULL */
+  XMLMemoryResource* mResource;
+
+  /* the elements skipped as they are parsed, or NULL */
+  XMLElementFilter*  mFilter;
+
   /** @endcond */
 };
 
@@ -459,6 +677,30 @@ XMLInputStream_t *
 XMLInputStream_create (const char* content, int isFile, const char *library);
 
 
+/**
+ * Creates a new XMLInputStream_t structure whose parser is taken from the
+ * given pool.
+ *
+ * @param content the source of the stream.
+ *
+ * @param isFile nonzero if @p content is a file name.
+ *
+ * @param pool the XMLParserPool_t to take the parser from, which must
+ * outlive the stream.
+ *
+ * @param library the name of the parser library to use.
+ *
+ * @return pointer to the XMLInputStream_t structure created, or @c NULL if
+ * any argument is @c NULL.
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+XMLInputStream_t *
+XMLInputStream_createWithPool (const char* content, int isFile,
+                               XMLParserPool_t *pool, const char *library);
+
+
 /**
  * Destroys this XMLInputStream_t structure.
  *
@@ -616,6 +858,18 @@ void
 XMLInputStream_skipText (XMLInputStream_t *stream);
 
 
+/**
+ * Consume the next token without returning it.
+ *
+ * @param stream the XMLInputStream_t structure to act on.
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+void
+XMLInputStream_skipToken (XMLInputStream_t *stream);
+
+
 /**
  * Sets the XMLErrorLog this stream will use to log errors.
  *
@@ -634,6 +888,95 @@ int
 XMLInputStream_setErrorLog (XMLInputStream_t *stream, XMLErrorLog_t *log);
 
 
+/**
+ * Starts collecting statistics on the given stream.
+ *
+ * @param stream the XMLInputStream_t structure.
+ *
+ * @param timed nonzero to measure where time is spent as well.
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+void
+XMLInputStream_enableStats (XMLInputStream_t *stream, int timed);
+
+
+/**
+ * Sets the filter deciding which elements are skipped as the given stream
+ * is parsed.
+ *
+ * @param stream the XMLInputStream_t structure.
+ *
+ * @param filter the XMLElementFilter_t to copy, or @c NULL to stop
+ * filtering.
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+void
+XMLInputStream_setElementFilter (  XMLInputStream_t *stream
+                                 , const XMLElementFilter_t *filter );
+
+
+/**
+ * Sets whether whitespace-only character data between elements is
+ * dropped as the given stream is read.
+ *
+ * @param stream the XMLInputStream_t structure.
+ *
+ * @param ignore nonzero to drop whitespace-only character data.
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+void
+XMLInputStream_setIgnoreWhitespace (XMLInputStream_t *stream, int ignore);
+
+
+/**
+ * Returns whether whitespace-only character data is dropped as the given
+ * stream is read.
+ *
+ * @param stream the XMLInputStream_t structure.
+ *
+ * @return @c 1 if it is dropped, @c 0 otherwise or if @p stream is
+ * @c NULL.
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+int
+XMLInputStream_getIgnoreWhitespace (const XMLInputStream_t *stream);
+
+
+/**
+ * Stops collecting statistics on the given stream.
+ *
+ * @param stream the XMLInputStream_t structure.
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+void
+XMLInputStream_disableStats (XMLInputStream_t *stream);
+
+
+/**
+ * Returns the statistics collected on the given stream.
+ *
+ * @param stream the XMLInputStream_t structure.
+ *
+ * @return the XMLParseStats_t of @p stream, owned by it, or @c NULL if
+ * statistics are not being collected or @p stream is @c NULL.
+ *
+ * @memberof XMLInputStream_t
+ */
+LIBLX_EXTERN
+const XMLParseStats_t *
+XMLInputStream_getStats (XMLInputStream_t *stream);
+
+
 END_C_DECLS
 
 LIBLX_CPP_NAMESPACE_END
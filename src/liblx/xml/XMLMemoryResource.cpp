@@ -0,0 +1,294 @@
+/**
+ * @file    XMLMemoryResource.cpp
+ * @brief   Sources of memory for XMLNode trees
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <new>
+
+#include <liblx/xml/XMLMemoryResource.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+const size_t XMLMemoryResource::DEFAULT_ALIGNMENT = alignof(max_align_t);
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * The default resource: operator new and operator delete, which align
+ * blocks for any type but no further.
+ */
+class NewDeleteResource : public XMLMemoryResource
+{
+protected:
+
+  virtual void* doAllocate (size_t bytes, size_t alignment)
+  {
+    if (alignment > DEFAULT_ALIGNMENT) throw bad_alloc();
+    return ::operator new(bytes);
+  }
+
+  virtual void doDeallocate (void* block, size_t, size_t)
+  {
+    ::operator delete(block);
+  }
+};
+/** @endcond */
+
+
+XMLMemoryResource::~XMLMemoryResource ()
+{
+}
+
+
+void*
+XMLMemoryResource::allocate (size_t bytes, size_t alignment)
+{
+  return doAllocate(bytes, alignment);
+}
+
+
+void
+XMLMemoryResource::deallocate (void* block, size_t bytes, size_t alignment)
+{
+  doDeallocate(block, bytes, alignment);
+}
+
+
+bool
+XMLMemoryResource::isEqual (const XMLMemoryResource& other) const
+{
+  return doIsEqual(other);
+}
+
+
+bool
+XMLMemoryResource::doIsEqual (const XMLMemoryResource& other) const
+{
+  return this == &other;
+}
+
+
+/*
+ * @return the resource that allocates from the global heap.
+ */
+XMLMemoryResource*
+XMLMemoryResource::getDefault ()
+{
+  static NewDeleteResource resource;
+  return &resource;
+}
+
+
+/*
+ * Creates a new XMLMonotonicResource.
+ */
+XMLMonotonicResource::XMLMonotonicResource (  size_t             initialSize
+                                            , XMLMemoryResource* upstream ) :
+   mUpstream ( (upstream != NULL) ? upstream : getDefault() )
+ , mNextSize ( (initialSize > 0) ? initialSize : 1 )
+ , mCur      ( NULL )
+ , mEnd      ( NULL )
+ , mReserved ( 0    )
+ , mUsed     ( 0    )
+{
+}
+
+
+/*
+ * Destroys this XMLMonotonicResource, returning all its memory.
+ */
+XMLMonotonicResource::~XMLMonotonicResource ()
+{
+  release();
+}
+
+
+/*
+ * Returns all the memory handed out to the upstream resource.
+ */
+void
+XMLMonotonicResource::release ()
+{
+  for (size_t n = 0; n < mBlocks.size(); ++n)
+  {
+    mUpstream->deallocate(mBlocks[n].data, mBlocks[n].size);
+  }
+
+  mBlocks.clear();
+  mCur      = NULL;
+  mEnd      = NULL;
+  mReserved = 0;
+  mUsed     = 0;
+}
+
+
+size_t
+XMLMonotonicResource::getBytesReserved () const
+{
+  return mReserved;
+}
+
+
+size_t
+XMLMonotonicResource::getBytesUsed () const
+{
+  return mUsed;
+}
+
+
+/*
+ * Hands out the next bytes of the current block, aligned, taking a new
+ * block from upstream when they do not fit.
+ */
+void*
+XMLMonotonicResource::doAllocate (size_t bytes, size_t alignment)
+{
+  size_t pad = (alignment - reinterpret_cast<size_t>(mCur) % alignment)
+             % alignment;
+
+  if (mCur == NULL || static_cast<size_t>(mEnd - mCur) < pad + bytes)
+  {
+    size_t size = mNextSize;
+    while (size < bytes + alignment) size *= 2;
+
+    Block block;
+    block.data = mUpstream->allocate(size);
+    block.size = size;
+    mBlocks.push_back(block);
+
+    mCur       = static_cast<char*>(block.data);
+    mEnd       = mCur + size;
+    mReserved += size;
+    mNextSize  = size * 2;
+
+    pad = (alignment - reinterpret_cast<size_t>(mCur) % alignment)
+        % alignment;
+  }
+
+  void* result = mCur + pad;
+  mCur  += pad + bytes;
+  mUsed += pad + bytes;
+
+  return result;
+}
+
+
+/*
+ * Memory is only returned by release().
+ */
+void
+XMLMonotonicResource::doDeallocate (void*, size_t, size_t)
+{
+}
+
+
+/*
+ * Creates a new XMLCountingResource.
+ */
+XMLCountingResource::XMLCountingResource (XMLMemoryResource* upstream) :
+   mUpstream         ( (upstream != NULL) ? upstream : getDefault() )
+ , mNumAllocations   ( 0 )
+ , mNumDeallocations ( 0 )
+ , mBytesAllocated   ( 0 )
+ , mBytesInUse       ( 0 )
+ , mPeakBytesInUse   ( 0 )
+{
+}
+
+
+unsigned long
+XMLCountingResource::getNumAllocations () const
+{
+  return mNumAllocations.load(memory_order_relaxed);
+}
+
+
+unsigned long
+XMLCountingResource::getNumDeallocations () const
+{
+  return mNumDeallocations.load(memory_order_relaxed);
+}
+
+
+size_t
+XMLCountingResource::getBytesAllocated () const
+{
+  return mBytesAllocated.load(memory_order_relaxed);
+}
+
+
+size_t
+XMLCountingResource::getBytesInUse () const
+{
+  return mBytesInUse.load(memory_order_relaxed);
+}
+
+
+size_t
+XMLCountingResource::getPeakBytesInUse () const
+{
+  return mPeakBytesInUse.load(memory_order_relaxed);
+}
+
+
+/*
+ * Sets every count back to zero, except the bytes in use.
+ */
+void
+XMLCountingResource::resetCounts ()
+{
+  mNumAllocations.store(0, memory_order_relaxed);
+  mNumDeallocations.store(0, memory_order_relaxed);
+  mBytesAllocated.store(0, memory_order_relaxed);
+  mPeakBytesInUse.store(mBytesInUse.load(memory_order_relaxed),
+                        memory_order_relaxed);
+}
+
+
+void*
+XMLCountingResource::doAllocate (size_t bytes, size_t alignment)
+{
+  void* block = mUpstream->allocate(bytes, alignment);
+
+  mNumAllocations.fetch_add(1, memory_order_relaxed);
+  mBytesAllocated.fetch_add(bytes, memory_order_relaxed);
+
+  const size_t inUse = mBytesInUse.fetch_add(bytes, memory_order_relaxed)
+                     + bytes;
+  size_t peak = mPeakBytesInUse.load(memory_order_relaxed);
+  while (inUse > peak
+         && !mPeakBytesInUse.compare_exchange_weak(peak, inUse,
+                                                   memory_order_relaxed))
+  {
+  }
+
+  return block;
+}
+
+
+void
+XMLCountingResource::doDeallocate (void* block, size_t bytes,
+                                   size_t alignment)
+{
+  mUpstream->deallocate(block, bytes, alignment);
+
+  mNumDeallocations.fetch_add(1, memory_order_relaxed);
+  mBytesInUse.fetch_sub(bytes, memory_order_relaxed);
+}
+
+
+LIBLX_CPP_NAMESPACE_END
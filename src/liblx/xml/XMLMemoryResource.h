@@ -0,0 +1,402 @@
+/**
+ * @file    XMLMemoryResource.h
+ * @brief   Sources of memory for XMLNode trees
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLMemoryResource
+ * @sbmlbrief{core} Where the nodes of an XMLNode tree are allocated.
+ *
+ * An XMLMemoryResource hands out and takes back blocks of memory, in the
+ * manner of C++17's <code>std::pmr::memory_resource</code>, which libLX
+ * cannot yet require.  By default every XMLNode comes from the global
+ * heap; given a resource, a tree's nodes and their lists of children come
+ * from it instead:
+ *
+@code{.cpp}
+XMLMonotonicResource arena;
+
+XMLInputStream stream("big.xml");
+stream.setMemoryResource(&arena);
+
+XMLNode* root = new (arena) XMLNode(stream);
+...
+delete root;        // runs the destructors; the arena keeps the memory
+@endcode
+ *
+ * Two resources come with libLX.  An XMLMonotonicResource hands out memory
+ * from large blocks and frees it all at once when it is destroyed, which
+ * suits trees that are read, used and thrown away together.  An
+ * XMLCountingResource passes every request on to another resource and
+ * counts them, which shows how much a given operation allocates.  Other
+ * strategies, such as pools or per-thread arenas, are written by deriving
+ * from XMLMemoryResource and overriding doAllocate() and doDeallocate().
+ *
+ * A resource must outlive every node allocated from it.  The names,
+ * characters, attributes and namespaces of each node are still kept in
+ * the strings and containers of XMLToken, which use the global heap.
+ */
+
+#ifndef XMLMemoryResource_h
+#define XMLMemoryResource_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+class LIBLX_EXTERN XMLMemoryResource
+{
+public:
+
+  /**
+   * The alignment used when none is given: enough for any type.
+   */
+  static const size_t DEFAULT_ALIGNMENT;
+
+
+  /**
+   * Destroys this XMLMemoryResource.
+   */
+  virtual ~XMLMemoryResource ();
+
+
+  /**
+   * Allocates a block of memory.
+   *
+   * @param bytes the size of the block.
+   * @param alignment the alignment of the block, a power of two.
+   *
+   * @return the block.
+   *
+   * @throws std::bad_alloc if the memory cannot be had.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  void* allocate (size_t bytes, size_t alignment = DEFAULT_ALIGNMENT);
+
+
+  /**
+   * Gives back a block of memory obtained from allocate() on this
+   * resource, or on one equal to it.
+   *
+   * @param block the block.
+   * @param bytes the size it was allocated with.
+   * @param alignment the alignment it was allocated with.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  void deallocate (void* block, size_t bytes,
+                   size_t alignment = DEFAULT_ALIGNMENT);
+
+
+  /**
+   * Returns @c true if memory allocated from this resource may be given
+   * back to @p other, and the other way round.
+   *
+   * @param other the resource to compare with.
+   *
+   * @return @c true if the two resources are interchangeable.
+   */
+  bool isEqual (const XMLMemoryResource& other) const;
+
+
+  /**
+   * Returns the resource used when none is given, which allocates from
+   * the global heap with <code>operator new</code>.
+   *
+   * @return the default resource, which lives as long as the process.
+   */
+  static XMLMemoryResource* getDefault ();
+
+
+protected:
+
+  /**
+   * Does the work of allocate().
+   */
+  virtual void* doAllocate (size_t bytes, size_t alignment) = 0;
+
+
+  /**
+   * Does the work of deallocate().
+   */
+  virtual void doDeallocate (void* block, size_t bytes, size_t alignment) = 0;
+
+
+  /**
+   * Does the work of isEqual().  The default considers a resource equal
+   * only to itself.
+   */
+  virtual bool doIsEqual (const XMLMemoryResource& other) const;
+};
+
+
+
+/**
+ * @class XMLMonotonicResource
+ * @sbmlbrief{core} Hands out memory from large blocks and frees it all
+ * at once.
+ *
+ * Memory given back with deallocate() is not reused; it is all returned to
+ * the upstream resource by release() or when the XMLMonotonicResource is
+ * destroyed.  Each block taken from upstream is twice the size of the one
+ * before, starting from the size given to the constructor.  An
+ * XMLMonotonicResource may be used by one thread at a time.
+ */
+class LIBLX_EXTERN XMLMonotonicResource : public XMLMemoryResource
+{
+public:
+
+  /**
+   * Creates a new XMLMonotonicResource.
+   *
+   * @param initialSize the size of the first block taken from upstream.
+   * @param upstream the resource blocks are taken from, or @c NULL for
+   * the default resource.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLMonotonicResource (  size_t             initialSize = 4096
+                        , XMLMemoryResource* upstream    = NULL );
+
+
+  /**
+   * Destroys this XMLMonotonicResource, returning all its memory.
+   */
+  virtual ~XMLMonotonicResource ();
+
+
+  /**
+   * Returns all the memory handed out to the upstream resource.  Anything
+   * allocated from this resource is invalid afterwards.
+   */
+  void release ();
+
+
+  /**
+   * @return the total size of the blocks taken from upstream.
+   */
+  size_t getBytesReserved () const;
+
+
+  /**
+   * @return the bytes handed out since the resource was created or last
+   * released, including padding for alignment.
+   */
+  size_t getBytesUsed () const;
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  virtual void* doAllocate (size_t bytes, size_t alignment);
+  virtual void  doDeallocate (void* block, size_t bytes, size_t alignment);
+
+  struct Block
+  {
+    void*  data;
+    size_t size;
+  };
+
+  XMLMemoryResource* mUpstream;
+  std::vector<Block> mBlocks;
+  size_t             mNextSize;
+  char*              mCur;
+  char*              mEnd;
+  size_t             mReserved;
+  size_t             mUsed;
+
+private:
+
+  XMLMonotonicResource (const XMLMonotonicResource& orig);
+  XMLMonotonicResource& operator= (const XMLMonotonicResource& rhs);
+
+  /** @endcond */
+};
+
+
+
+/**
+ * @class XMLCountingResource
+ * @sbmlbrief{core} Counts the memory requested through it.
+ *
+ * Every request is passed on to the upstream resource and counted, so
+ * that the allocations made by one operation can be measured:
+ *
+@code{.cpp}
+XMLCountingResource counter;
+
+XMLInputStream stream("model.xml");
+stream.setMemoryResource(&counter);
+XMLNode root(stream);
+
+std::cout << counter.getNumAllocations() << " nodes and child lists, "
+          << counter.getPeakBytesInUse() << " bytes at most\n";
+@endcode
+ *
+ * The counts are kept atomically, so an XMLCountingResource may be used by
+ * several threads at once if its upstream resource may.
+ */
+class LIBLX_EXTERN XMLCountingResource : public XMLMemoryResource
+{
+public:
+
+  /**
+   * Creates a new XMLCountingResource.
+   *
+   * @param upstream the resource requests are passed to, or @c NULL for
+   * the default resource.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLCountingResource (XMLMemoryResource* upstream = NULL);
+
+
+  /**
+   * @return the number of blocks allocated.
+   */
+  unsigned long getNumAllocations () const;
+
+
+  /**
+   * @return the number of blocks given back.
+   */
+  unsigned long getNumDeallocations () const;
+
+
+  /**
+   * @return the total bytes allocated.
+   */
+  size_t getBytesAllocated () const;
+
+
+  /**
+   * @return the bytes allocated and not yet given back.
+   */
+  size_t getBytesInUse () const;
+
+
+  /**
+   * @return the most bytes that were in use at any one time since the
+   * counts were last reset.
+   */
+  size_t getPeakBytesInUse () const;
+
+
+  /**
+   * Sets every count back to zero, except the bytes in use, from which
+   * the peak starts again.
+   */
+  void resetCounts ();
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  virtual void* doAllocate (size_t bytes, size_t alignment);
+  virtual void  doDeallocate (void* block, size_t bytes, size_t alignment);
+
+  XMLMemoryResource*   mUpstream;
+  std::atomic<unsigned long> mNumAllocations;
+  std::atomic<unsigned long> mNumDeallocations;
+  std::atomic<size_t>  mBytesAllocated;
+  std::atomic<size_t>  mBytesInUse;
+  std::atomic<size_t>  mPeakBytesInUse;
+
+private:
+
+  XMLCountingResource (const XMLCountingResource& orig);
+  XMLCountingResource& operator= (const XMLCountingResource& rhs);
+
+  /** @endcond */
+};
+
+
+
+/** @cond doxygenLibsbmlInternal */
+/**
+ * A standard allocator drawing on an XMLMemoryResource, in the manner of
+ * <code>std::pmr::polymorphic_allocator</code>, for the containers of
+ * classes whose memory can come from one.
+ */
+template <class T>
+class XMLAllocator
+{
+public:
+
+  typedef T value_type;
+
+  typedef std::true_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  XMLAllocator (XMLMemoryResource* resource = NULL)
+    : mResource( (resource != NULL) ? resource
+                                    : XMLMemoryResource::getDefault() )
+  {
+  }
+
+  template <class U>
+  XMLAllocator (const XMLAllocator<U>& other)
+    : mResource( other.resource() )
+  {
+  }
+
+  T* allocate (size_t n)
+  {
+    return static_cast<T*>( mResource->allocate(n * sizeof(T),
+                                                alignof(T)) );
+  }
+
+  void deallocate (T* block, size_t n)
+  {
+    mResource->deallocate(block, n * sizeof(T), alignof(T));
+  }
+
+  XMLMemoryResource* resource () const
+  {
+    return mResource;
+  }
+
+private:
+
+  XMLMemoryResource* mResource;
+};
+
+
+template <class T, class U>
+bool operator== (const XMLAllocator<T>& a, const XMLAllocator<U>& b)
+{
+  return a.resource() == b.resource() || a.resource()->isEqual(*b.resource());
+}
+
+
+template <class T, class U>
+bool operator!= (const XMLAllocator<T>& a, const XMLAllocator<U>& b)
+{
+  return !(a == b);
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* XMLMemoryResource_h */
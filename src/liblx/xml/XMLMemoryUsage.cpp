@@ -0,0 +1,225 @@
+/**
+ * @file    XMLMemoryUsage.cpp
+ * @brief   How much memory an XMLNode tree and its parts hold
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <algorithm>
+
+#include <liblx/xml/XMLMemoryUsage.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/*
+ * Creates a new, empty XMLMemoryUsage.
+ */
+XMLMemoryUsage::XMLMemoryUsage (bool byElement) :
+   mStructure  ( 0         )
+ , mText       ( 0         )
+ , mAttributes ( 0         )
+ , mNamespaces ( 0         )
+ , mErrors     ( 0         )
+ , mByElement  ( byElement )
+ , mOrderValid ( true      )
+{
+}
+
+
+size_t
+XMLMemoryUsage::getTotal () const
+{
+  return mStructure + mText + mAttributes + mNamespaces + mErrors;
+}
+
+
+size_t
+XMLMemoryUsage::getStructureBytes () const
+{
+  return mStructure;
+}
+
+
+size_t
+XMLMemoryUsage::getTextBytes () const
+{
+  return mText;
+}
+
+
+size_t
+XMLMemoryUsage::getAttributeBytes () const
+{
+  return mAttributes;
+}
+
+
+size_t
+XMLMemoryUsage::getNamespaceBytes () const
+{
+  return mNamespaces;
+}
+
+
+size_t
+XMLMemoryUsage::getErrorBytes () const
+{
+  return mErrors;
+}
+
+
+bool
+XMLMemoryUsage::isByElement () const
+{
+  return mByElement;
+}
+
+
+unsigned int
+XMLMemoryUsage::getNumElementNames () const
+{
+  return (unsigned int) mElements.size();
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Orders (bytes, name) pairs from the most bytes to the fewest, and
+ * alphabetically where the bytes are the same.
+ */
+static bool
+largerElement (const pair<size_t, string>& a, const pair<size_t, string>& b)
+{
+  return (a.first != b.first) ? a.first > b.first : a.second < b.second;
+}
+/** @endcond */
+
+
+/*
+ * @return the nth element name, from the one holding the most bytes.
+ */
+string
+XMLMemoryUsage::getElementName (unsigned int n) const
+{
+  if (n >= mElements.size()) return "";
+
+  if (!mOrderValid)
+  {
+    vector< pair<size_t, string> > sizes;
+    sizes.reserve(mElements.size());
+
+    map<string, ElementEntry>::const_iterator it;
+    for (it = mElements.begin(); it != mElements.end(); ++it)
+    {
+      sizes.push_back(make_pair(it->second.bytes, it->first));
+    }
+
+    sort(sizes.begin(), sizes.end(), largerElement);
+
+    mOrder.clear();
+    mOrder.reserve(sizes.size());
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+      mOrder.push_back(sizes[i].second);
+    }
+    mOrderValid = true;
+  }
+
+  return mOrder[n];
+}
+
+
+size_t
+XMLMemoryUsage::getElementBytes (const string& name) const
+{
+  map<string, ElementEntry>::const_iterator it = mElements.find(name);
+  return (it != mElements.end()) ? it->second.bytes : 0;
+}
+
+
+unsigned long
+XMLMemoryUsage::getElementCount (const string& name) const
+{
+  map<string, ElementEntry>::const_iterator it = mElements.find(name);
+  return (it != mElements.end()) ? it->second.count : 0;
+}
+
+
+/*
+ * Sets every count back to zero and forgets the elements met.
+ */
+void
+XMLMemoryUsage::clear ()
+{
+  mStructure  = 0;
+  mText       = 0;
+  mAttributes = 0;
+  mNamespaces = 0;
+  mErrors     = 0;
+
+  mElements.clear();
+  mSeen.clear();
+  mOrder.clear();
+  mOrderValid = true;
+}
+
+
+/*
+ * A string short enough to be kept in the string object itself, as most
+ * standard libraries do, holds nothing outside it; otherwise it holds its
+ * capacity and a terminating null.
+ */
+size_t
+XMLMemoryUsage::getStringBytes (const string& str)
+{
+  const char* data  = str.data();
+  const char* begin = reinterpret_cast<const char*>(&str);
+
+  if (data >= begin && data < begin + sizeof(string)) return 0;
+
+  return str.capacity() + 1;
+}
+
+
+/*
+ * Records bytes held by an element called name.
+ */
+void
+XMLMemoryUsage::addElement (const string& name, size_t bytes, bool isElement)
+{
+  ElementEntry& entry = mElements[name];
+
+  entry.bytes += bytes;
+  if (isElement) ++entry.count;
+
+  mOrderValid = false;
+}
+
+
+/*
+ * @return true the first time shared is passed.
+ */
+bool
+XMLMemoryUsage::firstVisit (const void* shared)
+{
+  return mSeen.insert(shared).second;
+}
+
+
+#endif /* __cplusplus */
+
+LIBLX_CPP_NAMESPACE_END
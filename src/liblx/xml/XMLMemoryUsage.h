@@ -0,0 +1,232 @@
+/**
+ * @file    XMLMemoryUsage.h
+ * @brief   How much memory an XMLNode tree and its parts hold
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLMemoryUsage
+ * @sbmlbrief{core} A breakdown of the memory held by XML objects.
+ *
+ * The getMemoryUsage() methods of XMLNode, XMLToken, XMLAttributes,
+ * XMLNamespaces, XMLErrorLog and XMLInputStream return the bytes an object
+ * holds, counting the object itself, the spare capacity of its strings and
+ * vectors, and everything it owns.  Given an XMLMemoryUsage, they also add
+ * what they find to it, split by kind:
+ *
+ * <ul>
+ * <li> structure: the objects themselves and the lists of children;
+ * <li> text: the characters of text nodes;
+ * <li> attributes: attribute names and values;
+ * <li> namespaces: namespace declarations;
+ * <li> errors: the errors held by an XMLErrorLog.
+ * </ul>
+ *
+ * Created with @p byElement set, an XMLMemoryUsage also splits the bytes
+ * of XMLNode trees by element name, text counting towards the element it
+ * is in:
+ *
+@code{.cpp}
+XMLMemoryUsage usage(true);
+root.getMemoryUsage(usage);
+
+for (unsigned int n = 0; n < usage.getNumElementNames() && n < 5; ++n)
+{
+  const std::string name = usage.getElementName(n);
+  std::cout << name << ": " << usage.getElementBytes(name) << " bytes in "
+            << usage.getElementCount(name) << " elements\n";
+}
+@endcode
+ *
+ * Several objects may be added to one XMLMemoryUsage.  Children shared
+ * between trees, by copies or by an XMLNodePool, are counted only the first
+ * time they are met.  Element names, which every token with the same name
+ * shares through the XMLNamePool, are not counted unless the pool was full
+ * and a token holds a copy of its own.  Strings short enough
+ * to be kept inside the string object hold no memory of their own, and the
+ * bookkeeping of the memory allocator is left out, so the figures are what
+ * the objects ask for rather than what the process pays.
+ */
+
+#ifndef XMLMemoryUsage_h
+#define XMLMemoryUsage_h
+
+#include <liblx/xml/common/extern.h>
+
+
+#ifdef __cplusplus
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+class LIBLX_EXTERN XMLMemoryUsage
+{
+public:
+
+  /**
+   * Creates a new, empty XMLMemoryUsage.
+   *
+   * @param byElement whether XMLNode trees are also to be split by
+   * element name.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLMemoryUsage (bool byElement = false);
+
+
+  /**
+   * @return the total bytes counted.
+   */
+  size_t getTotal () const;
+
+
+  /**
+   * @return the bytes held by the objects themselves and lists of
+   * children.
+   */
+  size_t getStructureBytes () const;
+
+
+  /**
+   * @return the bytes held by the characters of text.
+   */
+  size_t getTextBytes () const;
+
+
+  /**
+   * @return the bytes held by attributes.
+   */
+  size_t getAttributeBytes () const;
+
+
+  /**
+   * @return the bytes held by namespace declarations.
+   */
+  size_t getNamespaceBytes () const;
+
+
+  /**
+   * @return the bytes held by logged errors.
+   */
+  size_t getErrorBytes () const;
+
+
+  /**
+   * @return @c true if XMLNode trees are split by element name.
+   */
+  bool isByElement () const;
+
+
+  /**
+   * @return the number of element names met, or @c 0 if trees are not
+   * split by element name.
+   */
+  unsigned int getNumElementNames () const;
+
+
+  /**
+   * Returns the nth element name, the names being ordered from the one
+   * whose elements hold the most bytes to the one whose hold the fewest.
+   *
+   * @param n the index of the name.
+   *
+   * @return the name, with its prefix if it had one, or an empty string
+   * if @p n is out of range.
+   */
+  std::string getElementName (unsigned int n) const;
+
+
+  /**
+   * @param name the element name, with its prefix if it has one.
+   *
+   * @return the bytes held by elements of that name and the text directly
+   * in them, or @c 0 if none were met.
+   */
+  size_t getElementBytes (const std::string& name) const;
+
+
+  /**
+   * @param name the element name, with its prefix if it has one.
+   *
+   * @return the number of elements of that name met.
+   */
+  unsigned long getElementCount (const std::string& name) const;
+
+
+  /**
+   * Sets every count back to zero and forgets the elements met.
+   */
+  void clear ();
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+  /**
+   * @return the bytes str holds outside the string object itself.
+   */
+  static size_t getStringBytes (const std::string& str);
+
+  /** @endcond */
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  struct ElementEntry
+  {
+    size_t        bytes;
+    unsigned long count;
+  };
+
+  /*
+   * Records bytes held by an element called name, and the element itself
+   * if isElement is true.
+   */
+  void addElement (const std::string& name, size_t bytes, bool isElement);
+
+  /*
+   * @return true the first time shared is passed, false afterwards.
+   */
+  bool firstVisit (const void* shared);
+
+  size_t mStructure;
+  size_t mText;
+  size_t mAttributes;
+  size_t mNamespaces;
+  size_t mErrors;
+
+  bool                                mByElement;
+  std::map<std::string, ElementEntry> mElements;
+  std::set<const void*>               mSeen;
+
+  /* the names in mElements from the largest, rebuilt when out of date */
+  mutable std::vector<std::string>    mOrder;
+  mutable bool                        mOrderValid;
+
+  friend class XMLAttributes;
+  friend class XMLErrorLog;
+  friend class XMLInputStream;
+  friend class XMLNamespaces;
+  friend class XMLNode;
+  friend class XMLToken;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+#endif  /* XMLMemoryUsage_h */
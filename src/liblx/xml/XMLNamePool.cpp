@@ -0,0 +1,170 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLNamePool.cpp
+ * @brief   Process-wide table of interned element names
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <liblx/xml/XMLNamePool.h>
+
+using namespace std;
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+namespace
+{
+  struct TripleHash
+  {
+    size_t operator() (const XMLTriple& triple) const
+    {
+      hash<string> h;
+      size_t seed = h(triple.getName());
+      seed ^= h(triple.getURI())    + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      seed ^= h(triple.getPrefix()) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      return seed;
+    }
+  };
+
+  struct TripleEqual
+  {
+    bool operator() (const XMLTriple& lhs, const XMLTriple& rhs) const
+    {
+      return lhs.getName()   == rhs.getName()
+          && lhs.getURI()    == rhs.getURI()
+          && lhs.getPrefix() == rhs.getPrefix();
+    }
+  };
+
+  typedef unordered_set<XMLTriple, TripleHash, TripleEqual> TripleSet;
+
+  typedef unordered_map<XMLTriple, const XMLTriple*, TripleHash, TripleEqual>
+          TripleCache;
+
+  /*
+   * Each thread remembers the names it has interned, so that threads
+   * parsing at the same time rarely need the pool's lock.  Pool entries
+   * are never removed, so cached pointers stay valid; the cache is
+   * emptied if a document with very many distinct names fills it.
+   */
+  const size_t MAX_CACHED_NAMES = 4096;
+
+  /*
+   * The default limit on the size of the pool; far more distinct names
+   * than any vocabulary has, but few enough to bound the memory used
+   * when names are generated.
+   */
+  const unsigned int DEFAULT_MAX_NAMES = 65536;
+
+  atomic<unsigned int> maxPoolNames(DEFAULT_MAX_NAMES);
+
+  /*
+   * Both objects are deliberately leaked: tokens held in static storage
+   * elsewhere may outlive any destructor we would register here.
+   */
+  TripleSet&
+  pool ()
+  {
+    static TripleSet* names = new TripleSet;
+    return *names;
+  }
+
+  mutex&
+  poolMutex ()
+  {
+    static mutex* m = new mutex;
+    return *m;
+  }
+}
+
+
+/*
+ * Returns the shared copy of the given triple, adding it to the pool if
+ * it has not been seen before and the pool is not full.  Elements of an
+ * unordered_set never move, so the returned pointer stays valid as the
+ * pool grows.
+ */
+const XMLTriple*
+XMLNamePool::intern (const XMLTriple& triple)
+{
+  if (triple.isEmpty()) return NULL;
+
+  static thread_local TripleCache cache;
+
+  TripleCache::const_iterator found = cache.find(triple);
+  if (found != cache.end()) return found->second;
+
+  const XMLTriple* interned = NULL;
+  {
+    lock_guard<mutex> lock(poolMutex());
+    TripleSet& names = pool();
+
+    if (names.size() < maxPoolNames)
+    {
+      interned = &*names.insert(triple).first;
+    }
+    else
+    {
+      TripleSet::const_iterator it = names.find(triple);
+      if (it != names.end()) interned = &*it;
+    }
+  }
+
+  if (interned == NULL) return NULL;
+
+  if (cache.size() >= MAX_CACHED_NAMES) cache.clear();
+  cache.insert(make_pair(triple, interned));
+
+  return interned;
+}
+
+
+/*
+ * @return the number of distinct triples held by the pool.
+ */
+unsigned int
+XMLNamePool::getNumNames ()
+{
+  lock_guard<mutex> lock(poolMutex());
+  return (unsigned int)pool().size();
+}
+
+
+/*
+ * @return the number of distinct triples the pool holds at most.
+ */
+unsigned int
+XMLNamePool::getMaxNames ()
+{
+  return maxPoolNames;
+}
+
+
+/*
+ * Sets the number of distinct triples the pool holds at most.
+ */
+void
+XMLNamePool::setMaxNames (unsigned int maxNames)
+{
+  maxPoolNames = maxNames;
+}
+
+
+LIBLX_CPP_NAMESPACE_END
+
+/** @endcond */
@@ -0,0 +1,97 @@
+/**
+ * @cond doxygenLibsbmlInternal
+ *
+ * @file    XMLNamePool.h
+ * @brief   Process-wide table of interned element names
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLNamePool
+ * @sbmlbrief{core} Interns XMLTriple objects so that tokens can share them.
+ *
+ * @ifnot clike @internal @endif@~
+ *
+ * Every XMLToken used to carry its own copy of the element name, URI and
+ * prefix.  Documents only ever use a handful of distinct element names, so
+ * XMLToken instead keeps a pointer to a single shared XMLTriple obtained
+ * from this pool.  Two tokens whose name pointers are equal have the same
+ * qualified name, but tokens with the same name need not share a pointer,
+ * so a pointer comparison can only ever shortcut a comparison of names.
+ *
+ * Interned triples are never released, so the pool holds at most
+ * getMaxNames() of them.  Once it is full, names not already in it are
+ * not interned: intern() returns @c NULL and the caller keeps a copy of
+ * its own, so a process that meets an unbounded variety of names (a
+ * long-running server, or documents generated with unique element names)
+ * uses a bounded amount of memory for the pool.  Interning is thread-safe.
+ */
+
+#ifndef XMLNamePool_h
+#define XMLNamePool_h
+
+#ifdef __cplusplus
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/XMLTriple.h>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class LIBLX_EXTERN XMLNamePool
+{
+public:
+
+  /**
+   * Returns the shared copy of the given triple, adding it to the pool if
+   * it has not been seen before.
+   *
+   * @param triple the XMLTriple to intern.
+   *
+   * @return a pointer to the pooled XMLTriple, valid for the lifetime of
+   * the process, or @c NULL if @p triple is empty or is new and the pool
+   * is full.
+   */
+  static const XMLTriple* intern (const XMLTriple& triple);
+
+
+  /**
+   * @return the number of distinct triples held by the pool.
+   */
+  static unsigned int getNumNames ();
+
+
+  /**
+   * @return the number of distinct triples the pool holds at most.
+   */
+  static unsigned int getMaxNames ();
+
+
+  /**
+   * Sets the number of distinct triples the pool holds at most.  Triples
+   * already interned stay in the pool even if there are more of them.
+   *
+   * @param maxNames the new limit.
+   */
+  static void setMaxNames (unsigned int maxNames);
+
+
+private:
+
+  XMLNamePool ();
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+#endif  /* XMLNamePool_h */
+
+/** @endcond */
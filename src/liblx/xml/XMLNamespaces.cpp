@@ -47,6 +47,9 @@
 #include <liblx/xml/sbmlMemoryStubs.h>
 #include <liblx/xml/operationReturnValues.h>
 
+#include <atomic>
+#include <mutex>
+
 
 /** @cond doxygenIgnored */
 using namespace std;
@@ -57,6 +60,22 @@ LIBLX_CPP_NAMESPACE_BEGIN
 
 std::set<std::string> XMLNamespaces::reservedURIs;
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * reservedURIs is shared by every parse, possibly on several threads.
+ * Most programs never reserve a URI, so the flag lets lookups skip the
+ * lock while the set is empty.
+ */
+static mutex&
+reservedURIsMutex ()
+{
+  static mutex* m = new mutex;
+  return *m;
+}
+
+static atomic<bool> hasReservedURIs(false);
+/** @endcond */
+
 /*
  * Creates a new empty list of XML namespace declarations.
  */
@@ -351,7 +370,9 @@ bool XMLNamespaces::hasNS(const std::string& uri, const std::string& prefix) con
  */
 void XMLNamespaces::addReservedURI(const std::string& uri)
 {
+	lock_guard<mutex> lock(reservedURIsMutex());
 	reservedURIs.insert(uri);
+	hasReservedURIs = true;
 }
 
 /** @cond doxygenLibsbmlInternal */
@@ -406,6 +427,9 @@ XMLNamespaces::containIdenticalSetNS(XMLNamespaces* rhs)
 bool XMLNamespaces::isURIReserved(const std::string& uri) //const
 {
     // Is the URI in the set of reserved URIs?
+    if (!hasReservedURIs) return false;
+
+    lock_guard<mutex> lock(reservedURIsMutex());
 	return (reservedURIs.count(uri) != 0);
 }
 /** @endcond */
@@ -451,6 +475,37 @@ operator<< (XMLOutputStream& stream, const XMLNamespaces& namespaces)
 #endif  /* !SWIG */
 
 
+/*
+ * @return the bytes of memory this XMLNamespaces holds.
+ */
+size_t
+XMLNamespaces::getMemoryUsage () const
+{
+  XMLMemoryUsage usage;
+  return getMemoryUsage(usage);
+}
+
+
+/*
+ * Adds the memory this XMLNamespaces holds to usage.
+ */
+size_t
+XMLNamespaces::getMemoryUsage (XMLMemoryUsage& usage) const
+{
+  size_t bytes = sizeof(XMLNamespaces)
+               + mNamespaces.capacity() * sizeof(PrefixURIPair);
+
+  for (size_t n = 0; n < mNamespaces.size(); ++n)
+  {
+    bytes += XMLMemoryUsage::getStringBytes(mNamespaces[n].first)
+           + XMLMemoryUsage::getStringBytes(mNamespaces[n].second);
+  }
+
+  usage.mNamespaces += bytes;
+  return bytes;
+}
+
+
 #endif /* __cplusplus */
 /** @cond doxygenIgnored */
 LIBLX_EXTERN
@@ -625,6 +680,15 @@ XMLNamespaces_addReservedURI(const char* uri)
 {
 	XMLNamespaces::addReservedURI(uri);
 }
+
+
+LIBLX_EXTERN
+unsigned long
+XMLNamespaces_getMemoryUsage (const XMLNamespaces_t *ns)
+{
+  if (ns == NULL) return 0;
+  return (unsigned long) ns->getMemoryUsage();
+}
 /** @endcond */
 
 LIBLX_CPP_NAMESPACE_END
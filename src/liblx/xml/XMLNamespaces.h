@@ -66,6 +66,7 @@
 
 #include <liblx/xml/common/extern.h>
 #include <liblx/xml/common/liblxfwd.h>
+#include <liblx/xml/XMLMemoryUsage.h>
 
 
 #ifdef __cplusplus
@@ -381,6 +382,28 @@ public:
    */
   static void addReservedURI(const std::string& uri);
 
+
+  /**
+   * Returns the bytes of memory this XMLNamespaces holds, counting the object
+   * itself, the prefixes and URIs it declares, and the spare capacity of each.
+   *
+   * @return the bytes held by this XMLNamespaces.
+   *
+   * @see XMLMemoryUsage
+   */
+  size_t getMemoryUsage () const;
+
+
+  /**
+   * Adds the memory this XMLNamespaces holds to @p usage, split by kind, and
+   * returns it.
+   *
+   * @param usage the XMLMemoryUsage to add to.
+   *
+   * @return the bytes held by this XMLNamespaces.
+   */
+  size_t getMemoryUsage (XMLMemoryUsage& usage) const;
+
 #ifndef SWIG
 
   /** @cond doxygenLibsbmlInternal */
@@ -412,6 +435,7 @@ public:
 
   /** @cond doxygenLibsbmlInternal */
   friend class SBase;
+  friend class XMLNode;
 
   /** @endcond */
 
@@ -770,6 +794,21 @@ LIBLX_EXTERN
 void
 XMLNamespaces_addReservedURI(const char* uri);
 
+/**
+ * Returns the bytes of memory held by the given XMLNamespaces_t structure,
+ * counting the structure itself, the prefixes and URIs it declares, and the spare capacity of each.
+ *
+ * @param ns the XMLNamespaces_t structure.
+ *
+ * @return the bytes held, or @c 0 if @p ns is @c NULL.
+ *
+ * @memberof XMLNamespaces_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLNamespaces_getMemoryUsage (const XMLNamespaces_t *ns);
+
+
 END_C_DECLS
 LIBLX_CPP_NAMESPACE_END
 
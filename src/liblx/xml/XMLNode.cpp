@@ -34,6 +34,7 @@
  * also available online as http://sbml.org/software/libsbml/license.html
  * ---------------------------------------------------------------------- -->*/
 
+#include <functional>
 #include <sstream>
 
 /** @cond doxygenLibsbmlInternal */
@@ -43,6 +44,7 @@
 /** @endcond */
 
 #include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLNodePool.h>
 #include <liblx/xml/sbmlMemoryStubs.h>
 #include <liblx/xml/operationReturnValues.h>
 
@@ -70,10 +72,55 @@ trim (const string& s)
 }
 
 
+/*
+ * @return the formatting of strings made from nodes.  They never carry
+ * the program comment, so the process-wide settings need not be read.
+ */
+static const XMLWriterOptions&
+fragmentOptions ()
+{
+  static const XMLWriterOptions options;
+  return options;
+}
+
+
+/*
+ * XMLNode::mHash keeps a hash in its low HASH_BITS bits and, above them,
+ * the options it was computed with plus one, so that 0 means none.
+ */
+static const unsigned int       HASH_BITS = 61;
+static const unsigned long long HASH_MASK = (1ULL << HASH_BITS) - 1;
+
+
+/*
+ * @return seed with value mixed into it.
+ */
+static inline unsigned long long
+combineHash (unsigned long long seed, unsigned long long value)
+{
+  return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+
+/*
+ * @return the hash of s.
+ */
+static inline unsigned long long
+hashString (const string& s)
+{
+  return static_cast<unsigned long long>( std::hash<string>()(s) );
+}
+
+
 /*
  * Creates a new empty XMLNode with no children.
  */
 XMLNode::XMLNode ()
+ : mParent ( NULL )
+ , mRefs   ( 0    )
+ , mShareable ( true )
+ , mHash   ( 0    )
+ , mInTextCache ( false )
 {
 }
 
@@ -83,7 +130,10 @@ XMLNode::XMLNode ()
  */
 XMLNode::~XMLNode ()
 {
-  removeChildren();
+  for (size_t n = 0; n < mChildren.size(); ++n)
+  {
+    mChildren[n]->release();
+  }
 }
 
 
@@ -91,6 +141,27 @@ XMLNode::~XMLNode ()
  * Creates a new XMLNode by copying token.
  */
 XMLNode::XMLNode (const XMLToken& token) : XMLToken(token)
+                                         , mParent ( NULL )
+                                         , mRefs   ( 0    )
+                                         , mShareable ( true )
+                                         , mHash   ( 0    )
+                                         , mInTextCache ( false )
+{
+}
+
+
+/*
+ * Creates a new XMLNode by copying token, whose children will be
+ * allocated from resource.
+ */
+XMLNode::XMLNode (const XMLToken& token, XMLMemoryResource* resource)
+                 : XMLToken(token)
+                 , mChildren ( ChildList::allocator_type(resource) )
+                 , mParent ( NULL )
+                 , mRefs   ( 0    )
+                 , mShareable ( true )
+                 , mHash   ( 0    )
+                 , mInTextCache ( false )
 {
 }
 
@@ -105,6 +176,11 @@ XMLNode::XMLNode (  const XMLTriple&     triple
                   , const unsigned int   line
                   , const unsigned int   column) 
                   : XMLToken(triple, attributes, namespaces, line, column)
+                  , mParent ( NULL )
+                  , mRefs   ( 0    )
+                  , mShareable ( true )
+                  , mHash   ( 0    )
+                  , mInTextCache ( false )
 {
 }
 
@@ -117,6 +193,11 @@ XMLNode::XMLNode (  const XMLTriple&      triple
                   , const unsigned int    line
                   , const unsigned int    column )
                   : XMLToken(triple, attributes, line, column)
+                  , mParent ( NULL )
+                  , mRefs   ( 0    )
+                  , mShareable ( true )
+                  , mHash   ( 0    )
+                  , mInTextCache ( false )
 {
 }  
 
@@ -128,6 +209,11 @@ XMLNode::XMLNode (  const XMLTriple&   triple
                   , const unsigned int line
                   , const unsigned int column )
                   : XMLToken(triple, line, column)
+                  , mParent ( NULL )
+                  , mRefs   ( 0    )
+                  , mShareable ( true )
+                  , mHash   ( 0    )
+                  , mInTextCache ( false )
 {
 }
 
@@ -139,36 +225,84 @@ XMLNode::XMLNode (  const std::string& chars
                   , const unsigned int line
                   , const unsigned int column )
                   : XMLToken(chars, line, column)
+                  , mParent ( NULL )
+                  , mRefs   ( 0    )
+                  , mShareable ( true )
+                  , mHash   ( 0    )
+                  , mInTextCache ( false )
 {
 }
 
 
 /** @cond doxygenLibsbmlInternal */
 /*
- * Creates a new XMLNode by reading XMLTokens from stream.  The stream must
- * be positioned on a start element (stream.peek().isStart() == true) and
- * will be read until the matching end element is found.
+ * Forgets the hash and the text kept for this node and for its ancestors.
+ * Since a node whose hash is unknown has ancestors whose hashes are
+ * unknown too, and likewise for kept text, the walk up stops at the first
+ * node that has neither; building a tree from the leaves up therefore
+ * costs nothing extra.
  */
-XMLNode::XMLNode (XMLInputStream& stream) : XMLToken( stream.next() )
+void
+XMLNode::changed ()
 {
-  if ( isEnd() ) return;
+  for (XMLNode* node = this; node != NULL; node = node->mParent)
+  {
+    const bool hadHash = 
+      (node->mHash.exchange(0, std::memory_order_relaxed) != 0);
+    const bool hadText = 
+      node->mInTextCache.exchange(false, std::memory_order_relaxed);
+
+    if (hadText)
+    {
+      std::atomic_store(&node->mTextCache, 
+                        std::shared_ptr<const TextCache>());
+    }
+    else if (!hadHash)
+    {
+      break;
+    }
+  }
+}
+
+
+/*
+ * Makes node the last child of this node, taking a reference to it.
+ */
+void
+XMLNode::adoptChild (XMLNode* node)
+{
+  node->mRefs.fetch_add(1, std::memory_order_relaxed);
+  changed();
+  mChildren.push_back(node);
+}
 
-  std::string s;
+
+/*
+ * Reads the children of this node from stream, sharing them through pool
+ * unless it is NULL.  Only start elements and the EOF marker take
+ * children, as with addChild(); the children of other nodes are read and
+ * dropped.
+ */
+void
+XMLNode::readChildren (XMLInputStream& stream, XMLNodePool* pool)
+{
+  const bool keep = isStart() || isEOF();
+  XMLMemoryResource* resource = getMemoryResource();
 
   while ( stream.isGood() )
   {
     const XMLToken& next = stream.peek();
-
+    XMLNode* child = NULL;
 
     if ( next.isStart() )
     {
-      addChild( XMLNode(stream) );
+      child = new (*resource) XMLNode( stream.next(), resource );
+      if ( !child->isEnd() ) child->readChildren(stream, pool);
     }
     else if ( next.isText() )
     {
-      s = trim(next.getCharacters());
-      if (s != "")
-        addChild( stream.next() );
+      if (trim(next.getCharacters()) != "")
+        child = new (*resource) XMLNode( stream.next(), resource );
       else
         stream.skipText();
     }
@@ -177,24 +311,327 @@ XMLNode::XMLNode (XMLInputStream& stream) : XMLToken( stream.next() )
       stream.next();
       break;
     }
+
+    if (child == NULL) continue;
+
+    if (!keep)
+    {
+      delete child;
+      continue;
+    }
+
+    if (pool != NULL)
+    {
+      // the pool hands back a reference for this node to hold
+      child = pool->intern(child);
+      changed();
+      mChildren.push_back(child);
+    }
+    else
+    {
+      adoptChild(child);
+    }
   }
 }
-/** @endcond */
 
 
 /*
- * Copy constructor; creates a copy of this XMLNode.
+ * @return the nth child, first replaced by a copy of its own if it is
+ * shared, so that it can be changed.  Only the child is copied; its
+ * children stay shared until they are asked for in turn.
  */
-XMLNode::XMLNode(const XMLNode& orig):
-      XMLToken (orig)
+XMLNode*
+XMLNode::unshareChild (unsigned int n)
 {
-  std::vector<XMLNode*>::const_iterator it = orig.mChildren.begin();
-  while(it != orig.mChildren.end())
+  XMLNode* child = mChildren[n];
+
+  if (child->mRefs.load(std::memory_order_acquire) > 1)
   {
-    const XMLNode* node = *it;    
-    addChild(*node);
-    ++it;
+    XMLNode* copy = child->shareCopy(*getMemoryResource());
+    copy->mRefs.store(1, std::memory_order_relaxed);
+
+    child->release();
+    mChildren[n] = copy;
+    child = copy;
   }
+
+  child->mParent    = this;
+  child->mShareable = false;
+  return child;
+}
+
+
+/*
+ * Makes this node, which has no children, share those of orig.  A child
+ * that has been handed out for changes may still change through the
+ * reference given, so it is copied instead; the copy in turn shares what
+ * it can.  Children from another resource are copied too, since that
+ * resource may not live as long as this one.
+ */
+void
+XMLNode::shareChildren (const XMLNode& orig)
+{
+  XMLMemoryResource* resource = getMemoryResource();
+  const bool sameResource = 
+    (mChildren.get_allocator() == orig.mChildren.get_allocator());
+
+  mChildren.reserve(orig.mChildren.size());
+
+  for (size_t n = 0; n < orig.mChildren.size(); ++n)
+  {
+    XMLNode* child = orig.mChildren[n];
+
+    if (child->mShareable && sameResource)
+    {
+      child->mRefs.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+      child = child->shareCopy(*resource);
+      child->mRefs.store(1, std::memory_order_relaxed);
+    }
+
+    mChildren.push_back(child);
+  }
+}
+
+
+/*
+ * Makes this node, which has no children, hold copies of the children of
+ * orig, and of everything below them.
+ */
+void
+XMLNode::copyChildren (const XMLNode& orig)
+{
+  XMLMemoryResource* resource = getMemoryResource();
+
+  mChildren.reserve(orig.mChildren.size());
+
+  for (size_t n = 0; n < orig.mChildren.size(); ++n)
+  {
+    XMLNode* child = new (*resource) XMLNode(*orig.mChildren[n], resource);
+    child->mRefs.store(1, std::memory_order_relaxed);
+
+    mChildren.push_back(child);
+  }
+}
+
+
+/*
+ * @return a new node, allocated from resource, with the content of this
+ * one and sharing its children as shareChildren() does.  Its hash and
+ * kept text are those of this node, as is its content.
+ */
+XMLNode*
+XMLNode::shareCopy (XMLMemoryResource& resource) const
+{
+  XMLNode* copy =
+    new (resource) XMLNode(static_cast<const XMLToken&>(*this), &resource);
+
+  copy->shareChildren(*this);
+
+  copy->mHash.store(mHash.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+  std::atomic_store(&copy->mTextCache, std::atomic_load(&mTextCache));
+  copy->mInTextCache.store(mInTextCache.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+
+  return copy;
+}
+
+
+/*
+ * Drops a reference to this node, deleting it with the last one.
+ */
+void
+XMLNode::release ()
+{
+  if (mRefs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+}
+
+
+/*
+ * @return a hash of the content of this node itself, its children being
+ * identified by address.
+ */
+size_t
+XMLNode::contentHash () const
+{
+  unsigned long long value = 
+    static_cast<unsigned long long>( reinterpret_cast<size_t>(mTriple) );
+
+  value = combineHash(value, mKind);
+  value = combineHash(value, hashString(mChars));
+
+  if (mAttributes != NULL)
+  {
+    for (size_t n = 0; n < mAttributes->mNames.size(); ++n)
+    {
+      value = combineHash(value, hashString(mAttributes->mNames[n].getName()));
+      value = combineHash(value, hashString(mAttributes->mValues[n]));
+    }
+  }
+
+  if (mNamespaces != NULL)
+  {
+    for (size_t n = 0; n < mNamespaces->mNamespaces.size(); ++n)
+    {
+      value = combineHash(value, 
+                          hashString(mNamespaces->mNamespaces[n].second));
+    }
+  }
+
+  for (size_t n = 0; n < mChildren.size(); ++n)
+  {
+    value = combineHash(value, reinterpret_cast<size_t>(mChildren[n]));
+  }
+
+  return static_cast<size_t>(value);
+}
+
+
+/*
+ * @return true if this node and other have the same content, the same
+ * children included.  Positions are not compared.  Names are compared by
+ * their interned triple, so a node holding its own copy of a name the
+ * full XMLNamePool did not take is only ever the same as itself.
+ */
+bool
+XMLNode::sameContent (const XMLNode& other) const
+{
+  if (mTriple != other.mTriple || mKind != other.mKind) return false;
+  if (mChars != other.mChars || mChildren != other.mChildren) return false;
+
+  const bool noAttributes  = (mAttributes == NULL || mAttributes->isEmpty());
+  const bool noAttributes2 = (other.mAttributes == NULL 
+                              || other.mAttributes->isEmpty());
+
+  if (noAttributes != noAttributes2) return false;
+  if (!noAttributes && 
+      (mAttributes->mNames  != other.mAttributes->mNames ||
+       mAttributes->mValues != other.mAttributes->mValues))
+    return false;
+
+  const bool noNamespaces  = (mNamespaces == NULL || mNamespaces->isEmpty());
+  const bool noNamespaces2 = (other.mNamespaces == NULL 
+                              || other.mNamespaces->isEmpty());
+
+  if (noNamespaces != noNamespaces2) return false;
+  if (!noNamespaces && 
+      mNamespaces->mNamespaces != other.mNamespaces->mNamespaces)
+    return false;
+
+  return true;
+}
+
+
+/*
+ * @return an estimate of the bytes held by this node itself, not counting
+ * its children.
+ */
+size_t
+XMLNode::getFootprint () const
+{
+  size_t bytes = sizeof(XMLNode) + mChars.capacity()
+               + mChildren.capacity() * sizeof(XMLNode*);
+
+  if (mOwnsTriple)
+  {
+    bytes += sizeof(XMLTriple) + mTriple->getName().capacity()
+           + mTriple->getURI().capacity() + mTriple->getPrefix().capacity();
+  }
+
+  if (mAttributes != NULL)
+  {
+    bytes += sizeof(XMLAttributes);
+    for (size_t n = 0; n < mAttributes->mNames.size(); ++n)
+    {
+      const XMLTriple& triple = mAttributes->mNames[n];
+      bytes += sizeof(XMLTriple) + triple.getName().capacity()
+             + triple.getURI().capacity() + triple.getPrefix().capacity()
+             + sizeof(std::string) + mAttributes->mValues[n].capacity();
+    }
+  }
+
+  if (mNamespaces != NULL)
+  {
+    bytes += sizeof(XMLNamespaces);
+    for (size_t n = 0; n < mNamespaces->mNamespaces.size(); ++n)
+    {
+      bytes += 2 * sizeof(std::string) 
+             + mNamespaces->mNamespaces[n].first.capacity()
+             + mNamespaces->mNamespaces[n].second.capacity();
+    }
+  }
+
+  return bytes;
+}
+/** @endcond */
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Creates a new XMLNode by reading XMLTokens from stream.  The stream must
+ * be positioned on a start element (stream.peek().isStart() == true) and
+ * will be read until the matching end element is found.
+ */
+XMLNode::XMLNode (XMLInputStream& stream) : XMLToken( stream.next() )
+                                          , mChildren ( ChildList::allocator_type(
+                                              stream.getMemoryResource()) )
+                                          , mParent ( NULL )
+                                          , mRefs   ( 0    )
+                                          , mShareable ( true )
+                                          , mHash   ( 0    )
+                                          , mInTextCache ( false )
+{
+  if ( isEnd() ) return;
+
+  readChildren(stream, NULL);
+}
+/** @endcond */
+
+
+/*
+ * Creates a new XMLNode by reading XMLTokens from stream, sharing repeated
+ * content through pool.
+ */
+XMLNode::XMLNode (XMLInputStream& stream, XMLNodePool& pool) 
+                 : XMLToken( stream.next() )
+                 , mParent ( NULL )
+                 , mRefs   ( 0    )
+                 , mShareable ( true )
+                 , mHash   ( 0    )
+                 , mInTextCache ( false )
+{
+  if ( isEnd() ) return;
+
+  readChildren(stream, &pool);
+}
+
+
+/*
+ * Copy constructor; creates a deep copy of this XMLNode.
+ */
+XMLNode::XMLNode(const XMLNode& orig) : XMLNode(orig, NULL)
+{
+}
+
+
+/*
+ * Creates a deep copy of orig whose children are allocated from resource,
+ * or from the default resource if it is NULL.
+ */
+XMLNode::XMLNode(const XMLNode& orig, XMLMemoryResource* resource):
+      XMLToken (orig)
+    , mChildren( ChildList::allocator_type(resource) )
+    , mParent  ( NULL )
+    , mRefs    ( 0    )
+    , mShareable ( true )
+    , mHash    ( orig.mHash.load(std::memory_order_relaxed) )
+    , mTextCache ( std::atomic_load(&orig.mTextCache) )
+    , mInTextCache ( orig.mInTextCache.load(std::memory_order_relaxed) )
+{
+  copyChildren(orig);
 }
 
 
@@ -204,16 +641,17 @@ XMLNode::operator=(const XMLNode& rhs)
   if(&rhs!=this)
   {
     this->XMLToken::operator=(rhs);
-    removeChildren();
 
-    std::vector<XMLNode*>::const_iterator it = rhs.mChildren.begin();
-    while(it != rhs.mChildren.end())
+    // rhs may lie below this node, so its children are copied before the
+    // old ones are let go
+    ChildList old(mChildren.get_allocator());
+    old.swap(mChildren);
+    copyChildren(rhs);
+
+    for (size_t n = 0; n < old.size(); ++n)
     {
-      const XMLNode* node = *it;
-      addChild(*node);
-      ++it;
+      old[n]->release();
     }
-
   }
 
   return *this;
@@ -231,6 +669,182 @@ XMLNode::clone () const
 }
 
 
+/*
+ * Creates a copy of this XMLNode allocated, with the nodes below it, from
+ * resource.
+ */
+XMLNode*
+XMLNode::clone (XMLMemoryResource& resource) const
+{
+  return new (resource) XMLNode(*this, &resource);
+}
+
+
+/*
+ * Creates a copy of this XMLNode that shares its children, copy-on-write.
+ */
+XMLNode*
+XMLNode::cloneShared () const
+{
+  return shareCopy(*XMLMemoryResource::getDefault());
+}
+
+
+/*
+ * @return the resource the children of this node are allocated from.
+ */
+XMLMemoryResource*
+XMLNode::getMemoryResource () const
+{
+  return mChildren.get_allocator().resource();
+}
+
+
+/*
+ * Each XMLNode is preceded in memory by a header naming the resource it
+ * came from and the size of the block, so that operator delete can give
+ * the block back whichever operator new allocated it.
+ */
+struct NodeHeader
+{
+  XMLMemoryResource* resource;
+  size_t             size;
+};
+
+static const size_t NODE_HEADER_SIZE =
+  (sizeof(NodeHeader) + alignof(max_align_t) - 1)
+  / alignof(max_align_t) * alignof(max_align_t);
+
+
+void*
+XMLNode::operator new (size_t size)
+{
+  return operator new(size, *XMLMemoryResource::getDefault());
+}
+
+
+void*
+XMLNode::operator new (size_t size, const std::nothrow_t&) throw()
+{
+  try
+  {
+    return operator new(size, *XMLMemoryResource::getDefault());
+  }
+  catch (...)
+  {
+    return NULL;
+  }
+}
+
+
+void*
+XMLNode::operator new (size_t size, XMLMemoryResource& resource)
+{
+  char* block = static_cast<char*>(
+                  resource.allocate(NODE_HEADER_SIZE + size));
+
+  NodeHeader* header = reinterpret_cast<NodeHeader*>(block);
+  header->resource   = &resource;
+  header->size       = NODE_HEADER_SIZE + size;
+
+  return block + NODE_HEADER_SIZE;
+}
+
+
+void
+XMLNode::operator delete (void* node)
+{
+  if (node == NULL) return;
+
+  char*       block  = static_cast<char*>(node) - NODE_HEADER_SIZE;
+  NodeHeader* header = reinterpret_cast<NodeHeader*>(block);
+
+  header->resource->deallocate(block, header->size);
+}
+
+
+void
+XMLNode::operator delete (void* node, const std::nothrow_t&) throw()
+{
+  operator delete(node);
+}
+
+
+void
+XMLNode::operator delete (void* node, XMLMemoryResource&)
+{
+  operator delete(node);
+}
+
+
+/*
+ * @return the bytes of memory this XMLNode and its descendants hold.
+ */
+size_t
+XMLNode::getMemoryUsage () const
+{
+  XMLMemoryUsage usage;
+  return getMemoryUsage(usage);
+}
+
+
+/*
+ * Adds the memory this XMLNode and its descendants hold to usage.
+ */
+size_t
+XMLNode::getMemoryUsage (XMLMemoryUsage& usage) const
+{
+  return addMemoryUsage(usage, "", sizeof(XMLNode));
+}
+
+
+/*
+ * Each node below this one was allocated with a NodeHeader in front of
+ * it; this node may not have been, so its own size is passed in.
+ */
+size_t
+XMLNode::addMemoryUsage (  XMLMemoryUsage&    usage
+                         , const std::string& parent
+                         , size_t             self ) const
+{
+  const size_t structure = self + mChildren.capacity() * sizeof(XMLNode*);
+  usage.mStructure += structure;
+
+  const size_t own = structure + getContentUsage(usage);
+
+  string name;
+  if (usage.mByElement)
+  {
+    if (isText())
+    {
+      if (!parent.empty()) usage.addElement(parent, own, false);
+    }
+    else if (!isEOF())
+    {
+      name = getPrefix().empty() ? getName() : getPrefix() + ":" + getName();
+      usage.addElement(name, own, true);
+    }
+  }
+
+  size_t total = own;
+  for (size_t n = 0; n < mChildren.size(); ++n)
+  {
+    const XMLNode* child = mChildren[n];
+
+    if (child->mRefs.load(std::memory_order_relaxed) > 1
+        && !usage.firstVisit(child))
+    {
+      continue;
+    }
+
+    total += child->addMemoryUsage(usage, name,
+                                   NODE_HEADER_SIZE + sizeof(XMLNode));
+  }
+
+  return total;
+}
+
+
 /*
  * Adds a copy of child node to this XMLNode.
  */
@@ -238,9 +852,11 @@ int
 XMLNode::addChild (const XMLNode& node)
 {
 
+  XMLMemoryResource* resource = getMemoryResource();
+
   if (isStart())
   {
-    mChildren.push_back(new XMLNode(node));
+    adoptChild(new (*resource) XMLNode(node, resource));
     /* need to catch the case where this node is both a start and
     * an end element
     */
@@ -249,7 +865,7 @@ XMLNode::addChild (const XMLNode& node)
   }
   else if (isEOF())
   {
-    mChildren.push_back(new XMLNode(node));
+    adoptChild(new (*resource) XMLNode(node, resource));
     // this causes strange things to happen when node is written out
     //   this->mIsStart = true;
     return LIBLX_OPERATION_SUCCESS;
@@ -272,11 +888,17 @@ XMLNode::insertChild (unsigned int n, const XMLNode& node)
 
   if ( (n >= size) || (size == 0) )
   {
-    mChildren.push_back(node.clone());
-    return *mChildren.back();
+    adoptChild(node.clone(*getMemoryResource()));
+    return *unshareChild(size);
   }
 
-  return **(mChildren.insert(mChildren.begin() + n, node.clone()));
+  XMLNode* child = node.clone(*getMemoryResource());
+  child->mParent    = this;
+  child->mShareable = false;
+  child->mRefs.store(1, std::memory_order_relaxed);
+  changed();
+
+  return **(mChildren.insert(mChildren.begin() + n, child));
 }
 
 
@@ -295,6 +917,22 @@ XMLNode::removeChild(unsigned int n)
   {
     rval = mChildren[n];
     mChildren.erase(mChildren.begin() + n);
+
+    // the caller owns what is returned, so a shared child is copied; its
+    // own children stay shared
+    if (rval->mRefs.load(std::memory_order_acquire) > 1)
+    {
+      XMLNode* copy = rval->shareCopy(*XMLMemoryResource::getDefault());
+      rval->release();
+      rval = copy;
+    }
+    else
+    {
+      rval->mRefs.store(0, std::memory_order_relaxed);
+    }
+
+    rval->mParent = NULL;
+    changed();
   }
   
   return rval;
@@ -306,10 +944,14 @@ XMLNode::removeChild(unsigned int n)
 int
 XMLNode::removeChildren()
 {
-  std::vector<XMLNode*>::iterator curIt = mChildren.begin();
+  if (mChildren.empty()) return LIBLX_OPERATION_SUCCESS;
+
+  changed();
+
+  ChildList::iterator curIt = mChildren.begin();
     while(curIt != mChildren.end())
     {
-      delete *curIt;    
+      (*curIt)->release();
       ++curIt;
       }
   mChildren.clear(); 
@@ -323,6 +965,11 @@ XMLNode::removeChildren()
 XMLNode&
 XMLNode::getChild (unsigned int n)
 {
+  if (n < getNumChildren())
+  {
+    return *unshareChild(n);
+  }
+
    return const_cast<XMLNode&>( 
             static_cast<const XMLNode&>(*this).getChild(n)
           );
@@ -367,6 +1014,12 @@ XMLNode::getChild (unsigned int n) const
 XMLNode&
 XMLNode::getChild (const std::string&  name)
 {
+  int index = getIndex(name);
+  if (index != -1)
+  {
+    return getChild((unsigned int)index);
+  }
+
   return const_cast<XMLNode&>( 
                 static_cast<const XMLNode&>(*this).getChild(name)
                 );
@@ -435,49 +1088,128 @@ XMLNode::getIndex (const std::string& name) const
 bool 
 XMLNode::equals(const XMLNode& other, bool ignoreURI /*=false*/, bool ignoreAttributeValues /*=false*/) const
 {
-  bool equal;//=true;
-  // check if the nodes have the same name,
-  equal=getName()==other.getName();
-  if (!equal) 
+  if (&other == this) return true;
+
+  // trees with different hashes cannot be equal; the hashes of unchanged
+  // trees are kept, so this is usually all the work done for them
+  if (hash(ignoreURI, ignoreAttributeValues) != 
+      other.hash(ignoreURI, ignoreAttributeValues))
     return false;
-  // the same namespace uri, 
-  equal=(ignoreURI ||  getURI()==other.getURI());
-  if (!equal)
+
+  // check if the nodes have the same name and namespace uri; names are
+  // interned, so the same triple means both are the same
+  if (mTriple != other.mTriple)
+  {
+    if (getName() != other.getName()) 
+      return false;
+    if (!ignoreURI && getURI() != other.getURI())
+      return false;
+  }
+
+  // the same attributes, compared in place
+  const int iMax  = (mAttributes == NULL) ? 0 : mAttributes->getLength();
+  const int iMax2 = (other.mAttributes == NULL) ? 0 
+                                                : other.mAttributes->getLength();
+  if (iMax != iMax2)
     return false;
 
-  XMLAttributes attr1=getAttributes(); 
-  XMLAttributes attr2=other.getAttributes();
-  int i=0,iMax=attr1.getLength();
-  //the same attributes and the same number of children
-  equal=(iMax==attr2.getLength());
-  std::string attrName;
-  int attr2Index;
-  while(equal && i<iMax)
+  for (int i = 0; i < iMax; ++i)
   {
-    attrName=attr1.getName(i);
-    attr2Index = attr2.getIndex(attrName);
-    equal=(attr2Index !=-1);
+    const XMLTriple& attr1 = mAttributes->mNames[i];
+    const std::vector<XMLTriple>& names2 = other.mAttributes->mNames;
+
+    // attributes are usually in the same order on both sides
+    int j = i;
+    if (names2[j].getName() != attr1.getName())
+    {
+      for (j = 0; j < iMax; ++j)
+      {
+        if (names2[j].getName() == attr1.getName()) break;
+      }
+      if (j == iMax)
+        return false;
+    }
+    const XMLTriple& attr2 = names2[j];
+
     // also check the namespace
-    equal=(equal && (attr1.getURI(i)==attr2.getURI(attr2Index)
-      || (attr1.getPrefix(i) == "" && getURI() == attr2.getURI(attr2Index))
-      || (attr2.getPrefix(attr2Index) == "" && other.getURI() == attr1.getURI(i))
-      ));
+    if (!(attr1.getURI() == attr2.getURI()
+      || (attr1.getPrefix().empty() && getURI() == attr2.getURI())
+      || (attr2.getPrefix().empty() && other.getURI() == attr1.getURI())))
+      return false;
+
     // also check the value of the attribute
-    if (!ignoreAttributeValues)
-    equal = (equal && (attr1.getValue(i) == attr2.getValue(attr2Index)));
-    ++i;
+    if (!ignoreAttributeValues && 
+        mAttributes->mValues[i] != other.mAttributes->mValues[j])
+      return false;
   }
 
   // recursively check all children
-  i=0;
-  iMax=getNumChildren();
-  equal=(equal && (iMax==(int)other.getNumChildren()));
-  while(equal && i<iMax)
+  if (mChildren.size() != other.mChildren.size())
+    return false;
+
+  for (size_t c = 0; c < mChildren.size(); ++c)
   {
-    equal=getChild(i).equals(other.getChild(i), ignoreURI, ignoreAttributeValues);
-    ++i;
+    if (!mChildren[c]->equals(*other.mChildren[c], ignoreURI, 
+                              ignoreAttributeValues))
+      return false;
   }
-  return equal; 
+
+  return true; 
+}
+
+
+/*
+ * @return a hash of the tree rooted at this XMLNode.
+ */
+size_t
+XMLNode::hash (bool ignoreURI, bool ignoreAttributeValues) const
+{
+  const unsigned long long options = 1 + (ignoreURI ? 1 : 0)
+                                       + (ignoreAttributeValues ? 2 : 0);
+
+  const unsigned long long cached = mHash.load(std::memory_order_relaxed);
+  if ((cached >> HASH_BITS) == options)
+  {
+    return static_cast<size_t>(cached & HASH_MASK);
+  }
+
+  unsigned long long value = hashString(getName());
+  if (!ignoreURI) value = combineHash(value, hashString(getURI()));
+
+  // attributes are matched by name whatever their order, so their hashes
+  // are summed; their namespaces may differ between equal nodes
+  if (mAttributes != NULL)
+  {
+    unsigned long long attributes = 0;
+    const int length = mAttributes->getLength();
+
+    for (int i = 0; i < length; ++i)
+    {
+      unsigned long long attribute = 
+        combineHash(0, hashString(mAttributes->mNames[i].getName()));
+
+      if (!ignoreAttributeValues)
+      {
+        attribute = combineHash(attribute, hashString(mAttributes->mValues[i]));
+      }
+
+      attributes += attribute;
+    }
+
+    value = combineHash(value, attributes);
+  }
+
+  value = combineHash(value, mChildren.size());
+  for (size_t c = 0; c < mChildren.size(); ++c)
+  {
+    value = combineHash(value, 
+                        mChildren[c]->hash(ignoreURI, ignoreAttributeValues));
+  }
+
+  value &= HASH_MASK;
+  mHash.store((options << HASH_BITS) | value, std::memory_order_relaxed);
+
+  return static_cast<size_t>(value);
 }
 
 
@@ -506,11 +1238,120 @@ XMLNode::getNumChildren () const
 
 
 /** @cond doxygenLibsbmlInternal */
+/*
+ * The text an element was written as, with the state of the stream
+ * before it, which decides how the text starts and how deeply it is
+ * indented, and the state the stream is left in after it.
+ */
+struct XMLNode::TextCache
+{
+  bool          inStart;
+  bool          inText;
+  bool          skipNextIndent;
+  bool          doIndent;
+  unsigned int  indent;
+  unsigned int  indentWidth;
+  std::string   lineEnding;
+
+  bool          inStartAfter;
+  bool          inTextAfter;
+  bool          skipNextIndentAfter;
+  unsigned int  indentAfter;
+
+  std::string   text;
+};
+
+
 /*
  * Writes this XMLNode and its children to stream.
  */
 void
 XMLNode::write (XMLOutputStream& stream) const
+{
+  if (stream.mOptions.getCacheNodes())
+  {
+    if (!mChildren.empty())
+    {
+      writeCached(stream);
+      return;
+    }
+
+    // a childless node keeps no text of its own, but its ancestors' text
+    // includes it
+    mInTextCache.store(true, std::memory_order_relaxed);
+  }
+
+  writeContent(stream);
+}
+
+
+/*
+ * Writes this node from the text kept for it if that text was written in
+ * the state stream is in now.  Otherwise the node is written to a stream
+ * of its own, started in that state, and the text is kept.
+ */
+void
+XMLNode::writeCached (XMLOutputStream& stream) const
+{
+  const XMLWriterOptions& options = stream.mOptions;
+
+  std::shared_ptr<const TextCache> cache = std::atomic_load(&mTextCache);
+
+  if (!cache
+      || cache->inStart        != stream.mInStart
+      || cache->inText         != stream.mInText
+      || cache->skipNextIndent != stream.mSkipNextIndent
+      || cache->doIndent       != stream.mDoIndent
+      || cache->indent         != stream.mIndent
+      || cache->indentWidth    != options.getIndentWidth()
+      || cache->lineEnding     != options.getLineEnding())
+  {
+    std::ostringstream oss;
+    XMLOutputStream capture(oss, options, stream.mEncoding, false);
+
+    capture.mInStart        = stream.mInStart;
+    capture.mInText         = stream.mInText;
+    capture.mSkipNextIndent = stream.mSkipNextIndent;
+    capture.mDoIndent       = stream.mDoIndent;
+    capture.mIndent         = stream.mIndent;
+
+    writeContent(capture);
+
+    TextCache* text = new TextCache;
+
+    text->inStart             = stream.mInStart;
+    text->inText              = stream.mInText;
+    text->skipNextIndent      = stream.mSkipNextIndent;
+    text->doIndent            = stream.mDoIndent;
+    text->indent              = stream.mIndent;
+    text->indentWidth         = options.getIndentWidth();
+    text->lineEnding          = options.getLineEnding();
+    text->inStartAfter        = capture.mInStart;
+    text->inTextAfter         = capture.mInText;
+    text->skipNextIndentAfter = capture.mSkipNextIndent;
+    text->indentAfter         = capture.mIndent;
+    text->text                = oss.str();
+
+    cache.reset(text);
+    std::atomic_store(&mTextCache, cache);
+    mInTextCache.store(true, std::memory_order_relaxed);
+  }
+
+  stream.mStream.write(cache->text.data(), 
+                       static_cast<std::streamsize>(cache->text.size()));
+
+  stream.mInStart        = cache->inStartAfter;
+  stream.mInText         = cache->inTextAfter;
+  stream.mSkipNextIndent = cache->skipNextIndentAfter;
+  stream.mIndent         = cache->indentAfter;
+}
+
+
+/*
+ * Writes this XMLNode and its children to stream.
+ */
+void
+XMLNode::writeContent (XMLOutputStream& stream) const
 {
   unsigned int children = getNumChildren();
 
@@ -526,7 +1367,7 @@ XMLNode::write (XMLOutputStream& stream) const
         haveTextNode |= current.isText();
     }
 
-    if (!mTriple.isEmpty())
+    if (mTriple != NULL)
     {
       // I removed this as it was creating un - necessary down indents
       // no tests failed as a result of removing it
@@ -541,12 +1382,12 @@ XMLNode::write (XMLOutputStream& stream) const
       //  stream.downIndent();
       //}
 
-      stream.endElement( mTriple, haveTextNode);
+      stream.endElement( getTriple(), haveTextNode);
     }
   }
   else if ( isStart() && !isEnd() ) 
   {
-    stream.endElement( mTriple );
+    stream.endElement( getTriple() );
   }
 
 }
@@ -572,9 +1413,19 @@ XMLNode::writeToStream(XMLOutputStream& stream) const
  * Returns a string which is converted from this XMLNode.
  */
 std::string XMLNode::toXMLString() const
+{
+  return toXMLString(fragmentOptions());
+}
+
+
+/*
+ * Returns a string which is converted from this XMLNode, formatted as
+ * options say.
+ */
+std::string XMLNode::toXMLString(const XMLWriterOptions& options) const
 {
   std::ostringstream oss;
-  XMLOutputStream xos(oss,"UTF-8",false);
+  XMLOutputStream xos(oss, options, "UTF-8", false);
   write(xos);
 
   return oss.str();
@@ -586,20 +1437,29 @@ std::string XMLNode::toXMLString() const
  */
 std::string XMLNode::convertXMLNodeToString(const XMLNode* xnode)
 {
-  if(xnode == NULL) return "";
+  return convertXMLNodeToString(xnode, fragmentOptions());
+}
 
-  std::ostringstream oss;
-  XMLOutputStream xos(oss,"UTF-8",false);
-  xnode->write(xos);
 
-  return oss.str();
+/*
+ * Returns a string which is converted from a given XMLNode, formatted as
+ * options say.
+ */
+std::string XMLNode::convertXMLNodeToString(const XMLNode* xnode,
+                                            const XMLWriterOptions& options)
+{
+  if(xnode == NULL) return "";
+
+  return xnode->toXMLString(options);
 }
 
 
 /*
  * Returns a XMLNode which is converted from a given string.
  */
-XMLNode* XMLNode::convertStringToXMLNode(const std::string& xmlstr, const XMLNamespaces* xmlns)
+XMLNode* XMLNode::convertStringToXMLNode(const std::string& xmlstr, 
+                                         const XMLNamespaces* xmlns,
+                                         XMLNodePool* pool)
 {
 
   XMLNode* xmlnode     = NULL;
@@ -627,7 +1487,8 @@ XMLNode* XMLNode::convertStringToXMLNode(const std::string& xmlstr, const XMLNam
 
   const char* xmlstr_c = safe_strdup(oss.str().c_str());
   XMLInputStream xis(xmlstr_c,false);
-  XMLNode* xmlnode_tmp = new XMLNode(xis);
+  XMLNode* xmlnode_tmp = (pool != NULL) ? new XMLNode(xis, *pool) 
+                                        : new XMLNode(xis);
 
   if(xis.isError() || (xmlnode_tmp->getNumChildren() == 0) )
   {
@@ -644,16 +1505,17 @@ XMLNode* XMLNode::convertStringToXMLNode(const std::string& xmlstr, const XMLNam
    *  <p xmlns="http://www.w3.org/1999/xhtml"> Test2 </p>
    */
 
+  // the children are handed over rather than copied
   if (xmlnode_tmp->getNumChildren() == 1)
   {
-    xmlnode = new XMLNode(xmlnode_tmp->getChild(0));
+    xmlnode = xmlnode_tmp->removeChild(0);
   }
   else
   {
     xmlnode = new XMLNode();
     for(unsigned int i=0; i < xmlnode_tmp->getNumChildren(); i++)
     {
-      xmlnode->addChild(xmlnode_tmp->getChild(i));
+      xmlnode->adoptChild(xmlnode_tmp->mChildren[i]);
     }
   }
 
@@ -765,6 +1627,15 @@ XMLNode_clone (const XMLNode_t* n)
 }
 
 
+LIBLX_EXTERN
+XMLNode_t *
+XMLNode_cloneShared (const XMLNode_t* n)
+{
+  if (n == NULL) return NULL;
+  return n->cloneShared();
+}
+
+
 LIBLX_EXTERN
 void
 XMLNode_free (XMLNode_t *node)
@@ -917,6 +1788,14 @@ XMLNode_equals(const XMLNode_t *node, const XMLNode_t* other)
   return static_cast<int>( node->equals(*other) );
 }
 
+LIBLX_EXTERN
+unsigned long
+XMLNode_hash (const XMLNode_t *node)
+{
+  if (node == NULL) return 0;
+  return static_cast<unsigned long>( node->hash() );
+}
+
 LIBLX_EXTERN
 unsigned int
 XMLNode_getNumChildren (const XMLNode_t *node)
@@ -1368,6 +2247,16 @@ XMLNode_convertXMLNodeToString(const XMLNode_t *node)
 }
 
 
+LIBLX_EXTERN
+char *
+XMLNode_toXMLStringWithOptions(const XMLNode_t *node,
+                               const XMLWriterOptions_t *options)
+{
+  if (node == NULL || options == NULL) return NULL;
+  return safe_strdup(node->toXMLString(*options).c_str());
+}
+
+
 LIBLX_EXTERN
 XMLNode_t *
 XMLNode_convertStringToXMLNode(const char * xml, const XMLNamespaces_t* xmlns)
@@ -1377,6 +2266,17 @@ XMLNode_convertStringToXMLNode(const char * xml, const XMLNamespaces_t* xmlns)
 }
 
 
+LIBLX_EXTERN
+XMLNode_t *
+XMLNode_convertStringToXMLNodeWithPool(const char * xml, 
+                                       const XMLNamespaces_t* xmlns,
+                                       XMLNodePool_t* pool)
+{
+  if (xml == NULL || pool == NULL) return NULL;
+  return XMLNode::convertStringToXMLNode(xml, xmlns, pool);
+}
+
+
 LIBLX_EXTERN
 int
 XMLNode_isElement (const XMLNode_t *node)
@@ -1456,6 +2356,15 @@ XMLNode_unsetEnd (XMLNode_t *node)
   if (node == NULL) return LIBLX_INVALID_OBJECT;
   return node->unsetEnd();
 }
+
+
+LIBLX_EXTERN
+unsigned long
+XMLNode_getMemoryUsage (const XMLNode_t *node)
+{
+  if (node == NULL) return 0;
+  return (unsigned long) node->getMemoryUsage();
+}
 /** @endcond */
 
 LIBLX_CPP_NAMESPACE_END
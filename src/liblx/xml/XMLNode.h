@@ -152,12 +152,16 @@ else:
 #define XMLNode_h
 
 #include <liblx/xml/common/extern.h>
+#include <liblx/xml/XMLMemoryResource.h>
 #include <liblx/xml/XMLToken.h>
 #include <liblx/xml/common/liblxfwd.h>
 
 
 #ifdef __cplusplus
 
+#include <atomic>
+#include <memory>
+#include <new>
 #include <vector>
 #include <cstdlib>
 
@@ -165,7 +169,9 @@ LIBLX_CPP_NAMESPACE_BEGIN
 
 /** @cond doxygenLibsbmlInternal */
 class XMLInputStream;
+class XMLNodePool;
 class XMLOutputStream;
+class XMLWriterOptions;
 /** @endcond */
 
 
@@ -256,7 +262,8 @@ public:
    *
    * The stream must be positioned on a start element
    * (<code>stream.peek().isStart() == true</code>) and will be read until
-   * the matching end element is found.
+   * the matching end element is found.  The nodes below the new one are
+   * allocated from the stream's XMLMemoryResource.
    *
    * @param stream XMLInputStream from which XMLNode is to be created.
    */
@@ -264,6 +271,31 @@ public:
   /** @endcond */
 
 
+  /**
+   * Creates a new XMLNode by reading XMLTokens from stream, sharing
+   * repeated content through pool.
+   *
+   * Each subtree read below the new node is looked up in @p pool, and a
+   * subtree the pool has seen before, in this or an earlier document, is
+   * shared instead of being stored again.  The shared nodes are copied as
+   * soon as they are changed through this tree, so the tree behaves as
+   * if it had been read without a pool.  Shared nodes report the line and
+   * column of the first place their content was read.
+   *
+   * The stream must be positioned on a start element
+   * (<code>stream.peek().isStart() == true</code>) and will be read until
+   * the matching end element is found.  Since the pool may keep the nodes
+   * read for longer than any XMLMemoryResource given to the stream, they
+   * are allocated from the default resource.
+   *
+   * @param stream XMLInputStream from which XMLNode is to be created.
+   * @param pool the XMLNodePool keeping the content read so far.
+   *
+   * @see XMLNodePool
+   */
+  XMLNode (XMLInputStream& stream, XMLNodePool& pool);
+
+
   /**
    * Destroys this XMLNode.
    */
@@ -271,7 +303,7 @@ public:
 
 
   /**
-   * Copy constructor; creates a copy of this XMLNode.
+   * Copy constructor; creates a deep copy of this XMLNode.
    *
    * @param orig the XMLNode instance to copy.
    */
@@ -279,7 +311,8 @@ public:
 
 
   /**
-   * Assignment operator for XMLNode.
+   * Assignment operator for XMLNode.  The children of @p rhs are copied
+   * as by the copy constructor.
    *
    * @param rhs the XMLNode object whose values are used as the basis
    * of the assignment.
@@ -295,6 +328,82 @@ public:
   XMLNode* clone () const;
 
 
+  /**
+   * Creates and returns a copy of this XMLNode that shares the children
+   * of this one rather than copying them.  A shared child is copied only
+   * when one of the trees holding it asks for it for changes, through
+   * getChild(), so the copy costs little more than the node itself.
+   *
+   * A reference to a shared child taken through const access is left to
+   * the old child when its tree later asks for that child for changes:
+   * it stays valid while any tree still holds the old child, but no
+   * longer follows the tree it was taken from.
+   *
+   * @return the copy, to be deleted by the caller.
+   *
+   * @see clone()
+   */
+  XMLNode* cloneShared () const;
+
+
+  /**
+   * Creates and returns a copy of this XMLNode allocated, with all the
+   * nodes below it, from @p resource.
+   *
+   * @param resource the XMLMemoryResource the copy is allocated from.
+   *
+   * @return the copy, to be deleted by the caller while @p resource is
+   * alive.
+   *
+   * @see getMemoryResource()
+   */
+  XMLNode* clone (XMLMemoryResource& resource) const;
+
+
+  /**
+   * Returns the XMLMemoryResource the children of this node are
+   * allocated from: children added, copied or read later come from it.
+   * The default resource, on the global heap, is used unless the node was
+   * read from an XMLInputStream given another, or made by
+   * clone(XMLMemoryResource&).
+   *
+   * @return the resource of this node's children.
+   */
+  XMLMemoryResource* getMemoryResource () const;
+
+
+#ifndef SWIG
+
+  /** @cond doxygenLibsbmlInternal */
+  /*
+   * XMLNode objects remember the resource they came from, so that delete
+   * returns them to it.
+   */
+  static void* operator new (size_t size);
+  static void* operator new (size_t size, const std::nothrow_t&) throw();
+  static void  operator delete (void* node);
+  static void  operator delete (void* node, const std::nothrow_t&) throw();
+  /** @endcond */
+
+
+  /**
+   * Allocates an XMLNode from @p resource, as in
+   * <code>new (resource) XMLNode(stream)</code>.  The node is given back
+   * to @p resource when it is deleted.
+   *
+   * @param size the size of the node.
+   * @param resource the XMLMemoryResource to allocate from.
+   */
+  static void* operator new (size_t size, XMLMemoryResource& resource);
+
+
+  /** @cond doxygenLibsbmlInternal */
+  static void  operator delete (void* node, XMLMemoryResource& resource);
+  /** @endcond */
+
+#endif  /* !SWIG */
+
+
   /**
    * Adds a copy of @p node as a child of this XMLNode.
    *
@@ -362,6 +471,13 @@ public:
    * If the index @p n is greater than the number of child nodes,
    * this method returns an empty node.
    *
+   * A child shared with other trees, as read through an XMLNodePool or
+   * copied by cloneShared(), is first replaced by a copy of its own, so
+   * that changes made through the reference returned affect this tree
+   * only.  A reference to that child taken earlier through const access
+   * then keeps to the old, shared child and no longer follows this tree;
+   * references to children that are not shared are never affected.
+   *
    * @param n an unsigned integer, the index of the node to return.
    *
    * @return the <code>n</code>th child of this XMLNode.
@@ -436,6 +552,14 @@ public:
    * Compare this XMLNode against another XMLNode returning true if both
    * nodes represent the same XML tree, or false otherwise.
    *
+   * Element names and URIs, attributes and the structure of the children
+   * are compared; character data is not.  The hashes of both trees are
+   * compared first, so trees that differ are usually told apart without
+   * walking them, and nothing is copied.  Where an element has several
+   * attributes with the same local name, each is matched to the attribute
+   * of that name at the same position in @p other if there is one, and to
+   * the first otherwise.
+   *
    * @param other another XMLNode to compare against.
    *
    * @param ignoreURI whether to ignore the namespace URI when doing the
@@ -448,6 +572,30 @@ public:
    * tree as another.
    */
   bool equals(const XMLNode& other, bool ignoreURI=false, bool ignoreAttributeValues=false) const;
+
+
+  /**
+   * Returns a hash of the tree rooted at this XMLNode.
+   *
+   * Nodes that are equal according to equals() with the same options have
+   * the same hash, so the hash can be used to group or deduplicate trees.
+   * Attribute namespaces and character data do not contribute, as they do
+   * not to equals().
+   *
+   * The hash is kept with each node and recomputed only after the node or
+   * one of its descendants changes, so hashing an unchanged tree again
+   * costs nothing.  A node remembers the hash for one set of options at a
+   * time.
+   *
+   * @param ignoreURI whether to leave element namespace URIs out of the
+   * hash.
+   *
+   * @param ignoreAttributeValues whether to leave attribute values out of
+   * the hash.
+   *
+   * @return the hash of this XMLNode and its descendants.
+   */
+  size_t hash (bool ignoreURI = false, bool ignoreAttributeValues = false) const;
 	
 
   /**
@@ -484,6 +632,31 @@ public:
   std::string toXMLString() const;
 
 
+  /**
+   * Returns a string representation of this XMLNode, formatted as
+   * @p options say.
+   *
+   * With XMLWriterOptions::withCacheNodes(), each element with children
+   * keeps the text written for it, and later calls write that text again
+   * for every subtree that has not changed since, at the same depth.  A
+   * change to a node drops the text kept by it and by its ancestors, so
+   * only the subtrees on the path to it are written afresh.
+   *
+@code{.cpp}
+const XMLWriterOptions cached = XMLWriterOptions().withCacheNodes(true);
+
+std::string before = annotation.toXMLString(cached);
+annotation.getChild(0).addAttr("id", "a1");
+std::string after  = annotation.toXMLString(cached);  // rewrites child 0 only
+@endcode
+   *
+   * @param options the formatting to use.
+   *
+   * @return a string derived from this XMLNode.
+   */
+  std::string toXMLString(const XMLWriterOptions& options) const;
+
+
   /**
    * Returns a string representation of a given XMLNode.
    *
@@ -494,6 +667,45 @@ public:
   static std::string convertXMLNodeToString(const XMLNode* node);
 
 
+  /**
+   * Returns a string representation of a given XMLNode, formatted as
+   * @p options say.
+   *
+   * @param node the XMLNode to be represented as a string.
+   * @param options the formatting to use; see
+   * toXMLString(const XMLWriterOptions&) for node caching.
+   *
+   * @return a string-form representation of @p node.
+   */
+  static std::string convertXMLNodeToString(const XMLNode* node,
+                                            const XMLWriterOptions& options);
+
+
+  /**
+   * Returns the bytes of memory this XMLNode and the nodes below it hold,
+   * counting the nodes themselves, their lists of children, characters,
+   * attributes and namespaces, and the spare capacity of each.
+   *
+   * @return the bytes held by this XMLNode and its descendants.
+   *
+   * @see XMLMemoryUsage
+   */
+  size_t getMemoryUsage () const;
+
+
+  /**
+   * Adds the memory this XMLNode and the nodes below it hold to @p usage,
+   * split by kind and, if @p usage was created to, by element name, and
+   * returns it.  Children that @p usage has already met through another
+   * tree sharing them are not counted again.
+   *
+   * @param usage the XMLMemoryUsage to add to.
+   *
+   * @return the bytes added.
+   */
+  virtual size_t getMemoryUsage (XMLMemoryUsage& usage) const;
+
+
   /**
    * Returns an XMLNode which is derived from a string containing XML
    * content.
@@ -504,6 +716,9 @@ public:
    *
    * @param xmlstr string to be converted to a XML node.
    * @param xmlns XMLNamespaces the namespaces to set (default value is @c NULL).
+   * @param pool an XMLNodePool through which repeated content is shared,
+   * as with XMLNode(XMLInputStream&, XMLNodePool&), or @c NULL (the
+   * default) to store every node.
    *
    * @note The caller owns the returned XMLNode and is reponsible for
    * deleting it.  The returned XMLNode object is a dummy root (container)
@@ -520,7 +735,8 @@ public:
    * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
    */
   static XMLNode* convertStringToXMLNode(const std::string& xmlstr,
-                                         const XMLNamespaces* xmlns = NULL);
+                                         const XMLNamespaces* xmlns = NULL,
+                                         XMLNodePool* pool = NULL);
 
 
 #ifndef SWIG
@@ -545,7 +761,154 @@ public:
 
 protected:
   /** @cond doxygenLibsbmlInternal */
-  std::vector<XMLNode*> mChildren;
+  friend class XMLDocumentStore;
+  friend class XMLNodePool;
+  friend class XMLParallelParser;
+
+  typedef std::vector<XMLNode*, XMLAllocator<XMLNode*> > ChildList;
+
+  /*
+   * Creates a new XMLNode by copying token, whose children will be
+   * allocated from resource.
+   */
+  XMLNode (const XMLToken& token, XMLMemoryResource* resource);
+
+  /*
+   * Creates a deep copy of orig whose children are allocated from
+   * resource, or from the default resource if it is NULL.
+   */
+  XMLNode (const XMLNode& orig, XMLMemoryResource* resource);
+
+  /*
+   * Forgets the hash and the text kept for this node and for its
+   * ancestors.
+   */
+  virtual void changed ();
+
+  /*
+   * Writes this node and its children to stream without consulting the
+   * text kept for this node.
+   */
+  void writeContent (XMLOutputStream& stream) const;
+
+  /*
+   * Writes this node to stream from the text kept for it, if that was
+   * written in the state stream is in, and otherwise writes it afresh and
+   * keeps the text.
+   */
+  void writeCached (XMLOutputStream& stream) const;
+
+  /*
+   * Makes node the last child of this node, taking a reference to it.
+   */
+  void adoptChild (XMLNode* node);
+
+  /*
+   * Reads the children of this node from stream, sharing them through
+   * pool unless it is NULL.
+   */
+  void readChildren (XMLInputStream& stream, XMLNodePool* pool);
+
+  /*
+   * @return the nth child, first replaced by a copy of its own if it is
+   * shared, so that it can be changed.
+   */
+  XMLNode* unshareChild (unsigned int n);
+
+  /*
+   * Makes this node share the children of orig, or hold copies of those
+   * that may be changed through a reference handed out earlier.
+   */
+  void shareChildren (const XMLNode& orig);
+
+  /*
+   * Makes this node, which has no children, hold deep copies of the
+   * children of orig.
+   */
+  void copyChildren (const XMLNode& orig);
+
+  /*
+   * @return a new node allocated from resource, with the content of this
+   * one, sharing its children as shareChildren() does.
+   */
+  XMLNode* shareCopy (XMLMemoryResource& resource) const;
+
+  /*
+   * Drops a reference to this node, deleting it with the last one.
+   */
+  void release ();
+
+  /*
+   * @return a hash of the content of this node itself, its children
+   * being identified by address; equal for nodes that sameContent().
+   */
+  size_t contentHash () const;
+
+  /*
+   * @return true if this node and other have the same name, kind,
+   * characters, attributes and namespaces in the same order, and the very
+   * same children.
+   */
+  bool sameContent (const XMLNode& other) const;
+
+  /*
+   * @return an estimate of the bytes held by this node itself, not
+   * counting its children.
+   */
+  size_t getFootprint () const;
+
+  /*
+   * Adds this node, taking self bytes itself, and the nodes below it to
+   * usage; text counts towards the element called parent.
+   */
+  size_t addMemoryUsage (  XMLMemoryUsage&    usage
+                         , const std::string& parent
+                         , size_t             self ) const;
+
+  /*
+   * The children are shared with other nodes when their reference count
+   * is above one; parents and XMLNodePools each hold a reference, while a
+   * node owned by its caller holds none.  The list, and the children
+   * added to it, are allocated from the resource of its allocator.
+   */
+  ChildList mChildren;
+
+  /*
+   * The node this one was last handed out for changes by, or NULL; used
+   * to pass changes up to the nodes whose hashes depend on this one.
+   * Shared nodes never change, so it is not kept up to date for them.
+   */
+  XMLNode* mParent;
+
+  std::atomic<unsigned int> mRefs;
+
+  /*
+   * False once a reference to this node has been handed out for changes,
+   * after which shared copies of its parent, made by cloneShared(), hold
+   * copies of it instead of sharing it, since it may change at any time.
+   */
+  bool mShareable;
+
+  /*
+   * The last hash computed, in the low HASH_BITS bits, and the options it
+   * was computed with in the bits above; 0 if there is none.  A node whose
+   * hash is unknown has ancestors whose hashes are unknown too.
+   */
+  mutable std::atomic<unsigned long long> mHash;
+
+  /*
+   * The text this node was last written as when node caching was on,
+   * with the stream states before and after it; empty if there is none.
+   */
+  struct TextCache;
+  mutable std::shared_ptr<const TextCache> mTextCache;
+
+  /*
+   * True while the text of this node is part of a kept text, its own or
+   * an ancestor's.  A node for which it is false has ancestors for which
+   * it is false too, so changed() can stop there.
+   */
+  mutable std::atomic<bool> mInTextCache;
 
   /** @endcond */
 };
@@ -652,7 +1015,7 @@ XMLNode_createTextNode (const char *text);
 
 
 /**
- * Creates a deep copy of the given XMLNode_t structure
+ * Creates a deep copy of the given XMLNode_t structure.
  *
  * @param n the XMLNode_t structure to be copied.
  *
@@ -665,6 +1028,24 @@ XMLNode_t *
 XMLNode_clone (const XMLNode_t* n);
 
 
+/**
+ * Creates a copy of the given XMLNode_t structure that shares its
+ * children until they are asked for changes.
+ *
+ * @param n the XMLNode_t structure to be copied.
+ *
+ * @return a copy of the given XMLNode_t structure, sharing its children.
+ *
+ * @see XMLNode_clone()
+ * @see XMLNode::cloneShared()
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+XMLNode_t *
+XMLNode_cloneShared (const XMLNode_t* n);
+
+
 /**
  * Destroys this XMLNode_t structure.
  *
@@ -934,6 +1315,22 @@ LIBLX_EXTERN
 int
 XMLNode_equals(const XMLNode_t *node, const XMLNode_t* other);
 
+
+/**
+ * Returns a hash of the tree rooted at this XMLNode_t structure, equal for
+ * nodes that XMLNode_equals() considers equal.
+ *
+ * @param node XMLNode_t structure to be hashed.
+ *
+ * @return the hash of @p node and its descendants, or @c 0 if @p node is
+ * @c NULL.
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLNode_hash (const XMLNode_t *node);
+
 /**
  * Returns the number of children for this XMLNode_t structure.
  *
@@ -1807,6 +2204,26 @@ const char *
 XMLNode_convertXMLNodeToString(const XMLNode_t *node);
 
 
+/**
+ * Returns a string which is converted from a given XMLNode_t, formatted
+ * as the given options say.
+ *
+ * @param node XMLNode_t to be converted to a string.
+ * @param options the XMLWriterOptions_t to format it with.
+ *
+ * @return a string (char*) which is converted from a given XMLNode_t, or
+ * @c NULL if @p node or @p options is @c NULL.
+ *
+ * @note returned char* should be freed with safe_free() by the caller.
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+char *
+XMLNode_toXMLStringWithOptions(const XMLNode_t *node,
+                               const XMLWriterOptions_t *options);
+
+
 /**
  * Returns an XMLNode_t pointer which is converted from a given string containing
  * XML content.
@@ -1826,6 +2243,27 @@ XMLNode_t *
 XMLNode_convertStringToXMLNode(const char * xml, const XMLNamespaces_t* xmlns);
 
 
+/**
+ * Returns an XMLNode_t pointer which is converted from a given string
+ * containing XML content, sharing repeated content through an
+ * XMLNodePool_t.
+ *
+ * @param xml string to be converted to a XML node.
+ * @param xmlns XMLNamespaces_t structure the namespaces to set.
+ * @param pool XMLNodePool_t structure keeping the content read so far.
+ *
+ * @return pointer to XMLNode_t structure which is converted from a given
+ * string, or @c NULL if @p xml or @p pool is @c NULL.
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+XMLNode_t *
+XMLNode_convertStringToXMLNodeWithPool(const char * xml,
+                                       const XMLNamespaces_t* xmlns,
+                                       XMLNodePool_t* pool);
+
+
 /**
  * Predicate returning @c 1 (true) or @c 0 (false) depending on whether
  * this XMLNode_t structure is an XML element.
@@ -1970,6 +2408,21 @@ int
 XMLNode_unsetEnd (XMLNode_t *node);
 
 
+/**
+ * Returns the bytes of memory held by the given XMLNode_t structure,
+ * counting the structure itself, the nodes below it, their characters, attributes and namespaces, and the spare capacity of each.
+ *
+ * @param node the XMLNode_t structure.
+ *
+ * @return the bytes held, or @c 0 if @p node is @c NULL.
+ *
+ * @memberof XMLNode_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLNode_getMemoryUsage (const XMLNode_t *node);
+
+
 END_C_DECLS
 LIBLX_CPP_NAMESPACE_END
 
@@ -0,0 +1,229 @@
+/**
+ * @file    XMLNodePool.cpp
+ * @brief   Shares identical subtrees between XMLNode trees
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <new>
+#include <ostream>
+#include <vector>
+
+#include <liblx/xml/XMLNodePool.h>
+#include <liblx/xml/XMLNode.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/*
+ * Creates a new, empty XMLNodePool.
+ */
+XMLNodePool::XMLNodePool ()
+ : mNumRead    ( 0 )
+ , mNumShared  ( 0 )
+ , mBytesSaved ( 0 )
+{
+}
+
+
+/*
+ * Destroys this XMLNodePool.
+ */
+XMLNodePool::~XMLNodePool ()
+{
+  clear();
+}
+
+
+/*
+ * @return the number of nodes read through this pool.
+ */
+unsigned int
+XMLNodePool::getNumRead () const
+{
+  lock_guard<mutex> guard(mLock);
+  return mNumRead;
+}
+
+
+/*
+ * @return the number of nodes read through this pool that were shared.
+ */
+unsigned int
+XMLNodePool::getNumShared () const
+{
+  lock_guard<mutex> guard(mLock);
+  return mNumShared;
+}
+
+
+/*
+ * @return the number of distinct nodes this pool keeps.
+ */
+unsigned int
+XMLNodePool::getNumKept () const
+{
+  lock_guard<mutex> guard(mLock);
+  return (unsigned int) mNodes.size();
+}
+
+
+/*
+ * @return an estimate of the bytes that sharing has saved.
+ */
+size_t
+XMLNodePool::getBytesSaved () const
+{
+  lock_guard<mutex> guard(mLock);
+  return mBytesSaved;
+}
+
+
+/*
+ * Writes a summary of the nodes read, shared and kept, and of the memory
+ * saved, to stream.
+ */
+void
+XMLNodePool::printReport (std::ostream& stream) const
+{
+  unsigned int read, shared, kept;
+  size_t       saved;
+  {
+    lock_guard<mutex> guard(mLock);
+    read   = mNumRead;
+    shared = mNumShared;
+    kept   = (unsigned int) mNodes.size();
+    saved  = mBytesSaved;
+  }
+
+  const double percent = (read > 0) ? 100.0 * shared / read : 0.0;
+
+  stream << "nodes read:   " << read   << '\n'
+         << "nodes shared: " << shared << " (" << percent << "%)\n"
+         << "nodes kept:   " << kept   << '\n'
+         << "bytes saved:  " << saved  << '\n';
+}
+
+
+/*
+ * Drops the references this pool holds.
+ */
+void
+XMLNodePool::clear ()
+{
+  unordered_multimap<size_t, XMLNode*> nodes;
+  {
+    lock_guard<mutex> guard(mLock);
+    nodes.swap(mNodes);
+  }
+
+  unordered_multimap<size_t, XMLNode*>::iterator it;
+  for (it = nodes.begin(); it != nodes.end(); ++it)
+  {
+    it->second->release();
+  }
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Takes a node whose children have been interned already and returns the
+ * node kept for its content.  Because the children are interned first,
+ * equal subtrees have the very same children, and comparing two nodes
+ * never needs to look below them.
+ */
+XMLNode*
+XMLNodePool::intern (XMLNode* node)
+{
+  const size_t hash  = node->contentHash();
+  XMLNode*     found = NULL;
+  {
+    lock_guard<mutex> guard(mLock);
+    ++mNumRead;
+
+    typedef unordered_multimap<size_t, XMLNode*>::iterator Iterator;
+    pair<Iterator, Iterator> range = mNodes.equal_range(hash);
+
+    for (Iterator it = range.first; it != range.second; ++it)
+    {
+      if (it->second->sameContent(*node))
+      {
+        found = it->second;
+        break;
+      }
+    }
+
+    if (found == NULL)
+    {
+      /* one reference for the pool and one for the caller */
+      node->mRefs.fetch_add(2, memory_order_relaxed);
+      mNodes.insert(make_pair(hash, node));
+      return node;
+    }
+
+    ++mNumShared;
+    mBytesSaved += node->getFootprint();
+
+    /* the caller's reference is taken before the lock is released, so a
+     * concurrent clear() cannot free the node first */
+    found->mRefs.fetch_add(1, memory_order_relaxed);
+  }
+
+  delete node;
+  return found;
+}
+/** @endcond */
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLNodePool_t *
+XMLNodePool_create (void)
+{
+  return new(nothrow) XMLNodePool();
+}
+
+
+LIBLX_EXTERN
+void
+XMLNodePool_free (XMLNodePool_t *pool)
+{
+  if (pool == NULL) return;
+  delete static_cast<XMLNodePool*>(pool);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLNodePool_getNumShared (const XMLNodePool_t *pool)
+{
+  if (pool == NULL) return 0;
+  return pool->getNumShared();
+}
+
+
+LIBLX_EXTERN
+unsigned long
+XMLNodePool_getBytesSaved (const XMLNodePool_t *pool)
+{
+  if (pool == NULL) return 0;
+  return static_cast<unsigned long>( pool->getBytesSaved() );
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
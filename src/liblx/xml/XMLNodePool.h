@@ -0,0 +1,225 @@
+/**
+ * @file    XMLNodePool.h
+ * @brief   Shares identical subtrees between XMLNode trees
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLNodePool
+ * @sbmlbrief{core} Keeps one copy of each distinct subtree read.
+ *
+ * Documents often repeat the same content many times: boilerplate
+ * annotations, identical notes, lists of equal elements.  Read into
+ * XMLNode trees, each repetition is a separate set of allocations.  Trees
+ * read through an XMLNodePool, by XMLNode(XMLInputStream&, XMLNodePool&)
+ * or XMLNode::convertStringToXMLNode(), instead share every subtree that
+ * the pool has seen before, in the same document or an earlier one.
+ *
+@code{.cpp}
+XMLNodePool pool;
+
+XMLInputStream stream("annotations.xml");
+XMLNode root(stream, pool);
+
+pool.printReport(std::cout);
+@endcode
+ *
+ * Subtrees are shared only when they are identical: the same names,
+ * namespaces, attributes in the same order, characters and children.
+ * Shared nodes are never changed; a node reached through
+ * XMLNode::getChild() on a tree that is not @c const is first replaced by
+ * a copy of its own, so changing a tree never affects another.  Shared
+ * nodes report the line and column at which their content was first read.
+ *
+ * The pool holds a reference to each distinct subtree until it is cleared
+ * or destroyed; trees read through it stay valid after that.  A pool may
+ * be used by several threads at once.
+ */
+
+#ifndef XMLNodePool_h
+#define XMLNodePool_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <iosfwd>
+#include <mutex>
+#include <unordered_map>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLNode;
+
+
+class LIBLX_EXTERN XMLNodePool
+{
+public:
+
+  /**
+   * Creates a new, empty XMLNodePool.
+   */
+  XMLNodePool ();
+
+
+  /**
+   * Destroys this XMLNodePool.  Trees read through it are not affected.
+   */
+  virtual ~XMLNodePool ();
+
+
+  /**
+   * @return the number of nodes read through this pool.
+   */
+  unsigned int getNumRead () const;
+
+
+  /**
+   * @return the number of nodes read through this pool that were found
+   * to be already kept, and so were shared instead of stored.
+   */
+  unsigned int getNumShared () const;
+
+
+  /**
+   * @return the number of distinct nodes this pool keeps.
+   */
+  unsigned int getNumKept () const;
+
+
+  /**
+   * @return an estimate of the bytes that sharing has saved, counting the
+   * node objects, their characters, attributes and namespaces.
+   */
+  size_t getBytesSaved () const;
+
+
+  /**
+   * Writes a summary of the nodes read, shared and kept, and of the
+   * memory saved, to stream.
+   *
+   * @param stream the stream to write to.
+   */
+  void printReport (std::ostream& stream) const;
+
+
+  /**
+   * Drops the references this pool holds, so that subtrees no tree uses
+   * any longer are freed.  Later trees no longer share with earlier ones.
+   * The counts are kept.
+   */
+  void clear ();
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+  /**
+   * Takes a node, whose children have been interned already, and returns
+   * the node kept for its content: either @p node itself, now kept by the
+   * pool, or an equal node kept before, in which case @p node is deleted.
+   * Either way the node returned carries a reference for the caller.
+   */
+  XMLNode* intern (XMLNode* node);
+
+
+protected:
+
+  std::unordered_multimap<size_t, XMLNode*> mNodes;
+
+  unsigned int        mNumRead;
+  unsigned int        mNumShared;
+  size_t              mBytesSaved;
+  mutable std::mutex  mLock;
+
+
+private:
+
+  XMLNodePool (const XMLNodePool& orig);
+  XMLNodePool& operator= (const XMLNodePool& rhs);
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Creates a new, empty XMLNodePool_t.
+ *
+ * @return pointer to the XMLNodePool_t structure created.
+ *
+ * @memberof XMLNodePool_t
+ */
+LIBLX_EXTERN
+XMLNodePool_t *
+XMLNodePool_create (void);
+
+
+/**
+ * Destroys this XMLNodePool_t structure.  Trees read through it are not
+ * affected.
+ *
+ * @param pool XMLNodePool_t structure to be freed.
+ *
+ * @memberof XMLNodePool_t
+ */
+LIBLX_EXTERN
+void
+XMLNodePool_free (XMLNodePool_t *pool);
+
+
+/**
+ * Returns the number of nodes read through this pool that were shared
+ * instead of stored.
+ *
+ * @param pool the XMLNodePool_t structure.
+ *
+ * @return the number of nodes shared, or @c 0 if @p pool is @c NULL.
+ *
+ * @memberof XMLNodePool_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLNodePool_getNumShared (const XMLNodePool_t *pool);
+
+
+/**
+ * Returns an estimate of the bytes that sharing has saved.
+ *
+ * @param pool the XMLNodePool_t structure.
+ *
+ * @return the bytes saved, or @c 0 if @p pool is @c NULL.
+ *
+ * @memberof XMLNodePool_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLNodePool_getBytesSaved (const XMLNodePool_t *pool);
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLNodePool_h */
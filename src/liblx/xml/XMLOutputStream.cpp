@@ -37,6 +37,7 @@
  * ---------------------------------------------------------------------- -->*/
 
 #include <iostream>
+#include <mutex>
 #include <sstream>
 #include <fstream>
 
@@ -46,6 +47,7 @@
 #include <liblx/xml/XMLAttributes.h>
 #include <liblx/xml/XMLConstructorException.h>
 #include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLTrace.h>
 #include <liblx/xml/sbmlMemoryStubs.h>
 #include <liblx/xml/sbmlMemoryStubs.h>
 #include <liblx/xml/common/common.h>
@@ -183,11 +185,11 @@ bool hasPredefinedEntity(const std::string &chars, size_t index)
 
 // boolean indicating whether the comment on the top of the file is
 // written (enabled by default)
-bool XMLOutputStream::mWriteComment = true;
+std::atomic<bool> XMLOutputStream::mWriteComment(true);
 
 // boolean indicating whether a timestamp will be generated at the time
 // of writing (enabled by default)
-bool XMLOutputStream::mWriteTimestamp = true;
+std::atomic<bool> XMLOutputStream::mWriteTimestamp(true);
 
 // the name of the library writing the file (i.e: libSBML)
 std::string XMLOutputStream::mLibraryName = "libSBML";
@@ -196,6 +198,19 @@ std::string XMLOutputStream::mLibraryName = "libSBML";
 // TODO: Replace with a libSBXML version string
 std::string XMLOutputStream::mLibraryVersion = getLibLXDottedVersion();
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Streams may be written on several threads at once; the library name
+ * and version are read and changed under this lock.
+ */
+static mutex&
+libraryInfoMutex ()
+{
+  static mutex* m = new mutex;
+  return *m;
+}
+/** @endcond */
+
 
 /**
  * Copy Constructor, made private so as to notify users, that copying an input stream is not supported. 
@@ -209,6 +224,8 @@ XMLOutputStream::XMLOutputStream (const XMLOutputStream& other)
   , mInText(other.mInText)
   , mSkipNextIndent(other.mSkipNextIndent)
   , mNextAmpersandIsRef(other.mNextAmpersandIsRef)
+  , mXMLns(NULL)
+  , mOptions(other.mOptions)
   , mStringStream(other.mStringStream)
 {
 }
@@ -240,12 +257,50 @@ XMLOutputStream::XMLOutputStream (  std::ostream&       stream
  , mSkipNextIndent ( false    )
  , mNextAmpersandIsRef( false )
  , mXMLns (NULL)
+ , mOptions ( XMLWriterOptions::getProcessDefaults() )
+{
+
+  unsetStringStream();
+  mStream.imbue( locale::classic() );
+  if (writeXMLDecl) this->writeXMLDecl();
+  if (mOptions.getWriteComment())
+    this->writeComment(programName, programVersion,
+                       mOptions.getWriteTimestamp());
+
+  LIBLX_TRACE2(write__start, this, mEncoding.c_str());
+}
+
+
+/*
+ * Creates a new XMLOutputStream that wraps stream and formats its output
+ * as options say.
+ */
+XMLOutputStream::XMLOutputStream (  std::ostream&           stream
+                                  , const XMLWriterOptions& options
+                                  , const std::string       encoding
+                                  , bool                    writeXMLDecl
+                                  , const std::string       programName
+                                  , const std::string       programVersion) :
+   mStream  ( stream   )
+ , mEncoding( encoding )
+ , mInStart ( false    )
+ , mDoIndent( options.getIndent() )
+ , mIndent  ( 0        )
+ , mInText  ( false    )
+ , mSkipNextIndent ( false    )
+ , mNextAmpersandIsRef( false )
+ , mXMLns (NULL)
+ , mOptions ( options  )
 {
 
   unsetStringStream();
   mStream.imbue( locale::classic() );
   if (writeXMLDecl) this->writeXMLDecl();
-  if (mWriteComment) this->writeComment(programName, programVersion, mWriteTimestamp);
+  if (mOptions.getWriteComment())
+    this->writeComment(programName, programVersion,
+                       mOptions.getWriteTimestamp());
+
+  LIBLX_TRACE2(write__start, this, mEncoding.c_str());
 }
 
 
@@ -783,8 +838,10 @@ XMLOutputStream::writeIndent (bool isEnd)
 {
   if (mDoIndent)
   {
-    if (mIndent > 0 || isEnd) mStream << endl;
-    for (unsigned int n = 0; n < mIndent; ++n) mStream << ' ' << ' ';
+    if (mIndent > 0 || isEnd) mStream << mOptions.getLineEnding();
+
+    const unsigned int width = mIndent * mOptions.getIndentWidth();
+    for (unsigned int n = 0; n < width; ++n) mStream << ' ';
   }
 }
 
@@ -895,7 +952,7 @@ XMLOutputStream::writeValue (const double& value)
   }
   else
   {
-    mStream.precision(LIBSBML_DOUBLE_PRECISION);
+    mStream.precision(mOptions.getDoublePrecision());
     mStream <<   value;
   }
 
@@ -957,7 +1014,7 @@ XMLOutputStream::writeXMLDecl ()
   if ( !mEncoding.empty() ) writeAttribute("encoding", mEncoding);
 
   mStream << "?>";
-  mStream << endl;
+  mStream << mOptions.getLineEnding();
 }
 
 
@@ -988,27 +1045,35 @@ XMLOutputStream::writeComment (const std::string& programName,
   {
     char formattedDateAndTime[17];
     time_t tim=time(NULL);
-    tm *now=localtime(&tim);
+    tm now;
+#if defined(WIN32) && !defined(CYGWIN)
+    localtime_s(&now, &tim);
+#else
+    localtime_r(&tim, &now);
+#endif
 
     sprintf(formattedDateAndTime, "%d-%02d-%02d %02d:%02d",
-            now->tm_year+1900, now->tm_mon+1, now->tm_mday,
-            now->tm_hour, now->tm_min);
+            now.tm_year+1900, now.tm_mon+1, now.tm_mday,
+            now.tm_hour, now.tm_min);
     mStream << " on " << formattedDateAndTime;
   }
 
   // write library information
-  if (!mLibraryName.empty())
+  const string& libraryName    = mOptions.getLibraryName();
+  const string& libraryVersion = mOptions.getLibraryVersion();
+
+  if (!libraryName.empty())
   {
-    mStream << " with " << mLibraryName;
+    mStream << " with " << libraryName;
 
-    if (!mLibraryVersion.empty())
+    if (!libraryVersion.empty())
     {
-      mStream << " version " << mLibraryVersion;
+      mStream << " version " << libraryVersion;
     }
   }
 
   mStream << ". -->";
-  mStream << endl;
+  mStream << mOptions.getLineEnding();
 
 }
 
@@ -1117,6 +1182,13 @@ XMLOutputStream::setXMLNamespaces(XMLNamespaces * xmlns)
     mXMLns = NULL;
 }
 
+
+const XMLWriterOptions&
+XMLOutputStream::getWriterOptions() const
+{
+  return mOptions;
+}
+
 bool XMLOutputStream::getWriteComment()
 {
   return mWriteComment;
@@ -1139,21 +1211,25 @@ void XMLOutputStream::setWriteTimestamp(bool writeTimestamp)
 
 string XMLOutputStream::getLibraryName()
 {
+  lock_guard<mutex> lock(libraryInfoMutex());
   return mLibraryName;
 }
 
 void XMLOutputStream::setLibraryName(const string& libraryName)
 {
+  lock_guard<mutex> lock(libraryInfoMutex());
   mLibraryName = libraryName;
 }
 
 string XMLOutputStream::getLibraryVersion()
 {
+  lock_guard<mutex> lock(libraryInfoMutex());
   return mLibraryVersion;
 }
 
 void XMLOutputStream::setLibraryVersion(const string& libraryVersion)
 {
+  lock_guard<mutex> lock(libraryInfoMutex());
   mLibraryVersion = libraryVersion;
 }
 
@@ -1169,6 +1245,8 @@ void XMLOutputStream::setIndent(unsigned int indent)
 
 XMLOutputStream::~XMLOutputStream()
 {
+  LIBLX_TRACE1(write__end, this);
+
   if (mXMLns != NULL)
     delete mXMLns;
 }
@@ -1188,6 +1266,20 @@ XMLOutputStringStream::XMLOutputStringStream (  std::ostringstream& stream
   setStringStream();
 }
 
+XMLOutputStringStream::XMLOutputStringStream (  std::ostringstream&     stream
+                   , const XMLWriterOptions& options
+                   , const std::string       encoding
+                   , bool                    writeXMLDecl
+                   , const std::string       programName
+                   , const std::string       programVersion):
+  XMLOutputStream(stream, options, encoding, writeXMLDecl,
+                    programName, programVersion)
+    , mString(stream)
+
+{
+  setStringStream();
+}
+
 std::ostringstream &
 XMLOutputStringStream::getString()
 {
@@ -1203,6 +1295,16 @@ XMLOwningOutputStringStream::XMLOwningOutputStringStream (const std::string  enc
   
 }
 
+XMLOwningOutputStringStream::XMLOwningOutputStringStream (const XMLWriterOptions& options
+                               , const std::string       encoding
+                               , bool                    writeXMLDecl
+                               , const std::string       programName
+                               , const std::string       programVersion)
+  : XMLOutputStringStream(*(new std::ostringstream), options, encoding, writeXMLDecl, programName, programVersion)
+{
+
+}
+
 XMLOwningOutputStringStream::~XMLOwningOutputStringStream()
 {
   delete &mStream;
@@ -1219,6 +1321,17 @@ XMLOutputFileStream::XMLOutputFileStream (std::ofstream& stream
 {
 }
 
+XMLOutputFileStream::XMLOutputFileStream (std::ofstream& stream
+                   , const XMLWriterOptions& options
+                   , const std::string       encoding
+                   , bool                    writeXMLDecl
+                   , const std::string       programName
+                   , const std::string       programVersion)
+  : XMLOutputStream(stream, options, encoding, writeXMLDecl,
+                    programName, programVersion)
+{
+}
+
 XMLOwningOutputFileStream::XMLOwningOutputFileStream (  
                                const std::string&  filename
                              , const std::string  encoding
@@ -1230,6 +1343,18 @@ XMLOwningOutputFileStream::XMLOwningOutputFileStream (
 {
 }
 
+XMLOwningOutputFileStream::XMLOwningOutputFileStream (
+                               const std::string&        filename
+                             , const XMLWriterOptions& options
+                             , const std::string       encoding
+                             , bool                    writeXMLDecl
+                             , const std::string       programName
+                             , const std::string       programVersion)
+  : XMLOutputFileStream( *(new std::ofstream(filename.c_str(), std::ios::out)),
+                         options, encoding, writeXMLDecl, programName, programVersion)
+{
+}
+
 XMLOwningOutputFileStream::~XMLOwningOutputFileStream()
 {
   delete &mStream;
@@ -1280,6 +1405,18 @@ XMLOutputStream_createAsStringWithProgramInfo (const char * encoding,
 }
 
 
+LIBLX_EXTERN
+XMLOutputStream_t *
+XMLOutputStream_createAsStringWithOptions (const XMLWriterOptions_t * options,
+        const char * encoding, int writeXMLDecl)
+{
+  if (options == NULL || encoding == NULL) return NULL;
+
+  return new(nothrow) XMLOwningOutputStringStream(*options, encoding,
+                                                  writeXMLDecl);
+}
+
+
 LIBLX_EXTERN
 XMLOutputStream_t *
 XMLOutputStream_createFile (const char * filename, const char * encoding, 
@@ -225,6 +225,7 @@ on yyyy-MM-dd HH:mm with libSBML version <libsbml version>. -->
 #include <liblx/xml/common/liblxfwd.h>
 #ifdef __cplusplus
 
+#include <atomic>
 #include <iostream>
 #include <limits>
 #include <locale>
@@ -233,6 +234,7 @@ on yyyy-MM-dd HH:mm with libSBML version <libsbml version>. -->
 #include <liblx/xml/common/liblx-version.h>
 
 #include <liblx/xml/common/extern.h>
+#include <liblx/xml/XMLWriterOptions.h>
 
 #include <liblx/xml/sbmlMemoryStubs.h>
 
@@ -277,6 +279,39 @@ public:
                    , const std::string  programVersion = "");
 
 
+  /**
+   * Creates a new XMLOutputStream that wraps the given @p stream and
+   * formats its output as @p options say.
+   *
+   * Unlike the constructor above, this one does not read the process-wide
+   * settings of setWriteComment(), setWriteTimestamp(), setLibraryName()
+   * and setLibraryVersion(); everything comes from @p options.
+   *
+   * @param stream the output stream to wrap.
+   *
+   * @param options the formatting of this stream.
+   *
+   * @param encoding the XML encoding to declare in the output.
+   *
+   * @param writeXMLDecl whether to write a standard XML declaration at
+   * the beginning of the content written on @p stream.
+   *
+   * @param programName an optional program name to write as a comment
+   * in the output stream.
+   *
+   * @param programVersion an optional version identification string to write
+   * as a comment in the output stream.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLOutputStream (std::ostream&            stream
+                   , const XMLWriterOptions& options
+                   , const std::string       encoding       = "UTF-8"
+                   , bool                    writeXMLDecl   = true
+                   , const std::string       programName    = ""
+                   , const std::string       programVersion = "");
+
+
   /**
    * Destroys this XMLOutputStream.
    */
@@ -718,6 +753,18 @@ on yyyy-MM-dd HH:mm with libSBML version <libsbml version>. -->
   void setXMLNamespaces(XMLNamespaces * xmlns);
 
 
+  /**
+   * @return the formatting of this stream.
+   */
+  const XMLWriterOptions& getWriterOptions() const;
+
+
+  /**
+   * The static settings below are the defaults for streams created
+   * without an XMLWriterOptions object; each such stream takes a copy of
+   * them when it is constructed.
+   */
+
   /**
    * @return a boolean, whether the output stream will write an XML
    * comment at the top of the file. (Enabled by default.)
@@ -795,6 +842,8 @@ private:
 
 protected:
   /** @cond doxygenLibsbmlInternal */
+  friend class XMLNode;
+
   /**
    * Unitialized XMLOutputStreams may only be created by subclasses.
    */
@@ -884,13 +933,17 @@ protected:
 
   XMLNamespaces* mXMLns;
 
+  // the formatting of this stream, fixed when it is constructed
+  XMLWriterOptions mOptions;
+
   // boolean indicating whether the comment on the top of the file is
-  // written (enabled by default)
-  static bool mWriteComment;
+  // written (enabled by default); atomic since streams may be written on
+  // several threads
+  static std::atomic<bool> mWriteComment;
 
   // boolean indicating whether a timestamp will be generated at the time
   // of writing (enabled by default)
-  static bool mWriteTimestamp;
+  static std::atomic<bool> mWriteTimestamp;
 
   // the name of the library writing the file (i.e: libSBML)
   static std::string mLibraryName;
@@ -923,6 +976,19 @@ public:
                          , const std::string  programName  = ""
                          , const std::string  programVersion = "");
 
+  /**
+   * Creates a new XMLOutputStream that wraps stream and formats its
+   * output as options say.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLOutputStringStream (  std::ostringstream&     stream
+                         , const XMLWriterOptions& options
+                         , const std::string       encoding     = "UTF-8"
+                         , bool                    writeXMLDecl = true
+                         , const std::string       programName  = ""
+                         , const std::string       programVersion = "");
+
   std::ostringstream& getString();
 
 protected:
@@ -947,6 +1013,18 @@ public:
                                , const std::string  programName  = ""
                                , const std::string  programVersion = "");
 
+  /**
+   * Creates a new XMLOutputStream that wraps stream and formats its
+   * output as options say.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLOwningOutputStringStream (  const XMLWriterOptions& options
+                               , const std::string       encoding     = "UTF-8"
+                               , bool                    writeXMLDecl = true
+                               , const std::string       programName  = ""
+                               , const std::string       programVersion = "");
+
   virtual ~XMLOwningOutputStringStream();
 
 };
@@ -968,6 +1046,19 @@ public:
                        , const std::string  programName  = ""
                        , const std::string  programVersion = "");
 
+  /**
+   * Creates a new XMLOutputStream that wraps stream and formats its
+   * output as options say.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLOutputFileStream (  std::ofstream&          stream
+                       , const XMLWriterOptions& options
+                       , const std::string       encoding     = "UTF-8"
+                       , bool                    writeXMLDecl = true
+                       , const std::string       programName  = ""
+                       , const std::string       programVersion = "");
+
 };
 /** @endcond */
 
@@ -988,6 +1079,19 @@ public:
                              , const std::string  programName  = ""
                              , const std::string  programVersion = "");
 
+  /**
+   * Creates a new XMLOutputStream that writes to the named file and
+   * formats its output as options say.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLOwningOutputFileStream (const std::string&        filename
+                             , const XMLWriterOptions& options
+                             , const std::string       encoding     = "UTF-8"
+                             , bool                    writeXMLDecl = true
+                             , const std::string       programName  = ""
+                             , const std::string       programVersion = "");
+
   virtual ~XMLOwningOutputFileStream();
 
 };
@@ -1072,6 +1176,26 @@ XMLOutputStream_createAsStringWithProgramInfo (const char * encoding,
                                                const char * programVersion);
 
 
+/**
+ * Creates a new XMLOutputStream_t that wraps std string output stream
+ * and formats its output as @p options say.
+ *
+ * @param options the XMLWriterOptions_t structure, which is copied.
+ * @param encoding the XML encoding to declare in the output.
+ * @param writeXMLDecl nonzero to write an XML declaration.
+ *
+ * @return the new XMLOutputStream_t, or @c NULL if @p options or
+ * @p encoding is @c NULL.
+ *
+ * @memberof XMLOutputStream_t
+ */
+LIBLX_EXTERN
+XMLOutputStream_t *
+XMLOutputStream_createAsStringWithOptions (const XMLWriterOptions_t * options,
+                                           const char * encoding,
+                                           int writeXMLDecl);
+
+
 /**
  * Creates a new XMLOutputStream_t that wraps std file output stream.
  *
@@ -0,0 +1,683 @@
+/**
+ * @file    XMLParallelParser.cpp
+ * @brief   Reads one large document into an XMLNode tree on several threads
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <liblx/xml/XMLParallelParser.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLFileBuffer.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/operationReturnValues.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/** @cond doxygenLibsbmlInternal */
+
+static const size_t DEFAULT_MIN_CHUNK_SIZE = 1 << 20;
+
+
+/*
+ * A piece of the document, wrapped so that it can be read on its own,
+ * and what reading it produced.  Positions read from the piece are moved
+ * by 'lines', and those on its first line also by 'columns', to give
+ * their positions in the whole document.
+ */
+struct XMLParallelParser::Chunk
+{
+  std::string doc;
+  int         lines;
+  int         columns;
+  XMLNode*    node;
+  bool        ok;
+};
+
+
+static inline bool
+isSpace (char c)
+{
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+
+static inline bool
+isNameStart (char c)
+{
+  const unsigned char u = (unsigned char) c;
+  return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z')
+      || u == '_' || u == ':' || u >= 0x80;
+}
+
+
+static const char*
+scanName (const char* p, const char* end)
+{
+  if (p == end || !isNameStart(*p)) return p;
+
+  for (++p; p < end; ++p)
+  {
+    const unsigned char u = (unsigned char) *p;
+    if (!isNameStart(*p) && !(u >= '0' && u <= '9') && u != '-' && u != '.')
+      break;
+  }
+
+  return p;
+}
+
+
+/*
+ * @return the first occurrence of literal in [p, end), or NULL.
+ */
+static const char*
+find (const char* p, const char* end, const char* literal)
+{
+  const size_t length = strlen(literal);
+
+  while ((p = static_cast<const char*>(memchr(p, literal[0], end - p))) != NULL)
+  {
+    if ((size_t) (end - p) < length) return NULL;
+    if (memcmp(p, literal, length) == 0) return p;
+    ++p;
+  }
+
+  return NULL;
+}
+
+
+/*
+ * @return the '>' that ends the tag starting at p, skipping quoted
+ * attribute values, or NULL.
+ */
+static const char*
+findTagEnd (const char* p, const char* end)
+{
+  char quote = 0;
+
+  for (; p < end; ++p)
+  {
+    if (quote != 0)
+    {
+      if (*p == quote) quote = 0;
+    }
+    else if (*p == '"' || *p == '\'')
+    {
+      quote = *p;
+    }
+    else if (*p == '>')
+    {
+      return p;
+    }
+  }
+
+  return NULL;
+}
+
+
+/*
+ * @return the number of characters in the UTF-8 text [p, end).
+ */
+static size_t
+countChars (const char* p, const char* end)
+{
+  size_t count = 0;
+
+  for (; p < end; ++p)
+  {
+    if ((*p & 0xC0) != 0x80) ++count;
+  }
+
+  return count;
+}
+
+
+/*
+ * @return true if the encoding named in the XML declaration [p, end) is
+ * UTF-8, or a subset of it, or is not given.
+ */
+static bool
+isUTF8Declaration (const char* p, const char* end)
+{
+  const char* e = find(p, end, "encoding");
+  if (e == NULL) return true;
+
+  e += 8;
+  while (e < end && (isSpace(*e) || *e == '=')) ++e;
+  if (e == end || (*e != '"' && *e != '\'')) return false;
+
+  const char  quote = *e++;
+  const char* v     = e;
+  while (e < end && *e != quote) ++e;
+
+  string name;
+  for (; v < e; ++v)
+  {
+    name += (*v >= 'a' && *v <= 'z') ? (char) (*v - 'a' + 'A') : *v;
+  }
+
+  return name == "UTF-8" || name == "UTF8" || name == "US-ASCII"
+      || name == "ASCII";
+}
+/** @endcond */
+
+
+/*
+ * Creates a new XMLParallelParser.
+ */
+XMLParallelParser::XMLParallelParser (  unsigned int  numThreads
+                                      , const string& library )
+ : mNumThreads     ( numThreads             )
+ , mLibrary        ( library                )
+ , mMinChunkSize   ( DEFAULT_MIN_CHUNK_SIZE )
+ , mNumChunks      ( 0                      )
+ , mSerialFallback ( false                  )
+{
+  if (mNumThreads == 0) mNumThreads = thread::hardware_concurrency();
+  if (mNumThreads == 0) mNumThreads = 1;
+}
+
+
+/*
+ * Destroys this XMLParallelParser.
+ */
+XMLParallelParser::~XMLParallelParser ()
+{
+}
+
+
+/*
+ * @return the number of threads this parser reads with.
+ */
+unsigned int
+XMLParallelParser::getNumThreads () const
+{
+  return mNumThreads;
+}
+
+
+/*
+ * Sets the smallest piece, in bytes, handed to a thread.
+ */
+int
+XMLParallelParser::setMinChunkSize (size_t bytes)
+{
+  if (bytes == 0) return LIBLX_INVALID_ATTRIBUTE_VALUE;
+
+  mMinChunkSize = bytes;
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the smallest piece, in bytes, handed to a thread.
+ */
+size_t
+XMLParallelParser::getMinChunkSize () const
+{
+  return mMinChunkSize;
+}
+
+
+/*
+ * Reads the document element of the given content.
+ */
+XMLNode*
+XMLParallelParser::parse (const char* content, bool isFile, XMLErrorLog* log)
+{
+  mNumChunks      = 1;
+  mSerialFallback = false;
+
+  if (content == NULL) return NULL;
+
+  XMLNode* root = NULL;
+
+  if (isFile)
+  {
+    /* compressed files are read through the same buffer as a serial
+     * parse; anything it cannot read is left to the serial parse to
+     * report */
+    XMLFileBuffer* buffer = NULL;
+    try
+    {
+      buffer = new XMLFileBuffer(content);
+    }
+    catch ( ... )
+    {
+      return parseSerial(content, isFile, log);
+    }
+
+    string text;
+    char   block[65536];
+    unsigned int bytes;
+
+    while (!buffer->error()
+           && (bytes = buffer->copyTo(block, sizeof(block))) > 0)
+    {
+      text.append(block, bytes);
+    }
+
+    const bool readable = !buffer->error();
+    delete buffer;
+
+    if (readable) root = parseChunks(text);
+  }
+  else
+  {
+    root = parseChunks(content);
+  }
+
+  if (root != NULL) return root;
+
+  mSerialFallback = (mNumChunks > 1);
+  mNumChunks      = 1;
+
+  return parseSerial(content, isFile, log);
+}
+
+
+/*
+ * @return the number of pieces the last call to parse() read in
+ * parallel, or 1 if it read the document serially.
+ */
+unsigned int
+XMLParallelParser::getNumChunks () const
+{
+  return mNumChunks;
+}
+
+
+/*
+ * @return true if the last call to parse() split the document but read
+ * it again serially.
+ */
+bool
+XMLParallelParser::isSerialFallback () const
+{
+  return mSerialFallback;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Moves the positions of node and everything in it; positions of 0 are
+ * unknown and are left alone.
+ */
+void
+XMLParallelParser::shiftPositions (XMLNode& node, int lines, int columns)
+{
+  if (node.mLine != 0)
+  {
+    if (node.mLine == 1) node.mColumn = (unsigned int) (node.mColumn + columns);
+    node.mLine = (unsigned int) (node.mLine + lines);
+  }
+
+  for (size_t n = 0; n < node.mChildren.size(); ++n)
+  {
+    shiftPositions(*node.mChildren[n], lines, columns);
+  }
+}
+
+/*
+ * Reads the document with a single XMLInputStream.
+ */
+XMLNode*
+XMLParallelParser::parseSerial (const char* content, bool isFile,
+                                XMLErrorLog* log)
+{
+  XMLInputStream stream(content, isFile, mLibrary, log);
+
+  if (stream.peek().isEOF()) return NULL;
+
+  return new XMLNode(stream);
+}
+
+
+/*
+ * Reads one wrapped piece of the document.  It is accepted only if it
+ * reads to the end without an error.
+ */
+void
+XMLParallelParser::parseChunk (Chunk* chunk, const string* library)
+{
+  try
+  {
+    XMLErrorLog    log;
+    XMLInputStream stream(chunk->doc.c_str(), false, *library, &log);
+
+    if (!stream.peek().isStart()) return;
+
+    chunk->node = new XMLNode(stream);
+
+    while (stream.isGood()) stream.next();
+
+    chunk->ok = !stream.isError() && log.getNumErrors() == 0;
+  }
+  catch ( ... )
+  {
+    chunk->ok = false;
+  }
+}
+
+
+/*
+ * Splits the children of the document element between several threads,
+ * reads them and joins the results.
+ *
+ * @return the document element, or NULL if the document was not split
+ * or a piece could not be read, in which case mNumChunks says how many
+ * pieces were tried.
+ */
+XMLNode*
+XMLParallelParser::parseChunks (const string& text)
+{
+  const char* begin = text.data();
+  const char* end   = begin + text.size();
+
+  if (mNumThreads < 2 || text.size() < 2 * mMinChunkSize) return NULL;
+
+  /* the prolog: only an XML declaration, comments, processing
+   * instructions and white space are expected before the document
+   * element */
+  const char* p = begin;
+  if (text.size() >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;
+
+  const char* declBegin = p;
+  const char* declEnd   = p;
+
+  while (true)
+  {
+    while (p < end && isSpace(*p)) ++p;
+
+    if (end - p < 2 || *p != '<') return NULL;
+
+    if (p[1] == '?')
+    {
+      const char* close = find(p, end, "?>");
+      if (close == NULL) return NULL;
+
+      if (p == declBegin && end - p > 5 && memcmp(p, "<?xml", 5) == 0
+          && isSpace(p[5]))
+      {
+        if (!isUTF8Declaration(p, close)) return NULL;
+        declEnd = close + 2;
+      }
+
+      p = close + 2;
+    }
+    else if (p[1] == '!')
+    {
+      /* a DOCTYPE may declare entities and default attributes that
+       * the pieces would not see */
+      if (end - p < 4 || memcmp(p, "<!--", 4) != 0) return NULL;
+
+      const char* close = find(p + 4, end, "-->");
+      if (close == NULL) return NULL;
+
+      p = close + 3;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  /* the document element's start and end tags */
+  const char* rootBegin = p;
+  const char* rootName  = p + 1;
+  const char* nameEnd   = scanName(rootName, end);
+  const char* rootEnd   = findTagEnd(nameEnd, end);
+
+  if (nameEnd == rootName || rootEnd == NULL || rootEnd[-1] == '/') return NULL;
+
+  const string name(rootName, nameEnd);
+  const char*  bodyBegin = rootEnd + 1;
+
+  const char* q = end;
+  while (q > bodyBegin && isSpace(q[-1])) --q;
+  if (q == bodyBegin || q[-1] != '>') return NULL;
+
+  const char* bodyEnd = q - 1;
+  while (bodyEnd > bodyBegin && isSpace(bodyEnd[-1])) --bodyEnd;
+  bodyEnd -= name.size() + 2;
+
+  if (bodyEnd < bodyBegin || bodyEnd[0] != '<' || bodyEnd[1] != '/'
+      || memcmp(bodyEnd + 2, name.data(), name.size()) != 0)
+  {
+    return NULL;
+  }
+
+  /* cuts go before start tags named like the first child */
+  const char* first = bodyBegin;
+  while ((first = static_cast<const char*>(memchr(first, '<', bodyEnd - first)))
+         != NULL && !isNameStart(first[1]))
+  {
+    ++first;
+  }
+  if (first == NULL) return NULL;
+
+  const string child(first + 1, scanName(first + 1, bodyEnd));
+
+  size_t numChunks = (size_t) (bodyEnd - bodyBegin) / mMinChunkSize;
+  if (numChunks > mNumThreads) numChunks = mNumThreads;
+  if (numChunks < 2) return NULL;
+
+  vector<const char*> cuts;
+  cuts.push_back(begin);
+
+  for (size_t n = 1; n < numChunks; ++n)
+  {
+    const char* c = bodyBegin + (bodyEnd - bodyBegin) * n / numChunks;
+    if (c <= cuts.back()) c = cuts.back() + 1;
+
+    while ((c = static_cast<const char*>(memchr(c, '<', bodyEnd - c))) != NULL)
+    {
+      const char* after = c + 1 + child.size();
+      const char* before = c;
+      while (before > bodyBegin && isSpace(before[-1])) --before;
+
+      if (after < bodyEnd
+          && memcmp(c + 1, child.data(), child.size()) == 0
+          && (isSpace(*after) || *after == '>' || *after == '/')
+          && before > bodyBegin && before[-1] == '>')
+      {
+        break;
+      }
+
+      ++c;
+    }
+
+    if (c == NULL) break;
+    cuts.push_back(c);
+  }
+
+  if (cuts.size() < 2) return NULL;
+
+  mNumChunks = (unsigned int) cuts.size();
+
+  /* every piece but the first is wrapped in the XML declaration and the
+   * document element's start tag, flattened onto one line */
+  string prefix(declBegin, declEnd);
+  prefix.append(rootBegin, bodyBegin);
+  for (size_t n = 0; n < prefix.size(); ++n)
+  {
+    if (prefix[n] == '\n' || prefix[n] == '\r') prefix[n] = ' ';
+  }
+
+  const int    prefixColumns = (int) countChars(prefix.data(),
+                                                prefix.data() + prefix.size());
+  const string suffix = "</" + name + ">";
+
+  vector<Chunk> chunks(cuts.size());
+  unsigned int  line    = 1;
+  const char*   counted = begin;
+
+  for (size_t n = 0; n < cuts.size(); ++n)
+  {
+    Chunk&      chunk    = chunks[n];
+    const char* chunkEnd = (n + 1 < cuts.size()) ? cuts[n + 1] : bodyEnd;
+
+    chunk.node = NULL;
+    chunk.ok   = false;
+
+    if (n == 0)
+    {
+      chunk.doc.assign(begin, chunkEnd);
+      chunk.lines   = 0;
+      chunk.columns = 0;
+    }
+    else
+    {
+      const char* nl;
+      while ((nl = static_cast<const char*>(memchr(counted, '\n',
+                                                   cuts[n] - counted))) != NULL)
+      {
+        ++line;
+        counted = nl + 1;
+      }
+
+      const char* lineBegin = cuts[n];
+      while (lineBegin > begin && lineBegin[-1] != '\n') --lineBegin;
+
+      const int column = (int) countChars(lineBegin, cuts[n]) + 1;
+
+      chunk.doc.reserve(prefix.size() + (chunkEnd - cuts[n]) + suffix.size());
+      chunk.doc  = prefix;
+      chunk.doc.append(cuts[n], chunkEnd);
+      chunk.lines   = (int) line - 1;
+      chunk.columns = column - (prefixColumns + 1);
+    }
+
+    chunk.doc += suffix;
+  }
+
+  vector<thread> threads;
+
+  for (size_t n = 1; n < chunks.size(); ++n)
+  {
+    try
+    {
+      threads.push_back(thread(parseChunk, &chunks[n], &mLibrary));
+    }
+    catch ( ... )
+    {
+      parseChunk(&chunks[n], &mLibrary);
+    }
+  }
+
+  parseChunk(&chunks[0], &mLibrary);
+
+  for (size_t n = 0; n < threads.size(); ++n)
+  {
+    threads[n].join();
+  }
+
+  bool ok = true;
+  for (size_t n = 0; n < chunks.size(); ++n)
+  {
+    ok = ok && chunks[n].ok;
+  }
+
+  if (!ok)
+  {
+    for (size_t n = 0; n < chunks.size(); ++n)
+    {
+      delete chunks[n].node;
+    }
+    return NULL;
+  }
+
+  /* move the children of each wrapper under the first */
+  XMLNode* root = chunks[0].node;
+
+  for (size_t n = 1; n < chunks.size(); ++n)
+  {
+    XMLNode* wrapper = chunks[n].node;
+
+    for (size_t c = 0; c < wrapper->mChildren.size(); ++c)
+    {
+      XMLNode* node = wrapper->mChildren[c];
+      shiftPositions(*node, chunks[n].lines, chunks[n].columns);
+      root->adoptChild(node);
+    }
+
+    /* the wrapper drops its references to them */
+    delete wrapper;
+  }
+
+  return root;
+}
+/** @endcond */
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLParallelParser_t *
+XMLParallelParser_create (unsigned int numThreads, const char *library)
+{
+  return new(nothrow) XMLParallelParser(numThreads,
+                                        library != NULL ? library : "");
+}
+
+
+LIBLX_EXTERN
+void
+XMLParallelParser_free (XMLParallelParser_t *parser)
+{
+  if (parser == NULL) return;
+  delete static_cast<XMLParallelParser*>(parser);
+}
+
+
+LIBLX_EXTERN
+int
+XMLParallelParser_setMinChunkSize (XMLParallelParser_t *parser, size_t bytes)
+{
+  if (parser == NULL) return LIBLX_INVALID_OBJECT;
+  return parser->setMinChunkSize(bytes);
+}
+
+
+LIBLX_EXTERN
+XMLNode_t *
+XMLParallelParser_parse (  XMLParallelParser_t *parser
+                         , const char          *content
+                         , int                 isFile
+                         , XMLErrorLog_t       *log )
+{
+  if (parser == NULL) return NULL;
+  return parser->parse(content, isFile != 0, log);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLParallelParser_getNumChunks (const XMLParallelParser_t *parser)
+{
+  if (parser == NULL) return 0;
+  return parser->getNumChunks();
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,273 @@
+/**
+ * @file    XMLParallelParser.h
+ * @brief   Reads one large document into an XMLNode tree on several threads
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLParallelParser
+ * @sbmlbrief{core} Reads a document into an XMLNode tree, splitting the
+ * children of the document element between several threads.
+ *
+ * A document whose element holds a long list of sibling elements can be
+ * read faster by cutting the list into pieces and reading the pieces at
+ * the same time.  XMLParallelParser guesses cut points in the text: each
+ * is placed before a start tag with the same name as the first child of
+ * the document element.  Every piece is then read by its own XMLParser,
+ * wrapped in a copy of the document element's start tag so that the
+ * namespaces in scope are the same as in the whole document.  Finally the
+ * children read from each piece are joined, in order, under a single
+ * document element, with their line and column numbers moved to where
+ * they are in the whole document.
+ *
+ * A guess is wrong when a cut lands inside one of the children, or inside
+ * a comment or CDATA section; the pieces on either side of it are then
+ * not well-formed on their own.  When any piece reports an error, the
+ * document is read again serially with a single XMLInputStream, so the
+ * tree and the errors logged are exactly those of a serial parse.
+ *
+ * Documents smaller than two pieces of getMinChunkSize() bytes, documents
+ * with a DOCTYPE and documents in an encoding other than UTF-8 are always
+ * read serially.
+ *
+@code{.cpp}
+XMLParallelParser parser(4);
+XMLErrorLog log;
+XMLNode* root = parser.parse("huge.xml", true, &log);
+@endcode
+ */
+
+#ifndef XMLParallelParser_h
+#define XMLParallelParser_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <string>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLErrorLog;
+class XMLNode;
+
+
+class LIBLX_EXTERN XMLParallelParser
+{
+public:
+
+  /**
+   * Creates a new XMLParallelParser.
+   *
+   * @param numThreads the number of threads to read with, or @c 0 for the
+   * number of hardware threads.
+   * @param library the XML library each thread uses, as for
+   * XMLParser::create().
+   */
+  XMLParallelParser (  unsigned int       numThreads = 0
+                     , const std::string& library    = "" );
+
+
+  /**
+   * Destroys this XMLParallelParser.
+   */
+  virtual ~XMLParallelParser ();
+
+
+  /**
+   * @return the number of threads this parser reads with.
+   */
+  unsigned int getNumThreads () const;
+
+
+  /**
+   * Sets the smallest piece, in bytes, handed to a thread.  Documents
+   * shorter than two such pieces are read serially.
+   *
+   * @param bytes the smallest piece size.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * if @p bytes is 0.
+   */
+  int setMinChunkSize (size_t bytes);
+
+
+  /**
+   * @return the smallest piece, in bytes, handed to a thread.
+   */
+  size_t getMinChunkSize () const;
+
+
+  /**
+   * Reads the document element of the given content.
+   *
+   * @param content the name of a file, or the document itself.
+   * @param isFile @c true if @p content is a file name.
+   * @param log the XMLErrorLog to receive errors, or @c NULL.
+   *
+   * @return the document element as a new XMLNode, which the caller
+   * owns, or @c NULL if nothing could be read.  As with a serial read,
+   * the tree may be incomplete if errors were logged.
+   */
+  XMLNode* parse (  const char*  content
+                  , bool         isFile = true
+                  , XMLErrorLog* log    = NULL );
+
+
+  /**
+   * @return the number of pieces the last call to parse() read in
+   * parallel, or @c 1 if it read the document serially.
+   */
+  unsigned int getNumChunks () const;
+
+
+  /**
+   * @return @c true if the last call to parse() split the document but
+   * read it again serially because a piece was not well-formed.
+   */
+  bool isSerialFallback () const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+protected:
+
+  struct Chunk;
+
+  XMLNode* parseSerial (const char* content, bool isFile, XMLErrorLog* log);
+
+  XMLNode* parseChunks (const std::string& text);
+
+  static void parseChunk (Chunk* chunk, const std::string* library);
+
+  static void shiftPositions (XMLNode& node, int lines, int columns);
+
+
+  unsigned int  mNumThreads;
+  std::string   mLibrary;
+  size_t        mMinChunkSize;
+
+  unsigned int  mNumChunks;
+  bool          mSerialFallback;
+
+private:
+
+  XMLParallelParser (const XMLParallelParser& orig);
+  XMLParallelParser& operator= (const XMLParallelParser& rhs);
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Creates a new XMLParallelParser_t.
+ *
+ * @param numThreads the number of threads to read with, or @c 0 for the
+ * number of hardware threads.
+ * @param library the XML library each thread uses, or @c NULL for the
+ * default.
+ *
+ * @return pointer to the XMLParallelParser_t structure created.
+ *
+ * @memberof XMLParallelParser_t
+ */
+LIBLX_EXTERN
+XMLParallelParser_t *
+XMLParallelParser_create (unsigned int numThreads, const char *library);
+
+
+/**
+ * Destroys this XMLParallelParser_t structure.
+ *
+ * @param parser XMLParallelParser_t structure to be freed.
+ *
+ * @memberof XMLParallelParser_t
+ */
+LIBLX_EXTERN
+void
+XMLParallelParser_free (XMLParallelParser_t *parser);
+
+
+/**
+ * Sets the smallest piece, in bytes, handed to a thread.
+ *
+ * @param parser the XMLParallelParser_t structure.
+ * @param bytes the smallest piece size.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLParallelParser_t
+ */
+LIBLX_EXTERN
+int
+XMLParallelParser_setMinChunkSize (XMLParallelParser_t *parser, size_t bytes);
+
+
+/**
+ * Reads the document element of the given content.
+ *
+ * @param parser the XMLParallelParser_t structure.
+ * @param content the name of a file, or the document itself.
+ * @param isFile nonzero if @p content is a file name.
+ * @param log the XMLErrorLog_t to receive errors, or @c NULL.
+ *
+ * @return the document element as a new XMLNode_t, which the caller
+ * owns, or @c NULL if nothing could be read.
+ *
+ * @memberof XMLParallelParser_t
+ */
+LIBLX_EXTERN
+XMLNode_t *
+XMLParallelParser_parse (  XMLParallelParser_t *parser
+                         , const char          *content
+                         , int                 isFile
+                         , XMLErrorLog_t       *log );
+
+
+/**
+ * Returns the number of pieces the last parse read in parallel.
+ *
+ * @param parser the XMLParallelParser_t structure.
+ *
+ * @return the number of pieces, or @c 1 for a serial read.
+ *
+ * @memberof XMLParallelParser_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLParallelParser_getNumChunks (const XMLParallelParser_t *parser);
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLParallelParser_h */
@@ -0,0 +1,287 @@
+/**
+ * @file    XMLParseStats.cpp
+ * @brief   Counters and timings gathered while an XMLInputStream is read
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <chrono>
+
+#include <liblx/xml/XMLParseStats.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/*
+ * Creates a new XMLParseStats with every counter at zero.
+ */
+XMLParseStats::XMLParseStats (bool timed) :
+   mBytesRead        ( 0     )
+ , mNumChunks        ( 0     )
+ , mNumTokens        ( 0     )
+ , mNumStartElements ( 0     )
+ , mNumEndElements   ( 0     )
+ , mNumTextTokens    ( 0     )
+ , mPeakQueueDepth   ( 0     )
+ , mNumCoalesced     ( 0     )
+ , mNumWhitespaceDropped ( 0     )
+ , mNumErrors        ( 0     )
+ , mTimed            ( timed )
+ , mParseTime        ( 0     )
+ , mTokenizerTime    ( 0     )
+ , mConsumerTime     ( 0     )
+ , mCoalescedBase    ( 0     )
+ , mWhitespaceBase   ( 0     )
+ , mErrorsBase       ( 0     )
+ , mLastReturn       ( 0     )
+{
+}
+
+
+unsigned long
+XMLParseStats::getBytesRead () const
+{
+  return mBytesRead;
+}
+
+
+unsigned long
+XMLParseStats::getNumChunks () const
+{
+  return mNumChunks;
+}
+
+
+unsigned long
+XMLParseStats::getNumTokens () const
+{
+  return mNumTokens;
+}
+
+
+unsigned long
+XMLParseStats::getNumStartElements () const
+{
+  return mNumStartElements;
+}
+
+
+unsigned long
+XMLParseStats::getNumEndElements () const
+{
+  return mNumEndElements;
+}
+
+
+unsigned long
+XMLParseStats::getNumTextTokens () const
+{
+  return mNumTextTokens;
+}
+
+
+unsigned long
+XMLParseStats::getPeakQueueDepth () const
+{
+  return mPeakQueueDepth;
+}
+
+
+unsigned long
+XMLParseStats::getNumCharactersCoalesced () const
+{
+  return mNumCoalesced;
+}
+
+
+unsigned long
+XMLParseStats::getNumWhitespaceDropped () const
+{
+  return mNumWhitespaceDropped;
+}
+
+
+unsigned long
+XMLParseStats::getNumErrors () const
+{
+  return mNumErrors;
+}
+
+
+bool
+XMLParseStats::isTimed () const
+{
+  return mTimed;
+}
+
+
+/*
+ * mParseTime holds all the time spent in XMLParser::parseNext(), which
+ * includes the tokenizer's handling of the events it raises.
+ */
+double
+XMLParseStats::getParseTime () const
+{
+  return (mParseTime > mTokenizerTime) ? mParseTime - mTokenizerTime : 0;
+}
+
+
+double
+XMLParseStats::getTokenizerTime () const
+{
+  return mTokenizerTime;
+}
+
+
+double
+XMLParseStats::getConsumerTime () const
+{
+  return mConsumerTime;
+}
+
+
+/*
+ * @return the current wall-clock time in seconds.
+ */
+double
+XMLParseStats::now ()
+{
+  return chrono::duration<double>(
+           chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getBytesRead (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getBytesRead();
+}
+
+
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumChunks (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getNumChunks();
+}
+
+
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumTokens (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getNumTokens();
+}
+
+
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumStartElements (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getNumStartElements();
+}
+
+
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumEndElements (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getNumEndElements();
+}
+
+
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumTextTokens (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getNumTextTokens();
+}
+
+
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getPeakQueueDepth (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getPeakQueueDepth();
+}
+
+
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumCharactersCoalesced (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getNumCharactersCoalesced();
+}
+
+
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumWhitespaceDropped (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getNumWhitespaceDropped();
+}
+
+
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumErrors (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getNumErrors();
+}
+
+
+LIBLX_EXTERN
+double
+XMLParseStats_getParseTime (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getParseTime();
+}
+
+
+LIBLX_EXTERN
+double
+XMLParseStats_getTokenizerTime (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getTokenizerTime();
+}
+
+
+LIBLX_EXTERN
+double
+XMLParseStats_getConsumerTime (const XMLParseStats_t *stats)
+{
+  if (stats == NULL) return 0;
+  return stats->getConsumerTime();
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,448 @@
+/**
+ * @file    XMLParseStats.h
+ * @brief   Counters and timings gathered while an XMLInputStream is read
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLParseStats
+ * @sbmlbrief{core} What an XMLInputStream has read so far, and where the
+ * time went.
+ *
+ * An XMLInputStream collects statistics only once asked to with
+ * XMLInputStream::enableStats(); until then it keeps nothing and costs
+ * nothing.  The object returned by XMLInputStream::getStats() is kept up
+ * to date as tokens are read, so it can be polled while the document is
+ * being read, for example to show progress:
+ *
+@code{.cpp}
+XMLInputStream stream("big.xml");
+stream.enableStats();
+
+while (stream.isGood())
+{
+  XMLToken token = stream.next();
+  ...
+  if (stream.getStats()->getNumTokens() % 100000 == 0)
+    showProgress(stream.getStats()->getBytesRead());
+}
+@endcode
+ *
+ * The bytes and chunks read are counted from the start of the document.
+ * The other counters start when statistics are enabled, which is
+ * normally straight after the stream is created.
+ *
+ * When enabled with timing, the stream also splits the wall-clock time
+ * spent reading between the XML library (getParseTime()), the
+ * XMLTokenizer turning its events into tokens (getTokenizerTime()) and
+ * the caller between one request for a token and the next
+ * (getConsumerTime()).  Timing reads the clock several times per
+ * token, so it is best left off when only the counters are wanted.
+ */
+
+#ifndef XMLParseStats_h
+#define XMLParseStats_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+#ifdef __cplusplus
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+class LIBLX_EXTERN XMLParseStats
+{
+public:
+
+  /**
+   * Creates a new XMLParseStats with every counter at zero.
+   *
+   * @param timed whether time is to be measured as well.
+   *
+   * @ifnot hasDefaultArgs @htmlinclude warn-default-args-in-docs.html @endif@~
+   */
+  XMLParseStats (bool timed = false);
+
+
+  /**
+   * Returns the number of bytes read from the document's XMLBuffer.
+   *
+   * @return the number of bytes handed to the XML library so far.
+   */
+  unsigned long getBytesRead () const;
+
+
+  /**
+   * Returns the number of chunks of the document handed to the XML
+   * library.
+   *
+   * @return the number of chunks read so far.
+   */
+  unsigned long getNumChunks () const;
+
+
+  /**
+   * Returns the number of tokens taken from the stream with next() or
+   * skipToken().
+   *
+   * @return the number of tokens delivered.
+   */
+  unsigned long getNumTokens () const;
+
+
+  /**
+   * Returns the number of start element tokens delivered.  An empty
+   * element counts as both a start and an end.
+   *
+   * @return the number of start elements delivered.
+   */
+  unsigned long getNumStartElements () const;
+
+
+  /**
+   * Returns the number of end element tokens delivered.  An empty
+   * element counts as both a start and an end.
+   *
+   * @return the number of end elements delivered.
+   */
+  unsigned long getNumEndElements () const;
+
+
+  /**
+   * Returns the number of text tokens delivered.
+   *
+   * @return the number of text tokens delivered.
+   */
+  unsigned long getNumTextTokens () const;
+
+
+  /**
+   * Returns the largest number of tokens the XMLTokenizer has held
+   * waiting to be read.
+   *
+   * @return the peak depth of the token queue.
+   */
+  unsigned long getPeakQueueDepth () const;
+
+
+  /**
+   * Returns the number of times the XML library delivered character data
+   * that the XMLTokenizer joined onto the text before it.
+   *
+   * @return the number of pieces of character data coalesced.
+   */
+  unsigned long getNumCharactersCoalesced () const;
+
+
+  /**
+   * Returns the number of runs of whitespace-only character data the
+   * XMLTokenizer dropped instead of turning into text tokens.  This stays
+   * at zero unless XMLInputStream::setIgnoreWhitespace() was called.
+   *
+   * @return the number of runs of whitespace dropped.
+   */
+  unsigned long getNumWhitespaceDropped () const;
+
+
+  /**
+   * Returns the number of errors logged while the stream was read.
+   * Errors dropped by XMLErrorLog::setMaxErrors() are included.
+   *
+   * @return the number of errors logged.
+   */
+  unsigned long getNumErrors () const;
+
+
+  /**
+   * Returns @c true if time is being measured.
+   *
+   * @return @c true if the timings below are being kept, @c false if they
+   * stay at zero.
+   */
+  bool isTimed () const;
+
+
+  /**
+   * Returns the seconds spent in the XML library, not counting the time
+   * the XMLTokenizer took to handle its events.
+   *
+   * @return the seconds spent parsing.
+   */
+  double getParseTime () const;
+
+
+  /**
+   * Returns the seconds the XMLTokenizer spent turning the events of the
+   * XML library into tokens.
+   *
+   * @return the seconds spent in the tokenizer.
+   */
+  double getTokenizerTime () const;
+
+
+  /**
+   * Returns the seconds spent by the caller between asking the stream for
+   * one token and asking for the next.
+   *
+   * @return the seconds spent by the consumer of the stream.
+   */
+  double getConsumerTime () const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+  /**
+   * @return the current wall-clock time in seconds.
+   */
+  static double now ();
+
+  /** @endcond */
+
+
+protected:
+  /** @cond doxygenLibsbmlInternal */
+
+  unsigned long mBytesRead;
+  unsigned long mNumChunks;
+  unsigned long mNumTokens;
+  unsigned long mNumStartElements;
+  unsigned long mNumEndElements;
+  unsigned long mNumTextTokens;
+  unsigned long mPeakQueueDepth;
+  unsigned long mNumCoalesced;
+  unsigned long mNumWhitespaceDropped;
+  unsigned long mNumErrors;
+
+  bool   mTimed;
+  double mParseTime;
+  double mTokenizerTime;
+  double mConsumerTime;
+
+  /* the counts already made when collection began, and when the stream
+     last returned to its caller (0 if it has not) */
+  unsigned long mCoalescedBase;
+  unsigned long mWhitespaceBase;
+  unsigned long mErrorsBase;
+  double        mLastReturn;
+
+  friend class XMLInputStream;
+  friend class TokenizerTimer;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Returns the number of bytes read from the document.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the number of bytes read, or @c 0 if @p stats is @c NULL.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getBytesRead (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the number of chunks of the document handed to the XML library.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the number of chunks read, or @c 0 if @p stats is @c NULL.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumChunks (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the number of tokens delivered by the stream.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the number of tokens delivered, or @c 0 if @p stats is @c NULL.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumTokens (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the number of start element tokens delivered.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the number of start elements, or @c 0 if @p stats is @c NULL.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumStartElements (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the number of end element tokens delivered.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the number of end elements, or @c 0 if @p stats is @c NULL.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumEndElements (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the number of text tokens delivered.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the number of text tokens, or @c 0 if @p stats is @c NULL.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumTextTokens (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the largest number of tokens held waiting to be read.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the peak depth of the token queue, or @c 0 if @p stats is
+ * @c NULL.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getPeakQueueDepth (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the number of pieces of character data joined onto the text
+ * before them.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the number coalesced, or @c 0 if @p stats is @c NULL.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumCharactersCoalesced (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the number of runs of whitespace-only character data dropped.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the number dropped, or @c 0 if @p stats is @c NULL.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumWhitespaceDropped (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the number of errors logged while the stream was read.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the number of errors, or @c 0 if @p stats is @c NULL.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLParseStats_getNumErrors (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the seconds spent in the XML library.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the seconds spent parsing, or @c 0 if @p stats is @c NULL or
+ * not timed.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+double
+XMLParseStats_getParseTime (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the seconds spent turning parse events into tokens.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the seconds spent in the tokenizer, or @c 0 if @p stats is
+ * @c NULL or not timed.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+double
+XMLParseStats_getTokenizerTime (const XMLParseStats_t *stats);
+
+
+/**
+ * Returns the seconds spent by the consumer of the stream.
+ *
+ * @param stats the XMLParseStats_t structure.
+ *
+ * @return the seconds spent between requests for tokens, or @c 0 if
+ * @p stats is @c NULL or not timed.
+ *
+ * @memberof XMLParseStats_t
+ */
+LIBLX_EXTERN
+double
+XMLParseStats_getConsumerTime (const XMLParseStats_t *stats);
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLParseStats_h */
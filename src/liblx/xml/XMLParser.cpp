@@ -51,6 +51,10 @@
 #include <liblx/xml/XercesParser.h>
 #endif
 
+#ifdef USE_NATIVE_PARSER
+#include <liblx/xml/NativeParser.h>
+#endif
+
 #include <liblx/xml/XMLErrorLog.h>
 #include <liblx/xml/XMLParser.h>
 #include <liblx/xml/operationReturnValues.h>
@@ -64,7 +68,10 @@ LIBLX_CPP_NAMESPACE_BEGIN
  * Creates a new XMLParser.  The parser will notify the given XMLHandler
  * of parse events and errors.
  */
-XMLParser::XMLParser () : mErrorLog(NULL)
+XMLParser::XMLParser () :
+   mErrorLog  ( NULL )
+ , mBytesRead ( 0    )
+ , mNumChunks ( 0    )
 {
 }
 
@@ -83,8 +90,9 @@ XMLParser::~XMLParser ()
  *
  * The library parameter indicates the underlying XML library to use if
  * the XML compatibility layer has been linked against multiple XML
- * libraries.  It may be one of: "expat" (default), "libxml", or
- * "xerces".
+ * libraries.  It may be one of: "expat" (default), "libxml",
+ * "xerces" or "native".  The native parser is only chosen by default
+ * when it is the only one built.
  *
  * If the XML compatibility layer has been linked against only a single
  * XML library, the library parameter is ignored.
@@ -104,10 +112,54 @@ XMLParser::create (XMLHandler& handler, const string library)
   if (library.empty() || library == "xerces") return new XercesParser(handler);
 #endif
 
+#ifdef USE_NATIVE_PARSER
+  if (library.empty() || library == "native") return new NativeParser(handler);
+#endif
+
   return NULL;
 }
 
 
+/*
+ * @return the names of the XML libraries built in, in the order create()
+ * prefers them.
+ */
+vector<string>
+XMLParser::getLibraries ()
+{
+  vector<string> libraries;
+
+#ifdef USE_EXPAT
+  libraries.push_back("expat");
+#endif
+
+#ifdef USE_LIBXML
+  libraries.push_back("libxml");
+#endif
+
+#ifdef USE_XERCES
+  libraries.push_back("xerces");
+#endif
+
+#ifdef USE_NATIVE_PARSER
+  libraries.push_back("native");
+#endif
+
+  return libraries;
+}
+
+
+/*
+ * Resets this parser for a new document whose events go to the given
+ * handler.  Parsers that cannot do so are not reused.
+ */
+bool
+XMLParser::reuse (XMLHandler& /*handler*/)
+{
+  return false;
+}
+
+
 /*
  * @return an XMLErrorLog which can be used to log XML parse errors and
  * other validation errors (and messages).
@@ -137,5 +189,49 @@ XMLParser::setErrorLog (XMLErrorLog* log)
 }
 
 
+/*
+ * @return the number of bytes read since resetReadCounts().
+ */
+unsigned long
+XMLParser::getBytesRead () const
+{
+  return mBytesRead;
+}
+
+
+/*
+ * @return the number of chunks read since resetReadCounts().
+ */
+unsigned long
+XMLParser::getNumChunks () const
+{
+  return mNumChunks;
+}
+
+
+/*
+ * Sets the counts of bytes and chunks read back to zero.
+ */
+void
+XMLParser::resetReadCounts ()
+{
+  mBytesRead = 0;
+  mNumChunks = 0;
+}
+
+
+/*
+ * Counts a chunk of bytes read from the parser's XMLBuffer.
+ */
+void
+XMLParser::countRead (unsigned int bytes)
+{
+  if (bytes == 0) return;
+
+  mBytesRead += bytes;
+  ++mNumChunks;
+}
+
+
 LIBLX_CPP_NAMESPACE_END
 /** @endcond */
@@ -50,6 +50,7 @@
 #ifdef __cplusplus
 
 #include <string>
+#include <vector>
 #include <liblx/xml/common/extern.h>
 
 LIBLX_CPP_NAMESPACE_BEGIN
@@ -68,8 +69,9 @@ public:
    *
    * The library parameter indicates the underlying XML library to use if
    * the XML compatibility layer has been linked against multiple XML
-   * libraries.  It may be one of: "expat" (default), "libxml", or
-   * "xerces".
+   * libraries.  It may be one of: "expat" (default), "libxml",
+   * "xerces" or "native".  The native parser is only chosen by default
+   * when it is the only one built.
    *
    * If the XML compatibility layer has been linked against only a single
    * XML library, the library parameter is ignored.
@@ -80,6 +82,18 @@ public:
                             , const std::string library = "" );
 
 
+  /**
+   * Returns the names of the XML libraries this copy of libLX was built
+   * with, in the order in which create() prefers them.  Each name may be
+   * passed to create() or to an XMLInputStream to parse with that library,
+   * which is how the same input can be compared across libraries.
+   *
+   * @return the names of the libraries built in: some of "expat",
+   * "libxml", "xerces" and "native".
+   */
+  static std::vector<std::string> getLibraries ();
+
+
   /**
    * Destroys this XMLParser.
    */
@@ -137,6 +151,19 @@ public:
   virtual void parseReset () = 0;
 
 
+  /**
+   * Resets this parser for a new document whose events go to the given
+   * handler, so that XMLParserPool can hand it to another XMLInputStream
+   * instead of creating a new one.
+   *
+   * The default returns @c false, meaning the parser cannot be reused;
+   * backends that can reset themselves override it.
+   *
+   * @return @c true if the parser is ready for parseFirst().
+   */
+  virtual bool reuse (XMLHandler& handler);
+
+
   /**
    * Returns the current column position of the parser.  Must be overridden by child classes.
    *
@@ -173,6 +200,28 @@ public:
   int setErrorLog (XMLErrorLog* log);
 
 
+  /** @cond doxygenLibsbmlInternal */
+  /**
+   * Returns the number of bytes this parser has read from its XMLBuffer
+   * since resetReadCounts() was last called.
+   */
+  unsigned long getBytesRead () const;
+
+
+  /**
+   * Returns the number of chunks this parser has read from its XMLBuffer
+   * since resetReadCounts() was last called.
+   */
+  unsigned long getNumChunks () const;
+
+
+  /**
+   * Sets the counts of bytes and chunks read back to zero.
+   */
+  void resetReadCounts ();
+  /** @endcond */
+
+
 protected:
   /**
    * Creates a new XMLParser.  The parser will notify the given XMLHandler
@@ -183,7 +232,17 @@ protected:
    */
   XMLParser ();
 
+
+  /**
+   * Counts a chunk of bytes read from the parser's XMLBuffer.  Backends
+   * call this after each XMLBuffer::copyTo() that returns data.
+   */
+  void countRead (unsigned int bytes);
+
   XMLErrorLog* mErrorLog;
+
+  unsigned long mBytesRead;
+  unsigned long mNumChunks;
 };
 
 
@@ -0,0 +1,238 @@
+/**
+ * @file    XMLParserPool.cpp
+ * @brief   Keeps parsers for reuse by later XMLInputStreams
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <new>
+
+#include <liblx/xml/XMLParserPool.h>
+#include <liblx/xml/XMLParser.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/*
+ * Creates a new, empty XMLParserPool.
+ */
+XMLParserPool::XMLParserPool (unsigned int maxIdle)
+ : mMaxIdle    ( maxIdle )
+ , mNumCreated ( 0       )
+ , mNumReused  ( 0       )
+{
+}
+
+
+/*
+ * Destroys this XMLParserPool and the parsers it keeps.
+ */
+XMLParserPool::~XMLParserPool ()
+{
+  clear();
+}
+
+
+/*
+ * @return the pool belonging to the calling thread.
+ */
+XMLParserPool&
+XMLParserPool::getThreadPool ()
+{
+  static thread_local XMLParserPool pool;
+  return pool;
+}
+
+
+/*
+ * @return the most parsers this pool keeps while no stream uses them.
+ */
+unsigned int
+XMLParserPool::getMaxIdle () const
+{
+  return mMaxIdle;
+}
+
+
+/*
+ * @return the number of parsers this pool keeps now.
+ */
+unsigned int
+XMLParserPool::getNumIdle () const
+{
+  lock_guard<mutex> guard(mLock);
+  return (unsigned int) mIdle.size();
+}
+
+
+/*
+ * @return the number of parsers this pool has had to create.
+ */
+unsigned int
+XMLParserPool::getNumCreated () const
+{
+  lock_guard<mutex> guard(mLock);
+  return mNumCreated;
+}
+
+
+/*
+ * @return the number of times this pool has handed out a parser it kept.
+ */
+unsigned int
+XMLParserPool::getNumReused () const
+{
+  lock_guard<mutex> guard(mLock);
+  return mNumReused;
+}
+
+
+/*
+ * Deletes the parsers this pool keeps.
+ */
+void
+XMLParserPool::clear ()
+{
+  vector<Idle> idle;
+  {
+    lock_guard<mutex> guard(mLock);
+    idle.swap(mIdle);
+  }
+
+  for (size_t n = 0; n < idle.size(); ++n)
+  {
+    delete idle[n].parser;
+  }
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return a parser for the given library that sends its events to
+ * handler.  The most recently returned parser is taken first, since its
+ * buffers are the most likely to still be in cache.
+ */
+XMLParser*
+XMLParserPool::acquire (XMLHandler& handler, const string& library)
+{
+  XMLParser* parser = NULL;
+  {
+    lock_guard<mutex> guard(mLock);
+
+    for (size_t n = mIdle.size(); n > 0; --n)
+    {
+      if (mIdle[n - 1].library != library) continue;
+
+      parser = mIdle[n - 1].parser;
+      mIdle.erase(mIdle.begin() + (n - 1));
+      break;
+    }
+  }
+
+  if (parser != NULL)
+  {
+    if (parser->reuse(handler))
+    {
+      lock_guard<mutex> guard(mLock);
+      ++mNumReused;
+      return parser;
+    }
+
+    delete parser;
+  }
+
+  parser = XMLParser::create(handler, library);
+
+  if (parser != NULL)
+  {
+    lock_guard<mutex> guard(mLock);
+    ++mNumCreated;
+  }
+
+  return parser;
+}
+
+
+/*
+ * Takes back a parser handed out by acquire().  Its input is released
+ * now rather than when it is next used, so files are not held open.
+ */
+void
+XMLParserPool::release (XMLParser* parser, const string& library)
+{
+  if (parser == NULL) return;
+
+  parser->setErrorLog(NULL);
+  parser->parseReset();
+
+  {
+    lock_guard<mutex> guard(mLock);
+
+    if (mIdle.size() < mMaxIdle)
+    {
+      Idle idle;
+      idle.library = library;
+      idle.parser  = parser;
+
+      mIdle.push_back(idle);
+      return;
+    }
+  }
+
+  delete parser;
+}
+/** @endcond */
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLParserPool_t *
+XMLParserPool_create (unsigned int maxIdle)
+{
+  return new(nothrow) XMLParserPool(maxIdle);
+}
+
+
+LIBLX_EXTERN
+void
+XMLParserPool_free (XMLParserPool_t *pool)
+{
+  if (pool == NULL) return;
+  delete static_cast<XMLParserPool*>(pool);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLParserPool_getNumCreated (const XMLParserPool_t *pool)
+{
+  if (pool == NULL) return 0;
+  return pool->getNumCreated();
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLParserPool_getNumReused (const XMLParserPool_t *pool)
+{
+  if (pool == NULL) return 0;
+  return pool->getNumReused();
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
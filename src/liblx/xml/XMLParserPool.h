@@ -0,0 +1,232 @@
+/**
+ * @file    XMLParserPool.h
+ * @brief   Keeps parsers for reuse by later XMLInputStreams
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLParserPool
+ * @sbmlbrief{core} Hands reset parsers to new XMLInputStream objects.
+ *
+ * Every XMLInputStream normally creates its own parser and deletes it
+ * when it is destroyed.  For a small document the cost of setting up the
+ * parser (an Expat or libxml2 context and its buffers) can exceed the
+ * cost of reading the document.  An XMLInputStream given an
+ * XMLParserPool instead takes an idle parser from the pool, resets it for
+ * the new document, and returns it to the pool when it is destroyed.
+ *
+@code{.cpp}
+XMLParserPool pool;
+
+for (size_t n = 0; n < requests.size(); ++n)
+{
+  XMLInputStream stream(requests[n].c_str(), false, pool);
+  handle(stream);
+}
+@endcode
+ *
+ * A pool may be shared by streams on several threads.  Each thread also
+ * has a pool of its own, returned by getThreadPool(), which is never
+ * contended.  A pool must outlive the streams that use it; in particular
+ * a stream using the pool of one thread must be destroyed on that thread.
+ *
+ * Parsers that cannot reset themselves are deleted when their stream is
+ * destroyed, as without a pool.
+ */
+
+#ifndef XMLParserPool_h
+#define XMLParserPool_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+#ifdef __cplusplus
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLHandler;
+class XMLParser;
+
+
+class LIBLX_EXTERN XMLParserPool
+{
+public:
+
+  /**
+   * Creates a new, empty XMLParserPool.
+   *
+   * @param maxIdle the most parsers the pool keeps while no stream uses
+   * them; parsers returned beyond this are deleted.
+   */
+  XMLParserPool (unsigned int maxIdle = 8);
+
+
+  /**
+   * Destroys this XMLParserPool and the parsers it keeps.
+   */
+  virtual ~XMLParserPool ();
+
+
+  /**
+   * @return the pool belonging to the calling thread, which is destroyed
+   * when the thread ends.
+   */
+  static XMLParserPool& getThreadPool ();
+
+
+  /**
+   * @return the most parsers this pool keeps while no stream uses them.
+   */
+  unsigned int getMaxIdle () const;
+
+
+  /**
+   * @return the number of parsers this pool keeps now.
+   */
+  unsigned int getNumIdle () const;
+
+
+  /**
+   * @return the number of parsers this pool has had to create.
+   */
+  unsigned int getNumCreated () const;
+
+
+  /**
+   * @return the number of times this pool has handed out a parser it
+   * kept instead of creating one.
+   */
+  unsigned int getNumReused () const;
+
+
+  /**
+   * Deletes the parsers this pool keeps.  Parsers in use by streams are
+   * not affected.
+   */
+  void clear ();
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+  /**
+   * @return a parser for the given library that sends its events to
+   * @p handler, reset if it was kept by the pool, or @c NULL if the
+   * library is not available.
+   */
+  XMLParser* acquire (XMLHandler& handler, const std::string& library);
+
+
+  /**
+   * Takes back a parser handed out by acquire() for the given library.
+   */
+  void release (XMLParser* parser, const std::string& library);
+
+
+protected:
+
+  struct Idle
+  {
+    std::string library;
+    XMLParser*  parser;
+  };
+
+  unsigned int        mMaxIdle;
+  std::vector<Idle>   mIdle;
+  unsigned int        mNumCreated;
+  unsigned int        mNumReused;
+  mutable std::mutex  mLock;
+
+
+private:
+
+  XMLParserPool (const XMLParserPool& orig);
+  XMLParserPool& operator= (const XMLParserPool& rhs);
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Creates a new, empty XMLParserPool_t.
+ *
+ * @param maxIdle the most parsers the pool keeps while no stream uses them.
+ *
+ * @return pointer to the XMLParserPool_t structure created.
+ *
+ * @memberof XMLParserPool_t
+ */
+LIBLX_EXTERN
+XMLParserPool_t *
+XMLParserPool_create (unsigned int maxIdle);
+
+
+/**
+ * Destroys this XMLParserPool_t structure and the parsers it keeps.
+ *
+ * @param pool XMLParserPool_t structure to be freed.
+ *
+ * @memberof XMLParserPool_t
+ */
+LIBLX_EXTERN
+void
+XMLParserPool_free (XMLParserPool_t *pool);
+
+
+/**
+ * Returns the number of parsers this pool has had to create.
+ *
+ * @param pool the XMLParserPool_t structure.
+ *
+ * @return the number of parsers created, or @c 0 if @p pool is @c NULL.
+ *
+ * @memberof XMLParserPool_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLParserPool_getNumCreated (const XMLParserPool_t *pool);
+
+
+/**
+ * Returns the number of times this pool has handed out a parser it kept.
+ *
+ * @param pool the XMLParserPool_t structure.
+ *
+ * @return the number of parsers reused, or @c 0 if @p pool is @c NULL.
+ *
+ * @memberof XMLParserPool_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLParserPool_getNumReused (const XMLParserPool_t *pool);
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLParserPool_h */
@@ -0,0 +1,932 @@
+/**
+ * @file    XMLPath.cpp
+ * @brief   Compiled path queries over XMLNode trees
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cctype>
+#include <cstdlib>
+#include <new>
+#include <unordered_set>
+
+#include <liblx/xml/XMLPath.h>
+#include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLNode.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/*
+ * Creates a new, empty XMLPathIndex.
+ */
+XMLPathIndex::XMLPathIndex ()
+{
+}
+
+
+/*
+ * Destroys this XMLPathIndex.
+ */
+XMLPathIndex::~XMLPathIndex ()
+{
+}
+
+
+/*
+ * Returns the positions of the children of node with the given local
+ * name, building the index for node on first use.
+ */
+const vector<unsigned int>*
+XMLPathIndex::getPositions (const XMLNode& node, const string& name)
+{
+  const unsigned int numChildren = node.getNumChildren();
+  if (numChildren < MIN_CHILDREN) return NULL;
+
+  unordered_map<const XMLNode*, NameIndex>::iterator it = mIndexes.find(&node);
+
+  if (it == mIndexes.end())
+  {
+    it = mIndexes.insert(make_pair(&node, NameIndex())).first;
+
+    for (unsigned int n = 0; n < numChildren; ++n)
+    {
+      const XMLNode& child = node.getChild(n);
+      if (child.isElement()) it->second[child.getName()].push_back(n);
+    }
+  }
+
+  static const vector<unsigned int> none;
+
+  NameIndex::const_iterator found = it->second.find(name);
+  return (found != it->second.end()) ? &found->second : &none;
+}
+
+
+/*
+ * Discards all indexes.
+ */
+void
+XMLPathIndex::clear ()
+{
+  mIndexes.clear();
+}
+
+
+/*
+ * @return the number of nodes that have been indexed.
+ */
+unsigned int
+XMLPathIndex::getNumIndexedNodes () const
+{
+  return (unsigned int)mIndexes.size();
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * A cursor over the expression text used while compiling.
+ */
+class PathLexer
+{
+public:
+
+  PathLexer (const string& text) : mText(text), mPos(0) { }
+
+  bool atEnd () { skipSpace(); return mPos >= mText.size(); }
+
+  /* consumes s if the remaining text starts with it */
+  bool accept (const char* s)
+  {
+    skipSpace();
+    size_t n = 0;
+    while (s[n] != '\0')
+    {
+      if (mPos + n >= mText.size() || mText[mPos + n] != s[n]) return false;
+      ++n;
+    }
+    mPos += n;
+    return true;
+  }
+
+  char peek () { skipSpace(); return mPos < mText.size() ? mText[mPos] : '\0'; }
+
+  /* reads an XML name without a colon */
+  bool readName (string& name)
+  {
+    skipSpace();
+    size_t start = mPos;
+    if (mPos >= mText.size() || !isNameStart(mText[mPos])) return false;
+
+    while (mPos < mText.size() && isNameChar(mText[mPos])) ++mPos;
+
+    name = mText.substr(start, mPos - start);
+    return true;
+  }
+
+  /* reads a quoted string literal */
+  bool readLiteral (string& value)
+  {
+    skipSpace();
+    if (mPos >= mText.size()) return false;
+
+    const char quote = mText[mPos];
+    if (quote != '\'' && quote != '"') return false;
+
+    size_t end = mText.find(quote, mPos + 1);
+    if (end == string::npos) return false;
+
+    value = mText.substr(mPos + 1, end - mPos - 1);
+    mPos  = end + 1;
+    return true;
+  }
+
+  /* reads a positive decimal integer */
+  bool readNumber (unsigned int& number)
+  {
+    skipSpace();
+    size_t start = mPos;
+    while (mPos < mText.size() && isdigit((unsigned char)mText[mPos])) ++mPos;
+
+    if (mPos == start) return false;
+
+    number = (unsigned int)strtoul(mText.substr(start, mPos - start).c_str(),
+                                   NULL, 10);
+    return number > 0;
+  }
+
+  /* true if the next character continues a name, e.g. the 'x' in '.x' */
+  bool nameFollows ()
+  {
+    return mPos < mText.size() && isNameChar(mText[mPos]);
+  }
+
+private:
+
+  static bool isNameStart (char c)
+  {
+    return isalpha((unsigned char)c) || c == '_' || (unsigned char)c >= 0x80;
+  }
+
+  static bool isNameChar (char c)
+  {
+    return isNameStart(c) || isdigit((unsigned char)c) || c == '-' || c == '.';
+  }
+
+  void skipSpace ()
+  {
+    while (mPos < mText.size() && isspace((unsigned char)mText[mPos])) ++mPos;
+  }
+
+  const string& mText;
+  size_t        mPos;
+};
+
+
+/*
+ * Resolves prefix to a namespace URI; false if it is not bound.
+ */
+static bool
+resolvePrefix (  const string&        prefix
+               , const XMLNamespaces* namespaces
+               , string&              uri )
+{
+  if (namespaces == NULL || !namespaces->hasPrefix(prefix)) return false;
+
+  uri = namespaces->getURI(prefix);
+  return true;
+}
+/** @endcond */
+
+
+/*
+ * Compiles a path expression.
+ */
+XMLPath*
+XMLPath::compile (const string& expression, const XMLNamespaces* namespaces)
+{
+  XMLPath* path = new XMLPath();
+
+  if (!path->parse(expression, namespaces))
+  {
+    delete path;
+    return NULL;
+  }
+
+  return path;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+XMLPath::XMLPath ()
+ : mAbsolute      ( false )
+ , mNeedsOrdering ( false )
+{
+}
+/** @endcond */
+
+
+/*
+ * Copy constructor; creates a copy of this XMLPath.
+ */
+XMLPath::XMLPath (const XMLPath& orig)
+ : mExpression    ( orig.mExpression    )
+ , mAbsolute      ( orig.mAbsolute      )
+ , mSteps         ( orig.mSteps         )
+ , mNeedsOrdering ( orig.mNeedsOrdering )
+{
+}
+
+
+/*
+ * Assignment operator for XMLPath.
+ */
+XMLPath&
+XMLPath::operator= (const XMLPath& rhs)
+{
+  if (&rhs != this)
+  {
+    mExpression    = rhs.mExpression;
+    mAbsolute      = rhs.mAbsolute;
+    mSteps         = rhs.mSteps;
+    mNeedsOrdering = rhs.mNeedsOrdering;
+  }
+
+  return *this;
+}
+
+
+/*
+ * Creates and returns a deep copy of this XMLPath.
+ */
+XMLPath*
+XMLPath::clone () const
+{
+  return new XMLPath(*this);
+}
+
+
+/*
+ * Destroys this XMLPath.
+ */
+XMLPath::~XMLPath ()
+{
+}
+
+
+/*
+ * @return the expression this path was compiled from.
+ */
+const string&
+XMLPath::getExpression () const
+{
+  return mExpression;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Parses expression into mSteps.
+ *
+ *   path      ::= ('/' | '//')? step (('/' | '//') step)*
+ *   step      ::= '.' | nametest predicate*
+ *   nametest  ::= '*' | name | prefix ':' ( '*' | name )
+ *   predicate ::= '[' ( number | 'last()' | '@' qname ( '=' literal )? ) ']'
+ */
+bool
+XMLPath::parse (const string& expression, const XMLNamespaces* namespaces)
+{
+  mExpression = expression;
+
+  PathLexer lexer(mExpression);
+  bool descendant = false;
+
+  if (lexer.accept("//"))
+  {
+    mAbsolute  = true;
+    descendant = true;
+  }
+  else if (lexer.accept("/"))
+  {
+    mAbsolute = true;
+  }
+
+  while (true)
+  {
+    Step step;
+    step.descendant = descendant;
+    step.self       = false;
+    step.anyName    = false;
+    step.anyURI     = true;
+
+    if (lexer.peek() == '.')
+    {
+      lexer.accept(".");
+      if (lexer.peek() == '.' || lexer.nameFollows()) return false;
+      step.self = true;
+    }
+    else
+    {
+      string first;
+
+      if (lexer.accept("*"))
+      {
+        step.anyName = true;
+      }
+      else if (!lexer.readName(first))
+      {
+        return false;
+      }
+
+      if (!step.anyName && lexer.accept(":"))
+      {
+        step.anyURI = false;
+        if (!resolvePrefix(first, namespaces, step.uri)) return false;
+
+        if (lexer.accept("*"))
+        {
+          step.anyName = true;
+        }
+        else if (!lexer.readName(step.name))
+        {
+          return false;
+        }
+      }
+      else
+      {
+        step.name = first;
+      }
+    }
+
+    while (lexer.accept("["))
+    {
+      Predicate predicate;
+      predicate.position = 0;
+
+      if (lexer.accept("@"))
+      {
+        string first;
+        if (!lexer.readName(first)) return false;
+
+        if (lexer.accept(":"))
+        {
+          if (!resolvePrefix(first, namespaces, predicate.uri)) return false;
+          if (!lexer.readName(predicate.name)) return false;
+        }
+        else
+        {
+          predicate.name = first;
+        }
+
+        predicate.kind = Predicate::HasAttribute;
+
+        if (lexer.accept("="))
+        {
+          if (!lexer.readLiteral(predicate.value)) return false;
+          predicate.kind = Predicate::AttributeEquals;
+        }
+      }
+      else if (lexer.accept("last()"))
+      {
+        predicate.kind = Predicate::Last;
+      }
+      else if (lexer.readNumber(predicate.position))
+      {
+        predicate.kind = Predicate::Position;
+      }
+      else
+      {
+        return false;
+      }
+
+      if (!lexer.accept("]")) return false;
+
+      step.predicates.push_back(predicate);
+    }
+
+    step.positional = false;
+    for (size_t n = 0; n < step.predicates.size(); ++n)
+    {
+      if (step.predicates[n].kind == Predicate::Position ||
+          step.predicates[n].kind == Predicate::Last)
+      {
+        step.positional = true;
+      }
+    }
+
+    mSteps.push_back(step);
+
+    if (lexer.atEnd()) break;
+
+    if (lexer.accept("//"))
+    {
+      descendant = true;
+    }
+    else if (lexer.accept("/"))
+    {
+      descendant = false;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  /*
+   * Once a descendant step has produced nodes that may be nested inside
+   * one another, the following steps can visit the same part of the tree
+   * more than once.
+   */
+  for (size_t n = 0; n + 1 < mSteps.size(); ++n)
+  {
+    if (mSteps[n].descendant) mNeedsOrdering = true;
+  }
+
+  return true;
+}
+
+
+/*
+ * @return a step selecting every element child, used to enumerate the
+ * descendants for './/.'.
+ */
+const XMLPath::Step&
+XMLPath::anyElement ()
+{
+  struct AnyElement : public Step
+  {
+    AnyElement ()
+    {
+      descendant = false;
+      self       = false;
+      anyName    = true;
+      anyURI     = true;
+      positional = false;
+    }
+  };
+
+  static const AnyElement any;
+  return any;
+}
+
+
+/*
+ * @return true if node passes the name test of step.
+ */
+bool
+XMLPath::matches (const Step& step, const XMLToken& node)
+{
+  if (!node.isElement()) return false;
+  if (!step.anyName && node.getName() != step.name) return false;
+  if (!step.anyURI  && node.getURI()  != step.uri)  return false;
+
+  return true;
+}
+
+
+/*
+ * Filters candidates through the given predicates, in order.
+ */
+void
+XMLPath::applyPredicates (  const vector<Predicate>& predicates
+                          , vector<const XMLNode*>&  candidates )
+{
+  for (size_t p = 0; p < predicates.size() && !candidates.empty(); ++p)
+  {
+    const Predicate& predicate = predicates[p];
+
+    switch (predicate.kind)
+    {
+    case Predicate::Position:
+      if (predicate.position <= candidates.size())
+      {
+        const XMLNode* keep = candidates[predicate.position - 1];
+        candidates.assign(1, keep);
+      }
+      else
+      {
+        candidates.clear();
+      }
+      break;
+
+    case Predicate::Last:
+      candidates.erase(candidates.begin(), candidates.end() - 1);
+      break;
+
+    default:
+      {
+        size_t kept = 0;
+        for (size_t n = 0; n < candidates.size(); ++n)
+        {
+          if (satisfies(predicate, *candidates[n]))
+          {
+            candidates[kept++] = candidates[n];
+          }
+        }
+        candidates.resize(kept);
+      }
+      break;
+    }
+  }
+}
+
+
+/*
+ * Appends the children of parent selected by step, ignoring its axis.
+ */
+void
+XMLPath::selectChildren (  const Step&             step
+                         , const XMLNode&          parent
+                         , vector<const XMLNode*>& result
+                         , XMLPathIndex*           index ) const
+{
+  vector<const XMLNode*> candidates;
+
+  const vector<unsigned int>* positions = NULL;
+  if (index != NULL && !step.anyName)
+  {
+    positions = index->getPositions(parent, step.name);
+  }
+
+  if (positions != NULL)
+  {
+    for (size_t n = 0; n < positions->size(); ++n)
+    {
+      const XMLNode& child = parent.getChild((*positions)[n]);
+      if (matches(step, child)) candidates.push_back(&child);
+    }
+  }
+  else
+  {
+    const unsigned int numChildren = parent.getNumChildren();
+    for (unsigned int n = 0; n < numChildren; ++n)
+    {
+      const XMLNode& child = parent.getChild(n);
+      if (matches(step, child)) candidates.push_back(&child);
+    }
+  }
+
+  applyPredicates(step.predicates, candidates);
+  result.insert(result.end(), candidates.begin(), candidates.end());
+}
+
+
+/*
+ * Appends, in document order, the children of node and of each of its
+ * descendants that are selected by step.
+ */
+void
+XMLPath::selectDescendants (  const Step&             step
+                            , const XMLNode&          node
+                            , vector<const XMLNode*>& result
+                            , XMLPathIndex*           index ) const
+{
+  vector<const XMLNode*> selected;
+  selectChildren(step, node, selected, index);
+
+  size_t next = 0;
+  const unsigned int numChildren = node.getNumChildren();
+
+  for (unsigned int n = 0; n < numChildren; ++n)
+  {
+    const XMLNode& child = node.getChild(n);
+
+    if (next < selected.size() && selected[next] == &child)
+    {
+      result.push_back(&child);
+      ++next;
+    }
+
+    if (child.getNumChildren() > 0)
+    {
+      selectDescendants(step, child, result, index);
+    }
+  }
+}
+
+
+/*
+ * @return true if node satisfies the given attribute predicate.
+ */
+bool
+XMLPath::satisfies (const Predicate& predicate, const XMLToken& node)
+{
+  const XMLAttributes& attributes = node.getAttributes();
+  int index = attributes.getIndex(predicate.name, predicate.uri);
+
+  if (index < 0) return false;
+
+  return predicate.kind != Predicate::AttributeEquals ||
+         attributes.getValue(index) == predicate.value;
+}
+
+
+/*
+ * @return true if node satisfies every attribute predicate.
+ */
+bool
+XMLPath::passes (const vector<Predicate>& predicates, const XMLNode& node)
+{
+  for (size_t p = 0; p < predicates.size(); ++p)
+  {
+    if (predicates[p].kind != Predicate::HasAttribute &&
+        predicates[p].kind != Predicate::AttributeEquals) continue;
+
+    if (!satisfies(predicates[p], node)) return false;
+  }
+
+  return true;
+}
+
+
+/*
+ * Evaluates the remaining steps from each child of node selected by step
+ * stepIndex, which has no positional predicates.
+ */
+void
+XMLPath::evaluateChildren (  size_t                  stepIndex
+                           , const XMLNode&          node
+                           , vector<const XMLNode*>& result
+                           , XMLPathIndex*           index ) const
+{
+  const Step& step = mSteps[stepIndex];
+
+  const vector<unsigned int>* positions = NULL;
+  if (index != NULL && !step.anyName)
+  {
+    positions = index->getPositions(node, step.name);
+  }
+
+  if (positions != NULL)
+  {
+    for (size_t n = 0; n < positions->size(); ++n)
+    {
+      const XMLNode& child = node.getChild((*positions)[n]);
+      if (matches(step, child) && passes(step.predicates, child))
+      {
+        evaluate(stepIndex + 1, child, result, index);
+      }
+    }
+  }
+  else
+  {
+    const unsigned int numChildren = node.getNumChildren();
+    for (unsigned int n = 0; n < numChildren; ++n)
+    {
+      const XMLNode& child = node.getChild(n);
+      if (matches(step, child) && passes(step.predicates, child))
+      {
+        evaluate(stepIndex + 1, child, result, index);
+      }
+    }
+  }
+}
+
+
+/*
+ * As evaluateChildren(), for every descendant of node in document order.
+ */
+void
+XMLPath::evaluateDescendants (  size_t                  stepIndex
+                              , const XMLNode&          node
+                              , vector<const XMLNode*>& result
+                              , XMLPathIndex*           index ) const
+{
+  const Step& step = mSteps[stepIndex];
+
+  const unsigned int numChildren = node.getNumChildren();
+  for (unsigned int n = 0; n < numChildren; ++n)
+  {
+    const XMLNode& child = node.getChild(n);
+    if (matches(step, child) && passes(step.predicates, child))
+    {
+      evaluate(stepIndex + 1, child, result, index);
+    }
+
+    if (child.getNumChildren() > 0)
+    {
+      evaluateDescendants(stepIndex, child, result, index);
+    }
+  }
+}
+
+
+/*
+ * Selects step stepIndex from node and evaluates the remaining steps from
+ * each node it selects.
+ */
+void
+XMLPath::evaluate (  size_t                  stepIndex
+                   , const XMLNode&          node
+                   , vector<const XMLNode*>& result
+                   , XMLPathIndex*           index ) const
+{
+  if (stepIndex == mSteps.size())
+  {
+    result.push_back(&node);
+    return;
+  }
+
+  const Step& step = mSteps[stepIndex];
+
+  /*
+   * Without positional predicates each candidate can be decided on its
+   * own, so the next step is evaluated as soon as one is found.
+   */
+  if (!step.self && !step.positional)
+  {
+    if (step.descendant)
+    {
+      evaluateDescendants(stepIndex, node, result, index);
+    }
+    else
+    {
+      evaluateChildren(stepIndex, node, result, index);
+    }
+    return;
+  }
+
+  vector<const XMLNode*> selected;
+
+  if (step.self)
+  {
+    selected.push_back(&node);
+    if (step.descendant)
+    {
+      selectDescendants(anyElement(), node, selected, index);
+    }
+    applyPredicates(step.predicates, selected);
+  }
+  else if (step.descendant)
+  {
+    selectDescendants(step, node, selected, index);
+  }
+  else
+  {
+    selectChildren(step, node, selected, index);
+  }
+
+  for (size_t n = 0; n < selected.size(); ++n)
+  {
+    evaluate(stepIndex + 1, *selected[n], result, index);
+  }
+}
+
+
+/*
+ * Appends to result, in document order, the nodes of the subtree rooted at
+ * node that are members of wanted, removing each from wanted.
+ */
+static void
+collectInOrder (  const XMLNode&                     node
+                , unordered_set<const XMLNode*>&     wanted
+                , vector<const XMLNode*>&            result )
+{
+  if (wanted.erase(&node) > 0) result.push_back(&node);
+
+  const unsigned int numChildren = node.getNumChildren();
+  for (unsigned int n = 0; n < numChildren && !wanted.empty(); ++n)
+  {
+    collectInOrder(node.getChild(n), wanted, result);
+  }
+}
+/** @endcond */
+
+
+/*
+ * Appends the nodes selected by this path to result.
+ */
+unsigned int
+XMLPath::select (  const XMLNode&          node
+                 , vector<const XMLNode*>& result
+                 , XMLPathIndex*           index ) const
+{
+  const size_t start = result.size();
+
+  if (mAbsolute && !node.isEOF())
+  {
+    /*
+     * node is the document element: the first step selects it (or, for
+     * '//', it and its descendants) rather than its children.
+     */
+    const Step& first = mSteps[0];
+    vector<const XMLNode*> selected;
+
+    if (first.self)
+    {
+      selected.push_back(&node);
+      if (first.descendant)
+      {
+        selectDescendants(anyElement(), node, selected, index);
+      }
+      applyPredicates(first.predicates, selected);
+    }
+    else
+    {
+      if (matches(first, node)) selected.push_back(&node);
+      applyPredicates(first.predicates, selected);
+
+      if (first.descendant)
+      {
+        selectDescendants(first, node, selected, index);
+      }
+    }
+
+    for (size_t n = 0; n < selected.size(); ++n)
+    {
+      evaluate(1, *selected[n], result, index);
+    }
+  }
+  else
+  {
+    evaluate(0, node, result, index);
+  }
+
+  if (mNeedsOrdering && result.size() - start > 1)
+  {
+    unordered_set<const XMLNode*> wanted(result.begin() + start, result.end());
+    result.resize(start);
+    collectInOrder(node, wanted, result);
+  }
+
+  return (unsigned int)(result.size() - start);
+}
+
+
+/*
+ * @return the first node selected by this path, or NULL.
+ */
+const XMLNode*
+XMLPath::selectFirst (const XMLNode& node, XMLPathIndex* index) const
+{
+  vector<const XMLNode*> result;
+  select(node, result, index);
+
+  return result.empty() ? NULL : result[0];
+}
+
+
+/*
+ * @return the number of nodes selected by this path.
+ */
+unsigned int
+XMLPath::count (const XMLNode& node, XMLPathIndex* index) const
+{
+  vector<const XMLNode*> result;
+  return select(node, result, index);
+}
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLPath_t *
+XMLPath_compile (const char *expression, const XMLNamespaces_t *namespaces)
+{
+  if (expression == NULL) return NULL;
+  return XMLPath::compile(expression, namespaces);
+}
+
+
+LIBLX_EXTERN
+void
+XMLPath_free (XMLPath_t *path)
+{
+  if (path == NULL) return;
+  delete static_cast<XMLPath*>(path);
+}
+
+
+LIBLX_EXTERN
+const XMLNode_t *
+XMLPath_selectFirst (const XMLPath_t *path, const XMLNode_t *node)
+{
+  if (path == NULL || node == NULL) return NULL;
+  return path->selectFirst(*node);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLPath_count (const XMLPath_t *path, const XMLNode_t *node)
+{
+  if (path == NULL || node == NULL) return 0;
+  return path->count(*node);
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,378 @@
+/**
+ * @file    XMLPath.h
+ * @brief   Compiled path queries over XMLNode trees
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLPath
+ * @sbmlbrief{core} A compiled query selecting nodes from an XMLNode tree.
+ *
+ * XMLPath understands a small subset of XPath 1.0, enough to replace the
+ * loops over XMLNode::getChild() and XMLNode::getIndex() that are otherwise
+ * needed to locate elements:
+ *
+ * @li steps separated by <code>/</code> (child axis) or <code>//</code>
+ * (descendant axis);
+ * @li name tests <code>name</code>, <code>prefix:name</code>,
+ * <code>*</code> and <code>prefix:*</code>, and the step <code>.</code>;
+ * @li predicates <code>[@attr]</code>, <code>[@attr='value']</code>,
+ * <code>[n]</code> and <code>[last()]</code>, applied in order.
+ *
+ * A path beginning with <code>/</code> treats the node it is evaluated
+ * against as the document element, so <code>/model/listOfSpecies</code>
+ * requires that node to be named @c model.  A dummy root as returned by
+ * XMLNode::convertStringToXMLNode() stands for the document itself.  Other
+ * paths are relative to the node.
+ *
+ * Prefixes used in the path are resolved against the XMLNamespaces given
+ * to XMLPath::compile().  Unlike XPath, an element name test without a
+ * prefix matches the local name in any namespace, as XMLNode::getChild()
+ * does; attribute names without a prefix only match attributes in no
+ * namespace.
+ *
+ * A query is compiled once and may be evaluated any number of times, also
+ * from several threads at once provided each uses its own XMLPathIndex.
+ * Results are returned in document order without duplicates.
+ *
+ * Nodes with many children can be searched through an XMLPathIndex, which
+ * records the positions of each node's children by name the first time it
+ * is needed:
+@code{.cpp}
+XMLPath* path = XMLPath::compile("//listOfSpecies/species[@compartment='c']");
+XMLPathIndex index;
+std::vector<const XMLNode*> found;
+path->select(*model, found, &index);
+@endcode
+ */
+
+#ifndef XMLPath_h
+#define XMLPath_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLNamespaces;
+class XMLNode;
+class XMLToken;
+
+
+class LIBLX_EXTERN XMLPathIndex
+{
+public:
+
+  /**
+   * Nodes with fewer children than this are scanned directly rather than
+   * indexed.
+   */
+  static const unsigned int MIN_CHILDREN = 16;
+
+
+  /**
+   * Creates a new, empty XMLPathIndex.
+   */
+  XMLPathIndex ();
+
+
+  /**
+   * Destroys this XMLPathIndex.
+   */
+  virtual ~XMLPathIndex ();
+
+
+  /**
+   * Returns the positions of the children of @p node with the given local
+   * name, building the index for @p node if it does not exist yet.
+   *
+   * @return the positions in increasing order, or @c NULL if @p node has
+   * too few children to be worth indexing.
+   */
+  const std::vector<unsigned int>* getPositions (  const XMLNode&     node
+                                                , const std::string& name );
+
+
+  /**
+   * Discards all indexes.  This must be called after a child of an
+   * indexed node is added, removed or renamed.
+   */
+  void clear ();
+
+
+  /**
+   * @return the number of nodes that have been indexed.
+   */
+  unsigned int getNumIndexedNodes () const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+protected:
+
+  typedef std::unordered_map<std::string, std::vector<unsigned int> >
+          NameIndex;
+
+  std::unordered_map<const XMLNode*, NameIndex> mIndexes;
+
+private:
+
+  XMLPathIndex (const XMLPathIndex& orig);
+  XMLPathIndex& operator= (const XMLPathIndex& rhs);
+
+  /** @endcond */
+};
+
+
+class LIBLX_EXTERN XMLPath
+{
+public:
+
+  /**
+   * Compiles a path expression.
+   *
+   * @param expression the path to compile.
+   * @param namespaces the bindings for prefixes used in @p expression, or
+   * @c NULL if it uses none.
+   *
+   * @return the compiled path, owned by the caller, or @c NULL if
+   * @p expression is not a valid path or uses an unbound prefix.
+   */
+  static XMLPath* compile (  const std::string&   expression
+                           , const XMLNamespaces* namespaces = NULL );
+
+
+  /**
+   * Copy constructor; creates a copy of this XMLPath.
+   */
+  XMLPath (const XMLPath& orig);
+
+
+  /**
+   * Assignment operator for XMLPath.
+   */
+  XMLPath& operator= (const XMLPath& rhs);
+
+
+  /**
+   * Creates and returns a deep copy of this XMLPath.
+   */
+  XMLPath* clone () const;
+
+
+  /**
+   * Destroys this XMLPath.
+   */
+  virtual ~XMLPath ();
+
+
+  /**
+   * @return the expression this path was compiled from.
+   */
+  const std::string& getExpression () const;
+
+
+  /**
+   * Appends the nodes selected by this path to @p result.
+   *
+   * @param node the node to evaluate the path against.
+   * @param result the vector to which the selected nodes are appended.
+   * @param index an optional index used for nodes with many children.
+   *
+   * @return the number of nodes selected.
+   */
+  unsigned int select (  const XMLNode&               node
+                       , std::vector<const XMLNode*>& result
+                       , XMLPathIndex*                index = NULL ) const;
+
+
+  /**
+   * @return the first node, in document order, selected by this path, or
+   * @c NULL if there is none.
+   */
+  const XMLNode* selectFirst (  const XMLNode& node
+                              , XMLPathIndex*  index = NULL ) const;
+
+
+  /**
+   * @return the number of nodes selected by this path.
+   */
+  unsigned int count (  const XMLNode& node
+                      , XMLPathIndex*  index = NULL ) const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+protected:
+
+  friend class XMLStreamMatcher;
+
+  struct Predicate
+  {
+    enum Kind { Position, Last, HasAttribute, AttributeEquals };
+
+    Kind         kind;
+    unsigned int position;
+    std::string  name;
+    std::string  uri;
+    std::string  value;
+  };
+
+  struct Step
+  {
+    bool        descendant;   /* preceded by '//' */
+    bool        self;         /* the step '.' */
+    bool        anyName;      /* '*' or 'prefix:*' */
+    bool        anyURI;       /* no prefix given */
+    bool        positional;   /* has a [n] or [last()] predicate */
+    std::string name;
+    std::string uri;
+
+    std::vector<Predicate> predicates;
+  };
+
+
+  XMLPath ();
+
+  bool parse (const std::string& expression, const XMLNamespaces* namespaces);
+
+  static const Step& anyElement ();
+
+  static void applyPredicates (  const std::vector<Predicate>& predicates
+                               , std::vector<const XMLNode*>&  candidates );
+
+  static bool satisfies (const Predicate& predicate, const XMLToken& node);
+
+  static bool passes (  const std::vector<Predicate>& predicates
+                      , const XMLNode&                node );
+
+  static bool matches (const Step& step, const XMLToken& node);
+
+  void selectChildren (  const Step&                  step
+                       , const XMLNode&               parent
+                       , std::vector<const XMLNode*>& result
+                       , XMLPathIndex*                index ) const;
+
+  void selectDescendants (  const Step&                  step
+                          , const XMLNode&               node
+                          , std::vector<const XMLNode*>& result
+                          , XMLPathIndex*                index ) const;
+
+  void evaluateChildren (  size_t                       stepIndex
+                         , const XMLNode&               node
+                         , std::vector<const XMLNode*>& result
+                         , XMLPathIndex*                index ) const;
+
+  void evaluateDescendants (  size_t                       stepIndex
+                            , const XMLNode&               node
+                            , std::vector<const XMLNode*>& result
+                            , XMLPathIndex*                index ) const;
+
+  void evaluate (  size_t                       stepIndex
+                 , const XMLNode&               node
+                 , std::vector<const XMLNode*>& result
+                 , XMLPathIndex*                index ) const;
+
+
+  std::string       mExpression;
+  bool              mAbsolute;
+  std::vector<Step> mSteps;
+
+  /* true when results from different branches can arrive out of
+   * document order and must be sorted */
+  bool              mNeedsOrdering;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Compiles a path expression.
+ *
+ * @param expression the path to compile.
+ * @param namespaces the bindings for prefixes used in @p expression, or
+ * @c NULL.
+ *
+ * @return the compiled XMLPath_t, or @c NULL if @p expression is invalid.
+ *
+ * @memberof XMLPath_t
+ */
+LIBLX_EXTERN
+XMLPath_t *
+XMLPath_compile (const char *expression, const XMLNamespaces_t *namespaces);
+
+
+/**
+ * Destroys this XMLPath_t structure.
+ *
+ * @param path XMLPath_t structure to be freed.
+ *
+ * @memberof XMLPath_t
+ */
+LIBLX_EXTERN
+void
+XMLPath_free (XMLPath_t *path);
+
+
+/**
+ * Returns the first node selected by the given path.
+ *
+ * @param path the XMLPath_t to evaluate.
+ * @param node the XMLNode_t to evaluate it against.
+ *
+ * @return the first selected node, or @c NULL if there is none.
+ *
+ * @memberof XMLPath_t
+ */
+LIBLX_EXTERN
+const XMLNode_t *
+XMLPath_selectFirst (const XMLPath_t *path, const XMLNode_t *node);
+
+
+/**
+ * Returns the number of nodes selected by the given path.
+ *
+ * @param path the XMLPath_t to evaluate.
+ * @param node the XMLNode_t to evaluate it against.
+ *
+ * @return the number of selected nodes.
+ *
+ * @memberof XMLPath_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLPath_count (const XMLPath_t *path, const XMLNode_t *node);
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLPath_h */
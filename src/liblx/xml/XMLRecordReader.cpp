@@ -0,0 +1,762 @@
+/**
+ * @file    XMLRecordReader.cpp
+ * @brief   Reads records from an XMLInputStream and processes them on
+ *          several threads
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <liblx/xml/XMLRecordReader.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLToken.h>
+#include <liblx/xml/operationReturnValues.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/** @cond doxygenLibsbmlInternal */
+
+static const unsigned int DEFAULT_MAX_PENDING = 256;
+
+
+/*
+ * Bounded multi-producer, multi-consumer queue of pointers (D. Vyukov's
+ * design).  Each cell carries a sequence number telling producers and
+ * consumers whose turn it is, so neither side takes a lock.
+ */
+template <class T>
+class BoundedQueue
+{
+public:
+
+  explicit BoundedQueue (size_t capacity)
+   : mCells   ( NULL )
+   , mMask    ( 0    )
+   , mPush    ( 0    )
+   , mPop     ( 0    )
+  {
+    size_t size = 2;
+    while (size < capacity) size *= 2;
+
+    mCells = new Cell[size];
+    mMask  = size - 1;
+
+    for (size_t n = 0; n < size; ++n)
+    {
+      mCells[n].sequence.store(n, memory_order_relaxed);
+    }
+  }
+
+
+  ~BoundedQueue ()
+  {
+    delete [] mCells;
+  }
+
+
+  bool push (T value)
+  {
+    size_t pos = mPush.load(memory_order_relaxed);
+    Cell*  cell;
+
+    while (true)
+    {
+      cell = &mCells[pos & mMask];
+
+      const size_t   sequence = cell->sequence.load(memory_order_acquire);
+      const ptrdiff_t diff    = (ptrdiff_t) sequence - (ptrdiff_t) pos;
+
+      if (diff == 0)
+      {
+        if (mPush.compare_exchange_weak(pos, pos + 1)) break;
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = mPush.load(memory_order_relaxed);
+      }
+    }
+
+    cell->value = value;
+    cell->sequence.store(pos + 1, memory_order_release);
+
+    return true;
+  }
+
+
+  bool pop (T& value)
+  {
+    size_t pos = mPop.load(memory_order_relaxed);
+    Cell*  cell;
+
+    while (true)
+    {
+      cell = &mCells[pos & mMask];
+
+      const size_t    sequence = cell->sequence.load(memory_order_acquire);
+      const ptrdiff_t diff     = (ptrdiff_t) sequence - (ptrdiff_t) (pos + 1);
+
+      if (diff == 0)
+      {
+        if (mPop.compare_exchange_weak(pos, pos + 1)) break;
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = mPop.load(memory_order_relaxed);
+      }
+    }
+
+    value = cell->value;
+    cell->sequence.store(pos + mMask + 1, memory_order_release);
+
+    return true;
+  }
+
+
+  /*
+   * @return true if nothing has been pushed that has not been popped.
+   * Only a hint while other threads are pushing or popping.
+   */
+  bool empty () const
+  {
+    return mPop.load() >= mPush.load();
+  }
+
+
+private:
+
+  struct Cell
+  {
+    atomic<size_t> sequence;
+    T              value;
+  };
+
+  Cell*          mCells;
+  size_t         mMask;
+  atomic<size_t> mPush;
+  atomic<size_t> mPop;
+
+  BoundedQueue (const BoundedQueue& orig);
+  BoundedQueue& operator= (const BoundedQueue& rhs);
+};
+
+
+/*
+ * A record on its way from the reader to the workers and back.
+ */
+struct XMLRecordReader::Record
+{
+  XMLNode*     node;
+  unsigned int index;
+  int          result;
+};
+
+
+/*
+ * The state shared by the reader and the workers during one call to
+ * run().  Records travel through the two queues; the mutex and condition
+ * variables are only used to put idle threads to sleep.
+ *
+ * A thread about to sleep announces it (idleWorkers, readerWaiting) and
+ * then checks its queue; a thread pushing to a queue then checks for a
+ * sleeper to wake.  A seq_cst fence between the store and the load on
+ * each side ensures that at least one of the two sees the other, so no
+ * wakeup is lost and the waits need no timeout.
+ */
+struct XMLRecordReader::Pipeline
+{
+  Pipeline (const XMLRecordReader& reader)
+   : process       ( reader.mProcess            )
+   , userData      ( reader.mUserData           )
+   , work          ( reader.mMaxPending         )
+   , done          ( reader.mMaxPending         )
+   , finished      ( false                      )
+   , stop          ( false                      )
+   , failed        ( false                      )
+   , idleWorkers   ( 0                          )
+   , readerWaiting ( false                      )
+   , window        ( reader.mMaxPending, NULL   )
+   , nextIndex     ( 0                          )
+   , pending       ( 0                          )
+  {
+  }
+
+  XMLRecordCallback       process;
+  void*                   userData;
+
+  BoundedQueue<Record*>   work;
+  BoundedQueue<Record*>   done;
+
+  atomic<bool>            finished;
+  atomic<bool>            stop;
+
+  /* Set when a callback throws or memory runs out; records still in the
+   * pipeline are then freed without being processed or completed. */
+  atomic<bool>            failed;
+
+  mutex                   lock;
+  condition_variable      workReady;
+  condition_variable      recordDone;
+  atomic<unsigned int>    idleWorkers;
+  atomic<bool>            readerWaiting;
+
+  /* Used by the reader only: records processed out of order, by index
+   * modulo the window size, and the number read but not completed. */
+  vector<Record*>         window;
+  unsigned int            nextIndex;
+  unsigned int            pending;
+};
+/** @endcond */
+
+
+/*
+ * Creates a new XMLRecordReader whose records are the children of the
+ * document element.
+ */
+XMLRecordReader::XMLRecordReader (  XMLRecordCallback process
+                                  , void*             userData
+                                  , unsigned int      numThreads )
+ : mProcess    ( process               )
+ , mCompletion ( NULL                  )
+ , mUserData   ( userData              )
+ , mNumThreads ( numThreads            )
+ , mOrder      ( LIBLX_RECORDS_ORDERED )
+ , mMaxPending ( DEFAULT_MAX_PENDING   )
+ , mNumRecords ( 0                     )
+ , mStopped    ( false                 )
+{
+  if (mNumThreads == 0) mNumThreads = thread::hardware_concurrency();
+  if (mNumThreads == 0) mNumThreads = 1;
+}
+
+
+/*
+ * Destroys this XMLRecordReader.
+ */
+XMLRecordReader::~XMLRecordReader ()
+{
+}
+
+
+/*
+ * @return the number of worker threads this reader uses.
+ */
+unsigned int
+XMLRecordReader::getNumThreads () const
+{
+  return mNumThreads;
+}
+
+
+/*
+ * Sets the name of the element whose children are the records.
+ */
+int
+XMLRecordReader::setContainer (const string& name)
+{
+  mContainer = name;
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the name of the element whose children are the records.
+ */
+const string&
+XMLRecordReader::getContainer () const
+{
+  return mContainer;
+}
+
+
+/*
+ * Sets the order in which records are completed.
+ */
+int
+XMLRecordReader::setOrder (XMLRecordOrder_t order)
+{
+  if (order != LIBLX_RECORDS_ORDERED && order != LIBLX_RECORDS_UNORDERED)
+  {
+    return LIBLX_INVALID_ATTRIBUTE_VALUE;
+  }
+
+  mOrder = order;
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the order in which records are completed.
+ */
+XMLRecordOrder_t
+XMLRecordReader::getOrder () const
+{
+  return mOrder;
+}
+
+
+/*
+ * Sets the largest number of records read but not yet completed.
+ */
+int
+XMLRecordReader::setMaxPending (unsigned int count)
+{
+  if (count == 0) return LIBLX_INVALID_ATTRIBUTE_VALUE;
+
+  mMaxPending = count;
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the largest number of records read but not yet completed.
+ */
+unsigned int
+XMLRecordReader::getMaxPending () const
+{
+  return mMaxPending;
+}
+
+
+/*
+ * Sets the function called for each record once it is processed.
+ */
+void
+XMLRecordReader::setCompletion (XMLRecordCompletion completion)
+{
+  mCompletion = completion;
+}
+
+
+/*
+ * Reads the stream to the end of the container and processes every
+ * record in it.
+ */
+int
+XMLRecordReader::run (XMLInputStream& stream)
+{
+  mNumRecords = 0;
+  mStopped    = false;
+
+  XMLToken container;
+
+  if (mProcess == NULL || !findContainer(stream, container))
+  {
+    return stream.isError() ? LIBLX_OPERATION_FAILED : LIBLX_OPERATION_SUCCESS;
+  }
+
+  Pipeline       pipeline(*this);
+  vector<thread> workers;
+
+  for (unsigned int n = 0; n < mNumThreads; ++n)
+  {
+    try
+    {
+      workers.push_back(thread(work, &pipeline));
+    }
+    catch ( ... )
+    {
+      break;
+    }
+  }
+
+  try
+  {
+    while (!container.isEnd() && stream.isGood() && !pipeline.stop)
+    {
+      const XMLToken& next = stream.peek();
+
+      if (next.isEndFor(container))
+      {
+        stream.next();
+        break;
+      }
+
+      if (!next.isStart())
+      {
+        stream.next();
+        continue;
+      }
+
+      /* backpressure: wait for a record to complete before reading more */
+      while (pipeline.pending >= mMaxPending)
+      {
+        collect(pipeline, true);
+      }
+
+      unique_ptr<XMLNode> node(new XMLNode(stream));
+
+      Record* record = new Record;
+      record->node   = node.release();
+      record->index  = mNumRecords++;
+      record->result = 0;
+
+      ++pipeline.pending;
+
+      if (workers.empty())
+      {
+        process(pipeline, record);
+        complete(pipeline, record);
+        continue;
+      }
+
+      pipeline.work.push(record);
+      atomic_thread_fence(memory_order_seq_cst);
+
+      if (pipeline.idleWorkers > 0)
+      {
+        lock_guard<mutex> guard(pipeline.lock);
+        pipeline.workReady.notify_one();
+      }
+
+      collect(pipeline, false);
+    }
+  }
+  catch ( ... )
+  {
+    pipeline.failed = true;
+    pipeline.stop   = true;
+  }
+
+  {
+    lock_guard<mutex> guard(pipeline.lock);
+    pipeline.finished = true;
+    pipeline.workReady.notify_all();
+  }
+
+  while (pipeline.pending > 0)
+  {
+    collect(pipeline, true);
+  }
+
+  for (size_t n = 0; n < workers.size(); ++n)
+  {
+    workers[n].join();
+  }
+
+  mStopped = pipeline.stop;
+
+  if (pipeline.failed) return LIBLX_OPERATION_FAILED;
+
+  return stream.isError() ? LIBLX_OPERATION_FAILED : LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the number of records read by the last call to run().
+ */
+unsigned int
+XMLRecordReader::getNumRecords () const
+{
+  return mNumRecords;
+}
+
+
+/*
+ * @return true if the last call to run() was stopped by the processing
+ * callback.
+ */
+bool
+XMLRecordReader::isStopped () const
+{
+  return mStopped;
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Reads up to and including the start of the container.
+ *
+ * @return true if it was found.
+ */
+bool
+XMLRecordReader::findContainer (XMLInputStream& stream, XMLToken& container)
+{
+  while (stream.isGood())
+  {
+    const XMLToken& next = stream.peek();
+
+    if (next.isEOF()) break;
+
+    if (next.isStart() && (mContainer.empty() || next.getName() == mContainer))
+    {
+      container = stream.next();
+      return true;
+    }
+
+    stream.next();
+  }
+
+  return false;
+}
+
+
+/*
+ * Processes records from the work queue until the reader has finished
+ * and the queue is empty.
+ */
+void
+XMLRecordReader::work (Pipeline* pipeline)
+{
+  Record* record;
+
+  while (true)
+  {
+    if (pipeline->work.pop(record))
+    {
+      process(*pipeline, record);
+      pipeline->done.push(record);
+      atomic_thread_fence(memory_order_seq_cst);
+
+      if (pipeline->readerWaiting)
+      {
+        lock_guard<mutex> guard(pipeline->lock);
+        pipeline->recordDone.notify_one();
+      }
+
+      continue;
+    }
+
+    if (pipeline->finished)
+    {
+      if (pipeline->work.empty()) break;
+      continue;
+    }
+
+    unique_lock<mutex> guard(pipeline->lock);
+
+    ++pipeline->idleWorkers;
+    atomic_thread_fence(memory_order_seq_cst);
+
+    pipeline->workReady.wait(guard, [pipeline] ()
+    {
+      return !pipeline->work.empty() || pipeline->finished;
+    });
+    --pipeline->idleWorkers;
+  }
+}
+
+
+/*
+ * Passes record to the processing callback, unless the pipeline has
+ * failed.  An exception from the callback fails the pipeline rather than
+ * escaping the thread.
+ */
+void
+XMLRecordReader::process (Pipeline& pipeline, Record* record)
+{
+  if (pipeline.failed) return;
+
+  try
+  {
+    record->result = pipeline.process(record->node, record->index,
+                                      pipeline.userData);
+    if (record->result != 0) pipeline.stop = true;
+  }
+  catch ( ... )
+  {
+    pipeline.failed = true;
+    pipeline.stop   = true;
+  }
+}
+
+
+/*
+ * Passes a processed record to the completion callback, in document order
+ * if required, and destroys it.
+ */
+void
+XMLRecordReader::complete (Pipeline& pipeline, Record* record)
+{
+  if (mOrder == LIBLX_RECORDS_ORDERED)
+  {
+    const size_t slots = pipeline.window.size();
+
+    pipeline.window[record->index % slots] = record;
+
+    while ((record = pipeline.window[pipeline.nextIndex % slots]) != NULL)
+    {
+      pipeline.window[pipeline.nextIndex % slots] = NULL;
+      ++pipeline.nextIndex;
+
+      finish(pipeline, record);
+    }
+  }
+  else
+  {
+    finish(pipeline, record);
+  }
+}
+
+
+/*
+ * Passes a record to the completion callback, unless the pipeline has
+ * failed, and destroys it.
+ */
+void
+XMLRecordReader::finish (Pipeline& pipeline, Record* record)
+{
+  if (mCompletion != NULL && !pipeline.failed)
+  {
+    try
+    {
+      mCompletion(record->node, record->index, record->result, mUserData);
+    }
+    catch ( ... )
+    {
+      pipeline.failed = true;
+      pipeline.stop   = true;
+    }
+  }
+
+  delete record->node;
+  delete record;
+  --pipeline.pending;
+}
+
+
+/*
+ * Completes the records the workers have processed.  If wait is true
+ * and there are none, waits until a worker has processed one.
+ *
+ * @return true if any record was collected.
+ */
+bool
+XMLRecordReader::collect (Pipeline& pipeline, bool wait)
+{
+  bool    collected = false;
+  Record* record;
+
+  while (pipeline.done.pop(record))
+  {
+    complete(pipeline, record);
+    collected = true;
+  }
+
+  if (collected || !wait) return collected;
+
+  unique_lock<mutex> guard(pipeline.lock);
+
+  pipeline.readerWaiting = true;
+  atomic_thread_fence(memory_order_seq_cst);
+
+  pipeline.recordDone.wait(guard, [&pipeline] ()
+  {
+    return !pipeline.done.empty();
+  });
+  pipeline.readerWaiting = false;
+
+  return false;
+}
+/** @endcond */
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLRecordReader_t *
+XMLRecordReader_create (  XMLRecordCallback process
+                        , void              *userData
+                        , unsigned int      numThreads )
+{
+  return new(nothrow) XMLRecordReader(process, userData, numThreads);
+}
+
+
+LIBLX_EXTERN
+void
+XMLRecordReader_free (XMLRecordReader_t *reader)
+{
+  if (reader == NULL) return;
+  delete static_cast<XMLRecordReader*>(reader);
+}
+
+
+LIBLX_EXTERN
+int
+XMLRecordReader_setContainer (XMLRecordReader_t *reader, const char *name)
+{
+  if (reader == NULL) return LIBLX_INVALID_OBJECT;
+  return reader->setContainer(name != NULL ? name : "");
+}
+
+
+LIBLX_EXTERN
+int
+XMLRecordReader_setOrder (XMLRecordReader_t *reader, XMLRecordOrder_t order)
+{
+  if (reader == NULL) return LIBLX_INVALID_OBJECT;
+  return reader->setOrder(order);
+}
+
+
+LIBLX_EXTERN
+int
+XMLRecordReader_setMaxPending (XMLRecordReader_t *reader, unsigned int count)
+{
+  if (reader == NULL) return LIBLX_INVALID_OBJECT;
+  return reader->setMaxPending(count);
+}
+
+
+LIBLX_EXTERN
+int
+XMLRecordReader_setCompletion (  XMLRecordReader_t   *reader
+                               , XMLRecordCompletion completion )
+{
+  if (reader == NULL) return LIBLX_INVALID_OBJECT;
+
+  reader->setCompletion(completion);
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+LIBLX_EXTERN
+int
+XMLRecordReader_run (XMLRecordReader_t *reader, XMLInputStream_t *stream)
+{
+  if (reader == NULL || stream == NULL) return LIBLX_INVALID_OBJECT;
+  return reader->run(*stream);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLRecordReader_getNumRecords (const XMLRecordReader_t *reader)
+{
+  if (reader == NULL) return 0;
+  return reader->getNumRecords();
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,448 @@
+/**
+ * @file    XMLRecordReader.h
+ * @brief   Reads records from an XMLInputStream and processes them on
+ *          several threads
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLRecordReader
+ * @sbmlbrief{core} Cuts the children of a container element out of an
+ * XMLInputStream and hands them to a pool of worker threads.
+ *
+ * Many documents are a long list of records: the children of one
+ * container element.  An XMLRecordReader reads the stream on the calling
+ * thread, reads each record into an XMLNode as soon as its end tag
+ * arrives, and passes it through a bounded queue to a pool of worker
+ * threads that call a processing callback.  Parsing stays sequential
+ * while the work done on each record runs on all the workers at once.
+ *
+ * At most getMaxPending() records are read but not yet completed at any
+ * time; when that many are waiting the reader stops parsing until a worker
+ * finishes one, so memory use is bounded however fast the stream is read.
+ *
+ * Once processed, each record is passed to the optional completion
+ * callback on the thread that called run(), one at a time, and is then
+ * destroyed.  With @sbmlconstant{LIBLX_RECORDS_ORDERED, XMLRecordOrder_t}
+ * completions are made in document order; with
+ * @sbmlconstant{LIBLX_RECORDS_UNORDERED, XMLRecordOrder_t} they are made
+ * as soon as each record is processed.
+ *
+@code{.cpp}
+static int
+score (const XMLNode_t* record, unsigned int index, void* data)
+{
+  return expensiveScore(*record);
+}
+
+static void
+report (const XMLNode_t* record, unsigned int index, int result, void* data)
+{
+  std::cout << index << ": " << result << std::endl;
+}
+
+XMLRecordReader reader(score, NULL, 8);
+reader.setContainer("listOfSpecies");
+reader.setCompletion(report);
+
+XMLInputStream stream("huge.xml");
+reader.run(stream);
+@endcode
+ */
+
+#ifndef XMLRecordReader_h
+#define XMLRecordReader_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+/**
+ * @enum XMLRecordOrder_t
+ * The order in which an XMLRecordReader completes records.
+ */
+typedef enum
+{
+    LIBLX_RECORDS_ORDERED = 0 /*!< Records are completed in document order. */
+
+  , LIBLX_RECORDS_UNORDERED   /*!< Records are completed as soon as they are
+                               *   processed. */
+} XMLRecordOrder_t;
+
+
+/**
+ * Function called by an XMLRecordReader, on one of its worker threads, for
+ * each record.
+ *
+ * @param record the record.
+ * @param index the position of the record among the records read, from 0.
+ * @param userData the pointer given when the reader was created.
+ *
+ * @return @c 0 to continue reading, or any other value to stop.  The
+ * value is also passed to the completion callback.
+ */
+typedef int (*XMLRecordCallback) (  const XMLNode_t* record
+                                  , unsigned int     index
+                                  , void*            userData );
+
+
+/**
+ * Function called by an XMLRecordReader, on the thread reading the
+ * stream, for each record once it has been processed.
+ *
+ * @param record the record.  It is destroyed when the callback returns.
+ * @param index the position of the record among the records read, from 0.
+ * @param result the value returned by the processing callback.
+ * @param userData the pointer given when the reader was created.
+ */
+typedef void (*XMLRecordCompletion) (  const XMLNode_t* record
+                                     , unsigned int     index
+                                     , int              result
+                                     , void*            userData );
+
+LIBLX_CPP_NAMESPACE_END
+
+
+#ifdef __cplusplus
+
+#include <string>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLInputStream;
+class XMLToken;
+
+
+class LIBLX_EXTERN XMLRecordReader
+{
+public:
+
+  /**
+   * Creates a new XMLRecordReader whose records are the children of the
+   * document element.
+   *
+   * @param process the function to call for each record.
+   * @param userData a pointer passed unchanged to the callbacks.
+   * @param numThreads the number of worker threads, or @c 0 for the
+   * number of hardware threads.
+   */
+  XMLRecordReader (  XMLRecordCallback process
+                   , void*             userData   = NULL
+                   , unsigned int      numThreads = 0 );
+
+
+  /**
+   * Destroys this XMLRecordReader.
+   */
+  virtual ~XMLRecordReader ();
+
+
+  /**
+   * @return the number of worker threads this reader uses.
+   */
+  unsigned int getNumThreads () const;
+
+
+  /**
+   * Sets the name of the element whose children are the records.  The
+   * first element with this name is used, whatever its namespace.
+   *
+   * @param name the name of the container, or the empty string for the
+   * document element.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   */
+  int setContainer (const std::string& name);
+
+
+  /**
+   * @return the name of the element whose children are the records, or
+   * the empty string for the document element.
+   */
+  const std::string& getContainer () const;
+
+
+  /**
+   * Sets the order in which records are completed.
+   *
+   * @param order the order.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * if @p order is not an XMLRecordOrder_t value.
+   */
+  int setOrder (XMLRecordOrder_t order);
+
+
+  /**
+   * @return the order in which records are completed.
+   */
+  XMLRecordOrder_t getOrder () const;
+
+
+  /**
+   * Sets the largest number of records read but not yet completed.
+   *
+   * @param count the number of records.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * if @p count is 0.
+   */
+  int setMaxPending (unsigned int count);
+
+
+  /**
+   * @return the largest number of records read but not yet completed.
+   */
+  unsigned int getMaxPending () const;
+
+
+  /**
+   * Sets the function called for each record once it is processed.
+   *
+   * @param completion the function, or @c NULL for none.
+   */
+  void setCompletion (XMLRecordCompletion completion);
+
+
+  /**
+   * Reads the stream to the end of the container and processes every
+   * record in it.  Every record read is processed and completed before
+   * this method returns, even when reading stops early.
+   *
+   * If a callback throws, or memory runs out, reading stops and the
+   * records not yet completed are freed without being processed or
+   * passed to the completion callback; the exception does not escape.
+   *
+   * @param stream the XMLInputStream to read.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_OPERATION_FAILED, OperationReturnValues_t}
+   * if the stream reported an error, a callback threw or memory ran out.
+   */
+  int run (XMLInputStream& stream);
+
+
+  /**
+   * @return the number of records read by the last call to run().
+   */
+  unsigned int getNumRecords () const;
+
+
+  /**
+   * @return @c true if the last call to run() was stopped by the
+   * processing callback.
+   */
+  bool isStopped () const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+protected:
+
+  struct Record;
+  struct Pipeline;
+
+  bool findContainer (XMLInputStream& stream, XMLToken& container);
+
+  static void work (Pipeline* pipeline);
+
+  static void process (Pipeline& pipeline, Record* record);
+
+  void complete (Pipeline& pipeline, Record* record);
+
+  void finish (Pipeline& pipeline, Record* record);
+
+  bool collect (Pipeline& pipeline, bool wait);
+
+
+  XMLRecordCallback   mProcess;
+  XMLRecordCompletion mCompletion;
+  void*               mUserData;
+  unsigned int        mNumThreads;
+
+  std::string         mContainer;
+  XMLRecordOrder_t    mOrder;
+  unsigned int        mMaxPending;
+
+  unsigned int        mNumRecords;
+  bool                mStopped;
+
+private:
+
+  XMLRecordReader (const XMLRecordReader& orig);
+  XMLRecordReader& operator= (const XMLRecordReader& rhs);
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Creates a new XMLRecordReader_t whose records are the children of the
+ * document element.
+ *
+ * @param process the function to call for each record.
+ * @param userData a pointer passed unchanged to the callbacks.
+ * @param numThreads the number of worker threads, or @c 0 for the number
+ * of hardware threads.
+ *
+ * @return pointer to the XMLRecordReader_t structure created.
+ *
+ * @memberof XMLRecordReader_t
+ */
+LIBLX_EXTERN
+XMLRecordReader_t *
+XMLRecordReader_create (  XMLRecordCallback process
+                        , void              *userData
+                        , unsigned int      numThreads );
+
+
+/**
+ * Destroys this XMLRecordReader_t structure.
+ *
+ * @param reader XMLRecordReader_t structure to be freed.
+ *
+ * @memberof XMLRecordReader_t
+ */
+LIBLX_EXTERN
+void
+XMLRecordReader_free (XMLRecordReader_t *reader);
+
+
+/**
+ * Sets the name of the element whose children are the records.
+ *
+ * @param reader the XMLRecordReader_t structure.
+ * @param name the name of the container, or @c NULL or the empty string
+ * for the document element.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLRecordReader_t
+ */
+LIBLX_EXTERN
+int
+XMLRecordReader_setContainer (XMLRecordReader_t *reader, const char *name);
+
+
+/**
+ * Sets the order in which records are completed.
+ *
+ * @param reader the XMLRecordReader_t structure.
+ * @param order the order.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLRecordReader_t
+ */
+LIBLX_EXTERN
+int
+XMLRecordReader_setOrder (XMLRecordReader_t *reader, XMLRecordOrder_t order);
+
+
+/**
+ * Sets the largest number of records read but not yet completed.
+ *
+ * @param reader the XMLRecordReader_t structure.
+ * @param count the number of records.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLRecordReader_t
+ */
+LIBLX_EXTERN
+int
+XMLRecordReader_setMaxPending (XMLRecordReader_t *reader, unsigned int count);
+
+
+/**
+ * Sets the function called for each record once it is processed.
+ *
+ * @param reader the XMLRecordReader_t structure.
+ * @param completion the function, or @c NULL for none.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLRecordReader_t
+ */
+LIBLX_EXTERN
+int
+XMLRecordReader_setCompletion (  XMLRecordReader_t   *reader
+                               , XMLRecordCompletion completion );
+
+
+/**
+ * Reads the stream to the end of the container and processes every
+ * record in it.
+ *
+ * @param reader the XMLRecordReader_t structure.
+ * @param stream the XMLInputStream_t to read.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_OPERATION_FAILED, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLRecordReader_t
+ */
+LIBLX_EXTERN
+int
+XMLRecordReader_run (XMLRecordReader_t *reader, XMLInputStream_t *stream);
+
+
+/**
+ * Returns the number of records read by the last run.
+ *
+ * @param reader the XMLRecordReader_t structure.
+ *
+ * @return the number of records read.
+ *
+ * @memberof XMLRecordReader_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLRecordReader_getNumRecords (const XMLRecordReader_t *reader);
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLRecordReader_h */
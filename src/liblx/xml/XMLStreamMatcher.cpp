@@ -0,0 +1,370 @@
+/**
+ * @file    XMLStreamMatcher.cpp
+ * @brief   Extracts the subtrees selected by XMLPath queries from a stream
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <new>
+
+#include <liblx/xml/XMLStreamMatcher.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLPath.h>
+#include <liblx/xml/operationReturnValues.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/*
+ * Creates a new XMLStreamMatcher with no paths.
+ */
+XMLStreamMatcher::XMLStreamMatcher (XMLMatchCallback callback, void* userData)
+ : mCallback   ( callback )
+ , mUserData   ( userData )
+ , mNumMatches ( 0        )
+ , mStopped    ( false    )
+{
+}
+
+
+/*
+ * Destroys this XMLStreamMatcher.
+ */
+XMLStreamMatcher::~XMLStreamMatcher ()
+{
+  for (size_t n = 0; n < mPaths.size(); ++n)
+  {
+    delete mPaths[n];
+  }
+}
+
+
+/*
+ * Adds a copy of the given path to the set evaluated by this matcher.
+ */
+int
+XMLStreamMatcher::addPath (const XMLPath& path)
+{
+  bool hasElementStep = false;
+
+  for (size_t n = 0; n < path.mSteps.size(); ++n)
+  {
+    const XMLPath::Step& step = path.mSteps[n];
+
+    if (step.self)
+    {
+      if (step.descendant || !step.predicates.empty())
+      {
+        return LIBLX_INVALID_ATTRIBUTE_VALUE;
+      }
+      continue;
+    }
+
+    hasElementStep = true;
+
+    for (size_t p = 0; p < step.predicates.size(); ++p)
+    {
+      if (step.predicates[p].kind == XMLPath::Predicate::Last)
+      {
+        return LIBLX_INVALID_ATTRIBUTE_VALUE;
+      }
+    }
+  }
+
+  if (!hasElementStep) return LIBLX_INVALID_ATTRIBUTE_VALUE;
+
+  mPaths.push_back(path.clone());
+  return LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the number of paths added to this matcher.
+ */
+unsigned int
+XMLStreamMatcher::getNumPaths () const
+{
+  return (unsigned int)mPaths.size();
+}
+
+
+/** @cond doxygenLibsbmlInternal */
+/*
+ * Activates step of the given path for the children of the element that
+ * owns frame, skipping any '.' steps.
+ */
+void
+XMLStreamMatcher::addState (Frame& frame, unsigned int path, unsigned int step)
+{
+  const vector<XMLPath::Step>& steps = mPaths[path]->mSteps;
+  while (step < steps.size() && steps[step].self) ++step;
+
+  State state;
+  state.path         = path;
+  state.step         = step;
+  state.counterBegin = (unsigned int)frame.counters.size();
+
+  frame.counters.resize(frame.counters.size() + steps[step].predicates.size(),
+                        0);
+  frame.states.push_back(state);
+}
+
+
+/*
+ * @return true if element, a child of the element that owns frame, passes
+ * the step of state.  Positional predicates count the candidates that
+ * reach them.
+ */
+bool
+XMLStreamMatcher::accepts (  Frame&          frame
+                           , const State&    state
+                           , const XMLToken& element )
+{
+  const XMLPath::Step& step = mPaths[state.path]->mSteps[state.step];
+
+  if (!XMLPath::matches(step, element)) return false;
+
+  for (size_t p = 0; p < step.predicates.size(); ++p)
+  {
+    const XMLPath::Predicate& predicate = step.predicates[p];
+
+    if (predicate.kind == XMLPath::Predicate::Position)
+    {
+      unsigned int& seen = frame.counters[state.counterBegin + p];
+      if (++seen != predicate.position) return false;
+    }
+    else if (!XMLPath::satisfies(predicate, element))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/*
+ * Consumes the element at the head of the stream and everything it
+ * contains without copying any tokens.
+ */
+void
+XMLStreamMatcher::skipElement (XMLInputStream& stream)
+{
+  const XMLToken& token = stream.peek();
+
+  if (token.isStart() && !token.isEnd())
+  {
+    /* skipPastEnd() consumes the start itself, and parses the rest of the
+       element without making tokens for it */
+    stream.skipPastEnd(token);
+  }
+  else
+  {
+    stream.skipToken();
+  }
+}
+/** @endcond */
+
+
+/*
+ * Reads the next element of the stream to its end and delivers every
+ * element selected by the paths.
+ */
+int
+XMLStreamMatcher::run (XMLInputStream& stream)
+{
+  mNumMatches = 0;
+  mStopped    = false;
+
+  if (mFrames.size() < 2) mFrames.resize(2);
+
+  Frame& document = mFrames[0];
+  document.states.clear();
+  document.counters.clear();
+
+  for (unsigned int p = 0; p < mPaths.size(); ++p)
+  {
+    if (mPaths[p]->mAbsolute) addState(document, p, 0);
+  }
+
+  unsigned int depth = 0;
+
+  while (stream.isGood() && !mStopped)
+  {
+    const XMLToken& token = stream.peek();
+
+    if (token.isStart())
+    {
+      if (mFrames.size() < depth + 2) mFrames.resize(depth + 2);
+
+      Frame& parent = mFrames[depth];
+      Frame& child  = mFrames[depth + 1];
+
+      child.states.clear();
+      child.counters.clear();
+
+      unsigned int matched = (unsigned int)mPaths.size();
+
+      for (size_t n = 0; n < parent.states.size(); ++n)
+      {
+        const State state = parent.states[n];
+        const vector<XMLPath::Step>& steps = mPaths[state.path]->mSteps;
+
+        if (steps[state.step].descendant)
+        {
+          addState(child, state.path, state.step);
+        }
+
+        if (!accepts(parent, state, token)) continue;
+
+        unsigned int next = state.step + 1;
+        while (next < steps.size() && steps[next].self) ++next;
+
+        if (next == steps.size())
+        {
+          if (state.path < matched) matched = state.path;
+        }
+        else
+        {
+          addState(child, state.path, next);
+        }
+      }
+
+      /* relative paths start at the document element */
+      if (depth == 0)
+      {
+        for (unsigned int p = 0; p < mPaths.size(); ++p)
+        {
+          if (!mPaths[p]->mAbsolute) addState(child, p, 0);
+        }
+      }
+
+      if (matched < mPaths.size())
+      {
+        XMLNode node(stream);
+        ++mNumMatches;
+
+        if (mCallback != NULL && mCallback(&node, matched, mUserData) != 0)
+        {
+          mStopped = true;
+        }
+
+        if (depth == 0) break;
+      }
+      else if (child.states.empty())
+      {
+        skipElement(stream);
+        if (depth == 0) break;
+      }
+      else
+      {
+        const bool empty = token.isEnd();
+        stream.skipToken();
+
+        if (!empty)
+        {
+          ++depth;
+        }
+        else if (depth == 0)
+        {
+          break;
+        }
+      }
+    }
+    else if (token.isEnd())
+    {
+      stream.skipToken();
+      if (depth == 0 || --depth == 0) break;
+    }
+    else
+    {
+      stream.skipToken();
+    }
+  }
+
+  return stream.isError() ? LIBLX_OPERATION_FAILED : LIBLX_OPERATION_SUCCESS;
+}
+
+
+/*
+ * @return the number of elements delivered by the last call to run().
+ */
+unsigned int
+XMLStreamMatcher::getNumMatches () const
+{
+  return mNumMatches;
+}
+
+
+/*
+ * @return true if the last call to run() was stopped by the callback.
+ */
+bool
+XMLStreamMatcher::isStopped () const
+{
+  return mStopped;
+}
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLStreamMatcher_t *
+XMLStreamMatcher_create (XMLMatchCallback callback, void *userData)
+{
+  return new(nothrow) XMLStreamMatcher(callback, userData);
+}
+
+
+LIBLX_EXTERN
+void
+XMLStreamMatcher_free (XMLStreamMatcher_t *matcher)
+{
+  if (matcher == NULL) return;
+  delete static_cast<XMLStreamMatcher*>(matcher);
+}
+
+
+LIBLX_EXTERN
+int
+XMLStreamMatcher_addPath (XMLStreamMatcher_t *matcher, const XMLPath_t *path)
+{
+  if (matcher == NULL || path == NULL) return LIBLX_INVALID_OBJECT;
+  return matcher->addPath(*path);
+}
+
+
+LIBLX_EXTERN
+int
+XMLStreamMatcher_run (XMLStreamMatcher_t *matcher, XMLInputStream_t *stream)
+{
+  if (matcher == NULL || stream == NULL) return LIBLX_INVALID_OBJECT;
+  return matcher->run(*stream);
+}
+
+
+LIBLX_EXTERN
+unsigned int
+XMLStreamMatcher_getNumMatches (const XMLStreamMatcher_t *matcher)
+{
+  if (matcher == NULL) return 0;
+  return matcher->getNumMatches();
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
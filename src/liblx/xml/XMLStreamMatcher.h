@@ -0,0 +1,305 @@
+/**
+ * @file    XMLStreamMatcher.h
+ * @brief   Extracts the subtrees selected by XMLPath queries from a stream
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLStreamMatcher
+ * @sbmlbrief{core} Delivers the elements selected by a set of paths while
+ * reading an XMLInputStream.
+ *
+ * Reading a whole document into an XMLNode tree costs memory in proportion
+ * to the size of the document.  When only the elements at a few paths are
+ * wanted, an XMLStreamMatcher can instead evaluate the paths as the tokens
+ * are read.  Each element selected by one of the paths is read into an
+ * XMLNode, together with everything it contains, and passed to a callback;
+ * everything else is consumed and dropped as soon as it is known not to
+ * lead to a match.  Memory use is then bounded by the largest matched
+ * element and the depth of the document.
+ *
+ * Paths are XMLPath objects and are interpreted as XMLPath::select() would
+ * interpret them when given the document element: absolute paths start
+ * above the document element and relative paths start at it.  The
+ * predicate <code>[last()]</code> and the step <code>.//.</code> cannot be
+ * decided before the end of the enclosing element and are not supported.
+ *
+ * An element selected by several paths is delivered once, for the first
+ * of them.  Elements inside a delivered element are not examined further;
+ * they are part of the XMLNode passed to the callback.
+ *
+@code{.cpp}
+static int
+printSpecies (const XMLNode_t* node, unsigned int path, void* data)
+{
+  std::cout << node->getAttributes().getValue("id") << std::endl;
+  return 0;
+}
+
+XMLStreamMatcher matcher(printSpecies);
+XMLPath* path = XMLPath::compile("/sbml/model/listOfSpecies/species");
+matcher.addPath(*path);
+
+XMLInputStream stream("huge.xml");
+matcher.run(stream);
+@endcode
+ */
+
+#ifndef XMLStreamMatcher_h
+#define XMLStreamMatcher_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+/**
+ * Function called by an XMLStreamMatcher for each selected element.
+ *
+ * @param node the selected element and its content.  It is destroyed when
+ * the callback returns.
+ * @param path the index of the path that selected it, in the order the
+ * paths were added.
+ * @param userData the pointer given when the matcher was created.
+ *
+ * @return @c 0 to continue reading, or any other value to stop.
+ */
+typedef int (*XMLMatchCallback) (  const XMLNode_t* node
+                                 , unsigned int     path
+                                 , void*            userData );
+
+LIBLX_CPP_NAMESPACE_END
+
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <vector>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+class XMLInputStream;
+class XMLPath;
+class XMLToken;
+
+
+class LIBLX_EXTERN XMLStreamMatcher
+{
+public:
+
+  /**
+   * Creates a new XMLStreamMatcher with no paths.
+   *
+   * @param callback the function to call for each selected element.
+   * @param userData a pointer passed unchanged to @p callback.
+   */
+  XMLStreamMatcher (XMLMatchCallback callback, void* userData = NULL);
+
+
+  /**
+   * Destroys this XMLStreamMatcher.
+   */
+  virtual ~XMLStreamMatcher ();
+
+
+  /**
+   * Adds a copy of the given path to the set evaluated by this matcher.
+   *
+   * @param path the XMLPath to add.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+   * if the path uses <code>[last()]</code> or <code>.//.</code>.
+   */
+  int addPath (const XMLPath& path);
+
+
+  /**
+   * @return the number of paths added to this matcher.
+   */
+  unsigned int getNumPaths () const;
+
+
+  /**
+   * Reads the next element of the stream, which is normally the document
+   * element, to its end and delivers every element selected by the paths.
+   *
+   * @param stream the XMLInputStream to read.
+   *
+   * @copydetails doc_returns_success_code
+   * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+   * @li @sbmlconstant{LIBLX_OPERATION_FAILED, OperationReturnValues_t}
+   * if the stream reported an error.
+   */
+  int run (XMLInputStream& stream);
+
+
+  /**
+   * @return the number of elements delivered by the last call to run().
+   */
+  unsigned int getNumMatches () const;
+
+
+  /**
+   * @return @c true if the last call to run() was stopped by the callback.
+   */
+  bool isStopped () const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+protected:
+
+  /*
+   * A path that has matched its first 'step' steps at the element owning
+   * the frame; the children of that element are tested against step
+   * 'step'.  Positional predicates count candidates in 'counters', one
+   * slot per predicate starting at 'counterBegin' in the frame.
+   */
+  struct State
+  {
+    unsigned int path;
+    unsigned int step;
+    unsigned int counterBegin;
+  };
+
+  struct Frame
+  {
+    std::vector<State>        states;
+    std::vector<unsigned int> counters;
+  };
+
+
+  void addState (Frame& frame, unsigned int path, unsigned int step);
+
+  bool accepts (Frame& frame, const State& state, const XMLToken& element);
+
+  void skipElement (XMLInputStream& stream);
+
+
+  XMLMatchCallback      mCallback;
+  void*                 mUserData;
+  std::vector<XMLPath*> mPaths;
+
+  /* mFrames[d] holds the states for the children of the element at
+   * depth d; mFrames[0] is the document itself.  Frames are reused from
+   * one element to the next. */
+  std::vector<Frame>    mFrames;
+
+  unsigned int          mNumMatches;
+  bool                  mStopped;
+
+private:
+
+  XMLStreamMatcher (const XMLStreamMatcher& orig);
+  XMLStreamMatcher& operator= (const XMLStreamMatcher& rhs);
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Creates a new XMLStreamMatcher_t with no paths.
+ *
+ * @param callback the function to call for each selected element.
+ * @param userData a pointer passed unchanged to @p callback.
+ *
+ * @return pointer to the XMLStreamMatcher_t structure created.
+ *
+ * @memberof XMLStreamMatcher_t
+ */
+LIBLX_EXTERN
+XMLStreamMatcher_t *
+XMLStreamMatcher_create (XMLMatchCallback callback, void *userData);
+
+
+/**
+ * Destroys this XMLStreamMatcher_t structure.
+ *
+ * @param matcher XMLStreamMatcher_t structure to be freed.
+ *
+ * @memberof XMLStreamMatcher_t
+ */
+LIBLX_EXTERN
+void
+XMLStreamMatcher_free (XMLStreamMatcher_t *matcher);
+
+
+/**
+ * Adds a copy of the given path to the matcher.
+ *
+ * @param matcher the XMLStreamMatcher_t structure.
+ * @param path the XMLPath_t to add.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_ATTRIBUTE_VALUE, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLStreamMatcher_t
+ */
+LIBLX_EXTERN
+int
+XMLStreamMatcher_addPath (XMLStreamMatcher_t *matcher, const XMLPath_t *path);
+
+
+/**
+ * Reads the next element of the stream and delivers every element
+ * selected by the paths of the matcher.
+ *
+ * @param matcher the XMLStreamMatcher_t structure.
+ * @param stream the XMLInputStream_t to read.
+ *
+ * @copydetails doc_returns_success_code
+ * @li @sbmlconstant{LIBLX_OPERATION_SUCCESS, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_OPERATION_FAILED, OperationReturnValues_t}
+ * @li @sbmlconstant{LIBLX_INVALID_OBJECT, OperationReturnValues_t}
+ *
+ * @memberof XMLStreamMatcher_t
+ */
+LIBLX_EXTERN
+int
+XMLStreamMatcher_run (XMLStreamMatcher_t *matcher, XMLInputStream_t *stream);
+
+
+/**
+ * Returns the number of elements delivered by the last run.
+ *
+ * @param matcher the XMLStreamMatcher_t structure.
+ *
+ * @return the number of elements delivered.
+ *
+ * @memberof XMLStreamMatcher_t
+ */
+LIBLX_EXTERN
+unsigned int
+XMLStreamMatcher_getNumMatches (const XMLStreamMatcher_t *matcher);
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLStreamMatcher_h */
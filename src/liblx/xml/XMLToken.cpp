@@ -42,6 +42,7 @@
 #include <liblx/xml/sbmlMemoryStubs.h>
 /** @endcond */
 #include <liblx/xml/XMLToken.h>
+#include <liblx/xml/XMLNamePool.h>
 
 #include <liblx/xml/operationReturnValues.h>
 
@@ -53,15 +54,45 @@ using namespace std;
 LIBLX_CPP_NAMESPACE_BEGIN
 #ifdef __cplusplus
 
+/*
+ * Shared empty blocks returned by the accessors of tokens that have no
+ * triple, attributes or namespaces of their own.
+ */
+static const XMLTriple&
+emptyTriple ()
+{
+  static const XMLTriple empty;
+  return empty;
+}
+
+
+static const XMLAttributes&
+emptyAttributes ()
+{
+  static const XMLAttributes empty;
+  return empty;
+}
+
+
+static const XMLNamespaces&
+emptyNamespaces ()
+{
+  static const XMLNamespaces empty;
+  return empty;
+}
+
+
 /*
  * Creates a new empty XMLToken.
  */
 XMLToken::XMLToken () :
-   mIsStart   ( false )
- , mIsEnd     ( false )
- , mIsText    ( false )
+   mTriple    ( NULL  )
+ , mAttributes( NULL  )
+ , mNamespaces( NULL  )
  , mLine      ( 0     )
  , mColumn    ( 0     )
+ , mKind      ( 0     )
+ , mOwnsTriple( false )
 {
 }
 
@@ -75,15 +106,15 @@ XMLToken::XMLToken (  const XMLTriple&      triple
                     , const XMLNamespaces&  namespaces
                     , const unsigned int    line
                     , const unsigned int    column ) :
-   mTriple    ( triple     )
- , mAttributes( attributes )
- , mNamespaces( namespaces )
- , mIsStart   ( true       )
- , mIsEnd     ( false      )
- , mIsText    ( false      )
+   mTriple    ( NULL       )
+ , mAttributes( attributes.isEmpty() ? NULL : new XMLAttributes(attributes) )
+ , mNamespaces( namespaces.isEmpty() ? NULL : new XMLNamespaces(namespaces) )
  , mLine      ( line       )
  , mColumn    ( column     )
+ , mKind      ( Start      )
+ , mOwnsTriple( false      )
 {
+  shareTriple(triple);
 }
 
 
@@ -94,14 +125,15 @@ XMLToken::XMLToken (  const XMLTriple&      triple
                     , const XMLAttributes&  attributes
                     , const unsigned int    line
                     , const unsigned int    column ) :
-   mTriple    ( triple     )
- , mAttributes( attributes )
- , mIsStart   ( true       )
- , mIsEnd     ( false      )
- , mIsText    ( false      )
+   mTriple    ( NULL       )
+ , mAttributes( attributes.isEmpty() ? NULL : new XMLAttributes(attributes) )
+ , mNamespaces( NULL       )
  , mLine      ( line       )
  , mColumn    ( column     )
+ , mKind      ( Start      )
+ , mOwnsTriple( false      )
 {
+  shareTriple(triple);
 }
 
 
@@ -111,14 +143,15 @@ XMLToken::XMLToken (  const XMLTriple&      triple
 XMLToken::XMLToken (  const XMLTriple&    triple
                     , const unsigned int  line
                     , const unsigned int  column ) :
-   mTriple    ( triple )
- , mIsStart   ( false  )
- , mIsEnd     ( true   )
- , mIsText    ( false  )
+   mTriple    ( NULL   )
+ , mAttributes( NULL   )
+ , mNamespaces( NULL   )
  , mLine      ( line   )
  , mColumn    ( column )
-
+ , mKind      ( End    )
+ , mOwnsTriple( false  )
 {
+  shareTriple(triple);
 }
 
 
@@ -128,12 +161,14 @@ XMLToken::XMLToken (  const XMLTriple&    triple
 XMLToken::XMLToken (  const std::string&  chars
                     , const unsigned int  line
                     , const unsigned int  column ) 
- : mChars     ( chars  )
- , mIsStart   ( false  )
- , mIsEnd     ( false  )
- , mIsText    ( true   )
+ : mTriple    ( NULL   )
+ , mAttributes( NULL   )
+ , mNamespaces( NULL   )
+ , mChars     ( chars  )
  , mLine      ( line   )
  , mColumn    ( column )
+ , mKind      ( Text   )
+ , mOwnsTriple( false  )
 {
 }
 
@@ -143,6 +178,9 @@ XMLToken::XMLToken (  const std::string&  chars
  */
 XMLToken::~XMLToken ()
 {
+  releaseTriple();
+  delete mAttributes;
+  delete mNamespaces;
 }
 
 
@@ -150,25 +188,23 @@ XMLToken::~XMLToken ()
  * Copy constructor; creates a copy of this XMLToken.
  */
 XMLToken::XMLToken(const XMLToken& orig)
- : mTriple()
- , mAttributes()
- , mNamespaces()
- , mChars (orig.mChars)
- , mIsStart (orig.mIsStart)
- , mIsEnd (orig.mIsEnd)
- , mIsText (orig.mIsText)
- , mLine (orig.mLine)
- , mColumn (orig.mColumn)
-{
-  if (!orig.mTriple.isEmpty())
-    mTriple = XMLTriple(orig.getName(), orig.getURI(), orig.getPrefix());
+ : mTriple    ( orig.mTriple )
+ , mAttributes( NULL )
+ , mNamespaces( NULL )
+ , mChars     ( orig.mChars )
+ , mLine      ( orig.mLine )
+ , mColumn    ( orig.mColumn )
+ , mKind      ( orig.mKind )
+ , mOwnsTriple( orig.mOwnsTriple )
+{
+  if (mOwnsTriple)
+    mTriple = new XMLTriple(*orig.mTriple);
+
+  if (orig.mAttributes != NULL && !orig.mAttributes->isEmpty())
+    mAttributes = new XMLAttributes(*orig.mAttributes);
   
-  if (!orig.mAttributes.isEmpty())
-    mAttributes = XMLAttributes(orig.getAttributes());
-  
-  if (!orig.mNamespaces.isEmpty())
-    mNamespaces = XMLNamespaces(orig.getNamespaces());
-
+  if (orig.mNamespaces != NULL && !orig.mNamespaces->isEmpty())
+    mNamespaces = new XMLNamespaces(*orig.mNamespaces);
 }
 
 
@@ -180,26 +216,41 @@ XMLToken::operator=(const XMLToken& rhs)
 {
   if(&rhs!=this)
   {
-    if (rhs.mTriple.isEmpty())
-      mTriple = XMLTriple();
+    changed();
+
+    if (rhs.mOwnsTriple)
+    {
+      shareTriple(*rhs.mTriple);
+    }
     else
-      mTriple = XMLTriple(rhs.getName(), rhs.getURI(), rhs.getPrefix());
-    
-    if (rhs.mAttributes.isEmpty())
-      mAttributes = XMLAttributes();
+    {
+      releaseTriple();
+      mTriple = rhs.mTriple;
+    }
+
+    if (rhs.mAttributes == NULL || rhs.mAttributes->isEmpty())
+    {
+      delete mAttributes;
+      mAttributes = NULL;
+    }
+    else if (mAttributes == NULL)
+      mAttributes = new XMLAttributes(*rhs.mAttributes);
     else
-      mAttributes = XMLAttributes(rhs.getAttributes());
+      *mAttributes = *rhs.mAttributes;
     
-    if (rhs.mNamespaces.isEmpty())
-      mNamespaces = XMLNamespaces();
+    if (rhs.mNamespaces == NULL || rhs.mNamespaces->isEmpty())
+    {
+      delete mNamespaces;
+      mNamespaces = NULL;
+    }
+    else if (mNamespaces == NULL)
+      mNamespaces = new XMLNamespaces(*rhs.mNamespaces);
     else
-      mNamespaces = XMLNamespaces(rhs.getNamespaces());
+      *mNamespaces = *rhs.mNamespaces;
 
     mChars = rhs.mChars;
 
-    mIsStart = rhs.mIsStart;
-    mIsEnd = rhs.mIsEnd;
-    mIsText = rhs.mIsText;
+    mKind = rhs.mKind;
 
     mLine = rhs.mLine;
     mColumn = rhs.mColumn;
@@ -220,6 +271,88 @@ XMLToken::clone () const
 }
 
 
+/** @cond doxygenLibsbmlInternal */
+/*
+ * @return the XMLTriple of this token; an empty XMLTriple if none is set.
+ */
+const XMLTriple&
+XMLToken::getTriple () const
+{
+  return (mTriple != NULL) ? *mTriple : emptyTriple();
+}
+
+
+/*
+ * Points this token at the pooled copy of triple, or at a copy of its own
+ * if the XMLNamePool is full.
+ */
+void
+XMLToken::shareTriple (const XMLTriple& triple)
+{
+  const XMLTriple* shared = XMLNamePool::intern(triple);
+
+  if (shared == NULL && !triple.isEmpty())
+  {
+    XMLTriple* copy = new XMLTriple(triple);
+    releaseTriple();
+    mTriple     = copy;
+    mOwnsTriple = true;
+    return;
+  }
+
+  releaseTriple();
+  mTriple = shared;
+}
+
+
+/*
+ * Frees the XMLTriple of this token if it is not pooled.
+ */
+void
+XMLToken::releaseTriple ()
+{
+  if (mOwnsTriple) delete mTriple;
+
+  mTriple     = NULL;
+  mOwnsTriple = false;
+}
+
+
+/*
+ * @return the attribute block of this token, allocating it on first use.
+ */
+XMLAttributes&
+XMLToken::attributes ()
+{
+  changed();
+  if (mAttributes == NULL) mAttributes = new XMLAttributes();
+  return *mAttributes;
+}
+
+
+/*
+ * @return the namespace block of this token, allocating it on first use.
+ */
+XMLNamespaces&
+XMLToken::namespaces ()
+{
+  changed();
+  if (mNamespaces == NULL) mNamespaces = new XMLNamespaces();
+  return *mNamespaces;
+}
+
+
+/*
+ * Called whenever the content of this token is about to change; a token
+ * derives nothing from its content, so there is nothing to drop.
+ */
+void
+XMLToken::changed ()
+{
+}
+/** @endcond */
+
+
 /*
  * Appends characters to this XML text content.
  */
@@ -232,6 +365,7 @@ XMLToken::append (const std::string& chars)
   }
   else
   {
+    changed();
     mChars.append(chars);
     return LIBLX_OPERATION_SUCCESS;
   }
@@ -258,6 +392,7 @@ XMLToken::setCharacters(const std::string& chars)
   }
   else
   {
+    changed();
     mChars = chars;
     return LIBLX_OPERATION_SUCCESS;
   }
@@ -289,7 +424,7 @@ XMLToken::getLine () const
 const XMLAttributes&
 XMLToken::getAttributes () const
 {
-  return mAttributes;
+  return (mAttributes != NULL) ? *mAttributes : emptyAttributes();
 }
 
 
@@ -308,11 +443,14 @@ XMLToken::setAttributes(const XMLAttributes& attributes)
   /* the code will crash if the attributes points to NULL
    * put in a try catch statement to check
    */
-  if (mIsStart)
+  if (isStart())
   {
     try
     {
-      mAttributes = attributes;
+      if (mAttributes != NULL || !attributes.isEmpty())
+      {
+        this->attributes() = attributes;
+      }
       return LIBLX_OPERATION_SUCCESS;
     }
     catch (...)
@@ -358,9 +496,9 @@ XMLToken::addAttr (  const std::string& name
                    , const std::string namespaceURI
                    , const std::string prefix      )
 {
-  if (mIsStart) 
+  if (isStart()) 
   {
-    return mAttributes.add(name, value, namespaceURI, prefix);
+    return attributes().add(name, value, namespaceURI, prefix);
   }
   else
   {
@@ -383,9 +521,9 @@ XMLToken::addAttr (  const std::string& name
 int 
 XMLToken::addAttr ( const XMLTriple& triple, const std::string& value)
 {
-  if (mIsStart) 
+  if (isStart()) 
   {
-    return mAttributes.add(triple, value);
+    return attributes().add(triple, value);
   }
   else
   {
@@ -404,9 +542,9 @@ XMLToken::addAttr ( const XMLTriple& triple, const std::string& value)
 int 
 XMLToken::removeAttr (int n)
 {
-  if (mIsStart) 
+  if (isStart()) 
   {
-    return mAttributes.remove(n);
+    return attributes().remove(n);
   }
   else
   {
@@ -426,9 +564,9 @@ XMLToken::removeAttr (int n)
 int 
 XMLToken::removeAttr (const std::string& name, const std::string uri)
 {
-  if (mIsStart) 
+  if (isStart()) 
   {
-    return mAttributes.remove(name, uri);
+    return attributes().remove(name, uri);
   }
   else
   {
@@ -447,9 +585,9 @@ XMLToken::removeAttr (const std::string& name, const std::string uri)
 int 
 XMLToken::removeAttr (const XMLTriple& triple)
 {
-  if (mIsStart) 
+  if (isStart()) 
   {
-    return mAttributes.remove(triple);
+    return attributes().remove(triple);
   }
   else
   {
@@ -465,9 +603,9 @@ XMLToken::removeAttr (const XMLTriple& triple)
 int 
 XMLToken::clearAttributes()
 {
-  if (mIsStart) 
+  if (isStart()) 
   {
-    return mAttributes.clear();
+    return attributes().clear();
   }
   else
   {
@@ -500,7 +638,7 @@ XMLToken::clearAttributes()
 int 
 XMLToken::getAttrIndex (const std::string& name, const std::string uri) const
 {
-  return mAttributes.getIndex(name, uri);
+  return getAttributes().getIndex(name, uri);
 }
 
 
@@ -515,7 +653,7 @@ XMLToken::getAttrIndex (const std::string& name, const std::string uri) const
 int 
 XMLToken::getAttrIndex (const XMLTriple& triple) const
 {
-  return mAttributes.getIndex(triple);
+  return getAttributes().getIndex(triple);
 }
 
 
@@ -527,7 +665,7 @@ XMLToken::getAttrIndex (const XMLTriple& triple) const
 int 
 XMLToken::getAttributesLength () const
 {
-  return mAttributes.getLength();
+  return getAttributes().getLength();
 }
 
 
@@ -547,7 +685,7 @@ XMLToken::getAttributesLength () const
 std::string 
 XMLToken::getAttrName (int index) const
 {
-  return mAttributes.getName(index);
+  return getAttributes().getName(index);
 }
 
 
@@ -567,7 +705,7 @@ XMLToken::getAttrName (int index) const
 std::string 
 XMLToken::getAttrPrefix (int index) const
 {
-  return mAttributes.getPrefix(index);
+  return getAttributes().getPrefix(index);
 }
 
 
@@ -587,7 +725,7 @@ XMLToken::getAttrPrefix (int index) const
 std::string 
 XMLToken::getAttrPrefixedName (int index) const
 {
-  return mAttributes.getPrefixedName(index);
+  return getAttributes().getPrefixedName(index);
 }
 
 
@@ -606,7 +744,7 @@ XMLToken::getAttrPrefixedName (int index) const
 std::string 
 XMLToken::getAttrURI (int index) const
 {
-  return mAttributes.getURI(index);
+  return getAttributes().getURI(index);
 }
 
 
@@ -626,7 +764,7 @@ XMLToken::getAttrURI (int index) const
 std::string 
 XMLToken::getAttrValue (int index) const
 {
-  return mAttributes.getValue(index);
+  return getAttributes().getValue(index);
 }
 
 
@@ -658,7 +796,7 @@ XMLToken::getAttrValue (int index) const
 std::string 
 XMLToken::getAttrValue (const std::string& name, const std::string uri) const
 {
-  return mAttributes.getValue(name, uri);
+  return getAttributes().getValue(name, uri);
 }
 
 
@@ -677,7 +815,7 @@ XMLToken::getAttrValue (const std::string& name, const std::string uri) const
 std::string 
 XMLToken::getAttrValue (const XMLTriple& triple) const
 {
-  return mAttributes.getValue(triple);
+  return getAttributes().getValue(triple);
 }
 
 
@@ -694,7 +832,7 @@ XMLToken::getAttrValue (const XMLTriple& triple) const
 bool 
 XMLToken::hasAttr (int index) const
 {
-  return mAttributes.hasAttribute(index);
+  return getAttributes().hasAttribute(index);
 }
 
 
@@ -714,7 +852,7 @@ XMLToken::hasAttr (int index) const
 bool 
 XMLToken::hasAttr (const std::string& name, const std::string uri) const
 {
-  return mAttributes.hasAttribute(name, uri);
+  return getAttributes().hasAttribute(name, uri);
 }
 
 
@@ -732,7 +870,7 @@ XMLToken::hasAttr (const std::string& name, const std::string uri) const
 bool 
 XMLToken::hasAttr (const XMLTriple& triple) const
 {
-  return mAttributes.hasAttribute(triple);
+  return getAttributes().hasAttribute(triple);
 }
 
 
@@ -746,7 +884,7 @@ XMLToken::hasAttr (const XMLTriple& triple) const
 bool 
 XMLToken::isAttributesEmpty () const
 {
-  return mAttributes.isEmpty();
+  return getAttributes().isEmpty();
 }
 
 
@@ -758,7 +896,7 @@ XMLToken::isAttributesEmpty () const
 const XMLNamespaces&
 XMLToken::getNamespaces () const
 {
-  return mNamespaces;
+  return (mNamespaces != NULL) ? *mNamespaces : emptyNamespaces();
 }
 
 
@@ -775,11 +913,14 @@ XMLToken::setNamespaces(const XMLNamespaces& namespaces)
   /* the code will crash if the namespaces points to NULL
    * put in a try catch statement to check
    */
-  if (mIsStart)
+  if (isStart())
   {
     try
     {
-      mNamespaces = namespaces;
+      if (mNamespaces != NULL || !namespaces.isEmpty())
+      {
+        this->namespaces() = namespaces;
+      }
       return LIBLX_OPERATION_SUCCESS;
     }
     catch (...)
@@ -805,9 +946,9 @@ int
 XMLToken::addNamespace (const std::string& uri, const std::string prefix)
 {
 
-   if (mIsStart)  
+   if (isStart())  
    {
-     mNamespaces.add(uri, prefix);
+     namespaces().add(uri, prefix);
      return LIBLX_OPERATION_SUCCESS;
    }
   else
@@ -827,9 +968,9 @@ XMLToken::addNamespace (const std::string& uri, const std::string prefix)
 int 
 XMLToken::removeNamespace (int index)
 {
-   if (mIsStart) 
+   if (isStart()) 
    {
-     return mNamespaces.remove(index);
+     return namespaces().remove(index);
    }
   else
   {
@@ -847,9 +988,9 @@ XMLToken::removeNamespace (int index)
 int 
 XMLToken::removeNamespace (const std::string& prefix)
 {
-  if (mIsStart)  
+  if (isStart())  
   {
-    return mNamespaces.remove(prefix);
+    return namespaces().remove(prefix);
   }
   else
   {
@@ -866,9 +1007,9 @@ XMLToken::removeNamespace (const std::string& prefix)
 int 
 XMLToken::clearNamespaces ()
 {
-   if (mIsStart) 
+   if (isStart()) 
    {
-     return mNamespaces.clear();
+     return namespaces().clear();
   }
   else
   {
@@ -887,7 +1028,7 @@ XMLToken::clearNamespaces ()
 int 
 XMLToken::getNamespaceIndex (const std::string& uri) const
 {
-  return mNamespaces.getIndex(uri);
+  return getNamespaces().getIndex(uri);
 }
 
 
@@ -901,7 +1042,7 @@ XMLToken::getNamespaceIndex (const std::string& uri) const
 int 
 XMLToken::getNamespaceIndexByPrefix (const std::string& prefix) const
 {
-  return mNamespaces.getIndexByPrefix(prefix);
+  return getNamespaces().getIndexByPrefix(prefix);
 }
 
 
@@ -914,7 +1055,7 @@ XMLToken::getNamespaceIndexByPrefix (const std::string& prefix) const
 int 
 XMLToken::getNamespacesLength () const
 {
-  return mNamespaces.getLength();
+  return getNamespaces().getLength();
 }
 
 
@@ -930,7 +1071,7 @@ XMLToken::getNamespacesLength () const
 std::string 
 XMLToken::getNamespacePrefix (int index) const
 {
-  return mNamespaces.getPrefix(index);
+  return getNamespaces().getPrefix(index);
 }
 
 
@@ -942,7 +1083,7 @@ XMLToken::getNamespacePrefix (int index) const
 std::string 
 XMLToken::getNamespacePrefix (const std::string& uri) const
 {
-  return mNamespaces.getPrefix(uri);
+  return getNamespaces().getPrefix(uri);
 }
 
 
@@ -955,7 +1096,7 @@ XMLToken::getNamespacePrefix (const std::string& uri) const
 std::string 
 XMLToken::getNamespaceURI (int index) const
 {
-  return mNamespaces.getURI(index);
+  return getNamespaces().getURI(index);
 }
 
 
@@ -967,7 +1108,7 @@ XMLToken::getNamespaceURI (int index) const
 std::string 
 XMLToken::getNamespaceURI (const std::string prefix) const
 {
-  return mNamespaces.getURI(prefix);
+  return getNamespaces().getURI(prefix);
 }
 
 
@@ -981,7 +1122,7 @@ XMLToken::getNamespaceURI (const std::string prefix) const
 bool 
 XMLToken::isNamespacesEmpty () const
 {
-  return mNamespaces.isEmpty();
+  return getNamespaces().isEmpty();
 }
 
 
@@ -996,7 +1137,7 @@ XMLToken::isNamespacesEmpty () const
 bool 
 XMLToken::hasNamespaceURI(const std::string& uri) const
 {
-  return mNamespaces.hasURI(uri);
+  return getNamespaces().hasURI(uri);
 }
 
 
@@ -1013,7 +1154,7 @@ XMLToken::hasNamespaceURI(const std::string& uri) const
 bool 
 XMLToken::hasNamespacePrefix(const std::string& prefix) const
 {
-  return mNamespaces.hasPrefix(prefix);
+  return getNamespaces().hasPrefix(prefix);
 }
 
 
@@ -1031,7 +1172,7 @@ XMLToken::hasNamespacePrefix(const std::string& prefix) const
 bool 
 XMLToken::hasNamespaceNS(const std::string& uri, const std::string& prefix) const
 {
-  return mNamespaces.hasNS(uri,prefix);
+  return getNamespaces().hasNS(uri,prefix);
 }
 
 
@@ -1046,11 +1187,12 @@ XMLToken::setTriple(const XMLTriple& triple)
   /* the code will crash if the triple points to NULL
    * put in a try catch statement to check
    */
-  if (! mIsText ) 
+  if (! isText() ) 
   {
     try
     {
-      mTriple = triple;
+      changed();
+      shareTriple(triple);
       return LIBLX_OPERATION_SUCCESS;
     }
     catch (...)
@@ -1072,7 +1214,7 @@ XMLToken::setTriple(const XMLTriple& triple)
 const string&
 XMLToken::getName () const
 {
-  return mTriple.getName();
+  return getTriple().getName();
 }
 
 
@@ -1083,7 +1225,7 @@ XMLToken::getName () const
 const string&
 XMLToken::getPrefix () const
 {
-  return mTriple.getPrefix();
+  return getTriple().getPrefix();
 }
 
 
@@ -1093,7 +1235,7 @@ XMLToken::getPrefix () const
 const string&
 XMLToken::getURI () const
 {
-  return mTriple.getURI();
+  return getTriple().getURI();
 }
 
 
@@ -1104,7 +1246,7 @@ XMLToken::getURI () const
 bool
 XMLToken::isElement () const
 {
-  return mIsStart || mIsEnd;
+  return (mKind & (Start | End)) != 0;
 }
 
  
@@ -1115,7 +1257,7 @@ XMLToken::isElement () const
 bool
 XMLToken::isEnd () const
 {
-  return mIsEnd;
+  return (mKind & End) != 0;
 }
 
 
@@ -1142,7 +1284,7 @@ XMLToken::isEndFor (const XMLToken& element) const
 bool
 XMLToken::isEOF () const
 {
-  return (mIsStart == false && mIsEnd == false && mIsText == false);
+  return (mKind == 0);
 }
 
 
@@ -1153,7 +1295,7 @@ XMLToken::isEOF () const
 bool
 XMLToken::isStart () const
 {
-  return mIsStart;
+  return (mKind & Start) != 0;
 }
 
 
@@ -1163,7 +1305,7 @@ XMLToken::isStart () const
 bool
 XMLToken::isText () const
 {
-  return mIsText;
+  return (mKind & Text) != 0;
 }
 
 
@@ -1173,7 +1315,8 @@ XMLToken::isText () const
 int
 XMLToken::setEnd ()
 {
-  mIsEnd = true;
+  changed();
+  mKind |= End;
   if (isEnd())
     return LIBLX_OPERATION_SUCCESS;
   else
@@ -1187,7 +1330,8 @@ XMLToken::setEnd ()
 int
 XMLToken::unsetEnd ()
 {
-  mIsEnd = false;
+  changed();
+  mKind &= ~End;
   if (!isEnd())
     return LIBLX_OPERATION_SUCCESS;
   else
@@ -1201,9 +1345,8 @@ XMLToken::unsetEnd ()
 int
 XMLToken::setEOF ()
 {
-  mIsStart = false;
-  mIsEnd   = false;
-  mIsText  = false;
+  changed();
+  mKind = 0;
 
   if (isEOF())
     return LIBLX_OPERATION_SUCCESS;
@@ -1227,9 +1370,9 @@ XMLToken::write (XMLOutputStream& stream) const
     return;
   }
 
-  if ( isStart() ) stream.startElement( mTriple );
-  if ( isStart() ) stream << mNamespaces << mAttributes;
-  if ( isEnd()   ) stream.endElement( mTriple );
+  if ( isStart() ) stream.startElement( getTriple() );
+  if ( isStart() ) stream << getNamespaces() << getAttributes();
+  if ( isEnd()   ) stream.endElement( getTriple() );
 }
 /** @endcond */
 
@@ -1276,6 +1419,56 @@ operator<< (XMLOutputStream& stream, const XMLToken& token)
 /** @endcond */
 
 
+/*
+ * @return the bytes of memory this XMLToken holds.
+ */
+size_t
+XMLToken::getMemoryUsage () const
+{
+  XMLMemoryUsage usage;
+  return getMemoryUsage(usage);
+}
+
+
+/*
+ * Adds the memory this XMLToken holds to usage.
+ */
+size_t
+XMLToken::getMemoryUsage (XMLMemoryUsage& usage) const
+{
+  usage.mStructure += sizeof(XMLToken);
+  return sizeof(XMLToken) + getContentUsage(usage);
+}
+
+
+/*
+ * Adds the characters, attributes and namespaces of this token to usage.
+ * The XMLTriple of its name is shared through the XMLNamePool and is not
+ * counted, unless the pool was full and the token holds its own copy.
+ */
+size_t
+XMLToken::getContentUsage (XMLMemoryUsage& usage) const
+{
+  size_t bytes = XMLMemoryUsage::getStringBytes(mChars);
+  usage.mText += bytes;
+
+  if (mOwnsTriple)
+  {
+    const size_t name = sizeof(XMLTriple)
+                      + XMLMemoryUsage::getStringBytes(mTriple->getName())
+                      + XMLMemoryUsage::getStringBytes(mTriple->getURI())
+                      + XMLMemoryUsage::getStringBytes(mTriple->getPrefix());
+    usage.mStructure += name;
+    bytes            += name;
+  }
+
+  if (mAttributes != NULL) bytes += mAttributes->getMemoryUsage(usage);
+  if (mNamespaces != NULL) bytes += mNamespaces->getMemoryUsage(usage);
+
+  return bytes;
+}
+
+
 #endif /* __cplusplus */
 /** @cond doxygenIgnored */
 LIBLX_EXTERN
@@ -1931,6 +2124,15 @@ XMLToken_unsetEnd (XMLToken_t *token)
   if (token == NULL) return LIBLX_INVALID_OBJECT;
   return token->unsetEnd();
 }
+
+
+LIBLX_EXTERN
+unsigned long
+XMLToken_getMemoryUsage (const XMLToken_t *token)
+{
+  if (token == NULL) return 0;
+  return (unsigned long) token->getMemoryUsage();
+}
 /** @endcond */
 
 LIBLX_CPP_NAMESPACE_END
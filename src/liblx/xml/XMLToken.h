@@ -1127,6 +1127,28 @@ public:
   int unsetEnd ();
 
 
+  /**
+   * Returns the bytes of memory this XMLToken holds, counting the object
+   * itself, its characters, attributes and namespaces, and the spare capacity of each.
+   *
+   * @return the bytes held by this XMLToken.
+   *
+   * @see XMLMemoryUsage
+   */
+  size_t getMemoryUsage () const;
+
+
+  /**
+   * Adds the memory this XMLToken holds to @p usage, split by kind, and
+   * returns it.
+   *
+   * @param usage the XMLMemoryUsage to add to.
+   *
+   * @return the bytes held by this XMLToken.
+   */
+  virtual size_t getMemoryUsage (XMLMemoryUsage& usage) const;
+
+
   /** @cond doxygenLibsbmlInternal */
   /**
    * Writes this XMLToken to stream.
@@ -1171,19 +1193,73 @@ public:
 
 protected:
   /** @cond doxygenLibsbmlInternal */
-  XMLTriple     mTriple;
-  XMLAttributes mAttributes;
-  XMLNamespaces mNamespaces;
 
-  std::string mChars;
+  friend class XMLDocumentStore;
+  friend class XMLParallelParser;
+
+  /*
+   * Bits stored in mKind.  A token collapsed from a start and an end
+   * element (e.g. <tt>&lt;foo/&gt;</tt>) carries both Start and End; a
+   * token with no bits set is EOF.
+   */
+  enum TokenKind { Start = 0x1, End = 0x2, Text = 0x4 };
+
+  /*
+   * @return the XMLTriple of this token; an empty XMLTriple if none is set.
+   */
+  const XMLTriple& getTriple () const;
+
+  /*
+   * Points this token at the pooled copy of triple, or at a copy of its
+   * own if the XMLNamePool is full.
+   */
+  void shareTriple (const XMLTriple& triple);
+
+  /*
+   * Frees the XMLTriple of this token if it is not pooled.
+   */
+  void releaseTriple ();
 
-  bool mIsStart;
-  bool mIsEnd;
-  bool mIsText;
+  /*
+   * @return the attribute block of this token, allocating it on first use.
+   */
+  XMLAttributes& attributes ();
+
+  /*
+   * @return the namespace block of this token, allocating it on first use.
+   */
+  XMLNamespaces& namespaces ();
+
+  /*
+   * Called whenever the content of this token is about to change, so that
+   * subclasses can drop anything they have derived from it.
+   */
+  virtual void changed ();
+
+  /*
+   * Adds what this token holds outside itself to usage, and returns it.
+   */
+  size_t getContentUsage (XMLMemoryUsage& usage) const;
+
+  /*
+   * The element name is interned in the XMLNamePool, so tokens with the
+   * same name share one XMLTriple; mOwnsTriple is set for a name the full
+   * pool did not take, which the token then holds a copy of.  Attributes
+   * and namespaces live out-of-line and are only allocated once the token
+   * has some; NULL means empty.
+   */
+  const XMLTriple* mTriple;
+  XMLAttributes*   mAttributes;
+  XMLNamespaces*   mNamespaces;
+
+  std::string mChars;
 
   unsigned int mLine;
   unsigned int mColumn;
 
+  unsigned char mKind;
+  bool          mOwnsTriple;
+
   /** @endcond */
 };
 
@@ -2411,6 +2487,21 @@ int
 XMLToken_unsetEnd (XMLToken_t *token);
 
 
+/**
+ * Returns the bytes of memory held by the given XMLToken_t structure,
+ * counting the structure itself, its characters, attributes and namespaces, and the spare capacity of each.
+ *
+ * @param token the XMLToken_t structure.
+ *
+ * @return the bytes held, or @c 0 if @p token is @c NULL.
+ *
+ * @memberof XMLToken_t
+ */
+LIBLX_EXTERN
+unsigned long
+XMLToken_getMemoryUsage (const XMLToken_t *token);
+
+
 END_C_DECLS
 LIBLX_CPP_NAMESPACE_END
 
@@ -38,20 +38,52 @@
 
 #include <sstream>
 
+#include <liblx/xml/XMLParseStats.h>
 #include <liblx/xml/XMLToken.h>
 #include <liblx/xml/XMLTokenizer.h>
+#include <liblx/xml/XMLTrace.h>
 
 using namespace std;
 
 LIBLX_CPP_NAMESPACE_BEGIN
 
+/*
+ * Adds the time from its construction to its destruction to the
+ * tokenizer time of stats, if there are stats to add it to.
+ */
+class TokenizerTimer
+{
+public:
+
+  TokenizerTimer (XMLParseStats* stats) :
+     mStats ( stats )
+   , mStart ( (stats != NULL) ? XMLParseStats::now() : 0 )
+  {
+  }
+
+  ~TokenizerTimer ()
+  {
+    if (mStats != NULL) mStats->mTokenizerTime += XMLParseStats::now() - mStart;
+  }
+
+private:
+
+  XMLParseStats* mStats;
+  double         mStart;
+};
+
+
 /*
  * Creates a new XMLTokenizer.
  */
 XMLTokenizer::XMLTokenizer () :
-   mInChars( false )
- , mInStart( false )
- , mEOFSeen( false )
+   mInChars     ( false )
+ , mInStart     ( false )
+ , mEOFSeen     ( false )
+ , mNumCoalesced( 0     )
+ , mStats       ( NULL  )
+ , mIgnoreWhitespace    ( false )
+ , mNumWhitespaceDropped( 0     )
 {
 }
 
@@ -67,6 +99,11 @@ XMLTokenizer::XMLTokenizer (const XMLTokenizer& other)
   , mVersion(other.mVersion)
   , mCurrent(other.mCurrent)
   , mTokens(other.mTokens)
+  , mNumCoalesced(other.mNumCoalesced)
+  , mStats(NULL)
+  , mIgnoreWhitespace(other.mIgnoreWhitespace)
+  , mSpace(other.mSpace)
+  , mNumWhitespaceDropped(other.mNumWhitespaceDropped)
 {
 }
 
@@ -140,6 +177,16 @@ XMLTokenizer::next ()
 }
 
 
+/*
+ * Consume the next XMLToken without copying it.
+ */
+void
+XMLTokenizer::discard ()
+{
+  mTokens.pop_front();
+}
+
+
 /*
  * Returns the next XMLToken without consuming it.  A subsequent call to
  * either peek() or next() will return the same token.
@@ -189,11 +236,15 @@ XMLTokenizer::XML (const string& version, const string& encoding)
 void
 XMLTokenizer::startElement (const XMLToken& element)
 {
+  TokenizerTimer timer(mStats);
+
+  dropWhitespace();
 
   if (mInChars || mInStart)
   {
     mInChars = false;
     mTokens.push_back( mCurrent );
+    LIBLX_TRACE2(tokenizer__queue, this, mTokens.size());
   }
 
   //
@@ -212,6 +263,7 @@ XMLTokenizer::startElement (const XMLToken& element)
 void
 XMLTokenizer::endDocument ()
 {
+  dropWhitespace();
   mEOFSeen = true;
 }
 
@@ -222,10 +274,15 @@ XMLTokenizer::endDocument ()
 void
 XMLTokenizer::endElement (const XMLToken& element)
 {
+  TokenizerTimer timer(mStats);
+
+  dropWhitespace();
+
   if (mInChars)
   {
     mInChars = false;
     mTokens.push_back( mCurrent );
+    LIBLX_TRACE2(tokenizer__queue, this, mTokens.size());
   }
 
   if (mInStart)
@@ -233,10 +290,12 @@ XMLTokenizer::endElement (const XMLToken& element)
     mInStart = false;
     mCurrent.setEnd();
     mTokens.push_back( mCurrent );
+    LIBLX_TRACE2(tokenizer__queue, this, mTokens.size());
   }
   else
   {
     mTokens.push_back(element);
+    LIBLX_TRACE2(tokenizer__queue, this, mTokens.size());
   }
 }
 
@@ -247,24 +306,111 @@ XMLTokenizer::endElement (const XMLToken& element)
 void
 XMLTokenizer::characters (const XMLToken& data)
 {
+  const string& chars = data.getCharacters();
+  characters(chars.data(), chars.size());
+}
+
+
+/*
+ * @return true if the length characters at chars are all XML whitespace.
+ */
+static bool
+isWhitespace (const char* chars, size_t length)
+{
+  for (size_t n = 0; n < length; ++n)
+  {
+    const char c = chars[n];
+    if (c != ' ' && c != '\t' && c != '\n' && c != '\r') return false;
+  }
+
+  return true;
+}
+
+
+/*
+ * Receive notification of character data inside an element, as the bytes
+ * the XML library delivered.
+ *
+ * When whitespace is ignored, whitespace that does not follow text is held
+ * back in mSpace rather than made into a token.  If text follows it before
+ * the next element starts or ends, it is put back in front of that text;
+ * otherwise it is dropped.  XML libraries split character data at line
+ * ends and buffer boundaries, so a single piece of whitespace says nothing
+ * about the text around it.
+ */
+void
+XMLTokenizer::characters (const char* chars, size_t length)
+{
+  TokenizerTimer timer(mStats);
+
+  if (mIgnoreWhitespace && !mInChars && isWhitespace(chars, length))
+  {
+    mSpace.append(chars, length);
+    return;
+  }
 
   if (mInStart)
   {
     mInStart = false;
     mTokens.push_back( mCurrent );
+    LIBLX_TRACE2(tokenizer__queue, this, mTokens.size());
   }
 
   if (mInChars)
   {
-    mCurrent.append( data.getCharacters() );
+    mCurrent.append( string(chars, length) );
+    ++mNumCoalesced;
   }
   else
   {
     mInChars = true;
-    mCurrent = data;
+
+    if (mSpace.empty())
+    {
+      mCurrent = XMLToken( string(chars, length) );
+    }
+    else
+    {
+      mSpace.append(chars, length);
+      mCurrent = XMLToken(mSpace);
+      mSpace.clear();
+    }
   }
 }
 
+
+/*
+ * Sets whether whitespace-only character data is dropped.
+ */
+void
+XMLTokenizer::setIgnoreWhitespace (bool ignore)
+{
+  mIgnoreWhitespace = ignore;
+}
+
+
+/*
+ * @return true if whitespace-only character data is dropped.
+ */
+bool
+XMLTokenizer::getIgnoreWhitespace () const
+{
+  return mIgnoreWhitespace;
+}
+
+
+/*
+ * Drops the whitespace held back by characters(), if there is any.
+ */
+void
+XMLTokenizer::dropWhitespace ()
+{
+  if (mSpace.empty()) return;
+
+  mSpace.clear();
+  ++mNumWhitespaceDropped;
+}
+
 unsigned int
 XMLTokenizer::determineNumberChildren(bool & valid, const std::string element)
 {
@@ -55,6 +55,7 @@
 LIBLX_CPP_NAMESPACE_BEGIN
 
 class LIBLX_EXTERN XMLToken;
+class XMLParseStats;
 
 class LIBLX_EXTERN XMLTokenizer : public XMLHandler
 {
@@ -125,6 +126,12 @@ public:
   XMLToken next ();
 
 
+  /**
+   * Consume the next XMLToken without copying it.
+   */
+  void discard ();
+
+
   /**
    * Returns the next XMLToken without consuming it.  A subsequent call to
    * either peek() or next() will return the same token.
@@ -141,6 +148,23 @@ public:
   std::string toString ();
 
 
+  /**
+   * Sets whether character data made only of whitespace (spaces, tabs,
+   * carriage returns and line feeds) between elements is to be dropped
+   * rather than turned into a text token.  Whitespace next to other
+   * characters, as in mixed content, is kept.
+   *
+   * @param ignore @c true to drop whitespace-only character data.
+   */
+  void setIgnoreWhitespace (bool ignore);
+
+
+  /**
+   * @return @c true if whitespace-only character data is being dropped.
+   */
+  bool getIgnoreWhitespace () const;
+
+
   /**
    * Receive notification of the XML declaration, i.e.
    * <?xml version="1.0" encoding="UTF-8"?>
@@ -172,6 +196,13 @@ public:
   virtual void characters (const XMLToken& data);
 
 
+  /**
+   * Receive notification of character data inside an element, as the
+   * bytes the XML library delivered.
+   */
+  virtual void characters (const char* chars, size_t length);
+
+
 protected:
 
   unsigned int determineNumberChildren(bool & valid, 
@@ -183,6 +214,11 @@ protected:
   bool containsChild(bool & valid, 
                const std::string& qualifier,  const std::string& container);
 
+  /*
+   * Drops the whitespace held back by characters(), if there is any.
+   */
+  void dropWhitespace ();
+
   bool mInChars;
   bool mInStart;
   bool mEOFSeen;
@@ -193,6 +229,18 @@ protected:
   XMLToken             mCurrent;
   std::deque<XMLToken> mTokens;
 
+  /* pieces of character data appended to the text before them, and the
+     statistics to time each event against, if the stream is timed */
+  unsigned long  mNumCoalesced;
+  XMLParseStats* mStats;
+
+  /* whether whitespace-only character data is dropped, the whitespace
+     held back until it is known whether text follows it, and the runs of
+     whitespace dropped */
+  bool          mIgnoreWhitespace;
+  std::string   mSpace;
+  unsigned long mNumWhitespaceDropped;
+
   friend class XMLInputStream;
 
 };
@@ -0,0 +1,78 @@
+/**
+ * @file    XMLTrace.h
+ * @brief   Static tracepoints on the paths that read and write XML
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * When libLX is configured with WITH_USDT, the macros below place USDT
+ * probes in the library, in the provider @c liblx.  Each probe is a single
+ * no-op instruction until a tracer attaches to it, so a running process
+ * can be traced without rebuilding:
+ *
+@verbatim
+bpftrace -e 'usdt:/usr/lib/liblx.so:liblx:parse__chunk
+             { @bytes = hist(arg1); @tokens = hist(arg2); }'
+@endverbatim
+ *
+ * Otherwise the macros expand to nothing, and their arguments are not
+ * evaluated.  The probes are:
+ *
+ * <ul>
+ * <li> @c stream__create (stream, is file, library name): an XMLInputStream
+ *      has been created and has read its first chunk.
+ * <li> @c stream__destroy (stream, bytes read, error): an XMLInputStream is
+ *      being destroyed.
+ * <li> @c parse__chunk (stream, bytes, tokens): the XML library has been run
+ *      once on behalf of a stream, reading the given number of bytes and
+ *      producing the given number of tokens.
+ * <li> @c tokenizer__queue (tokenizer, depth): an XMLTokenizer has queued a
+ *      token, and now holds depth tokens.
+ * <li> @c error__add (log, error id, severity, line): an error is being
+ *      logged to an XMLErrorLog.
+ * <li> @c write__start (stream, encoding): an XMLOutputStream has started a
+ *      document.
+ * <li> @c write__end (stream): an XMLOutputStream is being destroyed.
+ * </ul>
+ */
+
+#ifndef XMLTrace_h
+#define XMLTrace_h
+
+/** @cond doxygenLibsbmlInternal */
+
+#ifdef USE_USDT
+
+#include <sys/sdt.h>
+
+#define LIBLX_TRACE1(name, a)          DTRACE_PROBE1(liblx, name, a)
+#define LIBLX_TRACE2(name, a, b)       DTRACE_PROBE2(liblx, name, a, b)
+#define LIBLX_TRACE3(name, a, b, c)    DTRACE_PROBE3(liblx, name, a, b, c)
+#define LIBLX_TRACE4(name, a, b, c, d) DTRACE_PROBE4(liblx, name, a, b, c, d)
+
+#else
+
+/* the arguments are kept in an unreachable branch, so that they are still
+   checked and count as used, but never evaluated */
+#define LIBLX_TRACE1(name, a) \
+  do { if (0) { (void) (a); } } while (0)
+#define LIBLX_TRACE2(name, a, b) \
+  do { if (0) { (void) (a); (void) (b); } } while (0)
+#define LIBLX_TRACE3(name, a, b, c) \
+  do { if (0) { (void) (a); (void) (b); (void) (c); } } while (0)
+#define LIBLX_TRACE4(name, a, b, c, d) \
+  do { if (0) { (void) (a); (void) (b); (void) (c); (void) (d); } } while (0)
+
+#endif  /* USE_USDT */
+
+/** @endcond */
+
+#endif  /* XMLTrace_h */
@@ -0,0 +1,292 @@
+/**
+ * @file    XMLWriterOptions.cpp
+ * @brief   Settings for one XMLOutputStream
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <new>
+
+#include <liblx/xml/XMLWriterOptions.h>
+#include <liblx/xml/XMLOutputStream.h>
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/common/liblx-version.h>
+
+/** @cond doxygenIgnored */
+using namespace std;
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+#ifdef __cplusplus
+
+/*
+ * Creates the default options.
+ */
+XMLWriterOptions::XMLWriterOptions ()
+ : mIndent          ( true                     )
+ , mIndentWidth     ( 2                        )
+ , mWriteComment    ( true                     )
+ , mWriteTimestamp  ( true                     )
+ , mLibraryName     ( "libSBML"                )
+ , mLibraryVersion  ( getLibLXDottedVersion()  )
+ , mDoublePrecision ( LIBSBML_DOUBLE_PRECISION )
+ , mLineEnding      ( "\n"                     )
+ , mCacheNodes      ( false                    )
+{
+}
+
+
+/*
+ * @return the process-wide settings made with the static methods of
+ * XMLOutputStream.
+ */
+XMLWriterOptions
+XMLWriterOptions::getProcessDefaults ()
+{
+  XMLWriterOptions options;
+
+  options.mWriteComment   = XMLOutputStream::getWriteComment();
+  options.mWriteTimestamp = XMLOutputStream::getWriteTimestamp();
+  options.mLibraryName    = XMLOutputStream::getLibraryName();
+  options.mLibraryVersion = XMLOutputStream::getLibraryVersion();
+
+  return options;
+}
+
+
+bool
+XMLWriterOptions::getIndent () const
+{
+  return mIndent;
+}
+
+
+XMLWriterOptions
+XMLWriterOptions::withIndent (bool indent) const
+{
+  XMLWriterOptions options(*this);
+  options.mIndent = indent;
+  return options;
+}
+
+
+unsigned int
+XMLWriterOptions::getIndentWidth () const
+{
+  return mIndentWidth;
+}
+
+
+XMLWriterOptions
+XMLWriterOptions::withIndentWidth (unsigned int width) const
+{
+  XMLWriterOptions options(*this);
+  options.mIndentWidth = width;
+  return options;
+}
+
+
+bool
+XMLWriterOptions::getWriteComment () const
+{
+  return mWriteComment;
+}
+
+
+XMLWriterOptions
+XMLWriterOptions::withWriteComment (bool writeComment) const
+{
+  XMLWriterOptions options(*this);
+  options.mWriteComment = writeComment;
+  return options;
+}
+
+
+bool
+XMLWriterOptions::getWriteTimestamp () const
+{
+  return mWriteTimestamp;
+}
+
+
+XMLWriterOptions
+XMLWriterOptions::withWriteTimestamp (bool writeTimestamp) const
+{
+  XMLWriterOptions options(*this);
+  options.mWriteTimestamp = writeTimestamp;
+  return options;
+}
+
+
+const string&
+XMLWriterOptions::getLibraryName () const
+{
+  return mLibraryName;
+}
+
+
+XMLWriterOptions
+XMLWriterOptions::withLibraryName (const string& name) const
+{
+  XMLWriterOptions options(*this);
+  options.mLibraryName = name;
+  return options;
+}
+
+
+const string&
+XMLWriterOptions::getLibraryVersion () const
+{
+  return mLibraryVersion;
+}
+
+
+XMLWriterOptions
+XMLWriterOptions::withLibraryVersion (const string& version) const
+{
+  XMLWriterOptions options(*this);
+  options.mLibraryVersion = version;
+  return options;
+}
+
+
+int
+XMLWriterOptions::getDoublePrecision () const
+{
+  return mDoublePrecision;
+}
+
+
+XMLWriterOptions
+XMLWriterOptions::withDoublePrecision (int digits) const
+{
+  XMLWriterOptions options(*this);
+  options.mDoublePrecision = digits;
+  return options;
+}
+
+
+const string&
+XMLWriterOptions::getLineEnding () const
+{
+  return mLineEnding;
+}
+
+
+XMLWriterOptions
+XMLWriterOptions::withLineEnding (const string& ending) const
+{
+  XMLWriterOptions options(*this);
+  options.mLineEnding = ending;
+  return options;
+}
+
+
+bool
+XMLWriterOptions::getCacheNodes () const
+{
+  return mCacheNodes;
+}
+
+
+XMLWriterOptions
+XMLWriterOptions::withCacheNodes (bool cacheNodes) const
+{
+  XMLWriterOptions options(*this);
+  options.mCacheNodes = cacheNodes;
+  return options;
+}
+
+
+#endif /* __cplusplus */
+/** @cond doxygenIgnored */
+
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_create (void)
+{
+  return new(nothrow) XMLWriterOptions;
+}
+
+
+LIBLX_EXTERN
+void
+XMLWriterOptions_free (XMLWriterOptions_t *options)
+{
+  if (options == NULL) return;
+  delete static_cast<XMLWriterOptions*>(options);
+}
+
+
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withIndent (const XMLWriterOptions_t *options, int indent)
+{
+  if (options == NULL) return NULL;
+  return new(nothrow) XMLWriterOptions(options->withIndent(indent != 0));
+}
+
+
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withWriteComment (  const XMLWriterOptions_t *options
+                                   , int                      writeComment )
+{
+  if (options == NULL) return NULL;
+  return new(nothrow) XMLWriterOptions(
+                        options->withWriteComment(writeComment != 0));
+}
+
+
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withWriteTimestamp (  const XMLWriterOptions_t *options
+                                     , int                      writeTimestamp )
+{
+  if (options == NULL) return NULL;
+  return new(nothrow) XMLWriterOptions(
+                        options->withWriteTimestamp(writeTimestamp != 0));
+}
+
+
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withDoublePrecision (  const XMLWriterOptions_t *options
+                                      , int                      digits )
+{
+  if (options == NULL) return NULL;
+  return new(nothrow) XMLWriterOptions(options->withDoublePrecision(digits));
+}
+
+
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withLineEnding (  const XMLWriterOptions_t *options
+                                 , const char               *ending )
+{
+  if (options == NULL || ending == NULL) return NULL;
+  return new(nothrow) XMLWriterOptions(options->withLineEnding(ending));
+}
+
+
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withCacheNodes (  const XMLWriterOptions_t *options
+                                 , int                      cacheNodes )
+{
+  if (options == NULL) return NULL;
+  return new(nothrow) XMLWriterOptions(
+                        options->withCacheNodes(cacheNodes != 0));
+}
+/** @endcond */
+
+LIBLX_CPP_NAMESPACE_END
@@ -0,0 +1,373 @@
+/**
+ * @file    XMLWriterOptions.h
+ * @brief   Settings for one XMLOutputStream
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution and
+ * also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->
+ *
+ * @class XMLWriterOptions
+ * @sbmlbrief{core} How an XMLOutputStream formats what it writes.
+ *
+ * An XMLWriterOptions object holds the settings of one XMLOutputStream:
+ * indentation, the comment naming the program and library at the top of
+ * the output, the number of digits written for floating-point attribute
+ * values, the line ending, and whether XMLNode trees keep the text they
+ * are written as.  The object cannot be changed once made;
+ * each <code>with</code> method returns a copy with one setting changed:
+ *
+@code{.cpp}
+const XMLWriterOptions fast = XMLWriterOptions()
+                                .withWriteComment(false)
+                                .withIndent(false);
+
+XMLOutputStream stream(out, fast);
+@endcode
+ *
+ * A stream created with an XMLWriterOptions object never consults the
+ * process-wide settings made with XMLOutputStream::setWriteComment() and
+ * the other static methods, so streams on different threads can use
+ * different settings without any locking.  A stream created without one
+ * takes a copy of the process-wide settings when it is constructed.
+ */
+
+#ifndef XMLWriterOptions_h
+#define XMLWriterOptions_h
+
+#include <liblx/xml/common/extern.h>
+#include <liblx/xml/common/liblxfwd.h>
+
+
+#ifdef __cplusplus
+
+#include <string>
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+
+class LIBLX_EXTERN XMLWriterOptions
+{
+public:
+
+  /**
+   * Creates the default options: indentation by two spaces, a comment
+   * with a timestamp naming libSBML and the libLX version, 15 significant
+   * digits for floating-point values and @c "\n" line endings.
+   */
+  XMLWriterOptions ();
+
+
+  /**
+   * @return the process-wide settings made with the static methods of
+   * XMLOutputStream, which streams created without options use.
+   */
+  static XMLWriterOptions getProcessDefaults ();
+
+
+  /**
+   * @return @c true if elements are indented.
+   */
+  bool getIndent () const;
+
+
+  /**
+   * @param indent whether elements are indented.
+   *
+   * @return a copy of these options with the given indentation.
+   */
+  XMLWriterOptions withIndent (bool indent) const;
+
+
+  /**
+   * @return the number of spaces per level of indentation.
+   */
+  unsigned int getIndentWidth () const;
+
+
+  /**
+   * @param width the number of spaces per level of indentation.
+   *
+   * @return a copy of these options with the given indentation width.
+   */
+  XMLWriterOptions withIndentWidth (unsigned int width) const;
+
+
+  /**
+   * @return @c true if a comment naming the program is written after the
+   * XML declaration when a program name is given.
+   */
+  bool getWriteComment () const;
+
+
+  /**
+   * @param writeComment whether to write the program comment.
+   *
+   * @return a copy of these options with the given comment setting.
+   */
+  XMLWriterOptions withWriteComment (bool writeComment) const;
+
+
+  /**
+   * @return @c true if the program comment includes the time of writing.
+   */
+  bool getWriteTimestamp () const;
+
+
+  /**
+   * @param writeTimestamp whether the comment includes the time.
+   *
+   * @return a copy of these options with the given timestamp setting.
+   */
+  XMLWriterOptions withWriteTimestamp (bool writeTimestamp) const;
+
+
+  /**
+   * @return the library named in the program comment.
+   */
+  const std::string& getLibraryName () const;
+
+
+  /**
+   * @param name the library named in the program comment, or the empty
+   * string for none.
+   *
+   * @return a copy of these options with the given library name.
+   */
+  XMLWriterOptions withLibraryName (const std::string& name) const;
+
+
+  /**
+   * @return the library version given in the program comment.
+   */
+  const std::string& getLibraryVersion () const;
+
+
+  /**
+   * @param version the library version given in the program comment, or
+   * the empty string for none.
+   *
+   * @return a copy of these options with the given library version.
+   */
+  XMLWriterOptions withLibraryVersion (const std::string& version) const;
+
+
+  /**
+   * @return the number of significant digits written for floating-point
+   * attribute values.
+   */
+  int getDoublePrecision () const;
+
+
+  /**
+   * @param digits the number of significant digits written for
+   * floating-point attribute values; 17 writes every double so that it
+   * reads back exactly.
+   *
+   * @return a copy of these options with the given precision.
+   */
+  XMLWriterOptions withDoublePrecision (int digits) const;
+
+
+  /**
+   * @return the characters written at the end of each line.
+   */
+  const std::string& getLineEnding () const;
+
+
+  /**
+   * @param ending the characters written at the end of each line, for
+   * example @c "\r\n".
+   *
+   * @return a copy of these options with the given line ending.
+   */
+  XMLWriterOptions withLineEnding (const std::string& ending) const;
+
+
+  /**
+   * @return @c true if XMLNode elements written keep their text for
+   * later writes.
+   */
+  bool getCacheNodes () const;
+
+
+  /**
+   * @param cacheNodes whether each XMLNode element with children that is
+   * written keeps the text written for it, and writes that text again as
+   * long as neither it nor its descendants change.  Each such element
+   * keeps the text of its whole subtree, so the memory used grows with
+   * the depth of the tree.
+   *
+   * @return a copy of these options with node caching turned on or off.
+   */
+  XMLWriterOptions withCacheNodes (bool cacheNodes) const;
+
+
+  /** @cond doxygenLibsbmlInternal */
+
+protected:
+
+  bool          mIndent;
+  unsigned int  mIndentWidth;
+  bool          mWriteComment;
+  bool          mWriteTimestamp;
+  std::string   mLibraryName;
+  std::string   mLibraryVersion;
+  int           mDoublePrecision;
+  std::string   mLineEnding;
+  bool          mCacheNodes;
+
+  /** @endcond */
+};
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* __cplusplus */
+
+
+#ifndef SWIG
+
+LIBLX_CPP_NAMESPACE_BEGIN
+
+BEGIN_C_DECLS
+
+
+/**
+ * Creates a new XMLWriterOptions_t with the default settings.
+ *
+ * @return pointer to the XMLWriterOptions_t structure created.
+ *
+ * @memberof XMLWriterOptions_t
+ */
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_create (void);
+
+
+/**
+ * Destroys this XMLWriterOptions_t structure.
+ *
+ * @param options XMLWriterOptions_t structure to be freed.
+ *
+ * @memberof XMLWriterOptions_t
+ */
+LIBLX_EXTERN
+void
+XMLWriterOptions_free (XMLWriterOptions_t *options);
+
+
+/**
+ * Creates a copy of the options with indentation turned on or off.
+ *
+ * @param options the XMLWriterOptions_t structure.
+ * @param indent nonzero to indent elements.
+ *
+ * @return the new XMLWriterOptions_t structure, or @c NULL if
+ * @p options is @c NULL.
+ *
+ * @memberof XMLWriterOptions_t
+ */
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withIndent (const XMLWriterOptions_t *options, int indent);
+
+
+/**
+ * Creates a copy of the options with the program comment turned on or
+ * off.
+ *
+ * @param options the XMLWriterOptions_t structure.
+ * @param writeComment nonzero to write the program comment.
+ *
+ * @return the new XMLWriterOptions_t structure, or @c NULL if
+ * @p options is @c NULL.
+ *
+ * @memberof XMLWriterOptions_t
+ */
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withWriteComment (  const XMLWriterOptions_t *options
+                                   , int                      writeComment );
+
+
+/**
+ * Creates a copy of the options with the timestamp turned on or off.
+ *
+ * @param options the XMLWriterOptions_t structure.
+ * @param writeTimestamp nonzero to include the time in the comment.
+ *
+ * @return the new XMLWriterOptions_t structure, or @c NULL if
+ * @p options is @c NULL.
+ *
+ * @memberof XMLWriterOptions_t
+ */
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withWriteTimestamp (  const XMLWriterOptions_t *options
+                                     , int                      writeTimestamp );
+
+
+/**
+ * Creates a copy of the options with the given floating-point precision.
+ *
+ * @param options the XMLWriterOptions_t structure.
+ * @param digits the number of significant digits.
+ *
+ * @return the new XMLWriterOptions_t structure, or @c NULL if
+ * @p options is @c NULL.
+ *
+ * @memberof XMLWriterOptions_t
+ */
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withDoublePrecision (  const XMLWriterOptions_t *options
+                                      , int                      digits );
+
+
+/**
+ * Creates a copy of the options with the given line ending.
+ *
+ * @param options the XMLWriterOptions_t structure.
+ * @param ending the characters written at the end of each line.
+ *
+ * @return the new XMLWriterOptions_t structure, or @c NULL if
+ * @p options or @p ending is @c NULL.
+ *
+ * @memberof XMLWriterOptions_t
+ */
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withLineEnding (  const XMLWriterOptions_t *options
+                                 , const char               *ending );
+
+
+/**
+ * Creates a copy of the options with node caching turned on or off.
+ *
+ * @param options the XMLWriterOptions_t structure.
+ * @param cacheNodes nonzero to keep the text of XMLNode_t elements
+ * written and reuse it while they are unchanged.
+ *
+ * @return the new XMLWriterOptions_t structure, or @c NULL if
+ * @p options is @c NULL.
+ *
+ * @memberof XMLWriterOptions_t
+ */
+LIBLX_EXTERN
+XMLWriterOptions_t *
+XMLWriterOptions_withCacheNodes (  const XMLWriterOptions_t *options
+                                 , int                      cacheNodes );
+
+
+END_C_DECLS
+
+LIBLX_CPP_NAMESPACE_END
+
+#endif  /* !SWIG */
+#endif  /* XMLWriterOptions_h */
@@ -132,8 +132,13 @@ XercesHandler::startElement (  const XMLCh* const  uri
                              , const XMLCh* const  qname
                              , const Attributes&   attrs )
 {
+  if (mHandler.skipStartElement()) return;
+
   const string nsuri  = XercesTranscode( uri       );
   const string name   = XercesTranscode( localname );
+
+  if (mHandler.filterElement(name, nsuri)) return;
+
   const string prefix = getPrefix( XercesTranscode(qname) );
 
   const XMLTriple         triple    ( name, nsuri, prefix );
@@ -168,6 +173,8 @@ XercesHandler::endElement (  const XMLCh* const  uri
                            , const XMLCh* const  localname
                            , const XMLCh* const  qname )
 {
+  if (mHandler.skipEndElement()) return;
+
   const string nsuri  = XercesTranscode( uri       );
   const string name   = XercesTranscode( localname );
   const string prefix = getPrefix( XercesTranscode(qname) );
@@ -189,10 +196,11 @@ void
 XercesHandler::characters (  const XMLCh* const  chars
                            , const XercesSize_t  length )
 {
-  const string   transcoded = XercesTranscode(chars);
-  const XMLToken data(transcoded);
+  if (mHandler.isSkipping()) return;
+
+  const string transcoded = XercesTranscode(chars);
 
-  mHandler.characters(transcoded);
+  mHandler.characters(transcoded.data(), transcoded.size());
 }
 
 
@@ -40,6 +40,7 @@
 
 #include <cstring>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 
 #include <xercesc/framework/LocalFileInputSource.hpp>
@@ -352,6 +353,19 @@ protected:
 };
 
 
+/*
+ * XMLPlatformUtils::Initialize() and Terminate() count their calls but
+ * are not thread-safe, so parsers created and destroyed on several
+ * threads take turns.
+ */
+static mutex&
+platformMutex ()
+{
+  static mutex* m = new mutex;
+  return *m;
+}
+
+
 /**
  * Creates a new XercesParser.  The parser will notify the given XMLHandler
  * of parse events and errors.
@@ -363,7 +377,10 @@ XercesParser::XercesParser (XMLHandler& handler) :
 {
   try
   {
-    XMLPlatformUtils::Initialize();
+    {
+      lock_guard<mutex> lock(platformMutex());
+      XMLPlatformUtils::Initialize();
+    }
 
     mReader = new XercesReader(handler); // XMLReaderFactory::createXMLReader();
 
@@ -388,6 +405,8 @@ XercesParser::~XercesParser ()
 {
   delete mReader;
   delete mSource;
+
+  lock_guard<mutex> lock(platformMutex());
   XMLPlatformUtils::Terminate();
 }
 
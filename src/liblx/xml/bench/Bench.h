@@ -0,0 +1,115 @@
+/**
+ * @file    Bench.h
+ * @brief   Shared helpers for the libLX benchmarks
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#ifndef Bench_h
+#define Bench_h
+
+#include <cstddef>
+#include <string>
+
+
+/*
+ * Records one measurement of the running benchmark.
+ */
+void bench_report (  const std::string& benchmark
+                   , const std::string& metric
+                   , double             value
+                   , const std::string& unit );
+
+
+/*
+ * Bytes currently allocated through operator new, and the number of
+ * allocations made so far.  The benchmark runner replaces the global
+ * allocation functions so that the library's allocations are counted.
+ */
+size_t bench_heap_in_use ();
+size_t bench_heap_allocations ();
+
+
+/*
+ * The largest value bench_heap_in_use() has reached since the last call
+ * to bench_heap_reset_peak().
+ */
+size_t bench_heap_peak ();
+void   bench_heap_reset_peak ();
+
+
+/*
+ * Monotonic wall-clock time in seconds.
+ */
+double bench_now ();
+
+
+/*
+ * The largest resident set size the process has reached, in bytes, or 0
+ * where it cannot be found.
+ */
+size_t bench_peak_rss ();
+
+
+/*
+ * Returns a pretty-printed document containing @p count sibling
+ * <tt>&lt;item&gt;</tt> elements, each carrying a couple of attributes, a
+ * child element and some text.
+ */
+std::string bench_make_document (unsigned int count);
+
+
+/*
+ * The shapes of synthetic document bench_make_shaped_document() writes:
+ * many small siblings, long chains of nested elements, elements with many
+ * numeric attributes, long runs of text with entities, and elements each
+ * declaring a prefixed namespace.
+ */
+enum BenchShape
+{
+    BENCH_WIDE
+  , BENCH_DEEP
+  , BENCH_ATTRIBUTES
+  , BENCH_TEXT
+  , BENCH_NAMESPACES
+  , BENCH_NUM_SHAPES
+};
+
+
+const char* bench_shape_name (BenchShape shape);
+
+
+/*
+ * Returns a document of the given shape and of about @p size bytes.  The
+ * same arguments always give the same document.
+ */
+std::string bench_make_shaped_document (BenchShape shape, size_t size);
+
+
+/*
+ * Returns a copy of @p doc with one to three characters deleted, inserted
+ * or replaced by markup characters, chosen by @p seed, which is advanced.
+ * The same seed always gives the same document.
+ */
+std::string bench_corrupt_document (const std::string& doc,
+                                    unsigned int& seed);
+
+
+/*
+ * Writes @p doc to a file in the current directory, compressed according
+ * to @p extension (one of "", ".gz", ".bz2" or ".zip"), and returns its
+ * name, or an empty string if the library cannot write that format.
+ */
+std::string bench_write_file (  const std::string& doc
+                              , const std::string& extension );
+
+
+#endif  /* Bench_h */
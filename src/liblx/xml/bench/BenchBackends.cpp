@@ -0,0 +1,269 @@
+/**
+ * @file    BenchBackends.cpp
+ * @brief   Throughput, memory and agreement of each XML library built in
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLParser.h>
+#include <liblx/xml/XMLToken.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*  BENCH    = "Backends";
+static const size_t DOC_SIZE = 2 * 1048576;
+
+static const unsigned int CORPUS_SIZE = 500;
+
+
+/*
+ * A running FNV-1a hash of what a library reads, by which libraries are
+ * compared without keeping their token streams.
+ */
+struct Digest
+{
+  unsigned long long value;
+
+  Digest () : value(14695981039346656037ULL) {}
+
+  void add (const string& str)
+  {
+    for (size_t n = 0; n < str.size(); ++n)
+    {
+      value = (value ^ (unsigned char) str[n]) * 1099511628211ULL;
+    }
+    value = (value ^ 0xff) * 1099511628211ULL;
+  }
+};
+
+
+/*
+ * Reads doc with library, token by token, and returns the digest of the
+ * tokens and error ids, reporting the rate read at.  Adjacent pieces of
+ * text are digested as one, since libraries split text differently.
+ */
+static unsigned long long
+readTokens (const string& doc, const string& label, const string& library)
+{
+  XMLErrorLog    log;
+  XMLInputStream stream(doc.c_str(), false, library, &log);
+
+  Digest digest;
+  string text;
+  size_t tokens = 0;
+
+  const double start = bench_now();
+  while (stream.isGood())
+  {
+    const XMLToken token = stream.next();
+    if (token.isEOF()) break;
+    ++tokens;
+
+    if (token.isText())
+    {
+      text += token.getCharacters();
+      continue;
+    }
+
+    digest.add(text);
+    text.clear();
+
+    digest.add(token.isStart() ? (token.isEnd() ? "SE" : "S") : "E");
+    digest.add(token.getPrefix());
+    digest.add(token.getName());
+    digest.add(token.getURI());
+
+    for (int n = 0; n < token.getAttributesLength(); ++n)
+    {
+      digest.add(token.getAttrName(n));
+      digest.add(token.getAttrURI(n));
+      digest.add(token.getAttrValue(n));
+    }
+
+    for (int n = 0; n < token.getNamespacesLength(); ++n)
+    {
+      digest.add(token.getNamespacePrefix(n));
+      digest.add(token.getNamespaceURI(n));
+    }
+  }
+  const double elapsed = bench_now() - start;
+
+  digest.add(text);
+
+  for (unsigned int n = 0; n < log.getNumErrors(); ++n)
+  {
+    const unsigned int id = log.getError(n)->getErrorId();
+    digest.add(string((const char*) &id, sizeof(id)));
+  }
+
+  bench_report(BENCH, label + " MB/s", doc.size() / 1048576.0 / elapsed,
+               "MB/s");
+  bench_report(BENCH, label + " tokens/s", tokens / elapsed, "tokens/s");
+  if (log.getNumErrors() > 0)
+  {
+    bench_report(BENCH, label + " first error",
+                 log.getError(0)->getErrorId(), "");
+  }
+
+  return digest.value;
+}
+
+
+/*
+ * Reads doc into a tree with library, reporting the rate and the heap
+ * the tree took at its peak.
+ */
+static void
+readTree (const string& doc, const string& label, const string& library)
+{
+  const size_t before = bench_heap_in_use();
+  bench_heap_reset_peak();
+
+  XMLInputStream stream(doc.c_str(), false, library);
+
+  const double start = bench_now();
+  XMLNode root(stream);
+  const double elapsed = bench_now() - start;
+
+  bench_report(BENCH, label + " tree MB/s", doc.size() / 1048576.0 / elapsed,
+               "MB/s");
+  bench_report(BENCH, label + " tree heap peak",
+               (bench_heap_peak() - before) / 1048576.0, "MB");
+}
+
+
+/*
+ * Reads doc with every library, and reports for each whether it read the
+ * same as the first.
+ */
+static void
+measureClass (const string& doc, const string& name, bool tree)
+{
+  const vector<string> libraries = XMLParser::getLibraries();
+  unsigned long long   expected  = 0;
+
+  for (size_t n = 0; n < libraries.size(); ++n)
+  {
+    const string label = name + " " + libraries[n];
+
+    const unsigned long long digest = readTokens(doc, label, libraries[n]);
+    if (n == 0) expected = digest;
+
+    if (tree) readTree(doc, label, libraries[n]);
+
+    if (n > 0)
+    {
+      bench_report(BENCH, label + " same as " + libraries[0],
+                   (digest == expected) ? 1 : 0, "");
+    }
+  }
+}
+
+
+/*
+ * Reads each of docs with every library, and reports the rate and how
+ * many documents each library rejects differently from the first, or
+ * rejects with a different first error.
+ */
+static void
+measureCorpus (const vector<string>& docs, const string& name)
+{
+  const vector<string> libraries = XMLParser::getLibraries();
+  vector<unsigned int> expected;
+  unsigned long long   first     = 0;
+
+  for (size_t n = 0; n < libraries.size(); ++n)
+  {
+    const string label = name + " " + libraries[n];
+
+    Digest       digest;
+    unsigned int outcomes = 0;
+    unsigned int codes    = 0;
+
+    const double start = bench_now();
+    for (size_t d = 0; d < docs.size(); ++d)
+    {
+      XMLErrorLog    log;
+      XMLInputStream stream(docs[d].c_str(), false, libraries[n], &log);
+
+      while (stream.isGood() && !stream.next().isEOF()) ;
+
+      const unsigned int id = (log.getNumErrors() > 0)
+                            ? log.getError(0)->getErrorId() : 0;
+      digest.add(string((const char*) &id, sizeof(id)));
+
+      if (n == 0)
+      {
+        expected.push_back(id);
+      }
+      else if ((id == 0) != (expected[d] == 0))
+      {
+        ++outcomes;
+      }
+      else if (id != expected[d])
+      {
+        ++codes;
+      }
+    }
+    const double elapsed = bench_now() - start;
+
+    bench_report(BENCH, label + " docs/s", docs.size() / elapsed, "docs/s");
+    if (n == 0) first = digest.value;
+
+    if (n > 0)
+    {
+      bench_report(BENCH, label + " same as " + libraries[0],
+                   (digest.value == first) ? 1 : 0, "");
+      bench_report(BENCH, label + " outcome mismatches", outcomes, "docs");
+      bench_report(BENCH, label + " error mismatches", codes, "docs");
+    }
+  }
+}
+
+
+void
+bench_Backends ()
+{
+  for (int shape = 0; shape < BENCH_NUM_SHAPES; ++shape)
+  {
+    const BenchShape s   = static_cast<BenchShape>(shape);
+    const string     doc = bench_make_shaped_document(s, DOC_SIZE);
+
+    measureClass(doc, bench_shape_name(s), true);
+
+    /* cut off part way through, so that every library reports an error */
+    measureClass(doc.substr(0, doc.size() / 2 + 7),
+                 string(bench_shape_name(s)) + " truncated", false);
+
+    /* small documents each broken in a few places, with a fixed seed */
+    const string   small = bench_make_shaped_document(s, 2048);
+    vector<string> corpus;
+    unsigned int   seed  = 20261018;
+
+    for (unsigned int n = 0; n < CORPUS_SIZE; ++n)
+    {
+      corpus.push_back(bench_corrupt_document(small, seed));
+    }
+
+    measureCorpus(corpus, string(bench_shape_name(s)) + " corrupted");
+  }
+}
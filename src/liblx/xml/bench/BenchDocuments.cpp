@@ -0,0 +1,208 @@
+/**
+ * @file    BenchDocuments.cpp
+ * @brief   Synthetic documents of several shapes for the benchmarks
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include <liblx/xml/compress/CompressCommon.h>
+#include <liblx/xml/compress/OutputCompressor.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const unsigned int DEPTH      = 64;
+static const unsigned int NUM_ATTRS  = 16;
+static const unsigned int NUM_PREFIX = 8;
+
+
+const char*
+bench_shape_name (BenchShape shape)
+{
+  switch (shape)
+  {
+  case BENCH_WIDE:       return "wide";
+  case BENCH_DEEP:       return "deep";
+  case BENCH_ATTRIBUTES: return "attributes";
+  case BENCH_TEXT:       return "text";
+  case BENCH_NAMESPACES: return "namespaces";
+  default:               return "unknown";
+  }
+}
+
+
+/*
+ * Each writer below appends one unit of its shape, numbered n, to oss.
+ */
+static void
+writeWide (ostringstream& oss, unsigned int n)
+{
+  oss << "  <item id=\"i" << n << "\" value=\"" << n * 0.5 << "\">"
+      << "<name>item " << n << "</name><flag/></item>\n";
+}
+
+
+static void
+writeDeep (ostringstream& oss, unsigned int n)
+{
+  for (unsigned int d = 0; d < DEPTH; ++d)
+  {
+    oss << "<level depth=\"" << d << "\">";
+  }
+  oss << "leaf " << n;
+  for (unsigned int d = 0; d < DEPTH; ++d)
+  {
+    oss << "</level>";
+  }
+  oss << '\n';
+}
+
+
+static void
+writeAttributes (ostringstream& oss, unsigned int n)
+{
+  oss << "  <record";
+  for (unsigned int a = 0; a < NUM_ATTRS; a += 2)
+  {
+    oss << " i" << a << "=\"" << n * NUM_ATTRS + a << "\""
+        << " d" << a << "=\"" << (n + a) * 0.125 << "e-3\"";
+  }
+  oss << "/>\n";
+}
+
+
+static void
+writeText (ostringstream& oss, unsigned int n)
+{
+  oss << "  <para n=\"" << n << "\">";
+  for (unsigned int s = 0; s < 12; ++s)
+  {
+    oss << "Sentence " << s << " of paragraph " << n
+        << " compares a &lt; b &amp;&amp; c &gt; d in plain words. ";
+  }
+  oss << "</para>\n";
+}
+
+
+static void
+writeNamespaces (ostringstream& oss, unsigned int n)
+{
+  const unsigned int p = n % NUM_PREFIX;
+
+  oss << "  <p" << p << ":entry xmlns:p" << p
+      << "=\"http://example.org/ns/" << p << "\""
+      << " p" << p << ":ref=\"r" << n << "\">"
+      << "<p" << p << ":value>" << n << "</p" << p << ":value>"
+      << "</p" << p << ":entry>\n";
+}
+
+
+string
+bench_make_shaped_document (BenchShape shape, size_t size)
+{
+  ostringstream oss;
+
+  oss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<root xmlns=\"http://example.org/bench\">\n";
+
+  for (unsigned int n = 0; (size_t) oss.tellp() < size; ++n)
+  {
+    switch (shape)
+    {
+    case BENCH_WIDE:       writeWide(oss, n);       break;
+    case BENCH_DEEP:       writeDeep(oss, n);       break;
+    case BENCH_ATTRIBUTES: writeAttributes(oss, n); break;
+    case BENCH_TEXT:       writeText(oss, n);       break;
+    case BENCH_NAMESPACES: writeNamespaces(oss, n); break;
+    default:               return oss.str();
+    }
+  }
+
+  oss << "</root>\n";
+
+  return oss.str();
+}
+
+
+string
+bench_corrupt_document (const string& doc, unsigned int& seed)
+{
+  static const char junk[] = "<>&\"'=/:;x #!?[]-";
+
+  string copy = doc;
+
+  seed = seed * 1664525 + 1013904223;
+  unsigned int edits = 1 + (seed >> 16) % 3;
+
+  while (edits-- > 0 && !copy.empty())
+  {
+    seed = seed * 1664525 + 1013904223;
+    const size_t pos = (seed >> 8) % copy.size();
+    const char   c   = junk[(seed >> 24) % (sizeof(junk) - 1)];
+
+    switch (seed % 3)
+    {
+    case 0:  copy.erase(pos, 1);     break;
+    case 1:  copy.insert(pos, 1, c); break;
+    default: copy[pos] = c;          break;
+    }
+  }
+
+  return copy;
+}
+
+
+string
+bench_write_file (const string& doc, const string& extension)
+{
+  const string filename = "liblx-bench-document.xml" + extension;
+  unique_ptr<ostream> stream;
+
+  try
+  {
+    if (extension.empty())
+    {
+      stream.reset(new ofstream(filename.c_str(), ios::binary));
+    }
+    else if (extension == ".gz" && hasZlib())
+    {
+      stream.reset(OutputCompressor::openGzipOStream(filename));
+    }
+    else if (extension == ".bz2" && hasBzip2())
+    {
+      stream.reset(OutputCompressor::openBzip2OStream(filename));
+    }
+    else if (extension == ".zip" && hasZlib())
+    {
+      stream.reset(OutputCompressor::openZipOStream(filename,
+                                                    "document.xml"));
+    }
+  }
+  catch (...)
+  {
+    stream.reset();
+  }
+
+  if (!stream || !stream->good()) return "";
+
+  stream->write(doc.data(), doc.size());
+  stream.reset();
+
+  return filename;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file    BenchNativeParser.cpp
+ * @brief   Token throughput of the native parser and the library adapters
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLToken.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH     = "NativeParser";
+static const unsigned int NUM_ITEMS = 50000;
+static const unsigned int NUM_RUNS  = 5;
+
+
+/*
+ * Reads every token of doc with the given parser and reports the best
+ * throughput of several runs.
+ */
+static void
+measure (const string& doc, const char* library)
+{
+  double best   = 0;
+  size_t tokens = 0;
+
+  for (unsigned int run = 0; run < NUM_RUNS; ++run)
+  {
+    tokens = 0;
+
+    const double start = bench_now();
+    {
+      XMLInputStream stream(doc.c_str(), false, library);
+
+      while (stream.isGood())
+      {
+        stream.skipToken();
+        ++tokens;
+      }
+    }
+    const double elapsed = bench_now() - start;
+
+    if (run == 0 || elapsed < best) best = elapsed;
+  }
+
+  const string label = string(library) + " ";
+
+  bench_report(BENCH, label + "time", best * 1e3, "ms");
+  bench_report(BENCH, label + "throughput", doc.size() / best / 1048576.0,
+               "MB/s");
+  bench_report(BENCH, label + "tokens", (double) tokens, "");
+}
+
+
+void
+bench_NativeParser ()
+{
+  const string doc = bench_make_document(NUM_ITEMS);
+
+#ifdef USE_EXPAT
+  measure(doc, "expat");
+#endif
+#ifdef USE_LIBXML
+  measure(doc, "libxml");
+#endif
+#ifdef USE_XERCES
+  measure(doc, "xerces");
+#endif
+#ifdef USE_NATIVE_PARSER
+  measure(doc, "native");
+#endif
+}
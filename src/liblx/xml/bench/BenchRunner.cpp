@@ -0,0 +1,351 @@
+/**
+ * @file    BenchRunner.cpp
+ * @brief   Runs the libLX benchmarks
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+#include "Bench.h"
+
+using namespace std;
+
+
+void bench_XMLTokenFootprint (void);
+void bench_XMLDocumentStore (void);
+void bench_XMLPath (void);
+void bench_XMLStreamMatcher (void);
+void bench_NativeParser (void);
+void bench_XMLParallelParser (void);
+void bench_XMLBatchParser (void);
+void bench_XMLParserPool (void);
+void bench_XMLNodeHash (void);
+void bench_XMLNodePool (void);
+void bench_XMLNodeClone (void);
+void bench_XMLNodeString (void);
+void bench_XMLErrorLog (void);
+void bench_Throughput (void);
+void bench_Backends (void);
+void bench_XMLMemoryResource (void);
+void bench_XMLElementFilter (void);
+
+
+struct BenchEntry
+{
+  const char* name;
+  void (*run) (void);
+};
+
+static const BenchEntry benchmarks[] =
+{
+    { "XMLTokenFootprint", bench_XMLTokenFootprint }
+  , { "XMLDocumentStore",  bench_XMLDocumentStore  }
+  , { "XMLPath",           bench_XMLPath           }
+  , { "XMLStreamMatcher",  bench_XMLStreamMatcher  }
+  , { "NativeParser",      bench_NativeParser      }
+  , { "XMLParallelParser", bench_XMLParallelParser }
+  , { "XMLBatchParser",    bench_XMLBatchParser    }
+  , { "XMLParserPool",     bench_XMLParserPool     }
+  , { "XMLNodeHash",       bench_XMLNodeHash       }
+  , { "XMLNodePool",       bench_XMLNodePool       }
+  , { "XMLNodeClone",      bench_XMLNodeClone      }
+  , { "XMLNodeString",     bench_XMLNodeString     }
+  , { "XMLErrorLog",       bench_XMLErrorLog       }
+  , { "Throughput",        bench_Throughput        }
+  , { "Backends",          bench_Backends          }
+  , { "XMLMemoryResource", bench_XMLMemoryResource }
+  , { "XMLElementFilter",  bench_XMLElementFilter  }
+};
+
+
+/*
+ * Global allocation functions that keep a running total of the bytes in
+ * use.  Each block is prefixed with its size so it can be subtracted
+ * again on release.  The counters are atomic since some benchmarks
+ * allocate on several threads.
+ */
+static atomic<size_t> heapInUse(0);
+static atomic<size_t> heapPeak(0);
+static atomic<size_t> heapAllocCount(0);
+
+static const size_t HEADER_SIZE = 16;
+
+
+void*
+operator new (size_t size)
+{
+  char* block = static_cast<char*>(malloc(size + HEADER_SIZE));
+  if (block == NULL) throw bad_alloc();
+
+  *reinterpret_cast<size_t*>(block) = size;
+  const size_t inUse = (heapInUse += size);
+  size_t peak = heapPeak;
+  while (inUse > peak && !heapPeak.compare_exchange_weak(peak, inUse))
+  {
+  }
+  ++heapAllocCount;
+
+  return block + HEADER_SIZE;
+}
+
+
+void
+operator delete (void* p) noexcept
+{
+  if (p == NULL) return;
+
+  char* block = static_cast<char*>(p) - HEADER_SIZE;
+  heapInUse -= *reinterpret_cast<size_t*>(block);
+  free(block);
+}
+
+
+void*
+operator new[] (size_t size)
+{
+  return operator new(size);
+}
+
+
+void
+operator delete[] (void* p) noexcept
+{
+  operator delete(p);
+}
+
+
+size_t
+bench_heap_in_use ()
+{
+  return heapInUse;
+}
+
+
+size_t
+bench_heap_allocations ()
+{
+  return heapAllocCount;
+}
+
+
+size_t
+bench_heap_peak ()
+{
+  return heapPeak;
+}
+
+
+void
+bench_heap_reset_peak ()
+{
+  heapPeak = heapInUse.load();
+}
+
+
+double
+bench_now ()
+{
+  return chrono::duration<double>(
+           chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+size_t
+bench_peak_rss ()
+{
+#if defined(_WIN32)
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+
+#if defined(__APPLE__)
+  return (size_t) usage.ru_maxrss;
+#else
+  return (size_t) usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+
+/*
+ * With --json the measurements are kept and written as one JSON document
+ * when all benchmarks have run; otherwise each is printed as a line.
+ */
+struct BenchResult
+{
+  string benchmark;
+  string metric;
+  double value;
+  string unit;
+};
+
+static bool                writeJSON = false;
+static vector<BenchResult> results;
+
+
+void
+bench_report (  const string& benchmark
+              , const string& metric
+              , double        value
+              , const string& unit )
+{
+  if (writeJSON)
+  {
+    BenchResult result = { benchmark, metric, value, unit };
+    results.push_back(result);
+    return;
+  }
+
+  printf("%-24s %-40s %16.2f %s\n",
+         benchmark.c_str(), metric.c_str(), value, unit.c_str());
+}
+
+
+/*
+ * @return str as a JSON string literal.
+ */
+static string
+quoteJSON (const string& str)
+{
+  string quoted = "\"";
+
+  for (size_t n = 0; n < str.size(); ++n)
+  {
+    const char c = str[n];
+    if (c == '"' || c == '\\')
+    {
+      quoted += '\\';
+      quoted += c;
+    }
+    else if ((unsigned char) c < 0x20)
+    {
+      char escape[8];
+      snprintf(escape, sizeof(escape), "\\u%04x", c);
+      quoted += escape;
+    }
+    else
+    {
+      quoted += c;
+    }
+  }
+
+  return quoted + "\"";
+}
+
+
+static void
+printJSON ()
+{
+  printf("{\n  \"peak_rss_bytes\": %lu,\n  \"results\": [",
+         (unsigned long) bench_peak_rss());
+
+  for (size_t n = 0; n < results.size(); ++n)
+  {
+    printf("%s\n    { \"benchmark\": %s, \"metric\": %s, "
+           "\"value\": %.6g, \"unit\": %s }",
+           (n > 0) ? "," : "",
+           quoteJSON(results[n].benchmark).c_str(),
+           quoteJSON(results[n].metric).c_str(),
+           results[n].value,
+           quoteJSON(results[n].unit).c_str());
+  }
+
+  printf("\n  ]\n}\n");
+}
+
+
+string
+bench_make_document (unsigned int count)
+{
+  ostringstream oss;
+
+  oss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<root xmlns=\"http://example.org/bench\">\n"
+      << "  <listOfItems>\n";
+
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    oss << "    <item id=\"i" << n << "\" value=\"" << n * 0.5 << "\">\n"
+        << "      <name>item number " << n << "</name>\n"
+        << "      <flag/>\n"
+        << "    </item>\n";
+  }
+
+  oss << "  </listOfItems>\n"
+      << "</root>\n";
+
+  return oss.str();
+}
+
+
+/*
+ * Usage: liblx-bench [--json] [benchmark]
+ *
+ * Runs the named benchmark, or all of them.
+ */
+int
+main (int argc, char* argv[])
+{
+  const size_t num  = sizeof(benchmarks) / sizeof(benchmarks[0]);
+  const char*  name = NULL;
+  int ran = 0;
+
+  for (int arg = 1; arg < argc; ++arg)
+  {
+    if (strcmp(argv[arg], "--json") == 0)
+    {
+      writeJSON = true;
+    }
+    else
+    {
+      name = argv[arg];
+    }
+  }
+
+  for (size_t n = 0; n < num; ++n)
+  {
+    if (name != NULL && strcmp(name, benchmarks[n].name) != 0) continue;
+
+    benchmarks[n].run();
+    ++ran;
+  }
+
+  if (ran == 0)
+  {
+    fprintf(stderr, "unknown benchmark '%s'\n", name);
+    return 1;
+  }
+
+  if (writeJSON)
+  {
+    printJSON();
+  }
+  else
+  {
+    bench_report("liblx-bench", "peak RSS", 
+                 bench_peak_rss() / 1048576.0, "MB");
+  }
+
+  return 0;
+}
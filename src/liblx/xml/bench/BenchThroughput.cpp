@@ -0,0 +1,288 @@
+/**
+ * @file    BenchThroughput.cpp
+ * @brief   Reading and writing throughput on documents of several shapes
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLAttributes.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLOutputStream.h>
+#include <liblx/xml/XMLParseStats.h>
+#include <liblx/xml/XMLToken.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*  BENCH    = "Throughput";
+static const size_t DOC_SIZE = 4 * 1048576;
+
+
+/*
+ * Reports bytes, and tokens if there are any, processed in elapsed
+ * seconds.
+ */
+static void
+reportRate (  const string& label
+            , size_t        bytes
+            , size_t        tokens
+            , double        elapsed )
+{
+  bench_report(BENCH, label + " MB/s", bytes / 1048576.0 / elapsed, "MB/s");
+
+  if (tokens > 0)
+  {
+    bench_report(BENCH, label + " tokens/s", tokens / elapsed, "tokens/s");
+  }
+}
+
+
+/*
+ * @return the number of tokens stream delivers before its end.
+ */
+static size_t
+countTokens (XMLInputStream& stream)
+{
+  size_t count = 0;
+
+  while (stream.isGood())
+  {
+    if (stream.next().isEOF()) break;
+    ++count;
+  }
+
+  return count;
+}
+
+
+/*
+ * Reads every numeric attribute of the attribute-heavy document with
+ * XMLAttributes::readInto().
+ */
+static void
+measureReadInto (const string& doc)
+{
+  vector<string> ints, doubles;
+  for (unsigned int a = 0; a < 16; a += 2)
+  {
+    ostringstream i, d;
+    i << 'i' << a;
+    d << 'd' << a;
+    ints.push_back(i.str());
+    doubles.push_back(d.str());
+  }
+
+  XMLInputStream stream(doc.c_str(), false);
+  size_t values = 0;
+  double sum    = 0;
+
+  const double start = bench_now();
+  while (stream.isGood())
+  {
+    const XMLToken token = stream.next();
+    if (token.isEOF()) break;
+    if (!token.isStart() || token.getAttributesLength() == 0) continue;
+
+    const XMLAttributes& attrs = token.getAttributes();
+    for (size_t n = 0; n < ints.size(); ++n)
+    {
+      long   i = 0;
+      double d = 0;
+      if (attrs.readInto(ints[n], i))    ++values;
+      if (attrs.readInto(doubles[n], d)) ++values;
+      sum += i + d;
+    }
+  }
+  const double elapsed = bench_now() - start;
+
+  bench_report(BENCH, "attributes readInto", values / elapsed, "values/s");
+  if (sum < 0) bench_report(BENCH, "unexpected sum", sum, "");
+}
+
+
+/*
+ * Measures reading doc token by token with statistics collected, counted
+ * only and timed, to show what collecting them costs.
+ */
+static void
+measureStats (const string& doc)
+{
+  for (int timed = 0; timed < 2; ++timed)
+  {
+    XMLInputStream stream(doc.c_str(), false);
+    stream.enableStats(timed != 0);
+
+    const double start  = bench_now();
+    const size_t tokens = countTokens(stream);
+    reportRate(timed ? "wide tokens, timed stats" : "wide tokens, stats",
+               doc.size(), tokens, bench_now() - start);
+
+    if (timed)
+    {
+      const XMLParseStats* stats = stream.getStats();
+      bench_report(BENCH, "wide timed parse",
+                   stats->getParseTime() * 1e3, "ms");
+      bench_report(BENCH, "wide timed tokenizer",
+                   stats->getTokenizerTime() * 1e3, "ms");
+      bench_report(BENCH, "wide timed consumer",
+                   stats->getConsumerTime() * 1e3, "ms");
+    }
+  }
+}
+
+
+/*
+ * Measures reading a pretty-printed document token by token and into a
+ * tree, keeping and then dropping the whitespace between elements.
+ */
+static void
+measureIgnoreWhitespace ()
+{
+  const string doc = bench_make_document(40000);
+
+  for (int ignore = 0; ignore < 2; ++ignore)
+  {
+    const string label = ignore ? "pretty, whitespace ignored"
+                                : "pretty, whitespace kept";
+    double start;
+
+    {
+      XMLInputStream stream(doc.c_str(), false);
+      stream.setIgnoreWhitespace(ignore != 0);
+      stream.enableStats();
+
+      start = bench_now();
+      const size_t tokens = countTokens(stream);
+      reportRate(label + " tokens", doc.size(), tokens, bench_now() - start);
+
+      if (ignore)
+      {
+        bench_report(BENCH, label + " runs dropped",
+                     stream.getStats()->getNumWhitespaceDropped(), "");
+      }
+    }
+
+    XMLInputStream stream(doc.c_str(), false);
+    stream.setIgnoreWhitespace(ignore != 0);
+    start = bench_now();
+    XMLNode root(stream);
+    reportRate(label + " tree build", doc.size(), 0, bench_now() - start);
+  }
+}
+
+
+/*
+ * Measures reading doc token by token and into a tree, and writing the
+ * tree back, labelling each result with the name of the shape.
+ */
+static void
+measureShape (BenchShape shape)
+{
+  const string doc       = bench_make_shaped_document(shape, DOC_SIZE);
+  const string shapeName = bench_shape_name(shape);
+
+  double start;
+
+  {
+    XMLInputStream stream(doc.c_str(), false);
+    start = bench_now();
+    const size_t tokens = countTokens(stream);
+    reportRate(shapeName + " tokens", doc.size(), tokens,
+               bench_now() - start);
+  }
+
+  const size_t before = bench_heap_in_use();
+  bench_heap_reset_peak();
+
+  XMLInputStream stream(doc.c_str(), false);
+  start = bench_now();
+  XMLNode root(stream);
+  reportRate(shapeName + " tree build", doc.size(), 0, bench_now() - start);
+  bench_report(BENCH, shapeName + " tree heap peak",
+               (bench_heap_peak() - before) / 1048576.0, "MB");
+
+  start = bench_now();
+  const string text = root.toXMLString();
+  reportRate(shapeName + " toXMLString", text.size(), 0,
+             bench_now() - start);
+
+  {
+    ostringstream oss;
+    XMLOutputStream xos(oss);
+    start = bench_now();
+    xos << root;
+    reportRate(shapeName + " XMLOutputStream", oss.str().size(), 0,
+               bench_now() - start);
+  }
+
+  /* convertStringToXMLNode() takes content without a declaration */
+  const string body = doc.substr(doc.find('\n') + 1);
+  start = bench_now();
+  XMLNode* converted = XMLNode::convertStringToXMLNode(body);
+  reportRate(shapeName + " convertStringToXMLNode", body.size(), 0,
+             bench_now() - start);
+  delete converted;
+
+  if (shape == BENCH_WIDE)       measureStats(doc);
+  if (shape == BENCH_ATTRIBUTES) measureReadInto(doc);
+}
+
+
+/*
+ * Measures reading a file, plain and in each compressed format the
+ * library was built with.
+ */
+static void
+measureFiles ()
+{
+  static const char* extensions[] = { "", ".gz", ".bz2", ".zip" };
+
+  const string doc = bench_make_shaped_document(BENCH_WIDE, DOC_SIZE);
+
+  for (size_t n = 0; n < sizeof(extensions) / sizeof(extensions[0]); ++n)
+  {
+    const string filename = bench_write_file(doc, extensions[n]);
+    if (filename.empty()) continue;
+
+    const string label = string("file") + extensions[n] + " tokens";
+    {
+      XMLInputStream stream(filename.c_str(), true);
+      const double start  = bench_now();
+      const size_t tokens = countTokens(stream);
+      reportRate(label, doc.size(), tokens, bench_now() - start);
+    }
+
+    remove(filename.c_str());
+  }
+}
+
+
+void
+bench_Throughput ()
+{
+  for (int shape = 0; shape < BENCH_NUM_SHAPES; ++shape)
+  {
+    measureShape(static_cast<BenchShape>(shape));
+  }
+
+  measureIgnoreWhitespace();
+
+  measureFiles();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file    BenchXMLBatchParser.cpp
+ * @brief   Documents per second read by XMLBatchParser as threads are added
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <liblx/xml/XMLBatchParser.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH         = "XMLBatchParser";
+static const unsigned int NUM_DOCUMENTS = 5000;
+static const unsigned int NUM_RUNS      = 3;
+
+
+/*
+ * Reports the best rate of several reads of the batch with the given
+ * number of threads.
+ *
+ * @return the best time.
+ */
+static double
+measure (unsigned int threads, const string& doc, double serial)
+{
+  XMLBatchParser batch(threads);
+  for (unsigned int n = 0; n < NUM_DOCUMENTS; ++n) batch.addString(doc);
+
+  double best = 0;
+
+  for (unsigned int run = 0; run < NUM_RUNS; ++run)
+  {
+    const double start = bench_now();
+    batch.parse();
+    const double elapsed = bench_now() - start;
+
+    if (run == 0 || elapsed < best) best = elapsed;
+  }
+
+  ostringstream label;
+  label << threads << " threads ";
+
+  bench_report(BENCH, label.str() + "documents", NUM_DOCUMENTS / best, "/s");
+  if (serial > 0)
+  {
+    bench_report(BENCH, label.str() + "speedup", serial / best, "x");
+  }
+
+  return best;
+}
+
+
+void
+bench_XMLBatchParser ()
+{
+  const string doc = bench_make_document(20);
+
+  const double serial = measure(1, doc, 0);
+
+  unsigned int hardware = thread::hardware_concurrency();
+  if (hardware < 2) hardware = 2;
+
+  for (unsigned int threads = 2; threads <= hardware; threads *= 2)
+  {
+    measure(threads, doc, serial);
+  }
+}
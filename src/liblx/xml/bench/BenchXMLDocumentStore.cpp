@@ -0,0 +1,177 @@
+/**
+ * @file    BenchXMLDocumentStore.cpp
+ * @brief   Traversal and lookup over XMLDocumentStore versus XMLNode
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstring>
+#include <string>
+
+#include <liblx/xml/XMLDocumentStore.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH     = "XMLDocumentStore";
+static const unsigned int NUM_ITEMS = 20000;
+static const unsigned int PASSES    = 50;
+
+
+/*
+ * Full depth-first walk; returns the number of characters seen so the
+ * work cannot be optimised away.
+ */
+static size_t
+walkTree (const XMLNode& node)
+{
+  size_t total = node.isText() ? node.getCharacters().size() : 1;
+
+  for (unsigned int c = 0; c < node.getNumChildren(); ++c)
+  {
+    total += walkTree(node.getChild(c));
+  }
+
+  return total;
+}
+
+
+static size_t
+walkStore (const XMLDocumentStore& store)
+{
+  size_t total = 0;
+
+  for (XMLDocumentStore::const_iterator it = store.begin();
+       it != store.end(); ++it)
+  {
+    total += store.isText(*it) ? strlen(store.getCharacters(*it)) : 1;
+  }
+
+  return total;
+}
+
+
+/*
+ * Finds every <item> and reads its id attribute.
+ */
+static size_t
+lookupTree (const XMLNode& node)
+{
+  size_t total = 0;
+
+  if (node.getName() == "item")
+  {
+    total += node.getAttributes().getValue("id").size();
+  }
+
+  for (unsigned int c = 0; c < node.getNumChildren(); ++c)
+  {
+    total += lookupTree(node.getChild(c));
+  }
+
+  return total;
+}
+
+
+static size_t
+lookupStore (const XMLDocumentStore& store)
+{
+  const unsigned int item = store.findName("item", "http://example.org/bench");
+  const unsigned int id   = store.findName("id");
+  size_t total = 0;
+
+  for (XMLDocumentStore::const_iterator it = store.begin();
+       it != store.end(); ++it)
+  {
+    if (store.getNameId(*it) == item)
+    {
+      total += strlen(store.getAttrValueById(*it, id));
+    }
+  }
+
+  return total;
+}
+
+
+static void
+report (const char* what, double tree, double store)
+{
+  bench_report(BENCH, string(what) + " XMLNode", tree * 1e3, "ms");
+  bench_report(BENCH, string(what) + " store",   store * 1e3, "ms");
+  bench_report(BENCH, string(what) + " speedup", tree / store, "x");
+}
+
+
+void
+bench_XMLDocumentStore ()
+{
+  const string doc = bench_make_document(NUM_ITEMS);
+
+  size_t before = bench_heap_in_use();
+  double start  = bench_now();
+
+  XMLInputStream treeStream(doc.c_str(), false);
+  XMLNode* tree = new XMLNode(treeStream);
+
+  const double treeBuild = bench_now() - start;
+  const size_t treeHeap  = bench_heap_in_use() - before;
+
+  before = bench_heap_in_use();
+  start  = bench_now();
+
+  XMLInputStream storeStream(doc.c_str(), false);
+  XMLDocumentStore* store = new XMLDocumentStore(storeStream);
+
+  const double storeBuild = bench_now() - start;
+  const size_t storeHeap  = bench_heap_in_use() - before;
+
+  report("build", treeBuild, storeBuild);
+  bench_report(BENCH, "heap XMLNode", (double) treeHeap,  "bytes");
+  bench_report(BENCH, "heap store",   (double) storeHeap, "bytes");
+
+  size_t check = 0;
+
+  start = bench_now();
+  for (unsigned int n = 0; n < PASSES; ++n) check += walkTree(*tree);
+  const double treeWalk = (bench_now() - start) / PASSES;
+
+  start = bench_now();
+  for (unsigned int n = 0; n < PASSES; ++n) check -= walkStore(*store);
+  const double storeWalk = (bench_now() - start) / PASSES;
+
+  report("traverse", treeWalk, storeWalk);
+
+  start = bench_now();
+  for (unsigned int n = 0; n < PASSES; ++n) check += lookupTree(*tree);
+  const double treeLookup = (bench_now() - start) / PASSES;
+
+  start = bench_now();
+  for (unsigned int n = 0; n < PASSES; ++n) check -= lookupStore(*store);
+  const double storeLookup = (bench_now() - start) / PASSES;
+
+  report("lookup", treeLookup, storeLookup);
+
+  /* both sides must have seen the same content */
+  if (check != 0) bench_report(BENCH, "MISMATCH", (double) check, "");
+
+  start = bench_now();
+  XMLNode* converted = store->toXMLNode();
+  bench_report(BENCH, "toXMLNode", (bench_now() - start) * 1e3, "ms");
+
+  delete converted;
+  delete store;
+  delete tree;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file    BenchXMLElementFilter.cpp
+ * @brief   Time to skip elements as they are parsed rather than as tokens
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLElementFilter.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLParser.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*  BENCH    = "XMLElementFilter";
+static const size_t DOC_SIZE = 4 * 1048576;
+
+
+/*
+ * Reads the document element of doc and skips its content, token by
+ * token as skipPastEnd() used to, or with skipPastEnd().
+ */
+static double
+measureSkip (const string& doc, const string& library, bool tokens)
+{
+  XMLInputStream stream(doc.c_str(), false, library);
+  const double start = bench_now();
+
+  const XMLToken root = stream.next();
+
+  if (tokens)
+  {
+    while (stream.isGood() && !stream.peek().isEndFor(root)) stream.next();
+    stream.next();
+  }
+  else
+  {
+    stream.skipPastEnd(root);
+  }
+
+  return bench_now() - start;
+}
+
+
+/*
+ * Reads doc into a tree, keeping every element or only the document
+ * element.
+ */
+static double
+measureTree (const string& doc, const string& library,
+             const XMLElementFilter* filter)
+{
+  XMLInputStream stream(doc.c_str(), false, library);
+  stream.setElementFilter(filter);
+
+  const double start = bench_now();
+  XMLNode root(stream);
+
+  return bench_now() - start;
+}
+
+
+void
+bench_XMLElementFilter ()
+{
+  const string doc = bench_make_shaped_document(BENCH_ATTRIBUTES, DOC_SIZE);
+  const double mb  = doc.size() / 1048576.0;
+
+  XMLElementFilter filter;
+  filter.addElement("record");
+
+  const vector<string> libraries = XMLParser::getLibraries();
+
+  for (size_t n = 0; n < libraries.size(); ++n)
+  {
+    const string& library = libraries[n];
+
+    bench_report(BENCH, library + " skip token by token",
+                 mb / measureSkip(doc, library, true), "MB/s");
+    bench_report(BENCH, library + " skipPastEnd",
+                 mb / measureSkip(doc, library, false), "MB/s");
+    bench_report(BENCH, library + " tree, unfiltered",
+                 mb / measureTree(doc, library, NULL), "MB/s");
+    bench_report(BENCH, library + " tree, records filtered",
+                 mb / measureTree(doc, library, &filter), "MB/s");
+  }
+}
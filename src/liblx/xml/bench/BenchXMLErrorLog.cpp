@@ -0,0 +1,109 @@
+/**
+ * @file    BenchXMLErrorLog.cpp
+ * @brief   Cost of creating and logging many XMLErrors
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH      = "XMLErrorLog";
+static const unsigned int NUM_ERRORS = 200000;
+static const unsigned int NUM_QUERY  = 100000;
+
+
+void
+bench_XMLErrorLog ()
+{
+  const string details = "The element <item> is not closed.";
+
+  /* the ids a corrupt feed might produce, most of them repeated */
+  static const int ids[] = { XMLTagMismatch, BadlyFormedXML, 
+                             XMLContentEmpty, UnclosedXMLToken };
+
+  double start = bench_now();
+  for (unsigned int n = 0; n < NUM_ERRORS; ++n)
+  {
+    XMLError error(ids[n % 4], details, n + 1, 1);
+    if (error.getErrorId() == 0) return;
+  }
+  const double create = (bench_now() - start) / NUM_ERRORS;
+
+  bench_report(BENCH, "create error", create * 1e9, "ns");
+
+  const size_t before = bench_heap_in_use();
+  XMLErrorLog log;
+
+  start = bench_now();
+  for (unsigned int n = 0; n < NUM_ERRORS; ++n)
+  {
+    log.add(XMLError(ids[n % 4], details, n + 1, 1));
+  }
+  const double add = (bench_now() - start) / NUM_ERRORS;
+
+  bench_report(BENCH, "create and add error", add * 1e9, "ns");
+  bench_report(BENCH, "log heap", 
+               (bench_heap_in_use() - before) / 1048576.0, "MB");
+
+  start = bench_now();
+  unsigned int found = 0;
+  for (unsigned int n = 0; n < NUM_QUERY; ++n)
+  {
+    found += log.contains(BadXMLDecl) ? 1 : 0;
+    found += log.getNumErrorsWithId(XMLTagMismatch) > 0 ? 1 : 0;
+  }
+  const double query = (bench_now() - start) / NUM_QUERY;
+
+  bench_report(BENCH, "contains and count", query * 1e9, "ns");
+  bench_report(BENCH, "errors logged", log.getNumErrors(), "");
+  if (found != NUM_QUERY) bench_report(BENCH, "unexpected count", found, "");
+
+  log.clearLog();
+
+  /* the same storm into logs that aggregate repeats or keep only the
+   * first errors */
+  XMLErrorLog aggregated;
+  aggregated.setAggregateRepeats(true);
+
+  const size_t beforeAggregated = bench_heap_in_use();
+  start = bench_now();
+  for (unsigned int n = 0; n < NUM_ERRORS; ++n)
+  {
+    aggregated.add(XMLError(ids[n % 4], details, n + 1, 1));
+  }
+  const double addAggregated = (bench_now() - start) / NUM_ERRORS;
+
+  bench_report(BENCH, "add repeated error", addAggregated * 1e9, "ns");
+  bench_report(BENCH, "aggregated log heap", 
+               (bench_heap_in_use() - beforeAggregated) / 1048576.0, "MB");
+
+  XMLErrorLog capped;
+  capped.setMaxErrors(100);
+
+  start = bench_now();
+  for (unsigned int n = 0; n < NUM_ERRORS; ++n)
+  {
+    capped.add(XMLError(ids[n % 4], details, n + 1, 1));
+  }
+  const double addCapped = (bench_now() - start) / NUM_ERRORS;
+
+  bench_report(BENCH, "add error past limit", addCapped * 1e9, "ns");
+  bench_report(BENCH, "errors dropped", capped.getNumDroppedErrors(), "");
+}
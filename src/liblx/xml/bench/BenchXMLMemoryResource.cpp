@@ -0,0 +1,77 @@
+/**
+ * @file    BenchXMLMemoryResource.cpp
+ * @brief   Time to build and free trees from different memory resources
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLMemoryResource.h>
+#include <liblx/xml/XMLNode.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*  BENCH    = "XMLMemoryResource";
+static const size_t DOC_SIZE = 4 * 1048576;
+
+
+/*
+ * Reads doc into a tree allocated from resource and frees it again,
+ * reporting the time each took.
+ */
+static void
+measure (const string& doc, XMLMemoryResource& resource, const string& label)
+{
+  const double start = bench_now();
+
+  XMLInputStream stream(doc.c_str(), false);
+  stream.setMemoryResource(&resource);
+  XMLNode* root = new (resource) XMLNode(stream);
+
+  const double read = bench_now();
+  delete root;
+  const double freed = bench_now();
+
+  bench_report(BENCH, label + " read", (read - start) * 1e3, "ms");
+  bench_report(BENCH, label + " free", (freed - read) * 1e3, "ms");
+}
+
+
+void
+bench_XMLMemoryResource ()
+{
+  for (int shape = 0; shape < BENCH_NUM_SHAPES; ++shape)
+  {
+    const BenchShape s    = static_cast<BenchShape>(shape);
+    const string     doc  = bench_make_shaped_document(s, DOC_SIZE);
+    const string     name = bench_shape_name(s);
+
+    measure(doc, *XMLMemoryResource::getDefault(), name + " default");
+
+    XMLMonotonicResource arena(65536);
+    measure(doc, arena, name + " monotonic");
+    bench_report(BENCH, name + " monotonic reserved",
+                 arena.getBytesReserved() / 1048576.0, "MB");
+
+    XMLCountingResource counter;
+    measure(doc, counter, name + " counting");
+    bench_report(BENCH, name + " allocations",
+                 counter.getNumAllocations(), "");
+    bench_report(BENCH, name + " peak in use",
+                 counter.getPeakBytesInUse() / 1048576.0, "MB");
+  }
+}
@@ -0,0 +1,80 @@
+/**
+ * @file    BenchXMLNodeClone.cpp
+ * @brief   Cost of copying XMLNode trees and of changing the copies
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH     = "XMLNodeClone";
+static const unsigned int NUM_ITEMS = 20000;
+static const unsigned int PASSES    = 1000;
+static const unsigned int DEEP      = 20;
+
+
+void
+bench_XMLNodeClone ()
+{
+  const string doc = bench_make_document(NUM_ITEMS);
+
+  XMLInputStream stream(doc.c_str(), false);
+  XMLNode root(stream);
+
+  double start = bench_now();
+
+  for (unsigned int n = 0; n < DEEP; ++n)
+  {
+    XMLNode* copy = root.clone();
+    delete copy;
+  }
+
+  const double clone = (bench_now() - start) / DEEP;
+
+  bench_report(BENCH, "clone and delete", clone * 1e6, "us");
+
+  size_t before = bench_heap_in_use();
+  start = bench_now();
+
+  for (unsigned int n = 0; n < PASSES; ++n)
+  {
+    XMLNode* copy = root.cloneShared();
+    delete copy;
+  }
+
+  const double shared = (bench_now() - start) / PASSES;
+
+  bench_report(BENCH, "cloneShared and delete", shared * 1e6, "us");
+
+  /* a change to a shared copy copies the nodes on its path only */
+  XMLNode* copy = root.cloneShared();
+  start = bench_now();
+
+  XMLNode& list = copy->getChild("listOfItems");
+  list.getChild(NUM_ITEMS / 2).addAttr("extra", "1");
+
+  const double change = bench_now() - start;
+  const size_t held   = bench_heap_in_use() - before;
+
+  bench_report(BENCH, "first change", change * 1e6, "us");
+  bench_report(BENCH, "heap of changed copy", held / 1024.0, "KB");
+
+  delete copy;
+}
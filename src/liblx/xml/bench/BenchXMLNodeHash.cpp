@@ -0,0 +1,112 @@
+/**
+ * @file    BenchXMLNodeHash.cpp
+ * @brief   XMLNode::equals() and XMLNode::hash() on large trees
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <set>
+#include <string>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH     = "XMLNodeHash";
+static const unsigned int NUM_ITEMS = 20000;
+static const unsigned int PASSES    = 100;
+
+
+/*
+ * Reports the time and heap allocations of one call to a.equals(b), and
+ * of the calls after it, which find the hashes already computed.
+ */
+static void
+compare (const XMLNode& a, const XMLNode& b, const string& label)
+{
+  size_t before = bench_heap_allocations();
+  double start  = bench_now();
+
+  bool equal = a.equals(b);
+
+  const double first       = bench_now() - start;
+  const size_t allocations = bench_heap_allocations() - before;
+
+  start = bench_now();
+  for (unsigned int n = 0; n < PASSES; ++n)
+  {
+    if (a.equals(b) != equal) return;
+  }
+  const double again = (bench_now() - start) / PASSES;
+
+  bench_report(BENCH, label + " first equals", first * 1e3, "ms");
+  bench_report(BENCH, label + " repeated equals", again * 1e3, "ms");
+  bench_report(BENCH, label + " allocations", (double) allocations, "");
+}
+
+
+void
+bench_XMLNodeHash ()
+{
+  const string doc = bench_make_document(NUM_ITEMS);
+
+  XMLInputStream stream(doc.c_str(), false);
+  XMLNode root(stream);
+
+  /* read twice, since a copy would share its subtrees with root */
+  XMLInputStream again(doc.c_str(), false);
+  compare(root, XMLNode(again), "equal trees");
+
+  /* trees differing in their last item */
+  XMLNode changed(root);
+  XMLNode& list = changed.getChild("listOfItems");
+  list.getChild(list.getNumChildren() - 1).addAttr("extra", "1");
+
+  compare(root, changed, "different trees");
+
+  /* a change deep in a tree is rehashed along its path only */
+  XMLNode& item = list.getChild(list.getNumChildren() / 2);
+  double start = bench_now();
+  for (unsigned int n = 0; n < PASSES; ++n)
+  {
+    item.removeAttr("extra");
+    item.addAttr("extra", "1");
+    changed.hash();
+  }
+  const double rehash = (bench_now() - start) / PASSES;
+
+  bench_report(BENCH, "rehash after edit", rehash * 1e3, "ms");
+
+  /* duplicate subtrees found by their hashes */
+  XMLNode copies(root);
+  XMLNode& items = copies.getChild("listOfItems");
+  for (unsigned int n = 0; n < NUM_ITEMS; n += 2)
+  {
+    items.getChild(n).removeAttr("id");
+    items.getChild(n).removeAttr("value");
+  }
+
+  start = bench_now();
+  set<size_t> distinct;
+  for (unsigned int n = 0; n < items.getNumChildren(); ++n)
+  {
+    distinct.insert(items.getChild(n).hash());
+  }
+  const double dedupe = bench_now() - start;
+
+  bench_report(BENCH, "distinct items", (double) distinct.size(), "");
+  bench_report(BENCH, "hash items", dedupe * 1e3, "ms");
+}
@@ -0,0 +1,108 @@
+/**
+ * @file    BenchXMLNodePool.cpp
+ * @brief   Memory and time to read repetitive documents with XMLNodePool
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sstream>
+#include <string>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLNodePool.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH     = "XMLNodePool";
+static const unsigned int NUM_ITEMS = 20000;
+
+
+/*
+ * @return a document of NUM_ITEMS elements, each carrying one of a few
+ * boilerplate annotations.
+ */
+static string
+makeDocument ()
+{
+  ostringstream oss;
+
+  oss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<root xmlns=\"http://example.org/bench\">\n";
+
+  for (unsigned int n = 0; n < NUM_ITEMS; ++n)
+  {
+    oss << "  <item id=\"i" << n << "\">\n"
+        << "    <annotation>\n"
+        << "      <rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\">\n"
+        << "        <rdf:Description rdf:about=\"#meta" << n % 8 << "\">\n"
+        << "          <rdf:li rdf:resource=\"urn:miriam:obo.go:GO%3A0005623\"/>\n"
+        << "          <rdf:li rdf:resource=\"urn:miriam:taxonomy:9606\"/>\n"
+        << "        </rdf:Description>\n"
+        << "      </rdf:RDF>\n"
+        << "    </annotation>\n"
+        << "    <notes><p>Created by the benchmark.</p></notes>\n"
+        << "  </item>\n";
+  }
+
+  oss << "</root>\n";
+
+  return oss.str();
+}
+
+
+/*
+ * Reads doc through pool, or without one if it is NULL, and reports the
+ * time taken and the heap the tree holds.
+ */
+static void
+measure (const string& doc, XMLNodePool* pool, const string& label)
+{
+  const size_t before = bench_heap_in_use();
+  const double start  = bench_now();
+
+  XMLInputStream stream(doc.c_str(), false);
+  XMLNode* root = (pool != NULL) ? new XMLNode(stream, *pool)
+                                 : new XMLNode(stream);
+
+  const double elapsed = bench_now() - start;
+  const size_t held    = bench_heap_in_use() - before;
+
+  bench_report(BENCH, label + " read", elapsed * 1e3, "ms");
+  bench_report(BENCH, label + " heap", held / 1048576.0, "MB");
+  bench_report(BENCH, label + " getMemoryUsage",
+               root->getMemoryUsage() / 1048576.0, "MB");
+
+  delete root;
+}
+
+
+void
+bench_XMLNodePool ()
+{
+  const string doc = makeDocument();
+
+  bench_report(BENCH, "document size", doc.size() / 1048576.0, "MB");
+
+  measure(doc, NULL, "plain");
+
+  XMLNodePool pool;
+  measure(doc, &pool, "pooled");
+
+  bench_report(BENCH, "nodes read", pool.getNumRead(), "");
+  bench_report(BENCH, "nodes shared", pool.getNumShared(), "");
+  bench_report(BENCH, "estimated saving",
+               pool.getBytesSaved() / 1048576.0, "MB");
+}
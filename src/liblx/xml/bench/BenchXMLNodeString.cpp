@@ -0,0 +1,85 @@
+/**
+ * @file    BenchXMLNodeString.cpp
+ * @brief   Time to write XMLNode trees with and without node caching
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLWriterOptions.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH     = "XMLNodeString";
+static const unsigned int NUM_ITEMS = 20000;
+static const unsigned int PASSES    = 10;
+
+
+/*
+ * Reports the average time root.toXMLString(options) takes, changing one
+ * item before each call if edit is true.
+ */
+static void
+measure (XMLNode& root, const XMLWriterOptions& options, bool edit,
+         const string& label)
+{
+  XMLNode& list = root.getChild("listOfItems");
+
+  const double start = bench_now();
+  size_t       bytes = 0;
+
+  for (unsigned int n = 0; n < PASSES; ++n)
+  {
+    if (edit)
+    {
+      XMLNode& item = list.getChild((n * 7919) % NUM_ITEMS);
+      item.removeAttr("edit");
+      item.addAttr("edit", "1");
+    }
+
+    bytes += root.toXMLString(options).size();
+  }
+
+  const double elapsed = (bench_now() - start) / PASSES;
+
+  bench_report(BENCH, label, elapsed * 1e3, "ms");
+  if (bytes == 0) bench_report(BENCH, label + " wrote nothing", 0, "");
+}
+
+
+void
+bench_XMLNodeString ()
+{
+  const string doc = bench_make_document(NUM_ITEMS);
+
+  XMLInputStream stream(doc.c_str(), false);
+  XMLNode root(stream);
+
+  const XMLWriterOptions plain;
+  const XMLWriterOptions cached = plain.withCacheNodes(true);
+
+  measure(root, plain, false, "plain");
+
+  const double start = bench_now();
+  root.toXMLString(cached);
+  bench_report(BENCH, "cached first", (bench_now() - start) * 1e3, "ms");
+
+  measure(root, cached, false, "cached unchanged");
+  measure(root, cached, true,  "cached one change");
+  measure(root, plain,  true,  "plain one change");
+}
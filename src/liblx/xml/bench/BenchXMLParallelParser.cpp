@@ -0,0 +1,107 @@
+/**
+ * @file    BenchXMLParallelParser.cpp
+ * @brief   Tree building time of XMLParallelParser against a serial read
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLParallelParser.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH     = "XMLParallelParser";
+static const unsigned int NUM_ITEMS = 50000;
+static const unsigned int NUM_RUNS  = 3;
+
+
+/*
+ * @return the best time of several serial reads of doc.
+ */
+static double
+measureSerial (const string& doc)
+{
+  double best = 0;
+
+  for (unsigned int run = 0; run < NUM_RUNS; ++run)
+  {
+    const double start = bench_now();
+    {
+      XMLInputStream stream(doc.c_str(), false);
+      XMLNode root(stream);
+    }
+    const double elapsed = bench_now() - start;
+
+    if (run == 0 || elapsed < best) best = elapsed;
+  }
+
+  return best;
+}
+
+
+/*
+ * Reports the best time of several parallel reads of doc, and its
+ * speedup over the serial time.
+ */
+static void
+measureParallel (const string& doc, unsigned int threads, double serial)
+{
+  XMLParallelParser parser(threads);
+  parser.setMinChunkSize(64 * 1024);
+
+  double best = 0;
+
+  for (unsigned int run = 0; run < NUM_RUNS; ++run)
+  {
+    const double start = bench_now();
+    delete parser.parse(doc.c_str(), false);
+    const double elapsed = bench_now() - start;
+
+    if (run == 0 || elapsed < best) best = elapsed;
+  }
+
+  ostringstream label;
+  label << threads << " threads ";
+
+  bench_report(BENCH, label.str() + "time", best * 1e3, "ms");
+  bench_report(BENCH, label.str() + "chunks", parser.getNumChunks(), "");
+  bench_report(BENCH, label.str() + "speedup", serial / best, "x");
+}
+
+
+void
+bench_XMLParallelParser ()
+{
+  /* the items must be children of the document element to be split */
+  string doc = bench_make_document(NUM_ITEMS);
+  doc.erase(doc.find("  <listOfItems>\n"), 16);
+  doc.erase(doc.find("  </listOfItems>\n"), 17);
+
+  const double serial = measureSerial(doc);
+  bench_report(BENCH, "serial time", serial * 1e3, "ms");
+
+  unsigned int hardware = thread::hardware_concurrency();
+  if (hardware < 2) hardware = 2;
+
+  for (unsigned int threads = 2; threads <= hardware; threads *= 2)
+  {
+    measureParallel(doc, threads, serial);
+  }
+}
@@ -0,0 +1,133 @@
+/**
+ * @file    BenchXMLParserPool.cpp
+ * @brief   Small documents per second read with and without XMLParserPool
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLParserPool.h>
+#include <liblx/xml/XMLToken.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH         = "XMLParserPool";
+static const unsigned int NUM_DOCUMENTS = 20000;
+static const unsigned int NUM_RUNS      = 3;
+
+
+/*
+ * Reads every token of doc NUM_DOCUMENTS times, each with a new stream
+ * whose parser comes from pool, or is created afresh if pool is NULL.
+ *
+ * @return the best time of several runs.
+ */
+static double
+measure (const string& doc, const char* library, XMLParserPool* pool,
+         size_t& allocations)
+{
+  double best = 0;
+
+  for (unsigned int run = 0; run < NUM_RUNS; ++run)
+  {
+    const size_t before = bench_heap_allocations();
+    const double start  = bench_now();
+
+    for (unsigned int n = 0; n < NUM_DOCUMENTS; ++n)
+    {
+      XMLInputStream* stream = (pool != NULL)
+        ? new XMLInputStream(doc.c_str(), false, *pool, library)
+        : new XMLInputStream(doc.c_str(), false, library);
+
+      while (stream->isGood()) stream->skipToken();
+      delete stream;
+    }
+
+    const double elapsed = bench_now() - start;
+
+    if (run == 0 || elapsed < best)
+    {
+      best        = elapsed;
+      allocations = bench_heap_allocations() - before;
+    }
+  }
+
+  return best;
+}
+
+
+static void
+compare (const string& doc, const char* library, const string& size)
+{
+  size_t fresh_allocations  = 0;
+  size_t pooled_allocations = 0;
+
+  const double fresh  = measure(doc, library, NULL, fresh_allocations);
+
+  XMLParserPool pool;
+  const double pooled = measure(doc, library, &pool, pooled_allocations);
+
+  const string label = string(library) + " " + size + " ";
+
+  bench_report(BENCH, label + "fresh documents", NUM_DOCUMENTS / fresh, "/s");
+  bench_report(BENCH, label + "pooled documents", NUM_DOCUMENTS / pooled,
+               "/s");
+  bench_report(BENCH, label + "speedup", fresh / pooled, "x");
+  bench_report(BENCH, label + "fresh allocations",
+               (double) fresh_allocations / NUM_DOCUMENTS, "/doc");
+  bench_report(BENCH, label + "pooled allocations",
+               (double) pooled_allocations / NUM_DOCUMENTS, "/doc");
+}
+
+
+void
+bench_XMLParserPool ()
+{
+  /* request-sized payloads of about 1 KB */
+  unsigned int items = 1;
+  string       doc   = bench_make_document(items);
+
+  while (doc.size() < 1024) doc = bench_make_document(++items);
+
+  /* and the smallest, where setting up the parser costs the most */
+  const string tiny = "<?xml version=\"1.0\"?><ok/>";
+
+  bench_report(BENCH, "document size", (double) doc.size(), "bytes");
+
+  const char* libraries[] =
+  {
+#ifdef USE_EXPAT
+    "expat",
+#endif
+#ifdef USE_LIBXML
+    "libxml",
+#endif
+#ifdef USE_XERCES
+    "xerces",
+#endif
+#ifdef USE_NATIVE_PARSER
+    "native",
+#endif
+    NULL
+  };
+
+  for (unsigned int n = 0; libraries[n] != NULL; ++n)
+  {
+    compare(doc,  libraries[n], "1KB");
+    compare(tiny, libraries[n], "tiny");
+  }
+}
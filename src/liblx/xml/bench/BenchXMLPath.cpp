@@ -0,0 +1,109 @@
+/**
+ * @file    BenchXMLPath.cpp
+ * @brief   XMLPath queries versus hand-written XMLNode loops
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+#include <vector>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLPath.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH     = "XMLPath";
+static const unsigned int NUM_ITEMS = 20000;
+static const unsigned int PASSES    = 200;
+
+
+/*
+ * listOfItems/item/name written the way callers do today.
+ */
+static size_t
+namesByLoop (const XMLNode& root)
+{
+  size_t found = 0;
+
+  const XMLNode& list = root.getChild("listOfItems");
+  for (unsigned int n = 0; n < list.getNumChildren(); ++n)
+  {
+    const XMLNode& item = list.getChild(n);
+    if (item.getName() != "item") continue;
+
+    if (item.hasChild("name")) ++found;
+  }
+
+  return found;
+}
+
+
+void
+bench_XMLPath ()
+{
+  const string doc = bench_make_document(NUM_ITEMS);
+
+  XMLInputStream stream(doc.c_str(), false);
+  XMLNode root(stream);
+
+  /* a whole-tree query */
+  XMLPath* names = XMLPath::compile("listOfItems/item/name");
+  size_t check = 0;
+
+  double start = bench_now();
+  for (unsigned int n = 0; n < 10; ++n) check += namesByLoop(root);
+  const double loop = (bench_now() - start) / 10;
+
+  start = bench_now();
+  for (unsigned int n = 0; n < 10; ++n) check -= names->count(root);
+  const double path = (bench_now() - start) / 10;
+
+  bench_report(BENCH, "item/name loop", loop * 1e3, "ms");
+  bench_report(BENCH, "item/name XMLPath", path * 1e3, "ms");
+
+  /*
+   * Repeated lookups of a name among many siblings: getIndex() compares
+   * every child's name, the index answers after the first lookup.
+   */
+  XMLPath* missing = XMLPath::compile("listOfItems/notes");
+  XMLPathIndex index;
+  const XMLNode& list = root.getChild("listOfItems");
+
+  start = bench_now();
+  for (unsigned int n = 0; n < PASSES; ++n)
+  {
+    if (list.getIndex("notes") >= 0) ++check;
+  }
+  const double scan = (bench_now() - start) / PASSES;
+
+  start = bench_now();
+  for (unsigned int n = 0; n < PASSES; ++n) check += missing->count(root);
+  const double plain = (bench_now() - start) / PASSES;
+
+  start = bench_now();
+  for (unsigned int n = 0; n < PASSES; ++n) check += missing->count(root, &index);
+  const double indexed = (bench_now() - start) / PASSES;
+
+  bench_report(BENCH, "wide lookup getIndex", scan * 1e6, "us");
+  bench_report(BENCH, "wide lookup XMLPath", plain * 1e6, "us");
+  bench_report(BENCH, "wide lookup XMLPath+index", indexed * 1e6, "us");
+
+  if (check != 0) bench_report(BENCH, "MISMATCH", (double) check, "");
+
+  delete missing;
+  delete names;
+}
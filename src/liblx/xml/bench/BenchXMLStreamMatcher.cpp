@@ -0,0 +1,84 @@
+/**
+ * @file    BenchXMLStreamMatcher.cpp
+ * @brief   Streaming path matches versus XMLPath over a full XMLNode tree
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLPath.h>
+#include <liblx/xml/XMLStreamMatcher.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH     = "XMLStreamMatcher";
+static const unsigned int NUM_ITEMS = 50000;
+
+
+static int
+countNames (const XMLNode_t* node, unsigned int, void* data)
+{
+  if (node->getNumChildren() > 0) ++*static_cast<size_t*>(data);
+  return 0;
+}
+
+
+void
+bench_XMLStreamMatcher ()
+{
+  const string doc = bench_make_document(NUM_ITEMS);
+  XMLPath* names = XMLPath::compile("/root/listOfItems/item/name");
+  size_t check = 0;
+
+  /* build the whole tree, then query it */
+  size_t base = bench_heap_in_use();
+  bench_heap_reset_peak();
+  double start = bench_now();
+  {
+    XMLInputStream stream(doc.c_str(), false);
+    XMLNode root(stream);
+    check += names->count(root);
+  }
+  const double tree = bench_now() - start;
+  const size_t treePeak = bench_heap_peak() - base;
+
+  /* deliver the matches while reading */
+  base = bench_heap_in_use();
+  bench_heap_reset_peak();
+  start = bench_now();
+  {
+    XMLStreamMatcher matcher(countNames, &check);
+    matcher.addPath(*names);
+
+    XMLInputStream stream(doc.c_str(), false);
+    matcher.run(stream);
+    check -= 2 * matcher.getNumMatches();
+  }
+  const double streamed = bench_now() - start;
+  const size_t streamedPeak = bench_heap_peak() - base;
+
+  bench_report(BENCH, "XMLNode+XMLPath time", tree * 1e3, "ms");
+  bench_report(BENCH, "XMLStreamMatcher time", streamed * 1e3, "ms");
+  bench_report(BENCH, "XMLNode+XMLPath peak heap", treePeak / 1048576.0, "MB");
+  bench_report(BENCH, "XMLStreamMatcher peak heap",
+               streamedPeak / 1048576.0, "MB");
+
+  if (check != 0) bench_report(BENCH, "MISMATCH", (double) check, "");
+
+  delete names;
+}
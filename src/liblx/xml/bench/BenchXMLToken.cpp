@@ -0,0 +1,101 @@
+/**
+ * @file    BenchXMLToken.cpp
+ * @brief   Memory footprint of XMLToken and XMLNode
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <deque>
+#include <string>
+
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLToken.h>
+
+#include "Bench.h"
+
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+
+static const char*        BENCH     = "XMLTokenFootprint";
+static const unsigned int NUM_ITEMS = 20000;
+
+
+/*
+ * Heap bytes held by every token of the document when all of them are
+ * kept alive at once, as a tokenizer with a deep look-ahead would.
+ */
+static void
+measureTokens (const string& doc)
+{
+  deque<XMLToken>* tokens = new deque<XMLToken>;
+
+  XMLInputStream stream(doc.c_str(), false);
+  stream.next();   /* warm up the parser before taking the baseline */
+
+  const size_t before = bench_heap_in_use();
+
+  while (stream.isGood())
+  {
+    tokens->push_back(stream.next());
+    if (tokens->back().isEOF()) break;
+  }
+
+  const size_t used = bench_heap_in_use() - before;
+
+  bench_report(BENCH, "tokens", (double) tokens->size(), "");
+  bench_report(BENCH, "token heap", (double) used, "bytes");
+  bench_report(BENCH, "token heap per token",
+               (double) used / tokens->size(), "bytes");
+
+  delete tokens;
+}
+
+
+/*
+ * Heap bytes held by the XMLNode tree built from the document.
+ */
+static void
+measureTree (const string& doc)
+{
+  XMLInputStream stream(doc.c_str(), false);
+  stream.peek();
+
+  const size_t before = bench_heap_in_use();
+  const size_t allocs = bench_heap_allocations();
+
+  XMLNode* root = new XMLNode(stream);
+
+  const size_t used  = bench_heap_in_use() - before;
+
+  bench_report(BENCH, "tree heap", (double) used, "bytes");
+  bench_report(BENCH, "tree heap per item",
+               (double) used / NUM_ITEMS, "bytes");
+  bench_report(BENCH, "tree allocations",
+               (double) (bench_heap_allocations() - allocs), "");
+
+  delete root;
+}
+
+
+void
+bench_XMLTokenFootprint ()
+{
+  const string doc = bench_make_document(NUM_ITEMS);
+
+  bench_report(BENCH, "sizeof(XMLToken)", (double) sizeof(XMLToken), "bytes");
+  bench_report(BENCH, "sizeof(XMLNode)",  (double) sizeof(XMLNode),  "bytes");
+  bench_report(BENCH, "document size",    (double) doc.size(),       "bytes");
+
+  measureTokens(doc);
+  measureTree(doc);
+}
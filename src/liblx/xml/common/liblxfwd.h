@@ -79,18 +79,78 @@ typedef CLASS_OR_STRUCT XMLErrorLog               XMLErrorLog_t;
  */
 typedef CLASS_OR_STRUCT XMLNode                   XMLNode_t;
 
+/**
+ * @var typedef class XMLDocumentStore XMLDocumentStore_t
+ * @copydoc XMLDocumentStore
+ */
+typedef CLASS_OR_STRUCT XMLDocumentStore          XMLDocumentStore_t;
+
 /**
  * @var typedef class XMLAttributes XMLAttributes_t
  * @copydoc XMLAttributes
  */
 typedef CLASS_OR_STRUCT XMLAttributes             XMLAttributes_t;
 
+/**
+ * @var typedef class XMLBatchParser XMLBatchParser_t
+ * @copydoc XMLBatchParser
+ */
+typedef CLASS_OR_STRUCT XMLBatchParser            XMLBatchParser_t;
+
+/**
+ * @var typedef class XMLElementFilter XMLElementFilter_t
+ * @copydoc XMLElementFilter
+ */
+typedef CLASS_OR_STRUCT XMLElementFilter          XMLElementFilter_t;
+
 /**
  * @var typedef class XMLNamespaces XMLNamespaces_t
  * @copydoc XMLNamespaces
  */
 typedef CLASS_OR_STRUCT XMLNamespaces		  XMLNamespaces_t;
 
+/**
+ * @var typedef class XMLNodePool XMLNodePool_t
+ * @copydoc XMLNodePool
+ */
+typedef CLASS_OR_STRUCT XMLNodePool               XMLNodePool_t;
+
+/**
+ * @var typedef class XMLParallelParser XMLParallelParser_t
+ * @copydoc XMLParallelParser
+ */
+typedef CLASS_OR_STRUCT XMLParallelParser         XMLParallelParser_t;
+
+/**
+ * @var typedef class XMLParseStats XMLParseStats_t
+ * @copydoc XMLParseStats
+ */
+typedef CLASS_OR_STRUCT XMLParseStats             XMLParseStats_t;
+
+/**
+ * @var typedef class XMLParserPool XMLParserPool_t
+ * @copydoc XMLParserPool
+ */
+typedef CLASS_OR_STRUCT XMLParserPool             XMLParserPool_t;
+
+/**
+ * @var typedef class XMLPath XMLPath_t
+ * @copydoc XMLPath
+ */
+typedef CLASS_OR_STRUCT XMLPath                   XMLPath_t;
+
+/**
+ * @var typedef class XMLRecordReader XMLRecordReader_t
+ * @copydoc XMLRecordReader
+ */
+typedef CLASS_OR_STRUCT XMLRecordReader           XMLRecordReader_t;
+
+/**
+ * @var typedef class XMLStreamMatcher XMLStreamMatcher_t
+ * @copydoc XMLStreamMatcher
+ */
+typedef CLASS_OR_STRUCT XMLStreamMatcher          XMLStreamMatcher_t;
+
 /**
  * @var typedef class XMLToken XMLToken_t
  * @copydoc XMLToken
@@ -119,6 +179,12 @@ typedef CLASS_OR_STRUCT XMLOutputStream           XMLOutputStream_t;
  */
 typedef CLASS_OR_STRUCT XMLTriple                 XMLTriple_t;
 
+/**
+ * @var typedef class XMLWriterOptions XMLWriterOptions_t
+ * @copydoc XMLWriterOptions
+ */
+typedef CLASS_OR_STRUCT XMLWriterOptions          XMLWriterOptions_t;
+
 /* FIXME Remove when no longer needed */
 typedef CLASS_OR_STRUCT SBMLNamespaces            SBMLNamespaces_t;
 
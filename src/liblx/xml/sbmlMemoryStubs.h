@@ -9,6 +9,7 @@
 #define SBMLMEMORYSTUBS_H
 
 #include <ctype.h>
+#include <stddef.h>
 
 extern "C"
 char* safe_strdup(const char* s);
@@ -0,0 +1,387 @@
+/**
+ * \file    TestNativeParser.cpp
+ * \brief   NativeParser unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLToken.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+#ifdef USE_NATIVE_PARSER
+
+static const char* xmlstr =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<!DOCTYPE model>\n"
+  "<!-- a comment -->\n"
+  "<model xmlns=\"http://example.org/\" xmlns:x=\"http://x.org/\" id=\"m\">\r\n"
+  "  <x:item x:size=\"1\" name='a &amp; b'/>\n"
+  "  <note>caf\xC3\xA9 &lt;&#233;&#x263A;&gt; <![CDATA[<raw> & ]]>end</note>\n"
+  "  <?target data?>\n"
+  "  <inner xmlns=\"\"><leaf attr=\"a\tb\"/></inner>\n"
+  "</model>\n";
+
+
+/*
+ * @return a description of every token read from content followed by
+ * the ids of the errors logged, or "<none>" if the parser is missing.
+ */
+static string
+describe (const string& content, const string& library, bool positions = true)
+{
+  XMLErrorLog    log;
+  XMLInputStream stream(content.c_str(), false, library, &log);
+
+  if (stream.isError() && log.getNumErrors() == 0) return "<none>";
+
+  ostringstream oss;
+
+  while (stream.isGood())
+  {
+    const XMLToken token = stream.next();
+    if (token.isEOF()) break;
+
+    if (token.isStart()) oss << 'S';
+    if (token.isEnd())   oss << 'E';
+
+    if (token.isElement())
+    {
+      if (positions) oss << ' ' << token.getLine() << ':' << token.getColumn();
+      oss << ' ' << token.getPrefix() << '|' << token.getName()
+          << '|' << token.getURI();
+
+      for (int n = 0; n < token.getAttributesLength(); ++n)
+      {
+        oss << " @" << token.getAttrPrefix(n) << '|' << token.getAttrName(n)
+            << '|' << token.getAttrURI(n) << '=' << token.getAttrValue(n);
+      }
+
+      for (int n = 0; n < token.getNamespacesLength(); ++n)
+      {
+        oss << " ns" << token.getNamespacePrefix(n)
+            << '=' << token.getNamespaceURI(n);
+      }
+    }
+    else
+    {
+      oss << "T[" << token.getCharacters() << ']';
+    }
+
+    oss << '\n';
+  }
+
+  oss << stream.getVersion() << '|' << stream.getEncoding() << '\n';
+
+  for (unsigned int n = 0; n < log.getNumErrors(); ++n)
+  {
+    oss << "error " << log.getError(n)->getErrorId();
+    if (positions)
+    {
+      oss << ' ' << log.getError(n)->getLine()
+          << ':' << log.getError(n)->getColumn();
+    }
+    oss << '\n';
+  }
+
+  return oss.str();
+}
+
+
+/*
+ * @return the id of the first error the native parser logs for content,
+ * or 0 if there is none.
+ */
+static unsigned int
+firstError (const string& content)
+{
+  XMLErrorLog    log;
+  XMLInputStream stream(content.c_str(), false, "native", &log);
+
+  while (stream.isGood()) stream.next();
+
+  return (log.getNumErrors() > 0) ? log.getError(0)->getErrorId() : 0;
+}
+
+
+START_TEST (test_NativeParser_tokens)
+{
+  XMLInputStream stream(xmlstr, false, "native");
+
+  fail_unless( stream.getEncoding() == "" );
+  stream.peek();
+  fail_unless( stream.getVersion()  == "1.0" );
+  fail_unless( stream.getEncoding() == "UTF-8" );
+
+  XMLToken model = stream.next();
+  fail_unless( model.isStart() );
+  fail_unless( model.getName() == "model" );
+  fail_unless( model.getURI()  == "http://example.org/" );
+  fail_unless( model.getNamespacesLength() == 2 );
+  fail_unless( model.getNamespaceURI("x") == "http://x.org/" );
+  fail_unless( model.getAttrValue("id") == "m" );
+  fail_unless( model.getLine() == 4 );
+
+  /* \r\n is read as \n */
+  fail_unless( stream.next().getCharacters() == "\n  " );
+
+  XMLToken item = stream.next();
+  fail_unless( item.isStart() && item.isEnd() );
+  fail_unless( item.getPrefix() == "x" );
+  fail_unless( item.getURI()    == "http://x.org/" );
+  fail_unless( item.getAttrValue("size", "http://x.org/") == "1" );
+  fail_unless( item.getAttrValue("name") == "a & b" );
+
+  stream.skipText();
+  XMLToken note = stream.next();
+  fail_unless( note.getName() == "note" );
+  fail_unless( stream.next().getCharacters()
+               == "caf\xC3\xA9 <\xC3\xA9\xE2\x98\xBA> <raw> & end" );
+  fail_unless( stream.next().isEndFor(note) );
+
+  /* the processing instruction is dropped */
+  fail_unless( stream.next().getCharacters() == "\n  \n  " );
+
+  XMLToken inner = stream.next();
+  fail_unless( inner.getURI() == "" );
+
+  XMLToken leaf = stream.next();
+  fail_unless( leaf.getName() == "leaf" );
+  fail_unless( leaf.getURI()  == "" );
+  fail_unless( leaf.getAttrValue("attr") == "a b" );
+
+  while (stream.isGood()) stream.next();
+
+  fail_unless( stream.isEOF()   == true  );
+  fail_unless( stream.isError() == false );
+}
+END_TEST
+
+
+START_TEST (test_NativeParser_positions)
+{
+  const string doc = "<a>\n  <b x='1'/>\n  <c>\xC3\xA9</c>\n</a>";
+
+  const string expected =
+    "S 1:3 |a|\n"
+    "T[\n  ]\n"
+    "SE 2:11 |b| @|x|=1\n"
+    "T[\n  ]\n"
+    "S 3:5 |c|\n"
+    "T[\xC3\xA9]\n"
+    "E 3:11 |c|\n"
+    "T[\n]\n"
+    "E 4:5 |a|\n"
+    "1.0|\n";
+
+  fail_unless( describe(doc, "native") == expected );
+}
+END_TEST
+
+
+START_TEST (test_NativeParser_errors)
+{
+  fail_unless( firstError("<a><b></a>")         == XMLTagMismatch );
+  fail_unless( firstError("<a x='1' x='2'/>")   == DuplicateXMLAttribute );
+  fail_unless( firstError("<a xmlns:p='u' xmlns:q='u' p:x='1' q:x='2'/>")
+               == 0 );
+  fail_unless( firstError("<a xmlns:p='u' xmlns:p='v'><p:b/></a>")
+               == DuplicateXMLAttribute );
+  fail_unless( firstError("<a xmlns='u' xmlns='v'/>") == DuplicateXMLAttribute );
+  fail_unless( firstError("<a><b xmlns:p='u' xmlns:p='u'/></a>")
+               == DuplicateXMLAttribute );
+  fail_unless( firstError("<a>&foo;</a>")       == UndefinedXMLEntity );
+  fail_unless( firstError("<a>&#0;</a>")        == InvalidCharInXML );
+  fail_unless( firstError("<a>\xFF</a>")        == InvalidCharInXML );
+  fail_unless( firstError("<a>\xC0\x80</a>")    == InvalidCharInXML );
+  fail_unless( firstError("<a>\x01</a>")        == InvalidCharInXML );
+  fail_unless( firstError("<a>]]></a>")         == BadlyFormedXML );
+  fail_unless( firstError("<a")                 == BadlyFormedXML );
+  fail_unless( firstError("<a>")                == BadlyFormedXML );
+  fail_unless( firstError("")                   == BadlyFormedXML );
+  fail_unless( firstError("<a/><b/>")           == BadlyFormedXML );
+  fail_unless( firstError("<a x=1/>")           == BadlyFormedXML );
+  fail_unless( firstError("<a x='<'/>")         == BadlyFormedXML );
+  fail_unless( firstError("<a x='1'y='2'/>")    == BadlyFormedXML );
+  fail_unless( firstError("<!-- x -- y --><a/>") == BadXMLComment );
+  fail_unless( firstError(" <?xml version='1.0'?><a/>")
+               == BadXMLDeclLocation );
+  fail_unless( firstError("<a><?xml version='1.0'?></a>")
+               == BadXMLDeclLocation );
+  fail_unless( firstError("<?xml version='1.0' encoding='ISO-8859-1'?><a/>")
+               == BadXMLDecl );
+  fail_unless( firstError("<?xml version='1.0'?><a/>") == 0 );
+  fail_unless( firstError("<?xml version='1.0' encoding='utf_8'?><a/>") == 0 );
+
+  /* the codes libxml2 gives for the same mistakes */
+  fail_unless( firstError("<a><b c\"d\">e</b><f/></a>") == BadlyFormedXML );
+  fail_unless( firstError("<a x/>")             == MissingXMLAttributeValue );
+  fail_unless( firstError("<a></a:b>")          == XMLTagMismatch );
+  fail_unless( firstError("<list></li")         == XMLTagMismatch );
+  fail_unless( firstError("<list></list")       == BadlyFormedXML );
+  fail_unless( firstError("x<a/>")              == XMLContentEmpty );
+  fail_unless( firstError("<a><!-- x")          == BadXMLComment );
+  fail_unless( firstError("<a><?pi data")       == BadProcessingInstruction );
+  fail_unless( firstError("<?pi?data?><a/>")    == BadlyFormedXML );
+  fail_unless( firstError("<a>&#x;</a>")        == InvalidCharInXML );
+  fail_unless( firstError("<a x='&a&p;'/>")     == UndefinedXMLEntity );
+  fail_unless( firstError("<?xml version='1.x'?><a/>") == BadXMLDecl );
+  fail_unless( firstError("<?xml version='1.0'encoding='UTF-8'?><a/>")
+               == BadlyFormedXML );
+  fail_unless( firstError("<!DOCTYPE a")        == BadXMLDOCTYPE );
+  fail_unless( firstError("<!DOCTYPE a [ x ]><a/>") == BadXMLDOCTYPE );
+  fail_unless( firstError("<!DOCTYPE><a/>")     == BadlyFormedXML );
+  fail_unless( firstError("<!DOCTYPE a PUBLIC 'p' 's' [ ]><a/>") == 0 );
+}
+END_TEST
+
+
+START_TEST (test_NativeParser_errorPosition)
+{
+  const string expected =
+    "S 1:3 |a|\n"
+    "1.0|\n"
+    "error 1009 1:11\n";
+
+  fail_unless( describe("<a><b></a>", "native") == expected );
+  fail_unless( describe("<a x=\"1\" x=\"2\"/>", "native")
+               == "1.0|\nerror 1010 1:15\n" );
+  fail_unless( describe("<a>&foo;</a>", "native")
+               == "1.0|\nerror 1011 1:9\n" );
+
+  /* "xmlns:" with no prefix declares nothing */
+  fail_unless( describe("<a xmlns:=\"u\"><b/></a>", "native")
+               == "S 1:14 |a| @|xmlns:|=u\nSE 1:17 |b|\nE 1:23 |a|\n1.0|\n" );
+}
+END_TEST
+
+
+START_TEST (test_NativeParser_file)
+{
+  /* larger than the parser's buffer, so read in several pieces */
+  const char* filename = "native-parser-test.xml";
+  const string text(20000, 'x');
+
+  {
+    ofstream out(filename);
+    out << "<?xml version=\"1.0\"?>\n<r xmlns:p=\"urn:p\">";
+    for (unsigned int n = 0; n < 2000; ++n)
+    {
+      out << "<p:e n=\"" << n << "\">\xE2\x98\xBA</p:e>";
+    }
+    out << "<t>" << text << "</t></r>\n";
+  }
+
+  XMLInputStream stream(filename, true, "native");
+  XMLToken root = stream.next();
+  fail_unless( root.getName() == "r" );
+
+  unsigned int count = 0;
+  bool         ok    = true;
+
+  while (stream.peek().getName() == "e")
+  {
+    XMLToken e = stream.next();
+    ostringstream n;
+    n << count++;
+    ok = ok && e.getURI() == "urn:p" && e.getAttrValue("n") == n.str()
+            && stream.next().getCharacters() == "\xE2\x98\xBA"
+            && stream.next().isEndFor(e);
+  }
+
+  fail_unless( ok );
+  fail_unless( count == 2000 );
+  fail_unless( stream.next().getName() == "t" );
+  fail_unless( stream.next().getCharacters() == text );
+
+  while (stream.isGood()) stream.next();
+  fail_unless( stream.isEOF() && !stream.isError() );
+
+  remove(filename);
+}
+END_TEST
+
+
+#ifdef USE_LIBXML
+START_TEST (test_NativeParser_sameAsLibXML)
+{
+  const char* docs[] =
+  {
+      xmlstr
+    , "<a>\n  <b x='1'/>\n  <c>\xC3\xA9</c>\n</a>"
+    , "<a xmlns:p=\"\"/>"
+    , "<a><x:b/></a>"
+    , "<a>\xFF</a>"
+    , "<a><b></a>"
+    , "<a>&foo;</a>"
+    , "<a x='1'y='2'/>"
+    , "<a xmlns:p='u' xmlns:p='v'><p:b/></a>"
+    , "<a xmlns='u' xmlns='v'/>"
+    , "<a><b xmlns:p='u' xmlns:p='u'/></a>"
+    , "<a xmlns:=\"u\"><b/></a>"
+    , "<a><b c\"d\">e</b><f/></a>"
+    , "<a x/>"
+    , "<a></a:b>"
+    , "<a><!-- x"
+    , "<a><?pi data"
+    , "<?pi?data?><a/>"
+    , "<a x=\"&a&p;\"/>"
+    , "<?xml version=\"1.0\"encoding=\"UTF-8\"?><a/>"
+    , "<!DOCTYPE a [ x ]><a/>"
+    , "<a xmlns:p='u' xmlns:q='u' p:x='1' q:x='2'/>"
+  };
+
+  for (size_t n = 0; n < sizeof(docs) / sizeof(docs[0]); ++n)
+  {
+    fail_unless( describe(docs[n], "native") == describe(docs[n], "libxml") );
+  }
+}
+END_TEST
+#endif
+
+#endif /* USE_NATIVE_PARSER */
+
+
+Suite *
+create_suite_NativeParser (void)
+{
+  Suite *suite = suite_create("NativeParser");
+  TCase *tcase = tcase_create("NativeParser");
+
+#ifdef USE_NATIVE_PARSER
+  tcase_add_test( tcase, test_NativeParser_tokens );
+  tcase_add_test( tcase, test_NativeParser_positions );
+  tcase_add_test( tcase, test_NativeParser_errors );
+  tcase_add_test( tcase, test_NativeParser_errorPosition );
+  tcase_add_test( tcase, test_NativeParser_file );
+#ifdef USE_LIBXML
+  tcase_add_test( tcase, test_NativeParser_sameAsLibXML );
+#endif
+#endif
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
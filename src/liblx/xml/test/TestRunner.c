@@ -60,6 +60,21 @@ Suite *create_suite_XMLInputStream (void);
 Suite *create_suite_XMLOutputStream (void);
 Suite *create_suite_XMLAttributes_C (void);
 Suite *create_suite_XMLExceptions (void);
+Suite *create_suite_XMLDocumentStore (void);
+Suite *create_suite_XMLPath (void);
+Suite *create_suite_XMLStreamMatcher (void);
+Suite *create_suite_NativeParser (void);
+Suite *create_suite_XMLParallelParser (void);
+Suite *create_suite_XMLRecordReader (void);
+Suite *create_suite_XMLBatchParser (void);
+Suite *create_suite_XMLWriterOptions (void);
+Suite *create_suite_XMLParserPool (void);
+Suite *create_suite_XMLNodePool (void);
+Suite *create_suite_XMLNamePool (void);
+Suite *create_suite_XMLParserBackends (void);
+Suite *create_suite_XMLMemoryResource (void);
+Suite *create_suite_XMLMemoryUsage (void);
+Suite *create_suite_XMLElementFilter (void);
 
 int
 main (int argc, char* argv[]) 
@@ -81,6 +96,21 @@ main (int argc, char* argv[])
   srunner_add_suite(runner, create_suite_XMLOutputStream());
   srunner_add_suite(runner, create_suite_XMLAttributes_C());
   srunner_add_suite(runner, create_suite_XMLExceptions());
+  srunner_add_suite(runner, create_suite_XMLDocumentStore());
+  srunner_add_suite(runner, create_suite_XMLPath());
+  srunner_add_suite(runner, create_suite_XMLStreamMatcher());
+  srunner_add_suite(runner, create_suite_NativeParser());
+  srunner_add_suite(runner, create_suite_XMLParallelParser());
+  srunner_add_suite(runner, create_suite_XMLRecordReader());
+  srunner_add_suite(runner, create_suite_XMLBatchParser());
+  srunner_add_suite(runner, create_suite_XMLWriterOptions());
+  srunner_add_suite(runner, create_suite_XMLParserPool());
+  srunner_add_suite(runner, create_suite_XMLNodePool());
+  srunner_add_suite(runner, create_suite_XMLNamePool());
+  srunner_add_suite(runner, create_suite_XMLParserBackends());
+  srunner_add_suite(runner, create_suite_XMLMemoryResource());
+  srunner_add_suite(runner, create_suite_XMLMemoryUsage());
+  srunner_add_suite(runner, create_suite_XMLElementFilter());
 
   if (argc > 1 && !strcmp(argv[1], "-nofork"))
   {
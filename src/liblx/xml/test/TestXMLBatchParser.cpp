@@ -0,0 +1,224 @@
+/**
+ * \file    TestXMLBatchParser.cpp
+ * \brief   XMLBatchParser unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLBatchParser.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+/*
+ * @return document n of a batch: documents differ in size, and every
+ * tenth one is not well-formed.
+ */
+static string
+makeDocument (unsigned int n)
+{
+  ostringstream oss;
+
+  oss << "<doc xmlns=\"urn:doc\" n=\"" << n << "\">";
+  for (unsigned int i = 0; i < (n % 13) * 20; ++i)
+  {
+    oss << "<item i=\"" << i << "\">" << n * i << "</item>";
+  }
+  oss << ((n % 10 == 9) ? "</dog>" : "</doc>");
+
+  return oss.str();
+}
+
+
+static string
+describeSerially (const string& content)
+{
+  XMLErrorLog    log;
+  XMLInputStream stream(content.c_str(), false, "", &log);
+
+  ostringstream oss;
+  if (stream.peek().isStart())
+  {
+    XMLNode root(stream);
+    oss << root.toXMLString();
+  }
+  while (stream.isGood()) stream.next();
+
+  for (unsigned int n = 0; n < log.getNumErrors(); ++n)
+  {
+    oss << ' ' << log.getError(n)->getErrorId();
+  }
+
+  return oss.str();
+}
+
+
+static string
+describe (const XMLBatchParser& batch, unsigned int n)
+{
+  ostringstream oss;
+
+  if (batch.getDocument(n) != NULL) oss << batch.getDocument(n)->toXMLString();
+
+  const XMLErrorLog* log = batch.getErrorLog(n);
+  for (unsigned int e = 0; e < log->getNumErrors(); ++e)
+  {
+    oss << ' ' << log->getError(e)->getErrorId();
+  }
+
+  return oss.str();
+}
+
+
+START_TEST (test_XMLBatchParser_create)
+{
+  XMLBatchParser batch(3);
+
+  fail_unless( batch.getNumThreads()   == 3 );
+  fail_unless( batch.getNumDocuments() == 0 );
+  fail_unless( batch.parse() == LIBLX_OPERATION_SUCCESS );
+  fail_unless( batch.getDocument(0) == NULL );
+  fail_unless( batch.getErrorLog(0) == NULL );
+  fail_unless( batch.releaseDocument(0) == NULL );
+
+  XMLBatchParser automatic;
+  fail_unless( automatic.getNumThreads() >= 1 );
+}
+END_TEST
+
+
+START_TEST (test_XMLBatchParser_strings)
+{
+  const unsigned int count = 200;
+
+  XMLBatchParser batch(4);
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    fail_unless( batch.addString(makeDocument(n)) == LIBLX_OPERATION_SUCCESS );
+  }
+
+  fail_unless( batch.getNumDocuments() == count );
+  fail_unless( batch.parse() == LIBLX_OPERATION_FAILED );
+  fail_unless( batch.getNumFailed() == count / 10 );
+
+  bool same = true;
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    same = same && describe(batch, n) == describeSerially(makeDocument(n));
+  }
+  fail_unless( same );
+
+  fail_unless( batch.getErrorLog(9)->getError(0)->getErrorId()
+               == XMLTagMismatch );
+  fail_unless( batch.getErrorLog(10)->getNumErrors() == 0 );
+
+  /* reading again replaces the results */
+  fail_unless( batch.parse() == LIBLX_OPERATION_FAILED );
+  fail_unless( batch.getNumFailed() == count / 10 );
+  fail_unless( describe(batch, 3) == describeSerially(makeDocument(3)) );
+}
+END_TEST
+
+
+START_TEST (test_XMLBatchParser_files)
+{
+  const char* names[] = { "batch-test-0.xml", "batch-test-1.xml" };
+
+  for (unsigned int n = 0; n < 2; ++n)
+  {
+    ofstream out(names[n]);
+    out << makeDocument(n + 3);
+  }
+
+  XMLBatchParser batch(2);
+  batch.addFile(names[0]);
+  batch.addFile("no-such-batch-file.xml");
+  batch.addFile(names[1]);
+
+  fail_unless( batch.parse() == LIBLX_OPERATION_FAILED );
+  fail_unless( batch.getNumFailed() == 1 );
+  fail_unless( batch.getDocument(0)->getAttrValue("n") == "3" );
+  fail_unless( batch.getDocument(1) == NULL );
+  fail_unless( batch.getErrorLog(1)->getNumErrors() > 0 );
+  fail_unless( batch.getDocument(2)->getAttrValue("n") == "4" );
+
+  XMLNode* node = batch.releaseDocument(2);
+  fail_unless( node != NULL );
+  fail_unless( batch.getDocument(2) == NULL );
+  fail_unless( batch.releaseDocument(2) == NULL );
+  delete node;
+
+  batch.clear();
+  fail_unless( batch.getNumDocuments() == 0 );
+
+  for (unsigned int n = 0; n < 2; ++n) remove(names[n]);
+}
+END_TEST
+
+
+START_TEST (test_XMLBatchParser_C)
+{
+  XMLBatchParser_t* batch = XMLBatchParser_create(2, NULL);
+
+  fail_unless( XMLBatchParser_addString(batch, "<a><b/></a>")
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLBatchParser_addString(batch, "<a>")
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLBatchParser_addString(batch, NULL) == LIBLX_INVALID_OBJECT );
+  fail_unless( XMLBatchParser_addFile(NULL, "x.xml") == LIBLX_INVALID_OBJECT );
+
+  fail_unless( XMLBatchParser_parse(batch) == LIBLX_OPERATION_FAILED );
+  fail_unless( XMLNode_getNumChildren(XMLBatchParser_getDocument(batch, 0))
+               == 1 );
+  fail_unless( XMLErrorLog_getNumErrors(XMLBatchParser_getErrorLog(batch, 0))
+               == 0 );
+  fail_unless( XMLErrorLog_getNumErrors(XMLBatchParser_getErrorLog(batch, 1))
+               > 0 );
+  fail_unless( XMLBatchParser_getDocument(NULL, 0) == NULL );
+  fail_unless( XMLBatchParser_parse(NULL) == LIBLX_INVALID_OBJECT );
+
+  XMLBatchParser_free(batch);
+  XMLBatchParser_free(NULL);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLBatchParser (void)
+{
+  Suite *suite = suite_create("XMLBatchParser");
+  TCase *tcase = tcase_create("XMLBatchParser");
+
+  tcase_add_test( tcase, test_XMLBatchParser_create );
+  tcase_add_test( tcase, test_XMLBatchParser_strings );
+  tcase_add_test( tcase, test_XMLBatchParser_files );
+  tcase_add_test( tcase, test_XMLBatchParser_C );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
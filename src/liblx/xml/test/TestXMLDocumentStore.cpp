@@ -0,0 +1,200 @@
+/**
+ * \file    TestXMLDocumentStore.cpp
+ * \brief   XMLDocumentStore unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLDocumentStore.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+static const char* xmlstr =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<model xmlns=\"http://example.org/\" xmlns:x=\"http://x.org/\" id=\"m\">\n"
+  "  <listOfItems>\n"
+  "    <item id=\"a\" x:size=\"1\">first</item>\n"
+  "    <item id=\"b\"/>\n"
+  "    <x:note>text</x:note>\n"
+  "  </listOfItems>\n"
+  "</model>\n";
+
+
+START_TEST (test_XMLDocumentStore_read)
+{
+  XMLInputStream stream(xmlstr, false);
+  XMLDocumentStore store(stream);
+
+  /* model, listOfItems, item, "first", item, note, "text" */
+  fail_unless( store.getNumNodes() == 7 );
+  fail_unless( store.getName(0) == "model" );
+  fail_unless( store.getURI(0)  == "http://example.org/" );
+  fail_unless( store.getParent(0) == XMLDocumentStore::npos );
+  fail_unless( store.getNumNamespaces(0) == 2 );
+  fail_unless( strcmp(store.getNamespacePrefix(0, 1), "x") == 0 );
+  fail_unless( strcmp(store.getAttrValue(0, "id"), "m") == 0 );
+
+  fail_unless( store.getNumChildren(1) == 3 );
+  fail_unless( store.getChild(1, 0) == 2 );
+  fail_unless( store.getChild(1, 1) == 4 );
+  fail_unless( store.getChild(1, 2) == 5 );
+  fail_unless( store.getChild(1, 3) == XMLDocumentStore::npos );
+
+  fail_unless( store.isText(3) );
+  fail_unless( strcmp(store.getCharacters(3), "first") == 0 );
+  fail_unless( store.getParent(3) == 2 );
+  fail_unless( strcmp(store.getAttrValue(2, "size", "http://x.org/"), "1") == 0 );
+  fail_unless( store.getAttrValue(2, "size") == NULL );
+
+  fail_unless( store.getPrefix(5) == "x" );
+  fail_unless( store.getName(5) == "note" );
+
+  /* both item elements share a name id */
+  unsigned int item = store.findName("item", "http://example.org/");
+  fail_unless( item != XMLDocumentStore::npos );
+  fail_unless( store.getNameId(2) == item );
+  fail_unless( store.getNameId(4) == item );
+  fail_unless( store.findName("item") == XMLDocumentStore::npos );
+
+  unsigned int id = store.findName("id");
+  fail_unless( strcmp(store.getAttrValueById(4, id), "b") == 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLDocumentStore_iterate)
+{
+  XMLInputStream stream(xmlstr, false);
+  XMLDocumentStore store(stream);
+
+  unsigned int count = 0;
+  for (XMLDocumentStore::const_iterator it = store.begin();
+       it != store.end(); ++it)
+  {
+    fail_unless( *it == count );
+    ++count;
+  }
+  fail_unless( count == 7 );
+
+  /* the subtree of the first item is the item and its text */
+  count = 0;
+  for (XMLDocumentStore::const_iterator it = store.begin(2);
+       it != store.end(2); ++it)
+  {
+    ++count;
+  }
+  fail_unless( count == 2 );
+
+  /* the last element's subtree ends at the end of the store */
+  fail_unless( *store.end(5) == 7 );
+  fail_unless( *store.end(1) == 7 );
+}
+END_TEST
+
+
+START_TEST (test_XMLDocumentStore_roundTrip)
+{
+  XMLInputStream stream(xmlstr, false);
+  XMLNode node(stream);
+
+  XMLDocumentStore store(node);
+  XMLNode* copy = store.toXMLNode();
+
+  fail_unless( copy != NULL );
+  fail_unless( copy->toXMLString() == node.toXMLString() );
+  fail_unless( copy->equals(node, true) );
+
+  XMLNode* item = store.toXMLNode(4);
+  fail_unless( item->toXMLString() == "<item id=\"b\"/>" );
+
+  fail_unless( store.toXMLNode(7) == NULL );
+
+  delete item;
+  delete copy;
+}
+END_TEST
+
+
+START_TEST (test_XMLDocumentStore_dummyRoot)
+{
+  XMLNode* node = XMLNode::convertStringToXMLNode("<p>one</p><p>two</p>");
+  fail_unless( node->isEOF() );
+
+  XMLDocumentStore store(*node);
+  fail_unless( store.getNumNodes() == 4 );
+  fail_unless( store.getNextSibling(0) == 2 );
+  fail_unless( *store.end(0) == 2 );
+
+  XMLNode* copy = store.toXMLNode();
+  fail_unless( copy->isEOF() );
+  fail_unless( copy->getNumChildren() == 2 );
+  fail_unless( copy->toXMLString() == node->toXMLString() );
+
+  delete copy;
+  delete node;
+}
+END_TEST
+
+
+START_TEST (test_XMLDocumentStore_empty)
+{
+  XMLDocumentStore store;
+
+  fail_unless( store.isEmpty() );
+  fail_unless( store.toXMLNode() == NULL );
+  fail_unless( store.begin() == store.end() );
+  fail_unless( store.getName(0) == "" );
+  fail_unless( store.getNumAttributes(0) == 0 );
+  fail_unless( store.getParent(0) == XMLDocumentStore::npos );
+}
+END_TEST
+
+
+START_TEST (test_XMLDocumentStore_accessWithNULL)
+{
+  fail_unless( XMLDocumentStore_createFromStream(NULL) == NULL );
+  fail_unless( XMLDocumentStore_createFromNode(NULL) == NULL );
+  fail_unless( XMLDocumentStore_toXMLNode(NULL) == NULL );
+  fail_unless( XMLDocumentStore_getNumNodes(NULL) == 0 );
+  fail_unless( XMLDocumentStore_getName(NULL, 0) == NULL );
+  fail_unless( XMLDocumentStore_getCharacters(NULL, 0) == NULL );
+  fail_unless( XMLDocumentStore_getAttrValue(NULL, 0, "id") == NULL );
+
+  XMLDocumentStore_free(NULL);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLDocumentStore (void)
+{
+  Suite *suite = suite_create("XMLDocumentStore");
+  TCase *tcase = tcase_create("XMLDocumentStore");
+
+  tcase_add_test( tcase, test_XMLDocumentStore_read );
+  tcase_add_test( tcase, test_XMLDocumentStore_iterate );
+  tcase_add_test( tcase, test_XMLDocumentStore_roundTrip );
+  tcase_add_test( tcase, test_XMLDocumentStore_dummyRoot );
+  tcase_add_test( tcase, test_XMLDocumentStore_empty );
+  tcase_add_test( tcase, test_XMLDocumentStore_accessWithNULL );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
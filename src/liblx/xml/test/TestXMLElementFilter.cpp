@@ -0,0 +1,253 @@
+/**
+ * \file    TestXMLElementFilter.cpp
+ * \brief   XMLElementFilter and parse-time skipping unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLElementFilter.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLParser.h>
+#include <liblx/xml/operationReturnValues.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+static const char* document =
+  "<list xmlns=\"urn:list\" xmlns:x=\"urn:x\">"
+  "<item id=\"1\">one<notes><p>a <b>note</b></p></notes></item>"
+  "<x:extra><item id=\"hidden\"/></x:extra>"
+  "<item id=\"2\">two</item>"
+  "</list>";
+
+
+/*
+ * @return a document whose <skip> element is long enough to be parsed
+ * well after the stream has read ahead, and nests elements of its own name.
+ */
+static string
+makeLongDocument ()
+{
+  ostringstream oss;
+  oss << "<doc><first/><skip>";
+  for (unsigned int n = 0; n < 5000; ++n)
+  {
+    oss << "<skip n=\"" << n << "\">text &amp; more</skip><other/>";
+  }
+  oss << "</skip><last id=\"end\"/></doc>";
+  return oss.str();
+}
+
+
+START_TEST (test_XMLElementFilter_create)
+{
+  XMLElementFilter filter;
+
+  fail_unless( filter.isEmpty() );
+  fail_unless( !filter.getKeepListed() );
+  fail_unless( !filter.skips("a", "") );
+
+  fail_unless( filter.addElement("")  == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( filter.addElement("a") == LIBLX_OPERATION_SUCCESS );
+  fail_unless( filter.addElement("b", "urn:b") == LIBLX_OPERATION_SUCCESS );
+  fail_unless( filter.addNamespace("urn:n") == LIBLX_OPERATION_SUCCESS );
+
+  fail_unless( !filter.isEmpty() );
+  fail_unless(  filter.skips("a", "") );
+  fail_unless(  filter.skips("a", "urn:any") );
+  fail_unless(  filter.skips("b", "urn:b") );
+  fail_unless( !filter.skips("b", "") );
+  fail_unless(  filter.skips("c", "urn:n") );
+  fail_unless( !filter.skips("c", "") );
+
+  XMLElementFilter keep(true);
+  keep.addElement("a");
+
+  fail_unless(  keep.getKeepListed() );
+  fail_unless( !keep.skips("a", "") );
+  fail_unless(  keep.skips("b", "") );
+
+  filter.clear();
+  fail_unless( filter.isEmpty() );
+  fail_unless( !filter.skips("a", "") );
+}
+END_TEST
+
+
+START_TEST (test_XMLElementFilter_skipListed)
+{
+  XMLElementFilter filter;
+  filter.addElement("notes");
+  filter.addNamespace("urn:x");
+
+  const vector<string> libraries = XMLParser::getLibraries();
+
+  for (size_t n = 0; n < libraries.size(); ++n)
+  {
+    XMLInputStream stream(document, false, libraries[n]);
+    stream.setElementFilter(&filter);
+
+    fail_unless( stream.getElementFilter() != NULL );
+    fail_unless( stream.getElementFilter() != &filter );
+
+    XMLNode root(stream);
+
+    fail_unless( !stream.isError() );
+    fail_unless( root.getNumChildren() == 2 );
+    fail_unless( root.getChild(0).getNumChildren() == 1 );
+    fail_unless( root.getChild(0).getChild(0).getCharacters() == "one" );
+    fail_unless( root.getChild(1).getAttributes().getValue("id") == "2" );
+  }
+}
+END_TEST
+
+
+START_TEST (test_XMLElementFilter_keepListed)
+{
+  XMLElementFilter filter(true);
+  filter.addElement("list", "urn:list");
+  filter.addElement("item");
+
+  XMLInputStream stream(document, false);
+  stream.setElementFilter(&filter);
+  XMLNode root(stream);
+
+  /* the item inside x:extra goes with it */
+  fail_unless( root.getNumChildren() == 2 );
+  fail_unless( root.getChild(0).getNumChildren() == 1 );
+  fail_unless( root.getChild(1).getChild(0).getCharacters() == "two" );
+
+  /* with no filter, nothing is skipped */
+  XMLInputStream plain(document, false);
+  plain.setElementFilter(&filter);
+  plain.setElementFilter(NULL);
+
+  fail_unless( plain.getElementFilter() == NULL );
+  fail_unless( XMLNode(plain).getNumChildren() == 3 );
+}
+END_TEST
+
+
+START_TEST (test_XMLElementFilter_skipPastEnd)
+{
+  const string doc = makeLongDocument();
+  const vector<string> libraries = XMLParser::getLibraries();
+
+  for (size_t n = 0; n < libraries.size(); ++n)
+  {
+    XMLInputStream stream(doc.c_str(), false, libraries[n]);
+    stream.enableStats();
+
+    fail_unless( stream.next().getName() == "doc" );
+    fail_unless( stream.next().getName() == "first" );
+
+    const XMLToken skip = stream.next();
+    fail_unless( skip.getName() == "skip" );
+
+    stream.skipPastEnd(skip);
+
+    /* the nested elements of the same name do not end it */
+    const XMLToken last = stream.next();
+    fail_unless( last.getName() == "last" );
+    fail_unless( last.getAttrValue("id") == "end" );
+    fail_unless( !stream.isError() );
+
+    /* most of the element was never made into tokens */
+    fail_unless( stream.getStats()->getNumTokens() < 5000 );
+
+    stream.next();
+    fail_unless( stream.peek().isEOF() );
+    fail_unless( !stream.isError() );
+  }
+}
+END_TEST
+
+
+START_TEST (test_XMLElementFilter_skipPastEndPeeked)
+{
+  XMLInputStream stream("<a><b><b/><c/></b><d/></a>", false);
+
+  stream.next();
+  stream.skipPastEnd(stream.peek());
+
+  fail_unless( stream.next().getName() == "d" );
+
+  /* an end element leaves the stream as it is */
+  XMLToken end(XMLTriple("a", "", ""));
+  end.setEnd();
+  stream.skipPastEnd(end);
+
+  fail_unless( stream.peek().isEnd() );
+  fail_unless( stream.peek().getName() == "a" );
+}
+END_TEST
+
+
+START_TEST (test_XMLElementFilter_C)
+{
+  fail_unless( XMLElementFilter_addElement(NULL, "a", NULL) == LIBLX_INVALID_OBJECT );
+  fail_unless( XMLElementFilter_addNamespace(NULL, "urn:a") == LIBLX_INVALID_OBJECT );
+  fail_unless( XMLElementFilter_skips(NULL, "a", "") == 0 );
+  XMLElementFilter_free(NULL);
+  XMLInputStream_setElementFilter(NULL, NULL);
+
+  XMLElementFilter_t *filter = XMLElementFilter_create(0);
+
+  fail_unless( XMLElementFilter_addElement(filter, "notes", NULL)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLElementFilter_addElement(filter, "extra", "urn:x")
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLElementFilter_skips(filter, "notes", "urn:list") == 1 );
+  fail_unless( XMLElementFilter_skips(filter, "extra", "") == 0 );
+
+  XMLInputStream_t *stream = XMLInputStream_create(document, 0, "");
+  XMLInputStream_setElementFilter(stream, filter);
+  XMLElementFilter_free(filter);
+
+  XMLNode root(*stream);
+
+  fail_unless( root.getNumChildren() == 2 );
+  fail_unless( root.getChild(0).getNumChildren() == 1 );
+
+  XMLInputStream_free(stream);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLElementFilter (void)
+{
+  Suite *suite = suite_create("XMLElementFilter");
+  TCase *tcase = tcase_create("XMLElementFilter");
+
+  tcase_add_test( tcase, test_XMLElementFilter_create );
+  tcase_add_test( tcase, test_XMLElementFilter_skipListed );
+  tcase_add_test( tcase, test_XMLElementFilter_keepListed );
+  tcase_add_test( tcase, test_XMLElementFilter_skipPastEnd );
+  tcase_add_test( tcase, test_XMLElementFilter_skipPastEndPeeked );
+  tcase_add_test( tcase, test_XMLElementFilter_C );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
@@ -43,6 +43,8 @@
 
 #include <limits>
 
+#include <XMLErrorLog.h>
+
 #include <check.h>
 #include <XMLError.h>
 #include <operationReturnValues.h>
@@ -75,6 +77,18 @@ START_TEST (test_XMLError_create)
   fail_unless( error->getShortMessage()  == "Duplicate attribute" );
   delete error;
 
+  error = new XMLError(XMLTagMismatch, "Expected </a>.");
+  fail_unless( error->getMessage()  == 
+               "Element tag mismatch or missing tag. Expected </a>.\n" );
+  fail_unless( error->getShortMessage()  == "XML tag mismatch" );
+  delete error;
+
+  /* a code in the XML range that the table lacks */
+  error = new XMLError(2000);
+  fail_unless( error->getShortMessage()  == "Unknown error" );
+  fail_unless( error->getSeverity() == LIBLX_SEV_WARNING );
+  delete error;
+
   error = new XMLError(12345, "My message");
   fail_unless( error->getErrorId()  == 12345 );
   fail_unless( error->getMessage()  == "My message" );
@@ -131,6 +145,36 @@ START_TEST (test_XMLError_setters)
 END_TEST
 
 
+START_TEST (test_XMLError_lazyText)
+{
+  XMLError error(XMLTagMismatch, "At <a>.");
+  XMLError copy(error);
+
+  /* copies compose the same text as the original, before or after it */
+  fail_unless( copy.getMessage() == 
+    "Element tag mismatch or missing tag. At <a>.\n" );
+  fail_unless( error.getMessage() == copy.getMessage() );
+  fail_unless( error.getShortMessage() == "XML tag mismatch" );
+
+  XMLError assigned;
+  fail_unless( assigned.getShortMessage() == "Unknown error" );
+  assigned = error;
+  fail_unless( assigned.getShortMessage() == "XML tag mismatch" );
+  fail_unless( assigned.getSeverityAsString() == "Error" );
+
+  /* the names follow changes the log makes to the severity */
+  XMLErrorLog log;
+  log.setSeverityOverride(LIBSBXML_OVERRIDE_WARNING);
+  log.add(error);
+  fail_unless( log.getError(0)->getSeverityAsString() == "Warning" );
+
+  log.changeErrorSeverity(LIBLX_SEV_WARNING, LIBLX_SEV_FATAL);
+  fail_unless( log.getError(0)->getSeverityAsString() == "Fatal" );
+  fail_unless( log.getError(0)->getMessage() == error.getMessage() );
+}
+END_TEST
+
+
 Suite *
 create_suite_XMLError (void)
 {
@@ -139,6 +183,7 @@ create_suite_XMLError (void)
 
   tcase_add_test( tcase, test_XMLError_create  );
   tcase_add_test( tcase, test_XMLError_setters  );
+  tcase_add_test( tcase, test_XMLError_lazyText  );
   suite_add_tcase(suite, tcase);
 
   return suite;
@@ -37,6 +37,7 @@
 #include <liblx/xml/common/common.h>
 #include <liblx/xml/XMLError.h>
 #include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
 
 #include <check.h>
 
@@ -93,6 +94,260 @@ START_TEST (test_XMLErrorLog_clear)
 }
 END_TEST
 
+START_TEST (test_XMLErrorLog_counts)
+{
+  XMLErrorLog_t *log = XMLErrorLog_create();
+  XMLError_t* tag    = XMLError_createWithIdAndMessage(XMLTagMismatch, "");
+  XMLError_t* memory = XMLError_createWithIdAndMessage(XMLOutOfMemory, "");
+
+  XMLErrorLog_add( log, tag );
+  XMLErrorLog_add( log, memory );
+  XMLErrorLog_add( log, tag );
+
+  fail_unless( XMLErrorLog_getNumErrorsWithId(log, XMLTagMismatch) == 2 );
+  fail_unless( XMLErrorLog_getNumErrorsWithId(log, XMLOutOfMemory) == 1 );
+  fail_unless( XMLErrorLog_getNumErrorsWithId(log, BadXMLDecl)     == 0 );
+  fail_unless( XMLErrorLog_getNumLoggedWithId(log, XMLTagMismatch) == 2 );
+
+  fail_unless( XMLErrorLog_getNumErrorsWithSeverity(log, LIBLX_SEV_ERROR) 
+               == 2 );
+  fail_unless( XMLErrorLog_getNumErrorsWithSeverity(log, LIBLX_SEV_FATAL) 
+               == 1 );
+  fail_unless( XMLErrorLog_getNumErrorsWithSeverity(log, 99) == 0 );
+  fail_unless( XMLErrorLog_getNumLoggedWithSeverity(log, LIBLX_SEV_ERROR) 
+               == 2 );
+  fail_unless( XMLErrorLog_getNumLoggedWithSeverity(log, 99) == 0 );
+
+  fail_unless( log->contains(XMLTagMismatch) );
+  fail_unless( !log->contains(BadXMLDecl) );
+  fail_unless( log->getFirstErrorWithId(XMLOutOfMemory) 
+               == XMLErrorLog_getError(log, 1) );
+  fail_unless( log->getFirstErrorWithId(BadXMLDecl) == NULL );
+
+  log->changeErrorSeverity(LIBLX_SEV_ERROR, LIBLX_SEV_WARNING);
+  fail_unless( XMLErrorLog_getNumErrorsWithSeverity(log, LIBLX_SEV_ERROR) 
+               == 0 );
+  fail_unless( XMLErrorLog_getNumErrorsWithSeverity(log, LIBLX_SEV_WARNING) 
+               == 2 );
+
+  XMLErrorLog_clearLog(log);
+  fail_unless( XMLErrorLog_getNumErrorsWithId(log, XMLTagMismatch) == 0 );
+  fail_unless( !log->contains(XMLTagMismatch) );
+
+  fail_unless( XMLErrorLog_getNumErrorsWithId(NULL, XMLTagMismatch) == 0 );
+  fail_unless( XMLErrorLog_getNumLoggedWithId(NULL, XMLTagMismatch) == 0 );
+  fail_unless( XMLErrorLog_getNumErrorsWithSeverity(NULL, 0) == 0 );
+  fail_unless( XMLErrorLog_getNumLoggedWithSeverity(NULL, 0) == 0 );
+
+  XMLError_free(tag);
+  XMLError_free(memory);
+  XMLErrorLog_free(log);
+}
+END_TEST
+
+START_TEST (test_XMLErrorLog_storm)
+{
+  XMLErrorLog_t *log = XMLErrorLog_create();
+  XMLError_t* tag    = XMLError_createWithIdAndMessage(XMLTagMismatch, "a");
+  XMLError_t* other  = XMLError_createWithIdAndMessage(XMLTagMismatch, "b");
+  XMLError_t* memory = XMLError_createWithIdAndMessage(XMLOutOfMemory, "");
+
+  /* repeats of the same id and message are stored once */
+  XMLErrorLog_setAggregateRepeats( log, 1 );
+  XMLErrorLog_add( log, tag );
+  XMLErrorLog_add( log, other );
+  XMLErrorLog_add( log, tag );
+  XMLErrorLog_add( log, tag );
+
+  fail_unless( XMLErrorLog_getNumErrors(log) == 2 );
+  fail_unless( XMLErrorLog_getNumOccurrences(log, 0) == 3 );
+  fail_unless( XMLErrorLog_getNumOccurrences(log, 1) == 1 );
+  fail_unless( XMLErrorLog_getNumOccurrences(log, 2) == 0 );
+  fail_unless( XMLErrorLog_getNumErrorsWithId(log, XMLTagMismatch) == 2 );
+  fail_unless( XMLErrorLog_getNumLoggedWithId(log, XMLTagMismatch) == 4 );
+
+  /* errors past the limit are counted but not stored */
+  XMLErrorLog_setMaxErrors( log, 2 );
+  XMLErrorLog_add( log, memory );
+  XMLErrorLog_add( log, memory );
+  XMLErrorLog_add( log, tag );
+
+  fail_unless( XMLErrorLog_getNumErrors(log) == 2 );
+  fail_unless( XMLErrorLog_getNumDroppedErrors(log) == 2 );
+  fail_unless( XMLErrorLog_getNumOccurrences(log, 0) == 4 );
+  fail_unless( XMLErrorLog_getNumErrorsWithId(log, XMLOutOfMemory) == 0 );
+  fail_unless( XMLErrorLog_getNumLoggedWithId(log, XMLOutOfMemory) == 2 );
+  fail_unless( !log->contains(XMLOutOfMemory) );
+  fail_unless( log->getFirstErrorWithId(XMLOutOfMemory) == NULL );
+
+  /* copies keep the settings and counts */
+  XMLErrorLog copy(*log);
+  fail_unless( copy.getNumErrors() == 2 );
+  fail_unless( copy.getMaxErrors() == 2 );
+  fail_unless( copy.getAggregateRepeats() );
+  fail_unless( copy.getNumDroppedErrors() == 2 );
+  fail_unless( copy.getNumOccurrences(0) == 4 );
+
+  XMLErrorLog_clearLog(log);
+  fail_unless( XMLErrorLog_getNumDroppedErrors(log) == 0 );
+  fail_unless( XMLErrorLog_getNumOccurrences(log, 0) == 0 );
+
+  XMLErrorLog_add( log, memory );
+  fail_unless( XMLErrorLog_getNumErrors(log) == 1 );
+
+  fail_unless( XMLErrorLog_getNumDroppedErrors(NULL) == 0 );
+  fail_unless( XMLErrorLog_getNumOccurrences(NULL, 0) == 0 );
+
+  XMLError_free(tag);
+  XMLError_free(other);
+  XMLError_free(memory);
+  XMLErrorLog_free(log);
+}
+END_TEST
+
+
+static int
+countErrors (const XMLError_t* error, void* userData)
+{
+  unsigned int* count = static_cast<unsigned int*>(userData);
+  ++*count;
+
+  return XMLError_isFatal(error);
+}
+
+
+START_TEST (test_XMLErrorLog_callback)
+{
+  XMLErrorLog_t *log = XMLErrorLog_create();
+  XMLError_t* tag    = XMLError_createWithIdAndMessage(XMLTagMismatch, "");
+  XMLError_t* memory = XMLError_createWithIdAndMessage(XMLOutOfMemory, "");
+  unsigned int count = 0;
+
+  /* errors go to the callback instead of the log */
+  XMLErrorLog_setCallback( log, countErrors, &count );
+  XMLErrorLog_add( log, tag );
+  XMLErrorLog_add( log, tag );
+
+  fail_unless( count == 2 );
+  fail_unless( XMLErrorLog_getNumErrors(log) == 0 );
+  fail_unless( XMLErrorLog_getNumErrorsWithId(log, XMLTagMismatch) == 0 );
+  fail_unless( XMLErrorLog_getNumLoggedWithId(log, XMLTagMismatch) == 2 );
+  fail_unless( !log->contains(XMLTagMismatch) );
+  fail_unless( !XMLErrorLog_isStopRequested(log) );
+
+  XMLErrorLog_add( log, memory );
+  fail_unless( count == 3 );
+  fail_unless( XMLErrorLog_isStopRequested(log) );
+
+  XMLErrorLog_clearLog(log);
+  XMLErrorLog_setCallback( log, NULL, NULL );
+  fail_unless( !XMLErrorLog_isStopRequested(log) );
+
+  /* a threshold stops at the given number of errors of a severity */
+  XMLErrorLog_setStopThreshold( log, 2, LIBLX_SEV_ERROR );
+  XMLErrorLog_add( log, tag );
+  fail_unless( !XMLErrorLog_isStopRequested(log) );
+  XMLErrorLog_add( log, memory );
+  fail_unless( XMLErrorLog_isStopRequested(log) );
+
+  fail_unless( XMLErrorLog_isStopRequested(NULL) == 0 );
+  XMLErrorLog_setCallback( NULL, countErrors, NULL );
+  XMLErrorLog_setStopThreshold( NULL, 1, LIBLX_SEV_ERROR );
+
+  XMLError_free(tag);
+  XMLError_free(memory);
+  XMLErrorLog_free(log);
+}
+END_TEST
+
+
+START_TEST (test_XMLErrorLog_changeSeverityCounts)
+{
+  XMLErrorLog_t *log = XMLErrorLog_create();
+  XMLError_t* tag    = XMLError_createWithIdAndMessage(XMLTagMismatch, "");
+  unsigned int count = 0;
+
+  /* every repeat of an aggregated error moves */
+  XMLErrorLog_setAggregateRepeats( log, 1 );
+  XMLErrorLog_add( log, tag );
+  XMLErrorLog_add( log, tag );
+  XMLErrorLog_add( log, tag );
+
+  log->changeErrorSeverity(LIBLX_SEV_ERROR, LIBLX_SEV_WARNING);
+  XMLErrorLog_setStopThreshold( log, 2, LIBLX_SEV_ERROR );
+
+  fail_unless( XMLErrorLog_getNumLoggedWithSeverity(log, LIBLX_SEV_ERROR) 
+               == 0 );
+  fail_unless( XMLErrorLog_getNumLoggedWithSeverity(log, LIBLX_SEV_WARNING) 
+               == 3 );
+  fail_unless( XMLErrorLog_getNumErrorsWithSeverity(log, LIBLX_SEV_WARNING) 
+               == 1 );
+  fail_unless( !XMLErrorLog_isStopRequested(log) );
+
+  /* so do errors dropped once the log is full */
+  XMLErrorLog_clearLog(log);
+  XMLErrorLog_setAggregateRepeats( log, 0 );
+  XMLErrorLog_setMaxErrors( log, 1 );
+  XMLErrorLog_add( log, tag );
+  XMLErrorLog_add( log, tag );
+  XMLErrorLog_add( log, tag );
+
+  fail_unless( XMLErrorLog_getNumDroppedErrors(log) == 2 );
+  log->changeErrorSeverity(LIBLX_SEV_ERROR, LIBLX_SEV_WARNING, "core");
+  fail_unless( XMLErrorLog_getNumLoggedWithSeverity(log, LIBLX_SEV_ERROR) 
+               == 3 );
+  log->changeErrorSeverity(LIBLX_SEV_ERROR, LIBLX_SEV_WARNING);
+  fail_unless( XMLErrorLog_getNumLoggedWithSeverity(log, LIBLX_SEV_ERROR) 
+               == 0 );
+  fail_unless( XMLErrorLog_getNumLoggedWithSeverity(log, LIBLX_SEV_WARNING) 
+               == 3 );
+  fail_unless( XMLErrorLog_getNumErrorsWithSeverity(log, LIBLX_SEV_WARNING) 
+               == 1 );
+  fail_unless( XMLErrorLog_getNumErrorsWithSeverity(log, LIBLX_SEV_ERROR) 
+               == 0 );
+  fail_unless( !XMLErrorLog_isStopRequested(log) );
+
+  /* and errors passed to the callback */
+  XMLErrorLog_clearLog(log);
+  XMLErrorLog_setCallback( log, countErrors, &count );
+  XMLErrorLog_add( log, tag );
+  XMLErrorLog_add( log, tag );
+
+  log->changeErrorSeverity(LIBLX_SEV_ERROR, LIBLX_SEV_WARNING);
+  fail_unless( XMLErrorLog_getNumLoggedWithSeverity(log, LIBLX_SEV_WARNING) 
+               == 2 );
+  fail_unless( XMLErrorLog_getNumErrorsWithSeverity(log, LIBLX_SEV_WARNING) 
+               == 0 );
+  fail_unless( !XMLErrorLog_isStopRequested(log) );
+
+  XMLError_free(tag);
+  XMLErrorLog_free(log);
+}
+END_TEST
+
+
+START_TEST (test_XMLErrorLog_stopStream)
+{
+  const char* text = "<a><b/><b/><b/></a>";
+
+  XMLErrorLog    log;
+  XMLInputStream stream(text, false, "", &log);
+
+  fail_unless( stream.next().getName() == "a" );
+
+  /* once the log asks for it, the stream stops reading */
+  log.setStopThreshold(1, LIBLX_SEV_ERROR);
+  log.add(XMLError(XMLTagMismatch));
+
+  while (stream.isGood()) stream.next();
+
+  fail_unless( stream.isError() );
+  fail_unless( !stream.isEOF() );
+  fail_unless( log.getNumErrors() == 1 );
+}
+END_TEST
+
+
 START_TEST (test_XMLErrorLog_accessWithNULL)
 {
 
@@ -195,6 +450,11 @@ create_suite_XMLErrorLog (void)
   tcase_add_test( tcase, test_XMLErrorLog_create   );
   tcase_add_test( tcase, test_XMLErrorLog_add      );
   tcase_add_test( tcase, test_XMLErrorLog_clear    );
+  tcase_add_test( tcase, test_XMLErrorLog_counts   );
+  tcase_add_test( tcase, test_XMLErrorLog_storm    );
+  tcase_add_test( tcase, test_XMLErrorLog_callback );
+  tcase_add_test( tcase, test_XMLErrorLog_changeSeverityCounts );
+  tcase_add_test( tcase, test_XMLErrorLog_stopStream );
   tcase_add_test( tcase, test_XMLErrorLog_toString );
   tcase_add_test( tcase, test_XMLErrorLog_override );
   tcase_add_test( tcase, test_XMLErrorLog_accessWithNULL   );
@@ -195,6 +195,151 @@ START_TEST (test_XMLInputStream_setErrorLog)
 }
 END_TEST 
 
+START_TEST (test_XMLInputStream_stats)
+{
+  const char* text =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<a><b x=\"1\"/>one &amp; two<c>three</c></a>";
+
+  XMLInputStream_t *stream = XMLInputStream_create(text, 0, "");
+
+  fail_unless(XMLInputStream_getStats(stream) == NULL);
+
+  XMLInputStream_enableStats(stream, 0);
+
+  const XMLParseStats_t *stats = XMLInputStream_getStats(stream);
+
+  fail_unless(stats != NULL);
+  fail_unless(XMLParseStats_getNumTokens(stats) == 0);
+
+  XMLToken_t *token = XMLInputStream_next(stream);
+  XMLToken_free(token);
+
+  fail_unless(XMLParseStats_getNumTokens(stats) == 1);
+  fail_unless(XMLParseStats_getNumChunks(stats) >= 1);
+  fail_unless(XMLParseStats_getBytesRead(stats) > 0);
+  fail_unless(XMLParseStats_getBytesRead(stats) <= strlen(text));
+
+  while (XMLInputStream_isGood(stream))
+  {
+    XMLInputStream_skipToken(stream);
+  }
+
+  stats = XMLInputStream_getStats(stream);
+
+  fail_unless(XMLParseStats_getBytesRead(stats) == strlen(text));
+  fail_unless(XMLParseStats_getNumTokens(stats) == 7);
+  fail_unless(XMLParseStats_getNumStartElements(stats) == 3);
+  fail_unless(XMLParseStats_getNumEndElements(stats) == 3);
+  fail_unless(XMLParseStats_getNumTextTokens(stats) == 2);
+  fail_unless(XMLParseStats_getPeakQueueDepth(stats) >= 1);
+  fail_unless(XMLParseStats_getNumErrors(stats) == 0);
+  fail_unless(XMLParseStats_getParseTime(stats) == 0);
+  fail_unless(XMLParseStats_getConsumerTime(stats) == 0);
+
+  XMLInputStream_disableStats(stream);
+
+  fail_unless(XMLInputStream_getStats(stream) == NULL);
+
+  XMLInputStream_free(stream);
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_statsTimed)
+{
+  const char* text = "<a><b></a>";
+
+  XMLErrorLog_t    *log    = XMLErrorLog_create();
+  XMLInputStream_t *stream = XMLInputStream_create(text, 0, "");
+
+  XMLInputStream_setErrorLog(stream, log);
+  XMLInputStream_enableStats(stream, 1);
+
+  while (XMLInputStream_isGood(stream))
+  {
+    XMLInputStream_skipToken(stream);
+  }
+
+  const XMLParseStats_t *stats = XMLInputStream_getStats(stream);
+
+  fail_unless(XMLParseStats_getNumErrors(stats) == XMLErrorLog_getNumErrors(log));
+  fail_unless(XMLParseStats_getNumErrors(stats) > 0);
+  fail_unless(XMLParseStats_getParseTime(stats) > 0);
+  fail_unless(XMLParseStats_getTokenizerTime(stats) > 0);
+  fail_unless(XMLParseStats_getConsumerTime(stats) >= 0);
+
+  XMLInputStream_free(stream);
+  XMLErrorLog_free(log);
+}
+END_TEST
+
+
+START_TEST (test_XMLInputStream_ignoreWhitespace)
+{
+  const char* text =
+    "<a>\n"
+    "  <b>x y</b>\n"
+    "  <c>\n    text\n  </c>\n"
+    "  <d> <e/> tail </d>\n"
+    "</a>";
+
+  const char* expected[] = { "x y", "\n    text\n  ", " tail " };
+
+  XMLInputStream_t *stream = XMLInputStream_create(text, 0, "");
+
+  fail_unless(XMLInputStream_getIgnoreWhitespace(stream) == 0);
+
+  XMLInputStream_setIgnoreWhitespace(stream, 1);
+  XMLInputStream_enableStats(stream, 0);
+
+  fail_unless(XMLInputStream_getIgnoreWhitespace(stream) == 1);
+
+  unsigned int numText = 0;
+
+  while (XMLInputStream_isGood(stream))
+  {
+    XMLToken_t *token = XMLInputStream_next(stream);
+
+    if (XMLToken_isText(token))
+    {
+      fail_unless(numText < 3);
+      fail_unless(!strcmp(XMLToken_getCharacters(token), expected[numText]));
+      ++numText;
+    }
+
+    XMLToken_free(token);
+  }
+
+  fail_unless(numText == 3);
+
+  const XMLParseStats_t *stats = XMLInputStream_getStats(stream);
+
+  fail_unless(XMLParseStats_getNumTextTokens(stats) == 3);
+  fail_unless(XMLParseStats_getNumWhitespaceDropped(stats) == 5);
+  fail_unless(XMLParseStats_getNumStartElements(stats) == 5);
+
+  XMLInputStream_free(stream);
+
+  /* without the option, every run of whitespace is a token */
+  stream = XMLInputStream_create(text, 0, "");
+  XMLInputStream_enableStats(stream, 0);
+
+  while (XMLInputStream_isGood(stream))
+  {
+    XMLInputStream_skipToken(stream);
+  }
+
+  stats = XMLInputStream_getStats(stream);
+
+  fail_unless(XMLParseStats_getNumTextTokens(stats) == 8);
+  fail_unless(XMLParseStats_getNumWhitespaceDropped(stats) == 0);
+
+  XMLInputStream_free(stream);
+}
+END_TEST
+
+
 START_TEST (test_XMLInputStream_accessWithNULL)
 {
   fail_unless (XMLInputStream_create(NULL, 0, NULL) == NULL);
@@ -212,6 +357,15 @@ START_TEST (test_XMLInputStream_accessWithNULL)
 
   XMLInputStream_skipPastEnd(NULL, NULL);
   XMLInputStream_skipText(NULL);  
+  XMLInputStream_enableStats(NULL, 1);
+  XMLInputStream_disableStats(NULL);
+  fail_unless (XMLInputStream_getStats(NULL) == NULL);
+  fail_unless (XMLParseStats_getBytesRead(NULL) == 0);
+  fail_unless (XMLParseStats_getParseTime(NULL) == 0);
+  fail_unless (XMLParseStats_getNumWhitespaceDropped(NULL) == 0);
+
+  XMLInputStream_setIgnoreWhitespace(NULL, 1);
+  fail_unless (XMLInputStream_getIgnoreWhitespace(NULL) == 0);
 }
 END_TEST 
 
@@ -225,6 +379,9 @@ create_suite_XMLInputStream (void)
   tcase_add_test( tcase, test_XMLInputStream_next_peek  );
   tcase_add_test( tcase, test_XMLInputStream_skip  );
   tcase_add_test( tcase, test_XMLInputStream_setErrorLog  );
+  tcase_add_test( tcase, test_XMLInputStream_stats );
+  tcase_add_test( tcase, test_XMLInputStream_statsTimed );
+  tcase_add_test( tcase, test_XMLInputStream_ignoreWhitespace );
   tcase_add_test( tcase, test_XMLInputStream_accessWithNULL );
 
   suite_add_tcase(suite, tcase);
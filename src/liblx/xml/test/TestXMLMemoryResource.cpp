@@ -0,0 +1,191 @@
+/**
+ * \file    TestXMLMemoryResource.cpp
+ * \brief   XMLMemoryResource unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLMemoryResource.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLTriple.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+static const char* document =
+  "<?xml version=\"1.0\"?>\n"
+  "<a xmlns=\"urn:a\">\n"
+  "  <b x=\"1\"><c>text</c></b>\n"
+  "  <b x=\"2\"><c>more text</c><d/></b>\n"
+  "</a>";
+
+
+START_TEST (test_XMLMemoryResource_monotonic)
+{
+  XMLMonotonicResource arena(64);
+
+  fail_unless( arena.getBytesReserved() == 0 );
+  fail_unless( arena.getBytesUsed()     == 0 );
+
+  char* first  = static_cast<char*>( arena.allocate(10, 1) );
+  char* second = static_cast<char*>( arena.allocate(8, 8) );
+
+  fail_unless( second >= first + 10 );
+  fail_unless( reinterpret_cast<size_t>(second) % 8 == 0 );
+  fail_unless( arena.getBytesReserved() >= 64 );
+
+  /* larger than the next block; a block big enough is taken instead */
+  void* large = arena.allocate(1000);
+
+  fail_unless( large != NULL );
+  fail_unless( arena.getBytesUsed() >= 1018 );
+  fail_unless( arena.getBytesReserved() >= arena.getBytesUsed() );
+
+  arena.deallocate(large, 1000);
+  fail_unless( arena.getBytesUsed() >= 1018 );
+
+  arena.release();
+  fail_unless( arena.getBytesReserved() == 0 );
+  fail_unless( arena.getBytesUsed()     == 0 );
+
+  fail_unless( arena.isEqual(arena) );
+  fail_unless( !arena.isEqual(*XMLMemoryResource::getDefault()) );
+}
+END_TEST
+
+
+START_TEST (test_XMLMemoryResource_counting)
+{
+  XMLCountingResource counter;
+
+  XMLInputStream plainStream(document, false);
+  XMLNode plain(plainStream);
+
+  {
+    XMLInputStream stream(document, false);
+    stream.setMemoryResource(&counter);
+    fail_unless( stream.getMemoryResource() == &counter );
+
+    XMLNode root(stream);
+
+    fail_unless( root.getMemoryResource() == &counter );
+    fail_unless( root.getChild(1).getMemoryResource() == &counter );
+    fail_unless( root.toXMLString() == plain.toXMLString() );
+
+    fail_unless( counter.getNumAllocations() > 0 );
+    fail_unless( counter.getBytesInUse() > 0 );
+    fail_unless( counter.getPeakBytesInUse() >= counter.getBytesInUse() );
+  }
+
+  fail_unless( counter.getBytesInUse() == 0 );
+  fail_unless( counter.getNumDeallocations() == counter.getNumAllocations() );
+  fail_unless( counter.getBytesAllocated() > 0 );
+
+  counter.resetCounts();
+  fail_unless( counter.getNumAllocations() == 0 );
+  fail_unless( counter.getBytesAllocated() == 0 );
+  fail_unless( counter.getPeakBytesInUse() == 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLMemoryResource_arenaTree)
+{
+  XMLMonotonicResource arena;
+  XMLCountingResource  heap;
+
+  XMLInputStream stream(document, false);
+  stream.setMemoryResource(&arena);
+
+  XMLNode* root = new (arena) XMLNode(stream);
+  const size_t used = arena.getBytesUsed();
+
+  fail_unless( root->getMemoryResource() == &arena );
+  fail_unless( root->getNumChildren() == 2 );
+  fail_unless( root->getChild(1).getChild(0).getChild(0).getCharacters()
+               == "more text" );
+  fail_unless( used > 0 );
+
+  /* a copy on the default heap does not share children with the arena */
+  XMLNode copy(*root);
+
+  fail_unless( copy.getMemoryResource() == XMLMemoryResource::getDefault() );
+  fail_unless( &copy.getChild(0) != &root->getChild(0) );
+
+  /* nor does a clone into another resource */
+  XMLNode* clone = root->clone(heap);
+
+  fail_unless( clone->getMemoryResource() == &heap );
+  fail_unless( heap.getNumAllocations() > 0 );
+
+  delete root;
+  fail_unless( arena.getBytesUsed() == used );
+  arena.release();
+
+  fail_unless( copy.toXMLString() == clone->toXMLString() );
+  fail_unless( copy.getChild(1).getChild(0).getChild(0).getCharacters()
+               == "more text" );
+
+  delete clone;
+  fail_unless( heap.getBytesInUse() == 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLMemoryResource_addChild)
+{
+  XMLCountingResource counter;
+
+  XMLInputStream stream("<a/>", false);
+  stream.setMemoryResource(&counter);
+
+  XMLNode* root = new (counter) XMLNode(stream);
+  const unsigned long before = counter.getNumAllocations();
+
+  XMLNode child(XMLTriple("b", "", ""), XMLAttributes());
+  root->addChild(child);
+  root->insertChild(0, child);
+
+  fail_unless( root->getNumChildren() == 2 );
+  fail_unless( root->getChild(0).getMemoryResource() == &counter );
+  fail_unless( counter.getNumAllocations() > before + 1 );
+
+  delete root;
+  fail_unless( counter.getBytesInUse() == 0 );
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLMemoryResource (void)
+{
+  Suite *suite = suite_create("XMLMemoryResource");
+  TCase *tcase = tcase_create("XMLMemoryResource");
+
+  tcase_add_test( tcase, test_XMLMemoryResource_monotonic );
+  tcase_add_test( tcase, test_XMLMemoryResource_counting );
+  tcase_add_test( tcase, test_XMLMemoryResource_arenaTree );
+  tcase_add_test( tcase, test_XMLMemoryResource_addChild );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
@@ -0,0 +1,243 @@
+/**
+ * \file    TestXMLMemoryUsage.cpp
+ * \brief   XMLMemoryUsage unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <string>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLMemoryUsage.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLTriple.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+static const char* document =
+  "<?xml version=\"1.0\"?>\n"
+  "<list xmlns=\"urn:list\" xmlns:x=\"urn:x\">"
+  "<item id=\"first\" x:note=\"a note long enough to need the heap\">"
+  "a piece of text long enough to need the heap</item>"
+  "<item id=\"second\">short</item>"
+  "<x:empty/>"
+  "</list>";
+
+
+START_TEST (test_XMLMemoryUsage_token)
+{
+  XMLToken empty;
+
+  fail_unless( empty.getMemoryUsage() == sizeof(XMLToken) );
+
+  const string text(200, 'a');
+  XMLToken chars(text);
+  XMLMemoryUsage usage;
+
+  fail_unless( chars.getMemoryUsage(usage) > sizeof(XMLToken) + 200 );
+  fail_unless( usage.getTextBytes() > 200 );
+  fail_unless( usage.getStructureBytes() == sizeof(XMLToken) );
+  fail_unless( usage.getTotal() == chars.getMemoryUsage() );
+
+  XMLAttributes attributes;
+  attributes.add("value", string(100, 'v'));
+  XMLNamespaces namespaces;
+  namespaces.add("urn:a-namespace-uri-long-enough-for-the-heap", "p");
+  XMLToken element(XMLTriple("e", "", ""), attributes, namespaces);
+
+  usage.clear();
+  element.getMemoryUsage(usage);
+
+  fail_unless( usage.getAttributeBytes() > sizeof(XMLAttributes) + 100 );
+  fail_unless( usage.getAttributeBytes() == attributes.getMemoryUsage() );
+  fail_unless( usage.getNamespaceBytes() == namespaces.getMemoryUsage() );
+  fail_unless( usage.getTotal() == element.getMemoryUsage() );
+}
+END_TEST
+
+
+START_TEST (test_XMLMemoryUsage_tree)
+{
+  XMLInputStream stream(document, false);
+  XMLNode root(stream);
+
+  XMLMemoryUsage usage;
+  const size_t total = root.getMemoryUsage(usage);
+
+  fail_unless( total == root.getMemoryUsage() );
+  fail_unless( total == usage.getTotal() );
+  fail_unless( usage.getTotal() == usage.getStructureBytes()
+               + usage.getTextBytes() + usage.getAttributeBytes()
+               + usage.getNamespaceBytes() );
+
+  fail_unless( usage.getStructureBytes() > 6 * sizeof(XMLNode) );
+  fail_unless( usage.getTextBytes()      > 40 );
+  fail_unless( usage.getAttributeBytes() > 30 );
+  fail_unless( usage.getNamespaceBytes() > 0 );
+  fail_unless( usage.getErrorBytes()     == 0 );
+
+  fail_unless( !usage.isByElement() );
+  fail_unless( usage.getNumElementNames() == 0 );
+
+  /* a larger tree holds more */
+  XMLNode bigger(root);
+  const size_t before = bigger.getMemoryUsage();
+  bigger.getChild(1).getChild(0).append(string(1000, 't'));
+  fail_unless( bigger.getMemoryUsage() > before + 1000 );
+
+  usage.clear();
+  fail_unless( usage.getTotal() == 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLMemoryUsage_byElement)
+{
+  XMLInputStream stream(document, false);
+  XMLNode root(stream);
+
+  XMLMemoryUsage usage(true);
+  root.getMemoryUsage(usage);
+
+  fail_unless( usage.isByElement() );
+  fail_unless( usage.getNumElementNames() == 3 );
+
+  fail_unless( usage.getElementCount("list")    == 1 );
+  fail_unless( usage.getElementCount("item")    == 2 );
+  fail_unless( usage.getElementCount("x:empty") == 1 );
+  fail_unless( usage.getElementCount("text")    == 0 );
+
+  /* the items hold the text and attributes, and so the most */
+  fail_unless( usage.getElementName(0) == "item" );
+  fail_unless( usage.getElementName(3) == "" );
+  fail_unless( usage.getElementBytes(usage.getElementName(0))
+               >= usage.getElementBytes(usage.getElementName(1)) );
+  fail_unless( usage.getElementBytes(usage.getElementName(1))
+               >= usage.getElementBytes(usage.getElementName(2)) );
+
+  size_t sum = 0;
+  for (unsigned int n = 0; n < usage.getNumElementNames(); ++n)
+  {
+    sum += usage.getElementBytes(usage.getElementName(n));
+  }
+  fail_unless( sum == usage.getTotal() );
+}
+END_TEST
+
+
+START_TEST (test_XMLMemoryUsage_shared)
+{
+  XMLInputStream stream(document, false);
+  XMLNode root(stream);
+  XMLNode* copy = root.cloneShared();
+
+  const size_t one = root.getMemoryUsage();
+
+  /* the copy shares the children, which are counted once */
+  XMLMemoryUsage usage;
+  root.getMemoryUsage(usage);
+  const size_t more = copy->getMemoryUsage(usage);
+
+  /* only the copy itself, its namespaces and its list of children */
+  fail_unless( more >= sizeof(XMLNode) + 3 * sizeof(XMLNode*)
+                       + copy->getNamespaces().getMemoryUsage() );
+  fail_unless( more < one / 2 );
+  fail_unless( usage.getTotal() == one + more );
+
+  delete copy;
+}
+END_TEST
+
+
+START_TEST (test_XMLMemoryUsage_errorLog)
+{
+  XMLErrorLog log;
+  const size_t empty = log.getMemoryUsage();
+
+  fail_unless( empty >= sizeof(XMLErrorLog) );
+
+  for (unsigned int n = 0; n < 10; ++n)
+  {
+    log.add(XMLError(BadlyFormedXML, "details that are long enough for the heap"));
+  }
+
+  XMLMemoryUsage usage;
+  const size_t full = log.getMemoryUsage(usage);
+
+  fail_unless( full > empty + 10 * sizeof(XMLError) );
+  fail_unless( usage.getErrorBytes() == full );
+  fail_unless( usage.getTotal() == full );
+
+  /* composing a message makes the error larger */
+  const size_t before = log.getError(0)->getMemoryUsage();
+  log.getError(0)->getMessage();
+  fail_unless( log.getError(0)->getMemoryUsage() > before );
+}
+END_TEST
+
+
+START_TEST (test_XMLMemoryUsage_stream)
+{
+  XMLInputStream stream(document, false);
+
+  stream.peek();
+  fail_unless( stream.getMemoryUsage() >= sizeof(XMLToken) );
+
+  while (stream.isGood()) stream.next();
+  fail_unless( stream.getMemoryUsage() >= sizeof(XMLToken) );
+}
+END_TEST
+
+
+START_TEST (test_XMLMemoryUsage_C)
+{
+  fail_unless( XMLToken_getMemoryUsage(NULL)      == 0 );
+  fail_unless( XMLNode_getMemoryUsage(NULL)       == 0 );
+  fail_unless( XMLAttributes_getMemoryUsage(NULL) == 0 );
+  fail_unless( XMLNamespaces_getMemoryUsage(NULL) == 0 );
+  fail_unless( XMLErrorLog_getMemoryUsage(NULL)   == 0 );
+
+  XMLInputStream stream(document, false);
+  XMLNode root(stream);
+
+  fail_unless( XMLNode_getMemoryUsage(&root) == root.getMemoryUsage() );
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLMemoryUsage (void)
+{
+  Suite *suite = suite_create("XMLMemoryUsage");
+  TCase *tcase = tcase_create("XMLMemoryUsage");
+
+  tcase_add_test( tcase, test_XMLMemoryUsage_token );
+  tcase_add_test( tcase, test_XMLMemoryUsage_tree );
+  tcase_add_test( tcase, test_XMLMemoryUsage_byElement );
+  tcase_add_test( tcase, test_XMLMemoryUsage_shared );
+  tcase_add_test( tcase, test_XMLMemoryUsage_errorLog );
+  tcase_add_test( tcase, test_XMLMemoryUsage_stream );
+  tcase_add_test( tcase, test_XMLMemoryUsage_C );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
@@ -0,0 +1,155 @@
+/**
+ * \file    TestXMLNamePool.cpp
+ * \brief   XMLNamePool unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sstream>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLDocumentStore.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNamePool.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLToken.h>
+#include <liblx/xml/operationReturnValues.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+/*
+ * @return a name no other test interns.
+ */
+static string
+uniqueName (const string& test, unsigned int n)
+{
+  ostringstream oss;
+  oss << "namePool_" << test << '_' << n;
+  return oss.str();
+}
+
+
+START_TEST (test_XMLNamePool_intern)
+{
+  XMLTriple triple(uniqueName("intern", 0), "urn:u", "u");
+  XMLTriple same  (uniqueName("intern", 0), "urn:u", "u");
+  XMLTriple other (uniqueName("intern", 0), "urn:u", "v");
+
+  const XMLTriple* pooled = XMLNamePool::intern(triple);
+
+  fail_unless( pooled != NULL );
+  fail_unless( *pooled == triple );
+  fail_unless( XMLNamePool::intern(same)  == pooled );
+  fail_unless( XMLNamePool::intern(other) != pooled );
+  fail_unless( XMLNamePool::intern(XMLTriple()) == NULL );
+  fail_unless( XMLNamePool::getMaxNames() > 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLNamePool_bounded)
+{
+  const unsigned int max = XMLNamePool::getMaxNames();
+  XMLNamePool::setMaxNames(XMLNamePool::getNumNames() + 2);
+
+  const XMLTriple* first  = XMLNamePool::intern(
+                              XMLTriple(uniqueName("bounded", 0), "", ""));
+  const XMLTriple* second = XMLNamePool::intern(
+                              XMLTriple(uniqueName("bounded", 1), "", ""));
+
+  fail_unless( first != NULL && second != NULL );
+
+  /* the pool is full: new names are refused, known ones still shared */
+  for (unsigned int n = 2; n < 10; ++n)
+  {
+    fail_unless( XMLNamePool::intern(
+                   XMLTriple(uniqueName("bounded", n), "", "")) == NULL );
+  }
+
+  fail_unless( XMLNamePool::getNumNames() == XMLNamePool::getMaxNames() );
+  fail_unless( XMLNamePool::intern(
+                 XMLTriple(uniqueName("bounded", 0), "", "")) == first );
+
+  /* tokens keep a copy of a name the pool refused */
+  XMLTriple  refused(uniqueName("bounded", 10), "urn:r", "r");
+  XMLToken   token(refused, XMLAttributes());
+  XMLToken   empty;
+
+  fail_unless( token.getName()   == refused.getName() );
+  fail_unless( token.getURI()    == "urn:r" );
+  fail_unless( token.getPrefix() == "r" );
+  fail_unless( token.getMemoryUsage() > empty.getMemoryUsage() );
+
+  XMLToken copy(token);
+  XMLToken assigned;
+  assigned = token;
+  assigned = copy;
+
+  fail_unless( copy.getName()     == refused.getName() );
+  fail_unless( assigned.getName() == refused.getName() );
+
+  fail_unless( copy.setTriple(XMLTriple(uniqueName("bounded", 0), "", ""))
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( copy.getName() == uniqueName("bounded", 0) );
+  fail_unless( token.getName() == refused.getName() );
+
+  /* trees and stores built from such names read as before */
+  ostringstream oss;
+  oss << "<" << uniqueName("bounded", 11) << ">";
+  for (unsigned int n = 0; n < 3; ++n)
+  {
+    oss << "<" << uniqueName("bounded", 12) << " "
+        << uniqueName("bounded", 13) << "='" << n << "'/>";
+  }
+  oss << "</" << uniqueName("bounded", 11) << ">";
+
+  XMLInputStream stream1(oss.str().c_str(), false);
+  XMLInputStream stream2(oss.str().c_str(), false);
+  XMLNode        tree1(stream1);
+  XMLNode        tree2(stream2);
+
+  fail_unless( tree1.getName() == uniqueName("bounded", 11) );
+  fail_unless( tree1.equals(tree2) );
+  fail_unless( tree1.toXMLString() == tree2.toXMLString() );
+
+  XMLDocumentStore store(tree1);
+
+  fail_unless( store.getNumNodes() == 4 );
+  fail_unless( store.getNumNames() == 3 );
+  fail_unless( store.getName(0) == uniqueName("bounded", 11) );
+  fail_unless( store.getName(1) == uniqueName("bounded", 12) );
+  fail_unless( store.getNameId(1) == store.getNameId(3) );
+
+  XMLNamePool::setMaxNames(max);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLNamePool (void)
+{
+  Suite *suite = suite_create("XMLNamePool");
+  TCase *tcase = tcase_create("XMLNamePool");
+
+  tcase_add_test( tcase, test_XMLNamePool_intern );
+  tcase_add_test( tcase, test_XMLNamePool_bounded );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
@@ -39,6 +39,7 @@
 #include <liblx/xml/XMLToken.h>
 #include <liblx/xml/XMLNode.h>
 #include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLWriterOptions.h>
 
 #include <check.h>
 using namespace std;
@@ -115,6 +116,236 @@ START_TEST (test_XMLNode_equals)
 }
 END_TEST
 
+START_TEST (test_XMLNode_hash)
+{
+  const char* xmlstr = "<annotation>\n"
+  "  <a:test xmlns:a=\"http://a.org/\" id=\"test\" x=\"1\"><b/><c/></a:test>\n"
+  "</annotation>";
+
+  XMLNode* node1 = XMLNode::convertStringToXMLNode(xmlstr);
+  XMLNode* node2 = XMLNode::convertStringToXMLNode(xmlstr);
+
+  fail_unless( node1->hash() == node2->hash() );
+  fail_unless( node1->equals(*node2) );
+
+  /* attributes are matched by name, whatever their order */
+  XMLNode reordered(*node2);
+  XMLNode& test = reordered.getChild(0);
+  test.removeAttr("id");
+  test.addAttr("id", "test");
+  fail_unless( reordered.hash() == node1->hash() );
+  fail_unless( reordered.equals(*node1) );
+
+  /* a change to a descendant reaches the root */
+  node2->getChild(0).getChild(1).addAttr("y", "2");
+  fail_unless( node1->hash() != node2->hash() );
+  fail_unless( !node1->equals(*node2) );
+
+  XMLNode* removed = node2->getChild(0).removeChild(1);
+  fail_unless( node1->hash() != node2->hash() );
+  removed->removeAttr("y");
+  node2->getChild(0).addChild(*removed);
+  delete removed;
+  fail_unless( node1->hash() == node2->hash() );
+  fail_unless( node1->equals(*node2) );
+
+  node2->getChild(0).getChild(0).setTriple(XMLTriple("d", "", ""));
+  fail_unless( !node1->equals(*node2) );
+  node2->getChild(0).getChild(0).setTriple(XMLTriple("b", "", ""));
+  fail_unless( node1->equals(*node2) );
+
+  /* the options are honoured */
+  node2->getChild(0).removeAttr("x");
+  node2->getChild(0).addAttr("x", "2");
+  fail_unless( node1->hash(false, true) == node2->hash(false, true) );
+  fail_unless( node1->equals(*node2, false, true) );
+  fail_unless( !node1->equals(*node2) );
+
+  XMLNode other(*node1);
+  other.getChild(0).setTriple(XMLTriple("test", "http://b.org/", "a"));
+  fail_unless( !other.equals(*node1) );
+  fail_unless( other.hash(true) == node1->hash(true) );
+  fail_unless( other.equals(*node1, true) );
+
+  /* the C API */
+  fail_unless( XMLNode_hash(node1) == (unsigned long) node1->hash() );
+  fail_unless( XMLNode_hash(NULL) == 0 );
+
+  delete node1;
+  delete node2;
+}
+END_TEST
+
+
+/*
+ * @return true if node is written the same with and without node
+ * caching, twice over so that the second time uses the kept text.
+ */
+static bool
+sameWhenCached (const XMLNode& node, const XMLWriterOptions& options)
+{
+  const XMLWriterOptions cached = options.withCacheNodes(true);
+  const string expected = node.toXMLString(options);
+
+  return node.toXMLString(cached) == expected
+      && node.toXMLString(cached) == expected;
+}
+
+
+START_TEST (test_XMLNode_cachedString)
+{
+  const char* xmlstr = "<a>\n"
+    "  <b x=\"1\"><c>text</c><c><d/></c></b>\n"
+    "  <e>mixed <f>content</f> here</e>\n"
+    "</a>";
+
+  const XMLWriterOptions options;
+  XMLNode* root = XMLNode::convertStringToXMLNode(xmlstr);
+
+  fail_unless( root->toXMLString(options) == root->toXMLString() );
+  fail_unless( sameWhenCached(*root, options) );
+
+  /* changes anywhere below are seen */
+  root->getChild(0).getChild(1).getChild(0).addAttr("y", "2");
+  fail_unless( sameWhenCached(*root, options) );
+  fail_unless( root->toXMLString().find("<d y=\"2\"/>") != string::npos );
+
+  root->getChild(1).getChild(0).setCharacters("changed ");
+  fail_unless( sameWhenCached(*root, options) );
+
+  XMLNode* removed = root->getChild(0).removeChild(0);
+  fail_unless( sameWhenCached(*root, options) );
+  root->getChild(0).insertChild(1, *removed);
+  fail_unless( sameWhenCached(*root, options) );
+
+  /* a subtree written at one depth is rewritten at another */
+  XMLNode moved(root->getChild(0));
+  root->getChild(0).getChild(0).addChild(moved);
+  fail_unless( sameWhenCached(*root, options) );
+  fail_unless( sameWhenCached(moved, options) );
+
+  /* copies keep the text but not each other's changes */
+  XMLNode copy(*root);
+  copy.getChild(1).getChild(1).getChild(0).setCharacters("other");
+  fail_unless( sameWhenCached(copy, options) );
+  fail_unless( sameWhenCached(*root, options) );
+  fail_unless( root->toXMLString() != copy.toXMLString() );
+
+  /* other formatting */
+  const XMLWriterOptions wide = options.withIndentWidth(4)
+                                       .withLineEnding("\r\n");
+  fail_unless( sameWhenCached(*root, wide) );
+  fail_unless( sameWhenCached(*root, options.withIndent(false)) );
+
+  fail_unless( XMLNode::convertXMLNodeToString(root, 
+                                               options.withCacheNodes(true))
+               == root->toXMLString() );
+
+  /* the C API */
+  XMLWriterOptions_t* cached = XMLWriterOptions_withCacheNodes(&options, 1);
+  char* chars = XMLNode_toXMLStringWithOptions(root, cached);
+  fail_unless( chars == root->toXMLString() );
+  fail_unless( XMLNode_toXMLStringWithOptions(NULL, cached) == NULL );
+  fail_unless( XMLNode_toXMLStringWithOptions(root, NULL) == NULL );
+
+  safe_free(chars);
+  XMLWriterOptions_free(cached);
+  delete removed;
+  delete root;
+}
+END_TEST
+
+
+START_TEST (test_XMLNode_copyOnWrite)
+{
+  const char* xmlstr = "<a><b x=\"1\"><c>text</c></b><d/></a>";
+
+  XMLNode* orig = XMLNode::convertStringToXMLNode(xmlstr);
+  const string before = orig->toXMLString();
+
+  /* a shared copy shares the children until one of the trees changes them */
+  XMLNode* copy = orig->cloneShared();
+  const XMLNode& origC = *orig;
+  const XMLNode& copyC = *copy;
+  fail_unless( &origC.getChild(0) == &copyC.getChild(0) );
+
+  copy->getChild(0).getChild(0).getChild(0).setCharacters("changed");
+  copy->getChild(0).addAttr("y", "2");
+  fail_unless( orig->toXMLString() == before );
+  fail_unless( copyC.getChild(0).getAttrValue("y") == "2" );
+  fail_unless( &origC.getChild(1) == &copyC.getChild(1) );
+
+  XMLNode* removed = copy->removeChild(1);
+  removed->setTriple(XMLTriple("e", "", ""));
+  fail_unless( origC.getChild(1).getName() == "d" );
+  delete removed;
+
+  /* a child held for changes is copied, not shared, by later copies */
+  XMLNode& held = orig->getChild(1);
+  XMLNode* second = orig->cloneShared();
+  held.addAttr("z", "3");
+  fail_unless( second->getChild(1).getAttrValue("z").empty() );
+  fail_unless( second->toXMLString() == before );
+  delete second;
+
+  /* assignment, also from a node below the one assigned to */
+  XMLNode assigned;
+  assigned = *copy;
+  fail_unless( assigned.equals(*copy) );
+  assigned = assigned.getChild(0);
+  fail_unless( assigned.getName() == "b" );
+  fail_unless( assigned.getChild(0).getChild(0).getCharacters() == "changed" );
+
+  delete copy;
+  fail_unless( assigned.getAttrValue("y") == "2" );
+
+  /* the C API */
+  XMLNode_t* cloned = XMLNode_cloneShared(orig);
+  fail_unless( XMLNode_getChild(cloned, 0) == &origC.getChild(0) );
+  XMLNode_addAttr(XMLNode_getChildNC(cloned, 0), "w", "4");
+  fail_unless( origC.getChild(0).getAttrValue("w").empty() );
+  XMLNode_free(cloned);
+  fail_unless( XMLNode_cloneShared(NULL) == NULL );
+
+  delete orig;
+}
+END_TEST
+
+
+START_TEST (test_XMLNode_copyAliasing)
+{
+  const char* xmlstr = "<a><b x=\"1\"><c>text</c></b><d/></a>";
+
+  XMLNode* a = XMLNode::convertStringToXMLNode(xmlstr);
+
+  /* copies are deep: a child read before copying stays that of a */
+  const XMLNode* held = &static_cast<const XMLNode&>(*a).getChild(0);
+  XMLNode* b = new XMLNode(*a);
+  fail_unless( &static_cast<const XMLNode&>(*b).getChild(0) != held );
+
+  a->getChild(0).addAttr("y", "2");
+  delete b;
+
+  fail_unless( held->getName() == "b" );
+  fail_unless( held->getAttrValue("y") == "2" );
+  fail_unless( &a->getChild(0) == held );
+
+  XMLNode* cloned = a->clone();
+  XMLNode  assigned;
+  assigned = *a;
+  fail_unless( &static_cast<const XMLNode&>(*cloned).getChild(0) != held );
+  fail_unless( &static_cast<const XMLNode&>(assigned).getChild(0) != held );
+  delete cloned;
+
+  a->getChild(0).addAttr("z", "3");
+  fail_unless( held->getAttrValue("z") == "3" );
+  fail_unless( assigned.getChild(0).getAttrValue("z").empty() );
+
+  delete a;
+}
+END_TEST
+
+
 START_TEST (test_XMLNode_create)
 {
   XMLNode_t *node = XMLNode_create();
@@ -1645,6 +1876,10 @@ create_suite_XMLNode (void)
   tcase_add_test( tcase, test_XMLNode_hasChild  );
   tcase_add_test( tcase, test_XMLNode_getChildForName  );
   tcase_add_test( tcase, test_XMLNode_equals  );
+  tcase_add_test( tcase, test_XMLNode_hash  );
+  tcase_add_test( tcase, test_XMLNode_copyOnWrite  );
+  tcase_add_test( tcase, test_XMLNode_copyAliasing  );
+  tcase_add_test( tcase, test_XMLNode_cachedString  );
   tcase_add_test( tcase, test_XMLNode_create  );
   tcase_add_test( tcase, test_XMLNode_createFromToken  );
   tcase_add_test( tcase, test_XMLNode_createElement  );
@@ -0,0 +1,208 @@
+/**
+ * \file    TestXMLNodePool.cpp
+ * \brief   XMLNodePool unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sstream>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLNodePool.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+static const char* document =
+  "<?xml version=\"1.0\"?>\n"
+  "<a xmlns=\"urn:a\">\n"
+  "  <b x=\"1\"><c>text</c></b>\n"
+  "  <b x=\"1\"><c>text</c></b>\n"
+  "  <b x=\"2\"><c>text</c></b>\n"
+  "</a>";
+
+
+START_TEST (test_XMLNodePool_create)
+{
+  XMLNodePool pool;
+
+  fail_unless( pool.getNumRead()    == 0 );
+  fail_unless( pool.getNumShared()  == 0 );
+  fail_unless( pool.getNumKept()    == 0 );
+  fail_unless( pool.getBytesSaved() == 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLNodePool_share)
+{
+  XMLNodePool pool;
+
+  XMLInputStream plainStream(document, false);
+  XMLNode plain(plainStream);
+
+  XMLInputStream stream(document, false);
+  XMLNode root(stream, pool);
+
+  fail_unless( root.toXMLString() == plain.toXMLString() );
+  fail_unless( root.equals(plain) );
+
+  /* the first b is read as text, c and b; the others share them, apart
+   * from the third b whose attribute differs */
+  fail_unless( pool.getNumRead()   == 9 );
+  fail_unless( pool.getNumShared() == 5 );
+  fail_unless( pool.getNumKept()   == 4 );
+  fail_unless( pool.getBytesSaved() > 0 );
+
+  const XMLNode& shared = root;
+  fail_unless( &shared.getChild(0) == &shared.getChild(1) );
+  fail_unless( &shared.getChild(0) != &shared.getChild(2) );
+  fail_unless( &shared.getChild(0).getChild(0)
+               == &shared.getChild(2).getChild(0) );
+
+  /* a second document shares with the first */
+  XMLInputStream again(document, false);
+  XMLNode second(again, pool);
+
+  fail_unless( pool.getNumShared() == 5 + 9 );
+  fail_unless( pool.getNumKept()   == 4 );
+
+  const XMLNode& other = second;
+  fail_unless( &other.getChild(2) == &shared.getChild(2) );
+
+  ostringstream report;
+  pool.printReport(report);
+  fail_unless( report.str().find("nodes shared: 14") != string::npos );
+}
+END_TEST
+
+
+START_TEST (test_XMLNodePool_unshare)
+{
+  XMLNodePool pool;
+
+  XMLInputStream first(document, false);
+  XMLNode root(first, pool);
+
+  XMLInputStream second(document, false);
+  XMLNode* other = new XMLNode(second, pool);
+  const string before = other->toXMLString();
+
+  /* changes through one tree reach neither its other nodes nor the
+   * other tree */
+  root.getChild(0).addAttr("y", "3");
+  root.getChild(1).getChild(0).getChild(0).setCharacters("changed");
+
+  const XMLNode& shared = root;
+  fail_unless( shared.getChild(0).getAttrValue("y") == "3" );
+  fail_unless( shared.getChild(1).getAttrValue("y").empty() );
+  fail_unless( shared.getChild(1).getChild(0).getChild(0).getCharacters()
+               == "changed" );
+  fail_unless( shared.getChild(0).getChild(0).getChild(0).getCharacters()
+               == "text" );
+  fail_unless( other->toXMLString() == before );
+
+  /* a removed child belongs to the caller alone */
+  XMLNode* removed = other->removeChild(2);
+  removed->addAttr("z", "4");
+  fail_unless( shared.getChild(2).getAttrValue("z").empty() );
+  delete removed;
+
+  /* trees outlive the pool, and the pool outlives trees */
+  pool.clear();
+  fail_unless( pool.getNumKept() == 0 );
+  fail_unless( other->getNumChildren() == 2 );
+
+  delete other;
+  fail_unless( root.getChild(2).getAttrValue("x") == "2" );
+}
+END_TEST
+
+
+START_TEST (test_XMLNodePool_convert)
+{
+  XMLNodePool pool;
+
+  const string xml = "<p><q>one</q><q>one</q></p>";
+
+  XMLNode* first  = XMLNode::convertStringToXMLNode(xml, NULL, &pool);
+  XMLNode* second = XMLNode::convertStringToXMLNode(xml, NULL, &pool);
+  XMLNode* plain  = XMLNode::convertStringToXMLNode(xml);
+
+  fail_unless( first->toXMLString()  == plain->toXMLString() );
+  fail_unless( second->toXMLString() == plain->toXMLString() );
+
+  const XMLNode& one = *first;
+  const XMLNode& two = *second;
+  fail_unless( &one.getChild(0) == &two.getChild(1) );
+
+  delete first;
+  delete second;
+  delete plain;
+
+  /* several top-level elements go under a dummy root */
+  XMLNode* several = XMLNode::convertStringToXMLNode("<q>one</q><r/>",
+                                                     NULL, &pool);
+  fail_unless( several->isEOF() );
+  fail_unless( several->getNumChildren() == 2 );
+  fail_unless( several->getChild(0).getChild(0).getCharacters() == "one" );
+  delete several;
+}
+END_TEST
+
+
+START_TEST (test_XMLNodePool_C)
+{
+  XMLNodePool_t* pool = XMLNodePool_create();
+
+  XMLNode_t* first  =
+    XMLNode_convertStringToXMLNodeWithPool("<p><q/><q/></p>", NULL, pool);
+
+  fail_unless( first != NULL );
+  fail_unless( XMLNode_getNumChildren(first) == 2 );
+  fail_unless( XMLNodePool_getNumShared(pool)  == 1 );
+  fail_unless( XMLNodePool_getBytesSaved(pool) >  0 );
+
+  fail_unless( XMLNodePool_getNumShared(NULL)  == 0 );
+  fail_unless( XMLNode_convertStringToXMLNodeWithPool("<p/>", NULL, NULL)
+               == NULL );
+
+  XMLNodePool_free(pool);
+  XMLNodePool_free(NULL);
+  XMLNode_free(first);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLNodePool (void)
+{
+  Suite *suite = suite_create("XMLNodePool");
+  TCase *tcase = tcase_create("XMLNodePool");
+
+  tcase_add_test( tcase, test_XMLNodePool_create );
+  tcase_add_test( tcase, test_XMLNodePool_share );
+  tcase_add_test( tcase, test_XMLNodePool_unshare );
+  tcase_add_test( tcase, test_XMLNodePool_convert );
+  tcase_add_test( tcase, test_XMLNodePool_C );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
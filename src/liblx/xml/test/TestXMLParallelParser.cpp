@@ -0,0 +1,334 @@
+/**
+ * \file    TestXMLParallelParser.cpp
+ * \brief   XMLParallelParser unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLParallelParser.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+/*
+ * @return a document whose root holds count items spread over several
+ * lines, with namespaces declared on the root.
+ */
+static string
+makeDocument (unsigned int count)
+{
+  ostringstream oss;
+
+  oss << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+      << "<!-- items -->\n"
+      << "<list xmlns=\"urn:list\"\n      xmlns:p=\"urn:p\" id=\"l\">\n";
+
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    oss << "  <item n=\"" << n << "\" p:k='v'><p:name>caf\xC3\xA9 " << n
+        << "</p:name><empty/></item>";
+    if (n % 3 == 0) oss << '\n';
+  }
+
+  oss << "</list>\n";
+
+  return oss.str();
+}
+
+
+/*
+ * Writes the names, namespaces and positions of every element in node.
+ */
+static void
+writeTree (const XMLNode& node, ostream& out)
+{
+  if (node.isElement())
+  {
+    out << node.getURI() << '|' << node.getName() << ' '
+        << node.getLine() << ':' << node.getColumn() << '\n';
+  }
+  else
+  {
+    out << '[' << node.getCharacters() << "]\n";
+  }
+
+  for (unsigned int n = 0; n < node.getNumChildren(); ++n)
+  {
+    writeTree(node.getChild(n), out);
+  }
+}
+
+
+static string
+describe (const XMLNode* node)
+{
+  if (node == NULL) return "<null>";
+
+  ostringstream oss;
+  writeTree(*node, oss);
+  oss << node->toXMLString();
+
+  return oss.str();
+}
+
+
+static string
+describeLog (const XMLErrorLog& log)
+{
+  ostringstream oss;
+
+  for (unsigned int n = 0; n < log.getNumErrors(); ++n)
+  {
+    oss << log.getError(n)->getErrorId() << ' ' << log.getError(n)->getLine()
+        << ':' << log.getError(n)->getColumn() << '\n';
+  }
+
+  return oss.str();
+}
+
+
+static XMLNode*
+readSerially (const string& content, XMLErrorLog* log = NULL)
+{
+  XMLInputStream stream(content.c_str(), false, "", log);
+  return new XMLNode(stream);
+}
+
+
+START_TEST (test_XMLParallelParser_create)
+{
+  XMLParallelParser parser(3);
+
+  fail_unless( parser.getNumThreads() == 3 );
+  fail_unless( parser.getMinChunkSize() > 0 );
+  fail_unless( parser.setMinChunkSize(0) == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( parser.setMinChunkSize(64) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( parser.getMinChunkSize() == 64 );
+
+  XMLParallelParser automatic;
+  fail_unless( automatic.getNumThreads() >= 1 );
+
+  fail_unless( parser.parse(NULL) == NULL );
+}
+END_TEST
+
+
+START_TEST (test_XMLParallelParser_sameAsSerial)
+{
+  const string doc = makeDocument(200);
+
+  XMLParallelParser parser(4);
+  parser.setMinChunkSize(256);
+
+  XMLErrorLog log;
+  XMLNode* parallel = parser.parse(doc.c_str(), false, &log);
+  XMLNode* serial   = readSerially(doc);
+
+  fail_unless( parser.getNumChunks() == 4 );
+  fail_unless( parser.isSerialFallback() == false );
+  fail_unless( log.getNumErrors() == 0 );
+  fail_unless( parallel->getNumChildren() == 200 );
+  fail_unless( parallel->getNamespaces().getURI("p") == "urn:p" );
+  fail_unless( describe(parallel) == describe(serial) );
+
+  delete parallel;
+  delete serial;
+}
+END_TEST
+
+
+START_TEST (test_XMLParallelParser_small)
+{
+  const string doc = makeDocument(5);
+
+  XMLParallelParser parser(4);
+  XMLNode* node = parser.parse(doc.c_str(), false);
+
+  fail_unless( parser.getNumChunks() == 1 );
+  fail_unless( parser.isSerialFallback() == false );
+  fail_unless( node->getNumChildren() == 5 );
+
+  delete node;
+}
+END_TEST
+
+
+START_TEST (test_XMLParallelParser_misspeculation)
+{
+  /* every item looks like a place to cut, but the nested ones are not */
+  ostringstream oss;
+  oss << "<r>";
+  for (unsigned int n = 0; n < 100; ++n)
+  {
+    oss << "<item><item>" << n << "</item></item>\n"
+        << "<!-- <item> -->\n";
+  }
+  oss << "</r>";
+
+  const string doc = oss.str();
+
+  XMLParallelParser parser(4);
+  parser.setMinChunkSize(64);
+
+  XMLNode* parallel = parser.parse(doc.c_str(), false);
+  XMLNode* serial   = readSerially(doc);
+
+  fail_unless( parser.getNumChunks() >= 1 );
+  fail_unless( describe(parallel) == describe(serial) );
+
+  delete parallel;
+  delete serial;
+}
+END_TEST
+
+
+START_TEST (test_XMLParallelParser_errors)
+{
+  /* a mismatched tag deep in the last piece */
+  string doc = makeDocument(200);
+  doc.replace(doc.rfind("</p:name>"), 9, "</p:nome>");
+
+  XMLParallelParser parser(4);
+  parser.setMinChunkSize(256);
+
+  XMLErrorLog parallelLog;
+  XMLErrorLog serialLog;
+  XMLNode* parallel = parser.parse(doc.c_str(), false, &parallelLog);
+  XMLNode* serial   = readSerially(doc, &serialLog);
+
+  fail_unless( parser.isSerialFallback() == true );
+  fail_unless( parser.getNumChunks() == 1 );
+  fail_unless( parallelLog.getNumErrors() > 0 );
+  fail_unless( parallelLog.getError(0)->getErrorId() == XMLTagMismatch );
+  fail_unless( describeLog(parallelLog) == describeLog(serialLog) );
+  fail_unless( describe(parallel) == describe(serial) );
+
+  delete parallel;
+  delete serial;
+}
+END_TEST
+
+
+START_TEST (test_XMLParallelParser_serialOnly)
+{
+  XMLParallelParser parser(4);
+  parser.setMinChunkSize(64);
+
+  /* a DOCTYPE may declare entities the pieces would not see */
+  const string doctype = "<!DOCTYPE list>\n" + makeDocument(50).substr(39);
+
+  XMLNode* node = parser.parse(doctype.c_str(), false);
+  fail_unless( parser.getNumChunks() == 1 );
+  fail_unless( parser.isSerialFallback() == false );
+  fail_unless( node->getNumChildren() == 50 );
+  delete node;
+
+  /* one thread */
+  XMLParallelParser single(1);
+  single.setMinChunkSize(64);
+
+  const string doc = makeDocument(50);
+  node = single.parse(doc.c_str(), false);
+  fail_unless( single.getNumChunks() == 1 );
+  fail_unless( node->getNumChildren() == 50 );
+  delete node;
+}
+END_TEST
+
+
+START_TEST (test_XMLParallelParser_file)
+{
+  const char*  filename = "parallel-parser-test.xml";
+  const string doc      = makeDocument(300);
+
+  {
+    ofstream out(filename);
+    out << doc;
+  }
+
+  XMLParallelParser parser(3);
+  parser.setMinChunkSize(1024);
+
+  XMLNode* parallel = parser.parse(filename);
+  XMLNode* serial   = readSerially(doc);
+
+  fail_unless( parser.getNumChunks() == 3 );
+  fail_unless( describe(parallel) == describe(serial) );
+
+  delete parallel;
+  delete serial;
+
+  XMLErrorLog log;
+  fail_unless( parser.parse("no-such-file.xml", true, &log) == NULL );
+  fail_unless( log.getNumErrors() > 0 );
+
+  remove(filename);
+}
+END_TEST
+
+
+START_TEST (test_XMLParallelParser_C)
+{
+  const string doc = makeDocument(100);
+
+  XMLParallelParser_t* parser = XMLParallelParser_create(2, NULL);
+  fail_unless( XMLParallelParser_setMinChunkSize(parser, 256)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLParallelParser_setMinChunkSize(NULL, 256)
+               == LIBLX_INVALID_OBJECT );
+
+  XMLNode_t* node = XMLParallelParser_parse(parser, doc.c_str(), 0, NULL);
+  fail_unless( node != NULL );
+  fail_unless( XMLNode_getNumChildren(node) == 100 );
+  fail_unless( XMLParallelParser_getNumChunks(parser) == 2 );
+  fail_unless( XMLParallelParser_parse(NULL, doc.c_str(), 0, NULL) == NULL );
+
+  XMLNode_free(node);
+  XMLParallelParser_free(parser);
+  XMLParallelParser_free(NULL);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLParallelParser (void)
+{
+  Suite *suite = suite_create("XMLParallelParser");
+  TCase *tcase = tcase_create("XMLParallelParser");
+
+  tcase_add_test( tcase, test_XMLParallelParser_create );
+  tcase_add_test( tcase, test_XMLParallelParser_sameAsSerial );
+  tcase_add_test( tcase, test_XMLParallelParser_small );
+  tcase_add_test( tcase, test_XMLParallelParser_misspeculation );
+  tcase_add_test( tcase, test_XMLParallelParser_errors );
+  tcase_add_test( tcase, test_XMLParallelParser_serialOnly );
+  tcase_add_test( tcase, test_XMLParallelParser_file );
+  tcase_add_test( tcase, test_XMLParallelParser_C );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
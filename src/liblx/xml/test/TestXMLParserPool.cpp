@@ -0,0 +1,187 @@
+/**
+ * \file    TestXMLParserPool.cpp
+ * \brief   XMLParserPool unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sstream>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLError.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLParserPool.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+static const char* documents[] =
+{
+  "<?xml version=\"1.0\"?>\n<a xmlns=\"urn:a\"><b x=\"1\">one</b></a>",
+  "<?xml version=\"1.0\"?>\n<p:c xmlns:p=\"urn:c\"><p:d/></p:c>",
+  "<?xml version=\"1.0\"?>\n<e>\n  <f>\n</e>",
+  "<?xml version=\"1.0\"?>\n<g><h>two</h><h>three</h></g>"
+};
+
+
+/*
+ * @return the tree and the errors read from content, with a stream from
+ * pool, or a stream of its own if pool is NULL.
+ */
+static string
+readDocument (const char* content, XMLParserPool* pool)
+{
+  XMLErrorLog     log;
+  XMLInputStream* stream = (pool != NULL)
+                         ? new XMLInputStream(content, false, *pool, "", &log)
+                         : new XMLInputStream(content, false, "", &log);
+
+  ostringstream oss;
+  if (stream->peek().isStart())
+  {
+    XMLNode root(*stream);
+    oss << root.toXMLString();
+  }
+  while (stream->isGood()) stream->next();
+  delete stream;
+
+  for (unsigned int n = 0; n < log.getNumErrors(); ++n)
+  {
+    const XMLError* error = log.getError(n);
+    oss << ' ' << error->getErrorId() << '@' << error->getLine();
+  }
+
+  return oss.str();
+}
+
+
+START_TEST (test_XMLParserPool_create)
+{
+  XMLParserPool pool(3);
+
+  fail_unless( pool.getMaxIdle()    == 3 );
+  fail_unless( pool.getNumIdle()    == 0 );
+  fail_unless( pool.getNumCreated() == 0 );
+  fail_unless( pool.getNumReused()  == 0 );
+
+  fail_unless( &XMLParserPool::getThreadPool()
+               == &XMLParserPool::getThreadPool() );
+}
+END_TEST
+
+
+START_TEST (test_XMLParserPool_reuse)
+{
+  XMLParserPool pool;
+
+  /* each document, including the one after a malformed one, reads as it
+   * would with a parser of its own */
+  for (unsigned int round = 0; round < 2; ++round)
+  {
+    for (unsigned int n = 0; n < 4; ++n)
+    {
+      fail_unless( readDocument(documents[n], &pool)
+                   == readDocument(documents[n], NULL) );
+    }
+  }
+
+  fail_unless( readDocument(documents[2], NULL).find("@4") != string::npos );
+
+  fail_unless( pool.getNumCreated() == 1 );
+  fail_unless( pool.getNumReused()  == 7 );
+  fail_unless( pool.getNumIdle()    == 1 );
+
+  pool.clear();
+  fail_unless( pool.getNumIdle() == 0 );
+
+  readDocument(documents[0], &pool);
+  fail_unless( pool.getNumCreated() == 2 );
+}
+END_TEST
+
+
+START_TEST (test_XMLParserPool_concurrent)
+{
+  XMLParserPool pool(2);
+
+  /* streams alive at the same time each need a parser */
+  XMLInputStream* streams[3];
+  for (unsigned int n = 0; n < 3; ++n)
+  {
+    streams[n] = new XMLInputStream(documents[n], false, pool);
+  }
+
+  fail_unless( pool.getNumCreated() == 3 );
+
+  for (unsigned int n = 0; n < 3; ++n) delete streams[n];
+
+  /* only maxIdle of them are kept */
+  fail_unless( pool.getNumIdle() == 2 );
+
+  XMLParserPool none(0);
+  readDocument(documents[0], &none);
+  readDocument(documents[1], &none);
+
+  fail_unless( none.getNumCreated() == 2 );
+  fail_unless( none.getNumReused()  == 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLParserPool_C)
+{
+  XMLParserPool_t* pool = XMLParserPool_create(4);
+
+  for (unsigned int n = 0; n < 2; ++n)
+  {
+    XMLInputStream_t* stream =
+      XMLInputStream_createWithPool(documents[0], 0, pool, "");
+
+    fail_unless( stream != NULL );
+    fail_unless( XMLInputStream_isGood(stream) );
+    XMLInputStream_free(stream);
+  }
+
+  fail_unless( XMLParserPool_getNumCreated(pool) == 1 );
+  fail_unless( XMLParserPool_getNumReused(pool)  == 1 );
+  fail_unless( XMLParserPool_getNumCreated(NULL) == 0 );
+  fail_unless( XMLInputStream_createWithPool(documents[0], 0, NULL, "")
+               == NULL );
+
+  XMLParserPool_free(pool);
+  XMLParserPool_free(NULL);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLParserPool (void)
+{
+  Suite *suite = suite_create("XMLParserPool");
+  TCase *tcase = tcase_create("XMLParserPool");
+
+  tcase_add_test( tcase, test_XMLParserPool_create );
+  tcase_add_test( tcase, test_XMLParserPool_reuse );
+  tcase_add_test( tcase, test_XMLParserPool_concurrent );
+  tcase_add_test( tcase, test_XMLParserPool_C );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
@@ -0,0 +1,256 @@
+/**
+ * \file    TestXMLPath.cpp
+ * \brief   XMLPath unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sstream>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLPath.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+static const char* xmlstr =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<model xmlns=\"http://example.org/\" xmlns:x=\"http://x.org/\" id=\"m\">\n"
+  "  <listOfItems>\n"
+  "    <item id=\"a\" x:size=\"1\"><item id=\"a1\"/></item>\n"
+  "    <item id=\"b\"/>\n"
+  "    <x:item id=\"c\"/>\n"
+  "    <note>text</note>\n"
+  "  </listOfItems>\n"
+  "  <listOfItems>\n"
+  "    <item id=\"d\"/>\n"
+  "  </listOfItems>\n"
+  "</model>\n";
+
+static XMLNode* root;
+
+
+static void
+XMLPathTest_setup (void)
+{
+  XMLInputStream stream(xmlstr, false);
+  root = new XMLNode(stream);
+}
+
+
+static void
+XMLPathTest_teardown (void)
+{
+  delete root;
+}
+
+
+/*
+ * @return the id attributes of the selected nodes joined by spaces.
+ */
+static string
+selectIds (const char* expression, const XMLNamespaces* ns = NULL)
+{
+  XMLPath* path = XMLPath::compile(expression, ns);
+  if (path == NULL) return "<invalid>";
+
+  vector<const XMLNode*> found;
+  path->select(*root, found);
+  delete path;
+
+  ostringstream oss;
+  for (size_t n = 0; n < found.size(); ++n)
+  {
+    if (n > 0) oss << ' ';
+    oss << found[n]->getAttributes().getValue("id");
+  }
+  return oss.str();
+}
+
+
+START_TEST (test_XMLPath_child)
+{
+  fail_unless( selectIds("listOfItems/item") == "a b c d" );
+  fail_unless( selectIds("/model/listOfItems/item") == "a b c d" );
+  fail_unless( selectIds("/other/listOfItems/item") == "" );
+  fail_unless( selectIds("/model") == "m" );
+  fail_unless( selectIds("listOfItems[2]/*") == "d" );
+  fail_unless( selectIds("./listOfItems/item/item") == "a1" );
+}
+END_TEST
+
+
+START_TEST (test_XMLPath_descendant)
+{
+  fail_unless( selectIds("//item") == "a a1 b c d" );
+  fail_unless( selectIds(".//item") == "a a1 b c d" );
+  fail_unless( selectIds("listOfItems//item") == "a a1 b c d" );
+  fail_unless( selectIds("//item//item") == "a1" );
+  fail_unless( selectIds("//listOfItems/item[1]") == "a d" );
+}
+END_TEST
+
+
+START_TEST (test_XMLPath_namespaces)
+{
+  XMLNamespaces ns;
+  ns.add("http://x.org/", "x");
+  ns.add("http://example.org/", "e");
+
+  fail_unless( selectIds("//x:item", &ns) == "c" );
+  fail_unless( selectIds("//e:item", &ns) == "a a1 b d" );
+  fail_unless( selectIds("//e:*[@x:size]", &ns) == "a" );
+  fail_unless( selectIds("//item[@size]", &ns) == "" );
+  fail_unless( selectIds("//y:item", &ns) == "<invalid>" );
+  fail_unless( selectIds("//x:item") == "<invalid>" );
+}
+END_TEST
+
+
+START_TEST (test_XMLPath_predicates)
+{
+  fail_unless( selectIds("listOfItems/item[@id='b']") == "b" );
+  fail_unless( selectIds("listOfItems/item[@id=\"b\"]") == "b" );
+  fail_unless( selectIds("listOfItems[1]/item[2]") == "b" );
+  fail_unless( selectIds("listOfItems[2]/item[2]") == "" );
+  fail_unless( selectIds("listOfItems[last()]/item") == "d" );
+  fail_unless( selectIds("listOfItems/item[last()]") == "c d" );
+  fail_unless( selectIds("//item[@id][2]") == "b" );
+  fail_unless( selectIds("listOfItems/*[@id][last()]") == "c d" );
+  fail_unless( selectIds("//*[@id='a1']") == "a1" );
+}
+END_TEST
+
+
+START_TEST (test_XMLPath_invalid)
+{
+  fail_unless( XMLPath::compile("") == NULL );
+  fail_unless( XMLPath::compile("/") == NULL );
+  fail_unless( XMLPath::compile("a/") == NULL );
+  fail_unless( XMLPath::compile("a[0]") == NULL );
+  fail_unless( XMLPath::compile("a[@b=c]") == NULL );
+  fail_unless( XMLPath::compile("a[1") == NULL );
+  fail_unless( XMLPath::compile("../a") == NULL );
+  fail_unless( XMLPath::compile("a b") == NULL );
+}
+END_TEST
+
+
+START_TEST (test_XMLPath_index)
+{
+  XMLNode list(XMLTriple("list", "", ""), XMLAttributes());
+
+  for (unsigned int n = 0; n < 40; ++n)
+  {
+    XMLAttributes attr;
+    ostringstream id;
+    id << n;
+    attr.add("id", id.str());
+    list.addChild(XMLNode(XMLTriple(n % 2 ? "odd" : "even", "", ""), attr));
+  }
+
+  XMLPath* path = XMLPath::compile("odd[3]");
+  XMLPathIndex index;
+
+  const XMLNode* found = path->selectFirst(list, &index);
+  fail_unless( found != NULL );
+  fail_unless( found->getAttributes().getValue("id") == "5" );
+  fail_unless( index.getNumIndexedNodes() == 1 );
+  fail_unless( path->count(list, &index) == 1 );
+  fail_unless( path->count(list) == 1 );
+
+  XMLPath* all = XMLPath::compile("even");
+  fail_unless( all->count(list, &index) == 20 );
+  fail_unless( index.getNumIndexedNodes() == 1 );
+
+  /* small nodes are never indexed */
+  fail_unless( all->count(*root, &index) == 0 );
+  fail_unless( index.getNumIndexedNodes() == 1 );
+
+  index.clear();
+  fail_unless( index.getNumIndexedNodes() == 0 );
+
+  delete all;
+  delete path;
+}
+END_TEST
+
+
+START_TEST (test_XMLPath_dummyRoot)
+{
+  XMLNode* node = XMLNode::convertStringToXMLNode("<p id=\"1\"/><p id=\"2\"/>");
+  fail_unless( node->isEOF() );
+
+  XMLPath* path = XMLPath::compile("/p[2]");
+  const XMLNode* found = path->selectFirst(*node);
+  fail_unless( found != NULL );
+  fail_unless( found->getAttributes().getValue("id") == "2" );
+
+  delete path;
+  delete node;
+}
+END_TEST
+
+
+START_TEST (test_XMLPath_copy)
+{
+  XMLPath* path = XMLPath::compile("//item[@id='b']");
+  XMLPath* copy = path->clone();
+  delete path;
+
+  fail_unless( copy->getExpression() == "//item[@id='b']" );
+  fail_unless( copy->count(*root) == 1 );
+
+  XMLPath_t* cpath = XMLPath_compile("listOfItems/item", NULL);
+  fail_unless( XMLPath_count(cpath, root) == 4 );
+  fail_unless( XMLPath_selectFirst(cpath, root) == &root->getChild(0).getChild(0) );
+  XMLPath_free(cpath);
+
+  fail_unless( XMLPath_compile(NULL, NULL) == NULL );
+  fail_unless( XMLPath_count(NULL, root) == 0 );
+  fail_unless( XMLPath_selectFirst(NULL, root) == NULL );
+  XMLPath_free(NULL);
+
+  delete copy;
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLPath (void)
+{
+  Suite *suite = suite_create("XMLPath");
+  TCase *tcase = tcase_create("XMLPath");
+
+  tcase_add_checked_fixture( tcase,
+                             XMLPathTest_setup,
+                             XMLPathTest_teardown );
+
+  tcase_add_test( tcase, test_XMLPath_child );
+  tcase_add_test( tcase, test_XMLPath_descendant );
+  tcase_add_test( tcase, test_XMLPath_namespaces );
+  tcase_add_test( tcase, test_XMLPath_predicates );
+  tcase_add_test( tcase, test_XMLPath_invalid );
+  tcase_add_test( tcase, test_XMLPath_index );
+  tcase_add_test( tcase, test_XMLPath_dummyRoot );
+  tcase_add_test( tcase, test_XMLPath_copy );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
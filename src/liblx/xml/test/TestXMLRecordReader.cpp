@@ -0,0 +1,402 @@
+/**
+ * \file    TestXMLRecordReader.cpp
+ * \brief   XMLRecordReader unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <atomic>
+#include <new>
+#include <sstream>
+#include <vector>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLErrorLog.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLRecordReader.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+/*
+ * What the callbacks saw.  The processing callback runs on the workers,
+ * the completion callback on the reading thread.
+ */
+struct Seen
+{
+  atomic<unsigned int> processed;
+  atomic<unsigned int> completed;
+  atomic<bool>         overrun;
+  unsigned int         maxPending;
+  unsigned int         stopAt;
+  unsigned int         throwAt;
+  bool                 throwOnCompletion;
+  bool                 inOrder;
+  vector<unsigned int> ids;
+};
+
+
+static void
+resetSeen (Seen& seen)
+{
+  seen.processed         = 0;
+  seen.completed         = 0;
+  seen.overrun           = false;
+  seen.maxPending        = 0;
+  seen.stopAt            = 0;
+  seen.throwAt           = 0;
+  seen.throwOnCompletion = false;
+  seen.inOrder           = true;
+  seen.ids.clear();
+}
+
+
+static string
+makeDocument (unsigned int count)
+{
+  ostringstream oss;
+
+  oss << "<doc>\n  <header><item n=\"-1\"/></header>\n  <listOfItems>\n";
+  for (unsigned int n = 0; n < count; ++n)
+  {
+    oss << "    <item n=\"" << n << "\"><v>" << n * 2 << "</v></item>\n";
+  }
+  oss << "  </listOfItems>\n</doc>\n";
+
+  return oss.str();
+}
+
+
+static int
+processRecord (const XMLNode_t* record, unsigned int index, void* data)
+{
+  Seen* seen = static_cast<Seen*>(data);
+
+  /* the record was read before the ones not yet completed are gone */
+  if (seen->maxPending > 0 && index - seen->completed >= seen->maxPending)
+  {
+    seen->overrun = true;
+  }
+
+  /* some work, so that the workers finish out of order */
+  volatile unsigned int sum = 0;
+  for (unsigned int n = 0; n < (index % 7) * 20000; ++n) sum += n;
+
+  ++seen->processed;
+
+  if (seen->throwAt > 0 && index == seen->throwAt && !seen->throwOnCompletion)
+  {
+    throw bad_alloc();
+  }
+
+  if (record->getName() != "item") return -1;
+  return (seen->stopAt > 0 && index == seen->stopAt) ? 1 : 0;
+}
+
+
+static void
+completeRecord (const XMLNode_t* record, unsigned int index, int result,
+                void* data)
+{
+  Seen* seen = static_cast<Seen*>(data);
+
+  if (index != seen->completed) seen->inOrder = false;
+
+  unsigned int n = 0;
+  istringstream(record->getAttributes().getValue("n")) >> n;
+  if (n != index) seen->inOrder = false;
+
+  seen->ids.push_back(n);
+  ++seen->completed;
+
+  if (seen->throwAt > 0 && index == seen->throwAt && seen->throwOnCompletion)
+  {
+    throw bad_alloc();
+  }
+}
+
+
+START_TEST (test_XMLRecordReader_create)
+{
+  XMLRecordReader reader(processRecord, NULL, 3);
+
+  fail_unless( reader.getNumThreads() == 3 );
+  fail_unless( reader.getContainer()  == "" );
+  fail_unless( reader.getOrder()      == LIBLX_RECORDS_ORDERED );
+  fail_unless( reader.getMaxPending() >  0 );
+
+  fail_unless( reader.setContainer("list") == LIBLX_OPERATION_SUCCESS );
+  fail_unless( reader.getContainer() == "list" );
+  fail_unless( reader.setOrder(LIBLX_RECORDS_UNORDERED)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( reader.getOrder() == LIBLX_RECORDS_UNORDERED );
+  fail_unless( reader.setOrder((XMLRecordOrder_t) 7)
+               == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( reader.setMaxPending(0) == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( reader.setMaxPending(4) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( reader.getMaxPending() == 4 );
+
+  XMLRecordReader automatic(processRecord);
+  fail_unless( automatic.getNumThreads() >= 1 );
+}
+END_TEST
+
+
+START_TEST (test_XMLRecordReader_ordered)
+{
+  const string doc = makeDocument(500);
+
+  Seen seen;
+  resetSeen(seen);
+  seen.maxPending = 8;
+
+  XMLRecordReader reader(processRecord, &seen, 4);
+  reader.setContainer("listOfItems");
+  reader.setMaxPending(8);
+  reader.setCompletion(completeRecord);
+
+  XMLInputStream stream(doc.c_str(), false);
+
+  fail_unless( reader.run(stream) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( reader.getNumRecords() == 500 );
+  fail_unless( reader.isStopped() == false );
+  fail_unless( seen.processed == 500 );
+  fail_unless( seen.completed == 500 );
+  fail_unless( seen.inOrder   == true );
+  fail_unless( seen.overrun   == false );
+
+  /* the reader stops after the container */
+  stream.skipText();
+  fail_unless( stream.peek().isEnd() && stream.peek().getName() == "doc" );
+}
+END_TEST
+
+
+START_TEST (test_XMLRecordReader_unordered)
+{
+  const string doc = makeDocument(500);
+
+  Seen seen;
+  resetSeen(seen);
+  seen.maxPending = 3;
+
+  XMLRecordReader reader(processRecord, &seen, 4);
+  reader.setContainer("listOfItems");
+  reader.setOrder(LIBLX_RECORDS_UNORDERED);
+  reader.setMaxPending(3);
+  reader.setCompletion(completeRecord);
+
+  XMLInputStream stream(doc.c_str(), false);
+
+  fail_unless( reader.run(stream) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( seen.completed == 500 );
+  fail_unless( seen.overrun   == false );
+
+  /* every record is completed exactly once */
+  vector<bool> found(500, false);
+  bool once = true;
+  for (size_t n = 0; n < seen.ids.size(); ++n)
+  {
+    once = once && seen.ids[n] < 500 && !found[seen.ids[n]];
+    if (seen.ids[n] < 500) found[seen.ids[n]] = true;
+  }
+  fail_unless( once );
+}
+END_TEST
+
+
+START_TEST (test_XMLRecordReader_stop)
+{
+  const string doc = makeDocument(500);
+
+  Seen seen;
+  resetSeen(seen);
+  seen.stopAt = 10;
+
+  XMLRecordReader reader(processRecord, &seen, 2);
+  reader.setContainer("listOfItems");
+  reader.setMaxPending(4);
+  reader.setCompletion(completeRecord);
+
+  XMLInputStream stream(doc.c_str(), false);
+
+  fail_unless( reader.run(stream) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( reader.isStopped() == true );
+  fail_unless( reader.getNumRecords() > 10 );
+  fail_unless( reader.getNumRecords() < 500 );
+  fail_unless( seen.completed == reader.getNumRecords() );
+  fail_unless( seen.inOrder == true );
+}
+END_TEST
+
+
+START_TEST (test_XMLRecordReader_documentElement)
+{
+  /* without a container the records are the children of the root */
+  const char* doc = "<doc>\n  <item n='0'/>\n  text\n  <item n='1'/>\n</doc>";
+
+  Seen seen;
+  resetSeen(seen);
+
+  XMLRecordReader reader(processRecord, &seen, 1);
+  reader.setCompletion(completeRecord);
+
+  XMLInputStream stream(doc, false);
+
+  fail_unless( reader.run(stream) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( reader.getNumRecords() == 2 );
+  fail_unless( seen.inOrder == true );
+
+  XMLInputStream empty("<doc/>", false);
+  fail_unless( reader.run(empty) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( reader.getNumRecords() == 0 );
+}
+END_TEST
+
+
+START_TEST (test_XMLRecordReader_error)
+{
+  Seen seen;
+  resetSeen(seen);
+
+  XMLRecordReader reader(processRecord, &seen, 2);
+  reader.setCompletion(completeRecord);
+
+  XMLErrorLog    log;
+  XMLInputStream stream("<doc><item n='0'/><item n='1'></doc>", false, "",
+                        &log);
+
+  fail_unless( reader.run(stream) == LIBLX_OPERATION_FAILED );
+  fail_unless( log.getNumErrors() > 0 );
+  fail_unless( seen.completed == reader.getNumRecords() );
+}
+END_TEST
+
+
+START_TEST (test_XMLRecordReader_exception)
+{
+  const string doc = makeDocument(500);
+
+  /* a processing callback throws, with and without workers */
+  for (unsigned int threads = 1; threads <= 4; threads += 3)
+  {
+    Seen seen;
+    resetSeen(seen);
+    seen.throwAt = 20;
+
+    XMLRecordReader reader(processRecord, &seen, threads);
+    reader.setContainer("listOfItems");
+    reader.setMaxPending(6);
+    reader.setCompletion(completeRecord);
+
+    XMLInputStream stream(doc.c_str(), false);
+
+    fail_unless( reader.run(stream) == LIBLX_OPERATION_FAILED );
+    fail_unless( reader.isStopped() == true );
+    fail_unless( reader.getNumRecords() > 20 );
+    fail_unless( reader.getNumRecords() < 500 );
+    fail_unless( seen.completed <= 20 );
+    fail_unless( seen.inOrder == true );
+  }
+
+  /* the completion callback throws */
+  {
+    Seen seen;
+    resetSeen(seen);
+    seen.throwAt           = 20;
+    seen.throwOnCompletion = true;
+
+    XMLRecordReader reader(processRecord, &seen, 4);
+    reader.setContainer("listOfItems");
+    reader.setMaxPending(6);
+    reader.setCompletion(completeRecord);
+
+    XMLInputStream stream(doc.c_str(), false);
+
+    fail_unless( reader.run(stream) == LIBLX_OPERATION_FAILED );
+    fail_unless( reader.isStopped() == true );
+    fail_unless( reader.getNumRecords() < 500 );
+    fail_unless( seen.completed == 21 );
+    fail_unless( seen.inOrder == true );
+
+    /* the reader can be run again */
+    resetSeen(seen);
+    XMLInputStream again(doc.c_str(), false);
+
+    fail_unless( reader.run(again) == LIBLX_OPERATION_SUCCESS );
+    fail_unless( reader.isStopped() == false );
+    fail_unless( seen.completed == 500 );
+  }
+}
+END_TEST
+
+
+START_TEST (test_XMLRecordReader_C)
+{
+  const string doc = makeDocument(50);
+
+  Seen seen;
+  resetSeen(seen);
+
+  XMLRecordReader_t* reader = XMLRecordReader_create(processRecord, &seen, 2);
+
+  fail_unless( XMLRecordReader_setContainer(reader, "listOfItems")
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLRecordReader_setOrder(reader, LIBLX_RECORDS_ORDERED)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLRecordReader_setMaxPending(reader, 5)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLRecordReader_setCompletion(reader, completeRecord)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLRecordReader_setContainer(NULL, "x")
+               == LIBLX_INVALID_OBJECT );
+  fail_unless( XMLRecordReader_run(reader, NULL) == LIBLX_INVALID_OBJECT );
+
+  XMLInputStream_t* stream = XMLInputStream_create(doc.c_str(), 0, "");
+
+  fail_unless( XMLRecordReader_run(reader, stream) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLRecordReader_getNumRecords(reader) == 50 );
+  fail_unless( seen.completed == 50 );
+  fail_unless( seen.inOrder == true );
+
+  XMLInputStream_free(stream);
+  XMLRecordReader_free(reader);
+  XMLRecordReader_free(NULL);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLRecordReader (void)
+{
+  Suite *suite = suite_create("XMLRecordReader");
+  TCase *tcase = tcase_create("XMLRecordReader");
+
+  tcase_add_test( tcase, test_XMLRecordReader_create );
+  tcase_add_test( tcase, test_XMLRecordReader_ordered );
+  tcase_add_test( tcase, test_XMLRecordReader_unordered );
+  tcase_add_test( tcase, test_XMLRecordReader_stop );
+  tcase_add_test( tcase, test_XMLRecordReader_documentElement );
+  tcase_add_test( tcase, test_XMLRecordReader_error );
+  tcase_add_test( tcase, test_XMLRecordReader_exception );
+  tcase_add_test( tcase, test_XMLRecordReader_C );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
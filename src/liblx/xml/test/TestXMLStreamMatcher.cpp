@@ -0,0 +1,288 @@
+/**
+ * \file    TestXMLStreamMatcher.cpp
+ * \brief   XMLStreamMatcher unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <sstream>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLInputStream.h>
+#include <liblx/xml/XMLNamespaces.h>
+#include <liblx/xml/XMLNode.h>
+#include <liblx/xml/XMLPath.h>
+#include <liblx/xml/XMLStreamMatcher.h>
+#include <liblx/xml/operationReturnValues.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+static const char* xmlstr =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<model xmlns=\"http://example.org/\" xmlns:x=\"http://x.org/\" id=\"m\">\n"
+  "  <listOfItems>\n"
+  "    <item id=\"a\" x:size=\"1\"><item id=\"a1\"/></item>\n"
+  "    <item id=\"b\"/>\n"
+  "    <x:item id=\"c\"/>\n"
+  "    <note>text</note>\n"
+  "  </listOfItems>\n"
+  "  <listOfItems>\n"
+  "    <item id=\"d\"/>\n"
+  "  </listOfItems>\n"
+  "</model>\n";
+
+
+struct Collected
+{
+  ostringstream ids;
+  unsigned int  stopAfter;
+  unsigned int  seen;
+};
+
+
+static int
+collect (const XMLNode_t* node, unsigned int path, void* data)
+{
+  Collected* c = static_cast<Collected*>(data);
+
+  if (c->seen > 0) c->ids << ' ';
+  c->ids << node->getAttributes().getValue("id");
+  if (path > 0) c->ids << '@' << path;
+
+  ++c->seen;
+  return (c->stopAfter != 0 && c->seen == c->stopAfter) ? 1 : 0;
+}
+
+
+/*
+ * @return the id attributes of the elements delivered for the given
+ * paths, each followed by '@' and the path index unless it is 0.
+ */
+static string
+matchIds (  const char*          first
+          , const char*          second     = NULL
+          , const XMLNamespaces* ns         = NULL
+          , unsigned int         stopAfter  = 0 )
+{
+  Collected c;
+  c.stopAfter = stopAfter;
+  c.seen      = 0;
+
+  XMLStreamMatcher matcher(collect, &c);
+  const char* expressions[] = { first, second };
+
+  for (unsigned int n = 0; n < 2 && expressions[n] != NULL; ++n)
+  {
+    XMLPath* path = XMLPath::compile(expressions[n], ns);
+    if (path == NULL) return "<invalid>";
+
+    int status = matcher.addPath(*path);
+    delete path;
+    if (status != LIBLX_OPERATION_SUCCESS) return "<unsupported>";
+  }
+
+  XMLInputStream stream(xmlstr, false);
+  if (matcher.run(stream) != LIBLX_OPERATION_SUCCESS) return "<failed>";
+  if (matcher.getNumMatches() != c.seen) return "<miscounted>";
+
+  return c.ids.str();
+}
+
+
+/*
+ * @return the id attributes of the nodes XMLPath selects from the tree.
+ */
+static string
+selectIds (const char* expression)
+{
+  XMLInputStream stream(xmlstr, false);
+  XMLNode root(stream);
+
+  XMLPath* path = XMLPath::compile(expression);
+  vector<const XMLNode*> found;
+  path->select(root, found);
+  delete path;
+
+  ostringstream oss;
+  for (size_t n = 0; n < found.size(); ++n)
+  {
+    if (n > 0) oss << ' ';
+    oss << found[n]->getAttributes().getValue("id");
+  }
+  return oss.str();
+}
+
+
+START_TEST (test_XMLStreamMatcher_child)
+{
+  fail_unless( matchIds("listOfItems/item") == "a b c d" );
+  fail_unless( matchIds("/model/listOfItems/item") == "a b c d" );
+  fail_unless( matchIds("/other/listOfItems/item") == "" );
+  fail_unless( matchIds("/model") == "m" );
+  fail_unless( matchIds("./listOfItems/./item/item") == "a1" );
+}
+END_TEST
+
+
+START_TEST (test_XMLStreamMatcher_descendant)
+{
+  /* a1 is inside the delivered a and is not reported separately */
+  fail_unless( matchIds("//item") == "a b c d" );
+  fail_unless( matchIds(".//item") == "a b c d" );
+  fail_unless( matchIds("//item//item") == "a1" );
+  fail_unless( matchIds("//listOfItems/item[1]") == "a d" );
+}
+END_TEST
+
+
+START_TEST (test_XMLStreamMatcher_predicates)
+{
+  XMLNamespaces ns;
+  ns.add("http://x.org/", "x");
+
+  fail_unless( matchIds("listOfItems/item[@id='b']") == "b" );
+  fail_unless( matchIds("listOfItems[1]/item[2]") == "b" );
+  fail_unless( matchIds("listOfItems[2]/item[2]") == "" );
+  fail_unless( matchIds("//item[@id][2]") == "b" );
+  fail_unless( matchIds("//*[@id='a1']") == "a1" );
+  fail_unless( matchIds("//x:item", NULL, &ns) == "c" );
+  fail_unless( matchIds("//*[@x:size]", NULL, &ns) == "a" );
+}
+END_TEST
+
+
+START_TEST (test_XMLStreamMatcher_sameAsSelect)
+{
+  const char* paths[] =
+  {
+      "listOfItems/item"
+    , "/model/listOfItems[2]/item"
+    , "listOfItems/*[@id]"
+    , "listOfItems/item[@id='b']"
+    , "//item//item"
+    , "//listOfItems/item[1]"
+  };
+
+  for (size_t n = 0; n < sizeof(paths) / sizeof(paths[0]); ++n)
+  {
+    fail_unless( matchIds(paths[n]) == selectIds(paths[n]) );
+  }
+}
+END_TEST
+
+
+START_TEST (test_XMLStreamMatcher_severalPaths)
+{
+  fail_unless( matchIds("listOfItems[2]/item", "//item")
+               == "a@1 b@1 c@1 d" );
+  fail_unless( matchIds("//item[@id='b']", "listOfItems/item")
+               == "a@1 b c@1 d@1" );
+  fail_unless( matchIds("//*[@id]", "//item") == "m" );
+}
+END_TEST
+
+
+START_TEST (test_XMLStreamMatcher_stop)
+{
+  fail_unless( matchIds("//item", NULL, NULL, 2) == "a b" );
+
+  Collected c;
+  c.stopAfter = 1;
+  c.seen      = 0;
+
+  XMLStreamMatcher matcher(collect, &c);
+  XMLPath* path = XMLPath::compile("listOfItems/item");
+  matcher.addPath(*path);
+  delete path;
+
+  XMLInputStream stream(xmlstr, false);
+  fail_unless( matcher.run(stream) == LIBLX_OPERATION_SUCCESS );
+  fail_unless( matcher.isStopped() == true );
+  fail_unless( matcher.getNumMatches() == 1 );
+
+  /* the stream is left at the element after the match */
+  stream.skipText();
+  fail_unless( stream.peek().getName() == "item" );
+  fail_unless( stream.peek().getAttributes().getValue("id") == "b" );
+}
+END_TEST
+
+
+START_TEST (test_XMLStreamMatcher_unsupported)
+{
+  fail_unless( matchIds("listOfItems/item[last()]") == "<unsupported>" );
+  fail_unless( matchIds(".//.") == "<unsupported>" );
+  fail_unless( matchIds(".") == "<unsupported>" );
+
+  XMLStreamMatcher matcher(collect);
+  fail_unless( matcher.getNumPaths() == 0 );
+
+  XMLPath* path = XMLPath::compile("item[last()]");
+  fail_unless( matcher.addPath(*path) == LIBLX_INVALID_ATTRIBUTE_VALUE );
+  fail_unless( matcher.getNumPaths() == 0 );
+  delete path;
+}
+END_TEST
+
+
+START_TEST (test_XMLStreamMatcher_C)
+{
+  Collected c;
+  c.stopAfter = 0;
+  c.seen      = 0;
+
+  XMLStreamMatcher_t* matcher = XMLStreamMatcher_create(collect, &c);
+  XMLPath_t* path = XMLPath_compile("//note", NULL);
+  XMLInputStream_t* stream = XMLInputStream_create(xmlstr, 0, "");
+
+  fail_unless( XMLStreamMatcher_addPath(matcher, path)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLStreamMatcher_run(matcher, stream)
+               == LIBLX_OPERATION_SUCCESS );
+  fail_unless( XMLStreamMatcher_getNumMatches(matcher) == 1 );
+
+  fail_unless( XMLStreamMatcher_addPath(NULL, path) == LIBLX_INVALID_OBJECT );
+  fail_unless( XMLStreamMatcher_addPath(matcher, NULL) == LIBLX_INVALID_OBJECT );
+  fail_unless( XMLStreamMatcher_run(NULL, stream) == LIBLX_INVALID_OBJECT );
+  fail_unless( XMLStreamMatcher_getNumMatches(NULL) == 0 );
+  XMLStreamMatcher_free(NULL);
+
+  XMLInputStream_free(stream);
+  XMLPath_free(path);
+  XMLStreamMatcher_free(matcher);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLStreamMatcher (void)
+{
+  Suite *suite = suite_create("XMLStreamMatcher");
+  TCase *tcase = tcase_create("XMLStreamMatcher");
+
+  tcase_add_test( tcase, test_XMLStreamMatcher_child );
+  tcase_add_test( tcase, test_XMLStreamMatcher_descendant );
+  tcase_add_test( tcase, test_XMLStreamMatcher_predicates );
+  tcase_add_test( tcase, test_XMLStreamMatcher_sameAsSelect );
+  tcase_add_test( tcase, test_XMLStreamMatcher_severalPaths );
+  tcase_add_test( tcase, test_XMLStreamMatcher_stop );
+  tcase_add_test( tcase, test_XMLStreamMatcher_unsupported );
+  tcase_add_test( tcase, test_XMLStreamMatcher_C );
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND
@@ -953,6 +953,43 @@ START_TEST(test_XMLToken_accessWithNULL)
 }
 END_TEST
 
+START_TEST(test_XMLToken_sharedName)
+{
+  XMLTriple_t     *triple = XMLTriple_createWith("item", "http://example.org/", "ex");
+  XMLAttributes_t *attr   = XMLAttributes_create();
+  XMLToken_t      *token1 = XMLToken_createWithTripleAttr(triple, attr);
+  XMLToken_t      *token2 = XMLToken_createWithTripleAttr(triple, attr);
+  XMLToken_t      *copy;
+
+  /* tokens with the same qualified name share one interned copy of it */
+  fail_unless( XMLToken_getName(token1) == XMLToken_getName(token2) );
+  fail_unless( XMLToken_getURI(token1)  == XMLToken_getURI(token2)  );
+  fail_unless( XMLToken_isAttributesEmpty(token1) == 1 );
+
+  XMLToken_addAttr(token1, "id", "i1");
+  copy = XMLToken_clone(token1);
+
+  /* attributes are not shared between copies */
+  XMLToken_addAttr(copy, "value", "0.5");
+  fail_unless( XMLToken_getAttributesLength(token1) == 1 );
+  fail_unless( XMLToken_getAttributesLength(copy)   == 2 );
+  fail_unless( XMLToken_getAttributesLength(token2) == 0 );
+  fail_unless( XMLToken_getName(copy) == XMLToken_getName(token1) );
+
+  XMLTriple_free(triple);
+  triple = XMLTriple_createWith("other", "", "");
+  XMLToken_setTriple(token2, triple);
+  fail_unless( strcmp(XMLToken_getName(token2), "other") == 0 );
+  fail_unless( strcmp(XMLToken_getName(token1), "item")  == 0 );
+
+  XMLToken_free(copy);
+  XMLToken_free(token2);
+  XMLToken_free(token1);
+  XMLAttributes_free(attr);
+  XMLTriple_free(triple);
+}
+END_TEST
+
 Suite *
 create_suite_XMLToken (void)
 {
@@ -970,6 +1007,7 @@ create_suite_XMLToken (void)
   tcase_add_test( tcase, test_XMLToken_attribute_add_remove);
   tcase_add_test( tcase, test_XMLToken_attribute_set_clear);
   tcase_add_test( tcase, test_XMLToken_accessWithNULL             );
+  tcase_add_test( tcase, test_XMLToken_sharedName );
 
   suite_add_tcase(suite, tcase);
 
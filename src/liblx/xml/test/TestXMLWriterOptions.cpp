@@ -0,0 +1,186 @@
+/**
+ * \file    TestXMLWriterOptions.cpp
+ * \brief   XMLWriterOptions unit tests
+ *
+ * <!--------------------------------------------------------------------------
+ * This file is part of libLX.  Please visit http://sbml.org for more
+ * information about SBML, and the latest version of libLX.
+ *
+ * This library is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation.  A copy of the license agreement is provided
+ * in the file named "LICENSE.txt" included with this software distribution
+ * and also available online as http://sbml.org/software/libsbml/license.html
+ * ---------------------------------------------------------------------- -->*/
+
+#include <cstring>
+#include <sstream>
+
+#include <liblx/xml/common/common.h>
+#include <liblx/xml/XMLOutputStream.h>
+#include <liblx/xml/XMLWriterOptions.h>
+#include <liblx/xml/XMLNode.h>
+
+#include <check.h>
+using namespace std;
+LIBLX_CPP_NAMESPACE_USE
+
+CK_CPPSTART
+
+
+START_TEST (test_XMLWriterOptions_defaults)
+{
+  XMLWriterOptions options;
+
+  fail_unless( options.getIndent()          == true );
+  fail_unless( options.getIndentWidth()     == 2 );
+  fail_unless( options.getWriteComment()    == true );
+  fail_unless( options.getWriteTimestamp()  == true );
+  fail_unless( options.getLibraryName()     == "libSBML" );
+  fail_unless( options.getLibraryVersion()  == getLibLXDottedVersion() );
+  fail_unless( options.getDoublePrecision() == 15 );
+  fail_unless( options.getLineEnding()      == "\n" );
+  fail_unless( options.getCacheNodes()      == false );
+
+  XMLWriterOptions changed = options.withIndent(false)
+                                    .withIndentWidth(4)
+                                    .withWriteComment(false)
+                                    .withWriteTimestamp(false)
+                                    .withLibraryName("lx")
+                                    .withLibraryVersion("9")
+                                    .withDoublePrecision(17)
+                                    .withLineEnding("\r\n")
+                                    .withCacheNodes(true);
+
+  fail_unless( changed.getIndent()          == false );
+  fail_unless( changed.getIndentWidth()     == 4 );
+  fail_unless( changed.getWriteComment()    == false );
+  fail_unless( changed.getWriteTimestamp()  == false );
+  fail_unless( changed.getLibraryName()     == "lx" );
+  fail_unless( changed.getLibraryVersion()  == "9" );
+  fail_unless( changed.getDoublePrecision() == 17 );
+  fail_unless( changed.getLineEnding()      == "\r\n" );
+  fail_unless( changed.getCacheNodes()      == true );
+
+  /* the original is untouched */
+  fail_unless( options.getIndent()          == true );
+  fail_unless( options.getLineEnding()      == "\n" );
+}
+END_TEST
+
+
+START_TEST (test_XMLWriterOptions_stream)
+{
+  const XMLWriterOptions options = XMLWriterOptions()
+                                     .withWriteTimestamp(false)
+                                     .withLibraryName("lx")
+                                     .withLibraryVersion("9")
+                                     .withIndentWidth(4)
+                                     .withDoublePrecision(17)
+                                     .withLineEnding("\r\n");
+
+  ostringstream oss;
+  XMLOutputStream stream(oss, options, "UTF-8", true, "prog", "1");
+
+  fail_unless( stream.getWriterOptions().getIndentWidth() == 4 );
+
+  stream.startElement("a");
+  stream.writeAttribute("x", 0.1);
+  stream.startElement("b");
+  stream.endElement("b");
+  stream.endElement("a");
+
+  const char* expected =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n"
+    "<!-- Created by prog version 1 with lx version 9. -->\r\n"
+    "<a x=\"0.10000000000000001\">\r\n"
+    "    <b/>\r\n"
+    "</a>";
+
+  fail_unless( oss.str() == expected );
+}
+END_TEST
+
+
+START_TEST (test_XMLWriterOptions_processDefaults)
+{
+  XMLOutputStream::setWriteComment(false);
+
+  /* streams with options ignore the process-wide settings */
+  ostringstream withOptions;
+  XMLOutputStream first(withOptions,
+                        XMLWriterOptions().withWriteTimestamp(false),
+                        "UTF-8", false, "prog");
+  fail_unless( withOptions.str() ==
+               "<!-- Created by prog with libSBML version "
+               + string(getLibLXDottedVersion()) + ". -->\n" );
+
+  /* streams without them take a copy when they are made */
+  ostringstream legacy;
+  XMLOutputStream second(legacy, "UTF-8", false, "prog");
+  fail_unless( legacy.str().empty() );
+  fail_unless( second.getWriterOptions().getWriteComment() == false );
+  fail_unless( XMLWriterOptions::getProcessDefaults().getWriteComment()
+               == false );
+
+  XMLOutputStream::setWriteComment(true);
+  fail_unless( second.getWriterOptions().getWriteComment() == false );
+
+  /* strings made from nodes are unaffected either way */
+  XMLNode node(XMLToken(XMLTriple("c", "", ""), XMLAttributes()));
+  fail_unless( node.toXMLString() == "<c/>" );
+}
+END_TEST
+
+
+START_TEST (test_XMLWriterOptions_C)
+{
+  XMLWriterOptions_t* defaults = XMLWriterOptions_create();
+  XMLWriterOptions_t* flat     = XMLWriterOptions_withIndent(defaults, 0);
+  XMLWriterOptions_t* options  = XMLWriterOptions_withLineEnding(flat, "\r\n");
+
+  fail_unless( XMLWriterOptions_withIndent(NULL, 0) == NULL );
+  fail_unless( XMLWriterOptions_withLineEnding(options, NULL) == NULL );
+
+  XMLOutputStream_t* stream =
+    XMLOutputStream_createAsStringWithOptions(options, "UTF-8", 1);
+
+  XMLOutputStream_startElement(stream, "a");
+  XMLOutputStream_startElement(stream, "b");
+  XMLOutputStream_endElement(stream, "b");
+  XMLOutputStream_endElement(stream, "a");
+
+  const char* chars = XMLOutputStream_getString(stream);
+  fail_unless( !strcmp(chars,
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n<a><b/></a>") );
+
+  fail_unless( XMLOutputStream_createAsStringWithOptions(NULL, "UTF-8", 1)
+               == NULL );
+
+  safe_free((void*)(chars));
+  XMLOutputStream_free(stream);
+  XMLWriterOptions_free(options);
+  XMLWriterOptions_free(flat);
+  XMLWriterOptions_free(defaults);
+  XMLWriterOptions_free(NULL);
+}
+END_TEST
+
+
+Suite *
+create_suite_XMLWriterOptions (void)
+{
+  Suite *suite = suite_create("XMLWriterOptions");
+  TCase *tcase = tcase_create("XMLWriterOptions");
+
+  tcase_add_test( tcase, test_XMLWriterOptions_defaults );
+  tcase_add_test( tcase, test_XMLWriterOptions_stream );
+  tcase_add_test( tcase, test_XMLWriterOptions_processDefaults );
+  tcase_add_test( tcase, test_XMLWriterOptions_C );
+
+  suite_add_tcase(suite, tcase);
+
+  return suite;
+}
+
+CK_CPPEND